@@ -13,6 +13,7 @@
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <algorithm>
 
 #include <boost/foreach.hpp>
 
@@ -74,6 +75,11 @@ DOMLauncher::DOMLauncher(const I3Context& ctx)
                 "Name of the random service in the context.",
                 randomServiceName_);
 
+    numThreads_ = 1;
+    AddParameter("NumThreads","Number of threads used to simulate the discriminators "
+                "of the hit DOMs. The output does not depend on the number of threads.",
+                numThreads_);
+
     AddOutBox("OutBox");
 }
 
@@ -88,6 +94,9 @@ void DOMLauncher::Configure(){
     GetParameter("MultiFrameEvents",multiFrameEvents_);
     GetParameter("BeaconLaunches",beaconLaunches_);
     GetParameter("BeaconLaunchRate",beaconLaunchRate_);
+    GetParameter("NumThreads",numThreads_);
+    if(numThreads_==0)
+        numThreads_ = std::max(1u, boost::thread::hardware_concurrency());
     
     I3DOM::beaconLaunchRate = beaconLaunchRate_;
     
@@ -138,6 +147,8 @@ void DOMLauncher::DAQ(I3FramePtr frame){
     // event or more generally for an entire frame for each DOM.
     double frameStart = DBL_MAX, frameEnd = -DBL_MAX;
     
+    std::vector<std::pair<I3DOM*, const I3MCPulseSeries*> > hitDOMs;
+    hitDOMs.reserve(pulseSeriesMap->size());
     BOOST_FOREACH(I3MCPulseSeriesMap::const_reference kv_pair, *pulseSeriesMap){
         const OMKey& omkey = kv_pair.first;
         const I3MCPulseSeries& pulses = kv_pair.second;
@@ -152,7 +163,7 @@ void DOMLauncher::DAQ(I3FramePtr frame){
                 frameEnd   = pulses[end].time > frameEnd ? pulses[end].time:frameEnd;
             }
             
-            DOMit->second->Discriminator(pulses, dcStream);
+            hitDOMs.push_back(std::make_pair(DOMit->second.get(), &pulses));
             activeDOMsMap_[omkey] = DOMit->second;
         }
         else{
@@ -160,6 +171,27 @@ void DOMLauncher::DAQ(I3FramePtr frame){
                     omkey.str().c_str());
         }
     }
+
+    // The discriminator of a DOM only depends on its own pulses and draws no
+    // random numbers, so the DOMs can be processed independently. Each DOM
+    // writes to its own stream and the streams are concatenated in map order,
+    // which gives the same dcStream as a sequential pass.
+    if(numThreads_ > 1){
+        std::vector<DCStream> domStreams(hitDOMs.size());
+        ParallelFor(hitDOMs.size(), numThreads_, [&](size_t i){
+            hitDOMs[i].first->Discriminator(*hitDOMs[i].second, domStreams[i]);
+        });
+        size_t nCrossings = 0;
+        BOOST_FOREACH(const DCStream& stream, domStreams)
+            nCrossings += stream.size();
+        dcStream.reserve(nCrossings);
+        BOOST_FOREACH(const DCStream& stream, domStreams)
+            dcStream.insert(dcStream.end(), stream.begin(), stream.end());
+    }
+    else{
+        for(size_t i = 0; i < hitDOMs.size(); i++)
+            hitDOMs[i].first->Discriminator(*hitDOMs[i].second, dcStream);
+    }
     
     
     if(frameEnd-frameStart> 60*I3Units::second){
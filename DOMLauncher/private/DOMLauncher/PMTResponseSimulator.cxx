@@ -1,4 +1,5 @@
 #include "DOMLauncher/PMTResponseSimulator.h"
+#include "DOMLauncher/domlauncherutils.h"
 
 #include <cmath>
 #include <cassert>
@@ -8,6 +9,7 @@
 #include <stack>
 
 #include <boost/make_shared.hpp>
+#include <boost/thread.hpp>
 #include <boost/math/constants/constants.hpp>
 
 #include <icetray/I3Units.h>
@@ -16,6 +18,7 @@
 #include <sim-services/MCPEMCPulseTools.hpp>
 #include <dataclasses/status/I3DetectorStatus.h>
 #include <dataclasses/calibration/I3Calibration.h>
+#include <phys-services/I3GSLRandomService.h>
 
 #include "discreteDistribution.h"
 #include "PMT.cxx"
@@ -37,7 +40,8 @@ afterPulseProbability_(0.0593), //http://icecube.wisc.edu/~chwendt/afterpulse-no
 applySaturation_(true),
 mergeHits_(true),
 lowMem_(false),
-randomServiceName_("I3RandomService")
+randomServiceName_("I3RandomService"),
+numThreads_(1)
 {
 	//For use if module description strings become supported in icetray
 	/*SetDescription("A module which simulates the behaviour of a PMT\n"
@@ -93,6 +97,12 @@ randomServiceName_("I3RandomService")
 	AddParameter("RandomServiceName",
 		     "Name of the random service in the context.",
 		     randomServiceName_);
+	AddParameter("NumThreads",
+	             "Number of threads used to process DOMs (0 uses all available cores). "
+	             "With more than one thread each DOM draws from its own random stream, "
+	             "seeded in OMKey order from the random service, so the output does not "
+	             "depend on the number of threads but differs from single-threaded running.",
+	             numThreads_);
 	AddOutBox("OutBox");
 }
 
@@ -110,6 +120,9 @@ void PMTResponseSimulator::Configure(){
 	GetParameter("MergeHits",mergeHits_);
 	GetParameter("LowMem",lowMem_);
 	GetParameter("RandomServiceName",randomServiceName_);
+	GetParameter("NumThreads",numThreads_);
+	if(numThreads_==0)
+		numThreads_=std::max(1u,boost::thread::hardware_concurrency());
 	randomService_ = context_.Get<I3RandomServicePtr>(randomServiceName_);
 	if(!randomService_)
 		log_fatal("No random service available");
@@ -172,6 +185,18 @@ void PMTResponseSimulator::DAQ(I3FramePtr frame){
 	I3ParticleIDMapPtr outputPIDMap(new I3ParticleIDMap());
 	I3MCPulseSeriesMapPtr outputPulses(new I3MCPulseSeriesMap());
 
+	//the DOMs to process, in OMKey order
+	struct DOMWork{
+		OMKey dom;
+		const std::vector<I3MCPE>* hits;
+		const I3DOMCalibration* calibration;
+		const I3DOMStatus* status;
+		const ParticlePulseIndexMap* pedigree;
+		I3OMGeo::OMType omType;
+	};
+	std::vector<DOMWork> work;
+	work.reserve(inputHits->size());
+
 	//iterate over PMTs
 	for(const auto& domPair : *inputHits){
         OMKey dom=domPair.first;
@@ -222,12 +247,37 @@ void PMTResponseSimulator::DAQ(I3FramePtr frame){
 		  = (inputPedigree && inputPedigree->count(dom) ?
 			 inputPedigree->find(dom)->second : dummyPedigree);
 
-		std::pair<std::vector<I3MCPulse>, ParticlePulseIndexMap> pulses=
-		processHits(domPair.second, dom, omCalibration->second, omStatus->second, pePedigree, omType);
-		outputPulses->insert(std::make_pair(domPair.first,pulses.first));
-		outputPIDMap->insert(std::make_pair(domPair.first,pulses.second));
+		DOMWork item={dom, &domPair.second, &omCalibration->second, &omStatus->second, &pePedigree, omType};
+		work.push_back(item);
 	} //end of iteration over DOMs
 
+	std::vector<std::pair<std::vector<I3MCPulse>, ParticlePulseIndexMap> > results(work.size());
+	if(numThreads_<=1){
+		for(size_t i=0; i<work.size(); i++){
+			const DOMWork& item=work[i];
+			results[i]=processDOMHits(*item.hits, item.dom, *item.calibration, *item.status,
+			                          *item.pedigree, item.omType, randomService_);
+		}
+	}
+	else{
+		//Seed one random stream per DOM, sequentially and in OMKey order, so
+		//that the result is independent of how the DOMs are spread over threads.
+		std::vector<unsigned int> seeds(work.size());
+		for(size_t i=0; i<work.size(); i++)
+			seeds[i]=randomService_->Integer(std::numeric_limits<unsigned int>::max());
+		domlauncherutils::ParallelFor(work.size(), numThreads_, [&](size_t i){
+			const DOMWork& item=work[i];
+			I3RandomServicePtr rng=boost::make_shared<I3GSLRandomService>(seeds[i],false);
+			results[i]=processDOMHits(*item.hits, item.dom, *item.calibration, *item.status,
+			                          *item.pedigree, item.omType, rng);
+		});
+	}
+
+	for(size_t i=0; i<work.size(); i++){
+		outputPulses->insert(std::make_pair(work[i].dom,std::move(results[i].first)));
+		outputPIDMap->insert(std::make_pair(work[i].dom,std::move(results[i].second)));
+	}
+
 	frame->Put(outputHitsName_,outputPulses);
 	frame->Put(outputHitsName_+"ParticleIDMap",outputPIDMap);
 
@@ -238,6 +288,14 @@ std::pair<std::vector<I3MCPulse>, ParticlePulseIndexMap>
 PMTResponseSimulator::processHits(const std::vector<I3MCPE>& inputHits, OMKey pmtKey,
                                   const I3DOMCalibration& calibration, const I3DOMStatus& status,
                                   const ParticlePulseIndexMap& pePedigree, const I3OMGeo::OMType domType){
+	return(processDOMHits(inputHits, pmtKey, calibration, status, pePedigree, domType, randomService_));
+}
+
+std::pair<std::vector<I3MCPulse>, ParticlePulseIndexMap>
+PMTResponseSimulator::processDOMHits(const std::vector<I3MCPE>& inputHits, OMKey pmtKey,
+                                     const I3DOMCalibration& calibration, const I3DOMStatus& status,
+                                     const ParticlePulseIndexMap& pePedigree, const I3OMGeo::OMType domType,
+                                     const I3RandomServicePtr& rng){
 	log_trace_stream(pmtKey << " has " << inputHits.size() << " input hits");
 	std::pair<std::vector<I3MCPulse>, ParticlePulseIndexMap> result;
 	std::vector<I3MCPulse>& outputHits=result.first;
@@ -248,13 +306,13 @@ PMTResponseSimulator::processHits(const std::vector<I3MCPE>& inputHits, OMKey pm
 		case I3OMGeo::OMType::IceCube:
 		case I3OMGeo::OMType::IceTop:
 		case I3OMGeo::OMType::PDOM:
-			pmt = boost::make_shared<HamamatsuR7081_02PMT>(prePulseProbability_, latePulseProbability_, randomService_);
+			pmt = boost::make_shared<HamamatsuR7081_02PMT>(prePulseProbability_, latePulseProbability_, rng);
 			break;
 		case I3OMGeo::OMType::mDOM:
 			pmt = boost::make_shared<HamamatsuR15458_02PMT>();
 			break;
 		case I3OMGeo::OMType::DEgg:
-			pmt = boost::make_shared<HamamatsuR5912_100PMT>(randomService_);
+			pmt = boost::make_shared<HamamatsuR5912_100PMT>(rng);
 			break;
 		default:
 			log_fatal_stream("unknown DOM type " << pmtKey);
@@ -275,7 +333,10 @@ PMTResponseSimulator::processHits(const std::vector<I3MCPE>& inputHits, OMKey pm
 	std::vector<I3ParticleID> parents;
 
 	//ensure that we have an up-to-date charge distribution for the DOM
+	//(the distributions are shared between threads, but only their lookup
+	//tables are used; random numbers are always drawn from rng)
 	boost::shared_ptr<I3SumGenerator> speDistribution;
+	boost::mutex::scoped_lock chargeDistributionsLock(chargeDistributionsMutex_);
 	if(!chargeDistributions_.count(pmtKey)){
 		speDistribution = pmt->GetSpeDistribution(calibration, randomService_);
 	    
@@ -283,6 +344,7 @@ PMTResponseSimulator::processHits(const std::vector<I3MCPE>& inputHits, OMKey pm
 	}
 	else
 		speDistribution=chargeDistributions_.find(pmtKey)->second;
+	chargeDistributionsLock.unlock();
 
 	const double pmtVoltage=status.pmtHV;
 	uint32_t peIndex=0; //index of the pe we are processing
@@ -318,21 +380,21 @@ PMTResponseSimulator::processHits(const std::vector<I3MCPE>& inputHits, OMKey pm
 			I3MCPulse pulse;
 			pulse.time=hit.time;
 			//decide randomly which kind of hit to make
-			double ran=randomService_->Uniform(1);
+			double ran=rng->Uniform(1);
 			bool canMakeAfterpulse=true;
 			if(ran<(1.-pmt->GetPrePulseProbability()-pmt->GetLatePulseProbability())){ //regular pulse
 				log_trace("creating an SPE");
 				pulse.source=I3MCPulse::PE;
-				pulse.charge=normalHitWeight(1,speDistribution);
+				pulse.charge=normalHitWeight(1,speDistribution,*rng);
 				if(usePMTJitter_)
-					pulse.time+=pmt->PMTJitter(randomService_);
+					pulse.time+=pmt->PMTJitter(rng);
 			}
 			else if(ran<(1.-pmt->GetLatePulseProbability())){ //prepulse
 				log_trace("creating a prepulse");
 				pulse.source=I3MCPulse::PRE_PULSE;
 				pulse.charge=prePulseWeight(pmtVoltage);
 				if(usePMTJitter_)
-					pulse.time+=pmt->PMTJitter(randomService_);
+					pulse.time+=pmt->PMTJitter(rng);
 				pulse.time += prePulseTimeShift(pmtVoltage);
 				//A prepulse created by a photon passing through the cathode to
 				//hit the first dynode cannot generate an afterpulse
@@ -340,7 +402,7 @@ PMTResponseSimulator::processHits(const std::vector<I3MCPE>& inputHits, OMKey pm
 			}
 			else{ //late pulse
 				log_trace("creating a late pulse");
-				createLatePulse(pulse,speDistribution,pmtVoltage);
+				createLatePulse(pulse,speDistribution,pmtVoltage,*rng);
 			}
 			outputHits.push_back(pulse);
 			particleMap[pid].push_back(pulseIndex++);
@@ -349,11 +411,11 @@ PMTResponseSimulator::processHits(const std::vector<I3MCPE>& inputHits, OMKey pm
 			//each additional afterpulse should have its time be defined relative
 			//to the hit which generates it, rather than relative to the original hit
 			double afterpulseBaseTime=hit.time;
-			while(canMakeAfterpulse && randomService_->Uniform(1)<afterPulseProbability_){
+			while(canMakeAfterpulse && rng->Uniform(1)<afterPulseProbability_){
 				log_trace("adding an afterpulse");
 				I3MCPulse afterPulse;
 				afterPulse.time=afterpulseBaseTime; //use the parent hit's time
-				createAfterPulse(afterPulse,speDistribution,pmtVoltage);
+				createAfterPulse(afterPulse,speDistribution,pmtVoltage,*rng);
 				afterpulseBaseTime=afterPulse.time; //set the base time for a possible subsidiary afterpulse
 				outputHits.push_back(afterPulse);
 				particleMap[pid].push_back(pulseIndex++);
@@ -390,10 +452,11 @@ PMTResponseSimulator::processHits(const std::vector<I3MCPE>& inputHits, OMKey pm
 	return(result);
 }
 
-double PMTResponseSimulator::normalHitWeight(unsigned int w, const boost::shared_ptr<I3SumGenerator>& speDistribution){
+double PMTResponseSimulator::normalHitWeight(unsigned int w, const boost::shared_ptr<I3SumGenerator>& speDistribution,
+                                             I3RandomService& rng){
 	if(!useSPEDistribution_)
 		return(w);
-	return(speDistribution->Generate(w));
+	return(speDistribution->Generate(w,rng));
 }
 
 
@@ -411,7 +474,7 @@ double PMTResponseSimulator::prePulseWeight(double voltage){
 }
 
 //Weighting formula taken from pmt-simulator
-double PMTResponseSimulator::earlyAfterPulseWeight(){
+double PMTResponseSimulator::earlyAfterPulseWeight(I3RandomService& rng){
 	if(!useSPEDistribution_)
 		return(1.0);
 	//Fisher-Tippett fit to Early Afterpulse Charge distribtion, peaks 2 and 3.
@@ -425,7 +488,7 @@ double PMTResponseSimulator::earlyAfterPulseWeight(){
 	const double ln_charge_lower_bound=1e-20;
 	//Lower bound of charge distribution corresponding to 3.33 PE
 	const double ln_charge_upper_bound=0.94883;
-	return(fisherTippett(peak_charge,charge_spread,ln_charge_lower_bound,ln_charge_upper_bound));
+	return(fisherTippett(peak_charge,charge_spread,ln_charge_lower_bound,ln_charge_upper_bound,rng));
 }
 
 struct pulseComponent{
@@ -440,7 +503,8 @@ struct pulseComponent{
 //This suggests to the compiler that var is 'used', suppressing unhelpful warnings
 #define used_var(var) while(0){ var++; }
 
-void PMTResponseSimulator::createLatePulse(I3MCPulse& hit, const boost::shared_ptr<I3SumGenerator>& speDistribution, double voltage){
+void PMTResponseSimulator::createLatePulse(I3MCPulse& hit, const boost::shared_ptr<I3SumGenerator>& speDistribution, double voltage,
+                                           I3RandomService& rng){
 	//data for different types of late pulses
 	const static unsigned int nComponents=5;
 	const static pulseComponent pulseTypes[nComponents]={
@@ -459,7 +523,7 @@ void PMTResponseSimulator::createLatePulse(I3MCPulse& hit, const boost::shared_p
 	static discrete_distribution dist(probabilities,probabilities+nComponents);
 
 	//decide which type of pulse to generate, randomly
-	random_adapter gen(randomService_.get());
+	random_adapter gen(&rng);
 	unsigned int index=dist(gen);
 	const pulseComponent& pulseType=pulseTypes[index];
 	hit.source=pulseType.source;
@@ -470,14 +534,15 @@ void PMTResponseSimulator::createLatePulse(I3MCPulse& hit, const boost::shared_p
 	const double ln_time_upper_bound=0.999998;
 
 	double timeDelay=0.0;
-	timeDelay = fisherTippett(pulseType.location,pulseType.scale,ln_time_lower_bound,ln_time_upper_bound);
+	timeDelay = fisherTippett(pulseType.location,pulseType.scale,ln_time_lower_bound,ln_time_upper_bound,rng);
 	timeDelay *= sqrt(referenceVoltage/voltage);
 	hit.time+=timeDelay;
 
-	hit.charge=normalHitWeight(1,speDistribution);
+	hit.charge=normalHitWeight(1,speDistribution,rng);
 }
 
-void PMTResponseSimulator::createAfterPulse(I3MCPulse& hit, const boost::shared_ptr<I3SumGenerator>& speDistribution, double voltage){
+void PMTResponseSimulator::createAfterPulse(I3MCPulse& hit, const boost::shared_ptr<I3SumGenerator>& speDistribution, double voltage,
+                                            I3RandomService& rng){
 	const static unsigned int nComponents=11;
 	//From hit-maker; should be derived from https://wiki.icecube.wisc.edu/index.php/Afterpulse_Data
 	//Note that early after pulse components produce multiple p.e. of charge, so
@@ -505,7 +570,7 @@ void PMTResponseSimulator::createAfterPulse(I3MCPulse& hit, const boost::shared_
 	static discrete_distribution dist(probabilities,probabilities+nComponents);
 
 	//decide which type of pulse to generate, randomly
-	random_adapter gen(randomService_.get());
+	random_adapter gen(&rng);
 	unsigned int index=dist(gen);
 	const pulseComponent& pulseType=pulseTypes[index];
 	hit.source=pulseType.source;
@@ -513,14 +578,14 @@ void PMTResponseSimulator::createAfterPulse(I3MCPulse& hit, const boost::shared_
 	const double referenceVoltage = 1345*I3Units::V;
 	double timeDelay=0.0;
 	while(timeDelay<=0.0)
-		timeDelay=randomService_->Gaus(pulseType.location,pulseType.scale);
+		timeDelay=rng.Gaus(pulseType.location,pulseType.scale);
 	timeDelay *= sqrt(referenceVoltage/voltage);
 	hit.time+=timeDelay;
 
 	if(pulseType.source==I3MCPulse::EARLY_AFTER_PULSE)
-		hit.charge=earlyAfterPulseWeight();
+		hit.charge=earlyAfterPulseWeight(rng);
 	else
-		hit.charge=normalHitWeight(1,speDistribution);
+		hit.charge=normalHitWeight(1,speDistribution,rng);
 }
 
 struct saturationParams{
@@ -607,8 +672,9 @@ void PMTResponseSimulator::saturate(std::vector<I3MCPulse>& hits, double pmtVolt
 }
 
 double PMTResponseSimulator::fisherTippett(double location, double scale,
-                                           double logLowerBound, double logUpperBound){
-	return(location - scale * log(-log(randomService_->Uniform(logLowerBound,logUpperBound))));
+                                           double logLowerBound, double logUpperBound,
+                                           I3RandomService& rng){
+	return(location - scale * log(-log(rng.Uniform(logLowerBound,logUpperBound))));
 }
 
 
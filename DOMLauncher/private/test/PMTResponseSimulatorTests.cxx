@@ -717,3 +717,46 @@ TEST(IngestMergedPE){
 	ENSURE_EQUAL(counts[particles[2]],1+2+2);
 	ENSURE_EQUAL(counts[particles[3]],2);
 }
+
+//Check that the output with several threads does not depend on the number of threads
+TEST(9_ThreadCountIndependence){
+	boost::shared_ptr<I3Calibration> calibration=boost::make_shared<I3Calibration>();
+	boost::shared_ptr<I3DetectorStatus> status=boost::make_shared<I3DetectorStatus>();
+	boost::shared_ptr<I3Map<OMKey,std::vector<I3MCPE> > > hitMap(new I3Map<OMKey,std::vector<I3MCPE> >);
+	for(unsigned int om=1; om<=20; om++){
+		OMKey dom(40,om);
+		calibration->domCal[dom]=getTestCalibration()->domCal[testOM];
+		status->domStatus[dom]=getTestStatus()->domStatus[testOM];
+		std::vector<I3MCPE>& hits=(*hitMap)[dom];
+		for(unsigned int i=0; i<om; i++)
+			hits.push_back(makeHit(10.0*i,1+i%3));
+	}
+	
+	auto simulate=[&](unsigned int nThreads){
+		I3Context context;
+		ServiceFactoryWrapper rng(context,"I3GSLRandomServiceFactory");
+		rng.Configure()("Seed",9381);
+		rng.installService();
+		PMTResponseSimulatorTestSetup rts(context);
+		rts.Configure()("NumThreads",nThreads);
+		boost::shared_ptr<I3Frame> frame(new I3Frame(I3Frame::DAQ));
+		frame->Put(calibration);
+		frame->Put(status);
+		frame->Put("I3MCPESeriesMap",hitMap);
+		frame=rts.processFrame(frame);
+		return(frame->Get<I3Map<OMKey,std::vector<I3MCPulse> > >("I3MCPulseSeriesMap"));
+	};
+	
+	const I3Map<OMKey,std::vector<I3MCPulse> > twoThreads=simulate(2);
+	const I3Map<OMKey,std::vector<I3MCPulse> > fiveThreads=simulate(5);
+	ENSURE_EQUAL(twoThreads.size(),hitMap->size(),"Every DOM should have pulses");
+	ENSURE_EQUAL(fiveThreads.size(),hitMap->size(),"Every DOM should have pulses");
+	for(const auto& domPulses : twoThreads){
+		const std::vector<I3MCPulse>& other=fiveThreads.at(domPulses.first);
+		ENSURE_EQUAL(domPulses.second.size(),other.size(),"Pulse counts should not depend on the number of threads");
+		for(size_t i=0; i<other.size(); i++){
+			ENSURE_EQUAL(domPulses.second[i].time,other[i].time,"Pulse times should not depend on the number of threads");
+			ENSURE_EQUAL(domPulses.second[i].charge,other[i].charge,"Pulse charges should not depend on the number of threads");
+		}
+	}
+}
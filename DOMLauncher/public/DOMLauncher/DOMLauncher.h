@@ -78,6 +78,10 @@ class DOMLauncher : public I3ConditionalModule{
   bool beaconLaunches_;
   /// Rate of beacon launches.
   double beaconLaunchRate_;
+
+  /// Number of threads used to simulate the discriminators of the DOMs.
+  /// The LC logic and the digitization always run sequentially.
+  unsigned int numThreads_;
   
   /// The name of the DOMLaunchSeriesMaps to be produced.
   std::string domLaunchMapName_;
@@ -11,6 +11,8 @@
 #include <simclasses/I3ParticleIDMap.hpp>
 #include "dataclasses/geometry/I3OMGeo.h"
 
+#include <boost/thread/mutex.hpp>
+
 class I3Calibration;
 class I3DOMCalibration;
 class I3DOMStatus;
@@ -71,10 +73,14 @@ private:
 
 	///The random service fetched from the tray
 	boost::shared_ptr<I3RandomService> randomService_;
+	///The number of threads used to process DOMs
+	unsigned int numThreads_;
 	///A generic distribution of charges produced by single photon hits
 	boost::shared_ptr<I3SumGenerator> genericChargeDistribution_;
 	///The charge distributions to be used for each DOM for single photon hits
 	std::map<OMKey, boost::shared_ptr<I3SumGenerator> > chargeDistributions_;
+	///Guards chargeDistributions_ when DOMs are processed in parallel
+	boost::mutex chargeDistributionsMutex_;
 
 	///The most recently seen calibration data
 	boost::shared_ptr<const I3Calibration> lastCalibration_;
@@ -85,9 +91,11 @@ private:
 	///
 	///\param w The weight of the hit in photons
 	///\param speDistribution The amplification distribution from which to sample 
+	///\param rng The random service to draw from
 	///\return  The amount of charge produced by the PMT for this hit, in units of the ideal charge
 	///         produced by a single photoelectron
-	double normalHitWeight(unsigned int w, const boost::shared_ptr<I3SumGenerator>& speDistribution);
+	double normalHitWeight(unsigned int w, const boost::shared_ptr<I3SumGenerator>& speDistribution,
+	                       I3RandomService& rng);
 
 	///Computes the amount by which prepulses are early at a given voltage
 	///\param voltage The operating voltage of the DOM
@@ -101,21 +109,35 @@ private:
 	double prePulseWeight(double voltage);
 
 	///Computes the charge of an early afterpulse, relative to an ideal s.p.e. at a given voltage
+	///\param rng The random service to draw from
 	///\return The amount of charge produced by the PMT for an early afterpulse, in units of the ideal
 	///        charge produced by a single photoelectron
-	double earlyAfterPulseWeight();
+	double earlyAfterPulseWeight(I3RandomService& rng);
 
 	///Alters the properies of the given hit to describe a late pulse
 	///\param hit The existing raw hit to be turned into a late pulse hit
 	///\param speDistribution The speDistribution for the DOM on which the hit is being detected
 	///\param voltage The operating voltage of the PMT
-	void createLatePulse(I3MCPulse& hit, const boost::shared_ptr<I3SumGenerator>& speDistribution, double voltage);
+	///\param rng The random service to draw from
+	void createLatePulse(I3MCPulse& hit, const boost::shared_ptr<I3SumGenerator>& speDistribution, double voltage,
+	                     I3RandomService& rng);
 
 	///Alters the properies of the given hit to describe an afterpulse
 	///\param hit The existing raw hit to be turned into an afterpulse hit
 	///\param speDistribution The speDistribution for the DOM on which the hit is being detected
 	///\param voltage The operating voltage of the PMT
-	void createAfterPulse(I3MCPulse& hit, const boost::shared_ptr<I3SumGenerator>& speDistribution, double voltage);
+	///\param rng The random service to draw from
+	void createAfterPulse(I3MCPulse& hit, const boost::shared_ptr<I3SumGenerator>& speDistribution, double voltage,
+	                      I3RandomService& rng);
+	///Applies all transformations to a set of hits on a single DOM, drawing all
+	///random numbers from rng. This is safe to call concurrently for different
+	///DOMs as long as each call is given its own random service.
+	std::pair<std::vector<I3MCPulse>, ParticlePulseIndexMap>
+	processDOMHits(const std::vector<I3MCPE>& inputHits, OMKey dom,
+	               const I3DOMCalibration& cal, const I3DOMStatus& status,
+	               const ParticlePulseIndexMap& pePedigree,
+	               const I3OMGeo::OMType domType,
+	               const boost::shared_ptr<I3RandomService>& rng);
 
 public:
 	///Applies all transformations to a set of hits on a single DOM
@@ -190,7 +212,9 @@ private:
 	///              (variance = (pi * scale)**2 / 6)
 	///\param logLowerBound Indirectly determines the lower cutoff of the distribution
 	///\param logUpperBound Indirectly determines the upper cutoff of the distribution
-	double fisherTippett(double location, double scale, double logLowerBound, double logUpperBound);
+	///\param rng The random service to draw from
+	double fisherTippett(double location, double scale, double logLowerBound, double logUpperBound,
+	                     I3RandomService& rng);
 
 	SET_LOGGER("PMTResponseSimulator");
 	friend class PMTResponseSimulatorTestSetup;
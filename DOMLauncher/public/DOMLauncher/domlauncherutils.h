@@ -8,6 +8,9 @@
 #include "icetray/OMKey.h"
 
 #include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include <atomic>
+#include <exception>
 #include <map>
 #include <algorithm>
 #include <list>
@@ -260,6 +263,41 @@ namespace domlauncherutils{
         double bufferTime_;
   };
   typedef std::vector<detail::DiscCross> DCStream;
+
+  ///Calls work(i) for every i in [0,n) using up to nThreads threads. Indices
+  ///are handed out dynamically so that a few very bright DOMs do not stall
+  ///the other threads. With nThreads<=1 the loop runs on the calling thread.
+  ///The first exception thrown by any call is rethrown on the calling thread.
+  template<typename Work>
+  void ParallelFor(size_t n, unsigned int nThreads, Work work){
+      if(nThreads<=1 || n<2){
+          for(size_t i = 0; i < n; i++)
+              work(i);
+          return;
+      }
+      if(nThreads > n)
+          nThreads = n;
+
+      std::atomic<size_t> next(0);
+      std::exception_ptr error;
+      boost::mutex errorMutex;
+      boost::thread_group threads;
+      for(unsigned int t = 0; t < nThreads; t++){
+          threads.create_thread([&](){
+              try{
+                  for(size_t i = next++; i < n; i = next++)
+                      work(i);
+              }catch(...){
+                  boost::mutex::scoped_lock lock(errorMutex);
+                  if(!error) error = std::current_exception();
+                  next = n;
+              }
+          });
+      }
+      threads.join_all();
+      if(error)
+          std::rethrow_exception(error);
+  }
  
 }//domlauncherutils
 
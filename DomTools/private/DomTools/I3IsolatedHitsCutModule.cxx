@@ -11,6 +11,7 @@
  */
 
 #include <cmath>
+#include <algorithm>
 #include <dataclasses/I3MapOMKeyMask.h>
 #include <dataclasses/physics/I3RecoPulse.h>
 #include <DomTools/I3IsolatedHitsCutModule.h>
@@ -88,75 +89,75 @@ I3IsolatedHitsCutModule<responseClass>::HitCleaning(I3FramePtr frame)
     return;
   }
 
-  const I3Geometry &geometry = frame->template Get<I3Geometry>();
-  const I3OMGeoMap &geo = geometry.omgeo;
+  I3GeometryConstPtr geometry = frame->template Get<I3GeometryConstPtr>();
+  if (!geometry)
+    log_fatal("No geometry found in the frame");
 
   const I3Map<OMKey, std::vector<responseClass> >& input = 
     frame->template Get<I3Map<OMKey,std::vector<responseClass> > >(inputResponse_);
-  
+
   shared_ptr<I3Map<OMKey,std::vector<responseClass> > > 
     output(new I3Map<OMKey,std::vector<responseClass> >);
 
-  if (!distPtr || &(distPtr->getGeo())!=&geo){
+  if (!neighborPtr || neighborGeo_ != geometry){
     log_info("Loading New Geometry");
-    distPtr=shared_ptr<I3DistanceMap>(new I3DistanceMap(geo));
+    neighborGeo_=geometry;
+    neighborPtr=shared_ptr<I3NeighborMap>(new I3NeighborMap(geometry->omgeo, RTRadius_));
   }
 
-  for(I3ResponseIter<responseClass> iter(input); 
-      !iter.End() ; 
-      iter++){
-    const OMKey &key = iter.GetOMKey();
-    double t1  = iter.GetTime();
-    double w1;
-    if ( UseWidth_ == -1)
-      w1  = iter.GetWidth();
-    else 
-      w1  = UseWidth_;
-    
+  double width = (UseWidth_ == -1) ? NAN : UseWidth_;
+  I3CoincidenceEngine<responseClass> engine(input, RTTime_, width);
+
+  //a response passes if it has more than RTMultiplicity_ coincident responses,
+  //itself included
+  unsigned limit = std::max(RTMultiplicity_ + 1, 1);
+
+  typename I3Map<OMKey, std::vector<responseClass> >::const_iterator domIter;
+  for(domIter=input.begin(); domIter!=input.end(); domIter++){
+    const OMKey &key = domIter->first;
+    if(domIter->second.empty())
+      continue;
+
     log_debug("Investigating str %d om %d", key.GetString(),key.GetOM());
 
-    //perform hit selection based on spatial and temporal isolation
-    
-    int multiplicity=0;
-
-    for(I3ResponseIter<responseClass> iter2(input);
-        !iter2.End();
-        iter2++){
-      const OMKey &key2  = iter2.GetOMKey();
-      double t2   = iter2.GetTime();
-      
-      double w2;
+    //the DOMs within RTRadius only depend on the DOM, so look them up once
+    //for all of its responses
+    const std::vector<OMKey> *geoNeighbors = neighborPtr->getNeighbors(key);
+    if(!geoNeighbors)
+      log_fatal("OMKey(%d,%u) is not in the geometry", key.GetString(), key.GetOM());
+    std::vector<int> neighbors;
+    for(std::vector<OMKey>::const_iterator key2=geoNeighbors->begin();
+        key2!=geoNeighbors->end();
+        key2++){
+      int dom2 = engine.Find(*key2);
+      if(dom2 >= 0)
+        neighbors.push_back(dom2);
+    }
+
+    for(typename std::vector<responseClass>::const_iterator iter=domIter->second.begin();
+        iter!=domIter->second.end();
+        iter++){
+      double t1  = domtools::GetTime(*iter);
+      double w1;
       if ( UseWidth_ == -1)
-        w2  = iter2.GetWidth();
-      else
-        w2  = UseWidth_;
-      
-      log_debug("Comparing to str %d om %d", key2.GetString(),key2.GetOM());
-
-      double distance = distPtr->getDistance(key,key2);
-      if(distance>RTRadius_) 
-        continue;  //distance too large
-
-      bool dt_too_large=true;
-      if(t1<=t2 && t1+w1>=t2) dt_too_large=false;                //second pulse starts "inside" first pulse
-      else if(t2<=t1 && t2+w2>=t1) dt_too_large=false;           //first pulse starts "inside" second pulse
-      else if(t1<=t2+w2 && t1+w1>=t2+w2) dt_too_large=false;     //second pulse ends "inside" first pulse
-      else if(t2<=t1+w1 && t2+w2>=t1+w1) dt_too_large=false;     //first pulse ends "inside" second pulse
-      else if(t1<t2 && t2-(t1+w1) < RTTime_) dt_too_large=false; //first pulse ends shortly before second pulse
-      else if(t2<t1 && t1-(t2+w2) < RTTime_) dt_too_large=false; //second pulse ends shortly before first pulse
-      if(dt_too_large) 
-        continue;
-      
-      multiplicity++;
-      if(multiplicity > RTMultiplicity_){
+        w1  = domtools::GetWidth(*iter);
+      else 
+        w1  = UseWidth_;
+
+      //perform hit selection based on spatial and temporal isolation
+      unsigned multiplicity=0;
+      for(std::vector<int>::const_iterator dom2=neighbors.begin();
+          dom2!=neighbors.end() && multiplicity<limit;
+          dom2++)
+        multiplicity += engine.Count(*dom2, t1, w1, limit - multiplicity);
+
+      if(multiplicity >= limit){
         //copy particular response from input to output
-        responseClass response=iter.Get();
-        (*output)[key].push_back(response);
-        break;
+        (*output)[key].push_back(*iter);
       }
     }
   }
-    
+
   //put the output in the frame
   WriteToFrame(frame, output);
   PushFrame(frame,"OutBox");
@@ -0,0 +1,219 @@
+/**
+ * copyright  (C) 2020
+ * the IceCube collaboration
+ * Version $Id$
+ *
+ * @file I3CoincidenceEngine.h
+ * @version $Revision:$
+ * @date $Date$
+ */
+
+#ifndef DOMTOOLS_I3COINCIDENCEENGINE_H_INCLUDED
+#define DOMTOOLS_I3COINCIDENCEENGINE_H_INCLUDED
+
+#include "DomTools/Utility.h"
+#include "icetray/OMKey.h"
+#include "icetray/I3Logging.h"
+#include "dataclasses/I3Map.h"
+#include "dataclasses/geometry/I3Geometry.h"
+#include <boost/foreach.hpp>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <map>
+#include <cmath>
+
+namespace domtools
+{
+  /**
+   * The local coincidence condition shared by I3Coincify and
+   * I3IsolatedHitsCutModule. A NaN window disables the time test.
+   */
+  inline bool InTimeCoincidence(double t1, double w1, double t2, double w2, double window)
+    {
+      if(std::isnan(window)) return true;
+      if(t1<=t2 && t1+w1>=t2) return true;         //second pulse starts "inside" first pulse
+      if(t2<=t1 && t2+w2>=t1) return true;         //first pulse starts "inside" second pulse
+      if(t1<=t2+w2 && t1+w1>=t2+w2) return true;   //second pulse ends "inside" first pulse
+      if(t2<=t1+w1 && t2+w2>=t1+w1) return true;   //first pulse ends "inside" second pulse
+      if(t1<t2 && t2-(t1+w1) < window) return true; //first pulse ends shortly before second pulse
+      if(t2<t1 && t1-(t2+w2) < window) return true; //second pulse ends shortly before first pulse
+      return false;
+    }
+}
+
+/**
+ * @brief Lists, for every OM of a geometry, the OMs that lie within a given
+ * distance of it (the OM itself included).
+ *
+ * Meant to be built once per geometry and kept until the geometry changes.
+ */
+class I3NeighborMap
+{
+ public:
+  /**
+   * @param geo the geometry to map
+   * @param radiusSquared the largest squared distance at which two OMs are neighbors
+   */
+  inline I3NeighborMap(const I3OMGeoMap &geo, double radiusSquared)
+  {
+    std::vector<OMKey> keys;
+    std::vector<I3Position> positions;
+    BOOST_FOREACH(I3OMGeoMap::const_reference itr, geo)
+      {
+	keys.push_back(itr.first);
+	positions.push_back(itr.second.position);
+	neighbors_[itr.first];
+      }
+    for(size_t i=0; i<keys.size(); i++)
+      {
+	std::vector<OMKey> &list=neighbors_[keys[i]];
+	for(size_t j=0; j<keys.size(); j++)
+	  {
+	    double dx=positions[i].GetX() - positions[j].GetX();
+	    double dy=positions[i].GetY() - positions[j].GetY();
+	    double dz=positions[i].GetZ() - positions[j].GetZ();
+	    if(dx*dx + dy*dy + dz*dz > radiusSquared) continue;
+	    list.push_back(keys[j]);
+	  }
+      }
+    log_info("Created new I3NeighborMap for %zu OMs", keys.size());
+  }
+
+  /**
+   * @return the neighbors of key, or NULL if key is not in the geometry
+   */
+  inline const std::vector<OMKey>* getNeighbors(const OMKey &key) const
+  {
+    std::map<OMKey, std::vector<OMKey> >::const_iterator itr=neighbors_.find(key);
+    return itr==neighbors_.end() ? NULL : &(itr->second);
+  }
+
+ private:
+  std::map<OMKey, std::vector<OMKey> > neighbors_;
+
+  SET_LOGGER("I3NeighborMap");
+};
+
+/**
+ * @brief Counts coincident responses on a DOM without walking all of its responses.
+ *
+ * The responses of every DOM are copied once per frame into a time-sorted
+ * list together with the range of their widths. Only responses whose start
+ * time can still satisfy domtools::InTimeCoincidence are then looked at, and
+ * that range is found by binary search. DOMs with times or widths that are
+ * not finite are checked response by response.
+ */
+template <class responseClass>
+class I3CoincidenceEngine
+{
+ public:
+  typedef I3Map<OMKey, std::vector<responseClass> > ResponseSeriesMap;
+
+  /**
+   * @param input the responses of the frame
+   * @param window the coincidence window (NaN: no time test)
+   * @param fixedWidth width to use for every response (NaN: use domtools::GetWidth)
+   */
+  I3CoincidenceEngine(const ResponseSeriesMap &input, double window, double fixedWidth=NAN) :
+    window_(window)
+  {
+    offsets_.push_back(0);
+    for(typename ResponseSeriesMap::const_iterator itr=input.begin(); itr!=input.end(); itr++)
+      {
+	bool sortable=true;
+	double minWidth=std::numeric_limits<double>::infinity();
+	double maxWidth=-std::numeric_limits<double>::infinity();
+	typename std::vector<responseClass>::const_iterator ritr;
+	for(ritr=itr->second.begin(); ritr!=itr->second.end(); ritr++)
+	  {
+	    Response response;
+	    response.time=domtools::GetTime(*ritr);
+	    response.width=std::isnan(fixedWidth) ? domtools::GetWidth(*ritr) : fixedWidth;
+	    if(!std::isfinite(response.time) || !std::isfinite(response.width))
+	      sortable=false;
+	    minWidth=std::min(minWidth, response.width);
+	    maxWidth=std::max(maxWidth, response.width);
+	    responses_.push_back(response);
+	  }
+	if(sortable)
+	  std::sort(responses_.begin()+offsets_.back(), responses_.end(), ResponseTimeLess);
+	keys_.push_back(itr->first);
+	offsets_.push_back(responses_.size());
+	minWidth_.push_back(minWidth);
+	maxWidth_.push_back(maxWidth);
+	sorted_.push_back(sortable);
+      }
+  }
+
+  /**
+   * @return the index of key among the DOMs of the input, or -1 if it has no entry
+   */
+  int Find(const OMKey &key) const
+  {
+    std::vector<OMKey>::const_iterator itr=std::lower_bound(keys_.begin(), keys_.end(), key);
+    if(itr==keys_.end() || *itr!=key) return -1;
+    return itr-keys_.begin();
+  }
+
+  /**
+   * @return how many responses on DOM dom are in coincidence with a response
+   * at time t with width w, counting no further than limit
+   */
+  unsigned Count(int dom, double t, double w, unsigned limit) const
+  {
+    typename std::vector<Response>::const_iterator first=responses_.begin()+offsets_[dom];
+    typename std::vector<Response>::const_iterator last=responses_.begin()+offsets_[dom+1];
+    if(std::isnan(window_))
+      return std::min<size_t>(last-first, limit);
+
+    if(sorted_[dom] && std::isfinite(t) && std::isfinite(w) && std::isfinite(window_))
+      {
+	// bounds on the start time of any response that can pass the test,
+	// whichever of the conditions it passes by
+	double e=t+w;
+	double lo=std::min(std::min(t, t-maxWidth_[dom]),
+			   std::min(e-maxWidth_[dom], t-window_-maxWidth_[dom]));
+	double hi=std::max(std::max(t, e),
+			   std::max(e-minWidth_[dom], e+window_));
+	// leave room for rounding; every candidate is tested exactly below
+	double pad=1e-6*(std::abs(lo)+std::abs(hi)+1.);
+	first=std::lower_bound(first, last, lo-pad, ResponseBefore);
+	last=std::upper_bound(first, last, hi+pad, ResponseAfter);
+      }
+
+    unsigned count=0;
+    for(; first!=last && count<limit; first++)
+      if(domtools::InTimeCoincidence(t, w, first->time, first->width, window_))
+	count++;
+    return count;
+  }
+
+ private:
+  I3CoincidenceEngine();
+
+  struct Response
+  {
+    double time;
+    double width;
+  };
+
+  static bool ResponseTimeLess(const Response &a, const Response &b) {return a.time<b.time;}
+  static bool ResponseBefore(const Response &a, double time) {return a.time<time;}
+  static bool ResponseAfter(double time, const Response &a) {return time<a.time;}
+
+  double window_;
+  ///DOMs of the input, in map order
+  std::vector<OMKey> keys_;
+  ///responses of DOM i are responses_[offsets_[i]] up to responses_[offsets_[i+1]]
+  std::vector<size_t> offsets_;
+  std::vector<Response> responses_;
+  std::vector<double> minWidth_;
+  std::vector<double> maxWidth_;
+  ///false if the DOM has times or widths that are not finite and must be searched linearly
+  std::vector<bool> sorted_;
+
+  SET_LOGGER("I3CoincidenceEngine");
+};
+
+#endif
@@ -16,7 +16,7 @@
 #include "icetray/I3Frame.h"
 #include "icetray/I3Units.h"
 #include "dataclasses/I3Map.h"
-#include "DomTools/I3ResponseIter.h"
+#include "DomTools/I3CoincidenceEngine.h"
 #include "DomTools/Utility.h"
 #include <string>
 #include <cmath>
@@ -95,67 +95,49 @@ class I3Coincify : public I3ConditionalModule
 
     const I3Map<OMKey, std::vector<responseClass> >& input = frame->template Get<I3Map<OMKey,std::vector<responseClass> > >(inputName_);
 
-    I3ResponseIter<responseClass> iter(input);
+    I3CoincidenceEngine<responseClass> engine(input, coincWindow_);
 
-    for(;!iter.End();iter++){
-      const OMKey& key1 = iter.GetOMKey();
+    typename I3Map<OMKey, std::vector<responseClass> >::const_iterator domIter;
+    for(domIter=input.begin(); domIter!=input.end(); domIter++){
+      const OMKey& key1 = domIter->first;
       int    string1 = key1.GetString();
       int    om1     = key1.GetOM();
-      double t1      = iter.GetTime()/I3Units::ns;
-      double w1      = iter.GetWidth()/I3Units::ns;
-      
+
       log_debug("Investigating str %d om %d", key1.GetString(),key1.GetOM());
-      
-      int multiplicity = 0;
-      const I3Map<OMKey, std::vector<responseClass> >& input2 = frame->template Get<I3Map<OMKey,std::vector<responseClass> > >(inputName_);
-      for(int om2 = (om1 - coincSpacing_); om2 <= (om1 + coincSpacing_); om2++){
 
+      // the neighbors only depend on the DOM, so look them up once for all of its responses
+      std::vector<int> neighbors;
+      for(int om2 = (om1 - coincSpacing_); om2 <= (om1 + coincSpacing_); om2++){
         OMKey key2(string1, om2);
-	if(key2 == key1) continue;
-        if(input2.find(key2) == input2.end()) continue; //om not found
-	
-        const std::vector<responseClass>& responseSeries2=input2.find(key2)->second;
-        typename std::vector<responseClass>::const_iterator iter2;
-	
-        for(iter2=responseSeries2.begin(); iter2!=responseSeries2.end(); iter2++){
-	  
-          double t2  = domtools::GetTime(*iter2)/I3Units::ns;
-          double w2  = domtools::GetWidth(*iter2)/I3Units::ns;
-	  
-          log_debug("Comparing to str %d om %d", key2.GetString(),key2.GetOM());
-	  
-          if(!std::isnan(coincWindow_)){ 
-            bool dt_too_large=true;
-            if(t1<=t2 && t1+w1>=t2) dt_too_large=false;        //second pulse starts "inside" first pulse
-            if(t2<=t1 && t2+w2>=t1) dt_too_large=false;        //first pulse starts "inside" second pulse
-            if(t1<=t2+w2 && t1+w1>=t2+w2) dt_too_large=false;  //second pulse ends "inside" first pulse
-            if(t2<=t1+w1 && t2+w2>=t1+w1) dt_too_large=false;  //first pulse ends "inside" second pulse
-            if(t1<t2 && t2-(t1+w1) < coincWindow_) dt_too_large=false; //first pulse ends shortly before second pulse
-            if(t2<t1 && t1-(t2+w2) < coincWindow_) dt_too_large=false; //second pulse ends shortly before first pulse
-            if(dt_too_large) continue;
-          }
-	  
-          multiplicity++;   //a hit that satisfies the requirements survived
+        if(key2 == key1) continue;
+        int dom2 = engine.Find(key2);
+        if(dom2 < 0) continue; //om not found
+        neighbors.push_back(dom2);
+      }
+
+      typename std::vector<responseClass>::const_iterator iter;
+      for(iter=domIter->second.begin(); iter!=domIter->second.end(); iter++){
+        double t1 = domtools::GetTime(*iter);
+        double w1 = domtools::GetWidth(*iter);
+
+        int multiplicity = 0;
+        std::vector<int>::const_iterator dom2;
+        for(dom2=neighbors.begin(); dom2!=neighbors.end() && multiplicity<Multiplicity_; dom2++){
+          multiplicity += engine.Count(*dom2, t1, w1, Multiplicity_ - multiplicity);
           log_trace("multiplicity is now %d",multiplicity);
-          if(multiplicity >= Multiplicity_) break; //no need to check for more hits - multiplicty requirement already satisfied
         }
-        if(multiplicity >= Multiplicity_) break; //no need to check for more hits - multiplicty requirement already satisfied
-      }
-      
-      if(multiplicity < Multiplicity_){
-        log_debug("This response doesn't pass the test!");
-	if(isoName_ != ""){
-	  responseClass response=iter.Get();
-	  (*isoOut)[key1].push_back(response);
-	}
-        continue;
-      }
 
-      log_debug("This response passes the test!");
-      
-      //copy particular response from input to output
-      responseClass response=iter.Get();
-      (*output)[key1].push_back(response);
+        if(multiplicity < Multiplicity_){
+          log_debug("This response doesn't pass the test!");
+          if(isoName_ != "") (*isoOut)[key1].push_back(*iter);
+          continue;
+        }
+
+        log_debug("This response passes the test!");
+
+        //copy particular response from input to output
+        (*output)[key1].push_back(*iter);
+      }
     }
     //put the output in the frame
     frame->Put(outputName_,output);
@@ -18,8 +18,7 @@
 #include <dataclasses/I3Map.h>
 #include <dataclasses/geometry/I3Geometry.h>
 #include <icetray/I3Units.h>
-#include <DomTools/I3ResponseIter.h>
-#include <DomTools/I3DistanceMap.h>
+#include <DomTools/I3CoincidenceEngine.h>
 
 template <class responseClass> 
 class I3IsolatedHitsCutModule : public I3ConditionalModule
@@ -51,8 +50,10 @@ class I3IsolatedHitsCutModule : public I3ConditionalModule
   //Width of the Hit object to consider (-1: use GetWidth)
   int UseWidth_;
 
-  ///pointer to a class that remembers distances bewteen OMs
-  boost::shared_ptr <I3DistanceMap> distPtr;
+  ///OMs within RTRadius of each OM, rebuilt when the geometry changes
+  boost::shared_ptr <I3NeighborMap> neighborPtr;
+  ///geometry neighborPtr was built from
+  I3GeometryConstPtr neighborGeo_;
 
   SET_LOGGER("I3IsolatedHitsCutModule");
 
@@ -48,30 +48,31 @@ HiveSplitter_ParameterSet::HiveSplitter_ParameterSet():
 //=============== namespace hivesplitter::details =================
 
 hivesplitter::detail::CausalCluster::CausalCluster():
-  endHit(Hit()),
+  endHit(std::numeric_limits<unsigned int>::max()),
   multiplicityMet(false)
 {};
 
-double hivesplitter::detail::CausalCluster::earliestTime() const{
+double hivesplitter::detail::CausalCluster::earliestTime(const HitSorting::HitSeries &series) const{
   if (!complete.empty() && !hits.empty())
-    return(std::min(complete.begin()->GetTime(),hits.begin()->GetTime()));
+    return(std::min(complete.begin()->GetTime(),series[hits.front()].GetTime()));
   if (!complete.empty())
     return(complete.begin()->GetTime());
   if (!hits.empty())
-    return(hits.begin()->GetTime());
+    return(series[hits.front()].GetTime());
   //else
   return(std::numeric_limits<double>::infinity());
 }
 
-void hivesplitter::detail::CausalCluster::insert(const HitSorting::Hit &h,
+void hivesplitter::detail::CausalCluster::insert(const unsigned int index,
+                                                 const HitSorting::Hit &h,
                                                  const unsigned int multiplicity) {
   ++doms[h.GetDOMIndex()];
-  hits.push_back(h);
+  hits.push_back(index);
   //if the total number of DOMs meets the multiplicity threshold, make note,
   //and also record that this is the last known hit within the cluster contributing
   if (doms.size()>=multiplicity) {
     log_trace_stream("Just met multiplicity"<<multiplicity<<" within a cluster");
-    endHit=h;
+    endHit=index;
     multiplicityMet=true;
   }
 }
@@ -89,7 +90,7 @@ bool hivesplitter::detail::isSubset(const CausalCluster& c1,
   if (c2.hits.size()<c1.hits.size())
     return(false);
   //use the fact that strict timeorder is enforced in the .hits
-  std::list<Hit>::const_iterator it1=c1.hits.begin(), end1=c1.hits.end(), it2=c2.hits.begin(), end2=c2.hits.end();
+  std::deque<unsigned int>::const_iterator it1=c1.hits.begin(), end1=c1.hits.end(), it2=c2.hits.begin(), end2=c2.hits.end();
   for (; it1!=end1 && it2!=end2; ++it1, ++it2) {
     //if the two current items don't match scan though the (potential) superset looking for a match
     while (it2!=end2 && *it2<*it1)
@@ -120,6 +121,7 @@ bool hivesplitter::detail::isSubset(const CausalCluster& c1,
 HiveSplitter::HiveSplitter(const HiveSplitter_ParameterSet& params):
   distanceMap_(OMKeyHash::MAX_SIMPLEINDEX+1), //+1 because index range is [0, MSI]
   vicinityMap_(OMKeyHash::MAX_SIMPLEINDEX+1),
+  series_(NULL),
   params_(params)
 {
   HiveGeometry hivegeo;
@@ -186,11 +188,17 @@ HitSorting::HitSeriesSeries HiveSplitter::Split (const HitSorting::HitSeries &in
   log_debug("Entering Split()");
   HitSorting::HitSeriesSeries outhits_series;
 
+  //the clusters refer to hits by their index in the series
+  series_ = &inhits;
+  connectionStamp_.assign(inhits.size(), 0);
+  connectionCache_.resize(inhits.size());
+
   //feed the hits into the clustering machinery
-  for (HitSorting::HitSeries::const_iterator hit=inhits.begin(); hit!=inhits.end(); ++hit){
-    AddHit(*hit);
+  for (unsigned int index=0; index<inhits.size(); ++index){
+    AddHit(index);
   }
   FinalizeSubEvents();
+  series_ = NULL;
 
   //move the outputs subEvents to the outbox
   for (hivesplitter::detail::HitSetSequence::const_iterator subEvent_iter=subEvents_.begin(); subEvent_iter!=subEvents_.end(); ++subEvent_iter){
@@ -207,7 +215,8 @@ void HiveSplitter::AdvanceClusterInTime(hivesplitter::detail::CausalCluster& clu
                                                   const double time) {
   log_debug("Entering AdvanceClusterInTime");
   while (!cluster.hits.empty()) {
-    const HitSorting::Hit &h=*cluster.hits.begin();
+    const unsigned int index=cluster.hits.front();
+    const HitSorting::Hit &h=(*series_)[index];
     if (time > h.GetTime()+params_.timeWindow) {
       //decrement the number of hits on the DOM where h occurred
       if ((--cluster.doms[h.GetDOMIndex()])<=0)
@@ -221,7 +230,7 @@ void HiveSplitter::AdvanceClusterInTime(hivesplitter::detail::CausalCluster& clu
           cluster.complete.insert(--cluster.complete.end(),h);
         //if h was the last in the multiplicity window,
         //shove the finished cluster back to the trigger for merging
-        if (h==cluster.endHit) {
+        if (index==cluster.endHit) {
           AddSubEvent(cluster.complete);
           cluster.multiplicityMet=false;
           //no need to bother resetting endHit;
@@ -273,8 +282,19 @@ bool HiveSplitter::CausallyConnected(const HitSorting::Hit& h1,
 }
 
 
-void HiveSplitter::AddHit (const HitSorting::Hit& h) {
+bool HiveSplitter::ConnectedToCurrent(const unsigned int index,
+                                      const unsigned int current) {
+  if (connectionStamp_[index]!=current+1) {
+    connectionCache_[index]=CausallyConnected((*series_)[index], (*series_)[current]);
+    connectionStamp_[index]=current+1;
+  }
+  return connectionCache_[index];
+}
+
+
+void HiveSplitter::AddHit (const unsigned int index) {
   log_debug("Entering AddHit()");
+  const HitSorting::Hit& h=(*series_)[index];
   newClusters_.clear();
   bool addedToCluster=false; //keep track of whether h has been added to any cluster
   
@@ -286,7 +306,7 @@ void HiveSplitter::AddHit (const HitSorting::Hit& h) {
     //if the cluster is still active, try to add the Hit to the cluster
     AdvanceClusterInTime(*cluster, h.GetTime());
     if (cluster->isActive()) {
-      addedToCluster |= AddHitToCluster(*cluster, h, params_.multiplicity);
+      addedToCluster |= AddHitToCluster(*cluster, index, params_.multiplicity);
       ++cluster;
     }
     else
@@ -303,7 +323,7 @@ void HiveSplitter::AddHit (const HitSorting::Hit& h) {
       //check whether the new cluster is a subset of the old cluster
       //if the old cluster does not contain h, it cannot be a superset of the new cluster which does,
       //and if the old cluster contains h, it will be the last hit in that cluster
-      if (cluster->hits.back()==h){
+      if (cluster->hits.back()==index){
         if (isSubset(*newCluster,*cluster)) {
           add=false;
           break;
@@ -327,16 +347,17 @@ void HiveSplitter::AddHit (const HitSorting::Hit& h) {
   //if h was not added to any cluster, put it in a cluster by itself
   if (!addedToCluster) {
     clusters_.push_back(hivesplitter::detail::CausalCluster());
-    clusters_.back().insert(h, params_.multiplicity);
+    clusters_.back().insert(index, h, params_.multiplicity);
   }
   log_debug("Leaving AddHit()");
 }
 
 
 bool HiveSplitter::AddHitToCluster (hivesplitter::detail::CausalCluster& c,
-                                              const HitSorting::Hit& h,
+                                              const unsigned int index,
                                               const unsigned int multiplicity) {
   log_debug("Entering AddHitToCluster()");
+  const HitSorting::Hit& h=(*series_)[index];
   //First, find out how many of the DOMs with hits in this cluster are causally connected to h
   //if there are more than multiplicity, h will be added to this cluster
   
@@ -344,9 +365,9 @@ bool HiveSplitter::AddHitToCluster (hivesplitter::detail::CausalCluster& c,
   
   std::set<unsigned int> connectedDOMs;
   bool allConnected=true;
-  for (std::list<HitSorting::Hit>::reverse_iterator it=c.hits.rbegin(), end=c.hits.rend(); it!=end; ++it) {
-    if (CausallyConnected(*it,h))
-      connectedDOMs.insert(it->GetDOMIndex());
+  for (std::deque<unsigned int>::reverse_iterator it=c.hits.rbegin(), end=c.hits.rend(); it!=end; ++it) {
+    if (ConnectedToCurrent(*it, index))
+      connectedDOMs.insert((*series_)[*it].GetDOMIndex());
     else
       allConnected=false;
     
@@ -357,17 +378,17 @@ bool HiveSplitter::AddHitToCluster (hivesplitter::detail::CausalCluster& c,
   
   if (connectedDOMs.size()+1 >=multiplicity || allConnected) {
     log_debug("Adding Hit to custer");
-    c.insert(h, multiplicity); //h is connected to enough hits to belong in this cluster
+    c.insert(index, h, multiplicity); //h is connected to enough hits to belong in this cluster
   }
   else if (connectedDOMs.size()>0) {
     //if h is connected to some of the hits in the cluster, but not enough to be a member,
     //we need to build a new cluster containing only those hits with which it is connected to
     hivesplitter::detail::CausalCluster newSubset;
-    for (std::list<HitSorting::Hit>::iterator it=c.hits.begin(), end=c.hits.end(); it!=end; ++it) {
-      if (CausallyConnected(*it, h))
-        newSubset.insert(*it, params_.multiplicity);
+    for (std::deque<unsigned int>::iterator it=c.hits.begin(), end=c.hits.end(); it!=end; ++it) {
+      if (ConnectedToCurrent(*it, index))
+        newSubset.insert(*it, (*series_)[*it], params_.multiplicity);
     }
-    newSubset.insert(h, params_.multiplicity);
+    newSubset.insert(index, h, params_.multiplicity);
     //we add the new cluster to our list of newly created clusters,
     //but if it is a subset of a cluster we already have we discard it as redundant,
     //and likewise if any of the clusters we have is a subset we discard that one
@@ -411,7 +432,7 @@ void HiveSplitter::AddSubEvent(HitSorting::HitSet& newSet) {
   //find the earliest time of all hits currently percolating through the clusters
   double earliestUpcomingTime = std::numeric_limits<double>::max();
   BOOST_FOREACH(const hivesplitter::detail::CausalCluster &cluster, clusters_)
-    earliestUpcomingTime=std::min(earliestUpcomingTime,cluster.earliestTime());
+    earliestUpcomingTime=std::min(earliestUpcomingTime,cluster.earliestTime(*series_));
   //any subevent whose last hit time is before the earliest time found above
   //cannot be merged again, and so is complete
   if (earliestUpcomingTime!=std::numeric_limits<double>::max()) {
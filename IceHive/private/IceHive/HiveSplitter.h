@@ -14,6 +14,7 @@
 #ifndef HIVESPLITTER_H
 #define HIVESPLITTER_H
 
+#include <deque>
 #include <limits>
 #include <list>
 #include <map>
@@ -63,26 +64,29 @@ namespace hivesplitter { namespace detail {
   ///and the number of distinct DOMs on which those hits occurred
   struct CausalCluster{
   //properties
-    ///The ordered queue of hits within this cluster which are still within the time window of the current time
-    std::list<HitSorting::Hit> hits;
+    ///The ordered queue of hits within this cluster which are still within the time window of the current time;
+    ///hits are referred to by their index in the (time ordered) series that is being split
+    std::deque<unsigned int> hits;
     ///Keeps track of the number of hits on each of the doms present in this cluster, keys are dom indices
     std::map<unsigned int, unsigned int> doms;
     ///The hits which have formed a group surpassing the multiplicity and are now outside the time window
     HitSorting::HitSet complete;
-    ///The most recent hit contributing to meeting the multiplicity condition
-    HitSorting::Hit endHit; //!!!!
+    ///The index of the most recent hit contributing to meeting the multiplicity condition
+    unsigned int endHit;
     ///Whether the multiplicity condition is met
     bool multiplicityMet;
   //methods
     ///constructor
     CausalCluster();
     ///Add a new hit to the cluster
+    ///\param index The index of the hit to add
     ///\param h The hit to add
     ///\param multiplicity The threshold for a group of hits within the time window to form a subevent
-    void insert(const HitSorting::Hit &h, const unsigned int multiplicity);
+    void insert(const unsigned int index, const HitSorting::Hit &h, const unsigned int multiplicity);
     ///Finds the time of the earliest hit in this cluster
+    ///\param series The series of hits the cluster indexes into
     ///\return The earliest hit time or infinity if the cluster is empty
-    double earliestTime() const;
+    double earliestTime(const HitSorting::HitSeries &series) const;
     ///Take all hits in other's complete list and merge them into this cluster's complete list
     ///\param c the cluster to be merged
     void takeComplete(const CausalCluster& c);
@@ -131,6 +135,13 @@ private: //properties
   IceHiveHelpers::SymmetricIndexMatrix_Bool vicinityMap_;
 
   //initialized during runtime
+  ///the (time ordered) series of hits which is currently split
+  const HitSorting::HitSeries* series_;
+  ///memo of CausallyConnected() between a hit in the series_ and the hit currently added:
+  ///connectionStamp_[i] holds the index+1 of the added hit for which connectionCache_[i] was evaluated
+  std::vector<unsigned int> connectionStamp_;
+  ///memo of CausallyConnected(); see connectionStamp_
+  std::vector<char> connectionCache_;
   ///all in-progress causal clusters
   std::list<hivesplitter::detail::CausalCluster> clusters_;
   ///temporary storage for causal clusters generated while adding a single hit
@@ -218,12 +229,20 @@ private: // --- THE REAL MACHINERY ---
     */
   bool CausallyConnected(const HitSorting::Hit& h1, const HitSorting::Hit& h2);
   
+  /** @brief Determine whether a hit in the series is connected to the hit currently added;
+   * every pair is only evaluated once, however many clusters the earlier hit belongs to
+   * @param index the index of the earlier hit in the series
+   * @param current the index of the hit currently added
+   * @return the result of CausallyConnected() for these hits
+   */
+  bool ConnectedToCurrent(const unsigned int index, const unsigned int current);
+  
   /**The main driver for the entire algorithm:
    * Adds a new hit to all clusters with which it is connected (including subsets of existing clusters).
    * By 'advancing' the clusters this function also causes subevents to be built when possible.
-   * @param h the hit to add
+   * @param index the index of the hit to add in the series
    */
-  void AddHit(const HitSorting::Hit &h);
+  void AddHit(const unsigned int index);
   
   /**Move this cluster forward in time to t, dropping hits which are no longer within the time window,
    * the request to merge clusters is accounted for
@@ -235,13 +254,13 @@ private: // --- THE REAL MACHINERY ---
   /** Attempt to add Hit h to existing cluster c, or to the subset of c with which it is connected by enough hits in c
    * to meet the multiplicity condition.
    * @param c the cluster to add to
-   * @param h the hit to add
+   * @param index the index of the hit to add in the series
    * @param multiplicity this multiplicity of connected DOMs minus 1 in the subgroup must be met!
    * @return true, if h was added to c, or to a new subset of c;
    *	       false, if h was not placed in any cluster
    */
   bool AddHitToCluster(hivesplitter::detail::CausalCluster& c,
-                       const HitSorting::Hit& h,
+                       const unsigned int index,
                        const unsigned int multiplicity);
 
   /** Inserts a cluster of hits into the set of subevents, after merging it with any existing subevents
@@ -122,10 +122,13 @@ namespace IceHiveHelpers{
    * @brief a two-dimentional map holding entries of type 'base'
    * 'internal' representation is a linear array of some art,
    * which can be evaluated in any field and typecast to 'base'
+   * The index conversion is resolved at compile time through 'derived' (CRTP),
+   * so that lookups in the hot loops of the splitting/cleaning can be inlined.
    * @tparam base a basic, or complex datatype
    * @tparam internal a vectorized array, which supports operator[]
+   * @tparam derived the implementing class, providing BiIndex_To_UniIndex()
    */
-  template <typename base, class internal>
+  template <typename base, class internal, class derived>
   class IndexMatrix {
   protected: //properties
     ///the size of the indexable range
@@ -137,9 +140,6 @@ namespace IceHiveHelpers{
     IndexMatrix (const unsigned int biSize, const unsigned int mapSize) :
       biSize_(biSize),
       internal_(mapSize) {};
-  private:
-    //forward declaration
-    virtual unsigned int BiIndex_To_UniIndex(const unsigned int indexA, const unsigned int indexB) const = 0;
 
   public:
     /** @brief get the value for field
@@ -147,40 +147,45 @@ namespace IceHiveHelpers{
      * @param indexB and this one
      */
     inline base Get (const unsigned int indexA, const unsigned int indexB) const
-      {return internal_[BiIndex_To_UniIndex(indexA, indexB)];};
+      {return internal_[static_cast<const derived*>(this)->BiIndex_To_UniIndex(indexA, indexB)];};
     /** @brief set the value for field
      * @param indexA this one
      * @param indexB and this one
      * @param value to this value
      */
     inline void Set (const unsigned int indexA, const unsigned int indexB, const base value)
-      {internal_[BiIndex_To_UniIndex(indexA, indexB)]=value;};
+      {internal_[static_cast<const derived*>(this)->BiIndex_To_UniIndex(indexA, indexB)]=value;};
   };
   
   ///dynamic symmetric BiIndexed map; input is anything [0..x][0..x]; all fields are filled
   ///NOTE beware, there is no explicit check if you leave the indexable range, that is your responsibile
   template <typename base, class internal>
-  class AsymmetricIndexMatrix : public IndexMatrix<base, internal> {
+  class AsymmetricIndexMatrix : public IndexMatrix<base, internal, AsymmetricIndexMatrix<base, internal> > {
+    friend class IndexMatrix<base, internal, AsymmetricIndexMatrix<base, internal> >;
+    typedef IndexMatrix<base, internal, AsymmetricIndexMatrix<base, internal> > matrix_base;
   private: // hidden methods
     ///convert from Bi-indexed representation to a linear index
     inline unsigned int BiIndex_To_UniIndex(const unsigned int indexA, const unsigned int indexB) const
-      {return (indexA*IndexMatrix<base, internal>::biSize_)+indexB;};
+      {return (indexA*matrix_base::biSize_)+indexB;};
   public:
     /**allocate enough memory
      * @param biSize that is the range of the biIndex
      */
     AsymmetricIndexMatrix<base, internal>(const int biSize) :
-      IndexMatrix<base, internal>(biSize, biSize*biSize) {};
+      matrix_base(biSize, biSize*biSize) {};
   };
 
   ///dynamic symmetric BiIndexed -map; input is anything [0..x][0..x]; only upper half and diagonal is filled
   ///NOTE beware, there is no explicit check if you leave the indexable range, that is your responsibility
-  template <typename base, class internal> class SymmetricIndexMatrix : public IndexMatrix<base, internal> {
+  template <typename base, class internal>
+  class SymmetricIndexMatrix : public IndexMatrix<base, internal, SymmetricIndexMatrix<base, internal> > {
+    friend class IndexMatrix<base, internal, SymmetricIndexMatrix<base, internal> >;
+    typedef IndexMatrix<base, internal, SymmetricIndexMatrix<base, internal> > matrix_base;
   private: // hidden methods
     ///convert from Bi-indexed representation to a linear index
     inline unsigned int BiIndex_To_UniIndex(const unsigned int indexA, const unsigned int indexB) const {
       if (indexB > indexA)
-        return BiIndex_To_UniIndex(indexB, indexA);
+        return (indexB*indexB+indexB)/2+indexA;
       return (indexA*indexA+indexA)/2+indexB;
     };
   public:
@@ -188,7 +193,7 @@ namespace IceHiveHelpers{
      * @param biSize that is the range of the biIndex
      */
     SymmetricIndexMatrix<base, internal> (const unsigned int biSize) :
-      IndexMatrix<base, internal>(biSize, (biSize*biSize+biSize)/2) {};
+      matrix_base(biSize, (biSize*biSize+biSize)/2) {};
   };
 
   //specialized classes for Bool and Double; watch out for filling the correct default values on init
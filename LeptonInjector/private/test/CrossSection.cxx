@@ -0,0 +1,43 @@
+#include <I3Test.h>
+
+#include <phys-services/I3CrossSection.h>
+#include <phys-services/I3GSLRandomService.h>
+
+#include "tools.h"
+
+TEST_GROUP(CrossSection);
+
+//Evaluating many points at one energy must agree with evaluating them one by
+//one, including the points which are cut or outside the spline
+TEST(1_batch_evaluation){
+	I3CrossSection xs(defaultCrosssectionPath,defaultTotalCrosssectionPath);
+	I3GSLRandomService rng(42);
+	const double logEMin=log10(xs.GetMinimumEnergy()), logEMax=log10(xs.GetMaximumEnergy());
+	const size_t n=2000;
+	
+	for(unsigned int i=1; i<5; i++){
+		const double energy=pow(10.,logEMin+(logEMax-logEMin)*i/5);
+		const double s=pow((xs.GetTargetMass()+energy),2)-pow(energy,2);
+		const double logxyMin=log10(xs.GetQ2Min()/s)-1;
+		std::vector<double> x(n), y(n);
+		for(size_t j=0; j<n; j++){
+			x[j]=pow(10.,rng.Uniform(logxyMin,0));
+			y[j]=pow(10.,rng.Uniform(logxyMin,0));
+		}
+		
+		std::vector<double> batch=xs.evaluateCrossSections(energy,x,y,I3Particle::MuMinus);
+		ENSURE_EQUAL(batch.size(),n);
+		size_t nonzero=0;
+		for(size_t j=0; j<n; j++){
+			const double single=xs.evaluateCrossSection(energy,x[j],y[j],I3Particle::MuMinus);
+			if(single==0){
+				ENSURE_EQUAL(batch[j],0.,"Batch and single evaluation cut the same points");
+				continue;
+			}
+			nonzero++;
+			ENSURE_DISTANCE(batch[j],single,1e-4*single,
+			                "Batch and single evaluation agree");
+		}
+		ENSURE(nonzero>0,"Some points lie within the cross section");
+	}
+}
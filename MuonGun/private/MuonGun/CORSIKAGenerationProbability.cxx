@@ -61,9 +61,17 @@ CORSIKAGenerationProbability::GetLogGenerationProbability(const I3Particle &axis
 	double coszen = cos(axis.GetDir().GetZenith());
 	unsigned m = static_cast<unsigned>(bundlespec.size());
 	double logprob = flux_->GetLog(h, coszen, m);
-	BOOST_FOREACH(const BundleConfiguration::value_type &track, bundlespec)
-		logprob += energyDistribution_->GetLog(h, coszen, m, track.radius,
-		    EnergyDistribution::log_value(std::log(track.energy)));
+	std::vector<double> radius, log_energy, energy_logprob(m);
+	radius.reserve(m);
+	log_energy.reserve(m);
+	BOOST_FOREACH(const BundleConfiguration::value_type &track, bundlespec) {
+		radius.push_back(track.radius);
+		log_energy.push_back(std::log(track.energy));
+	}
+	energyDistribution_->GetLogBatch(h, coszen, m, m, radius.data(),
+	    log_energy.data(), energy_logprob.data());
+	BOOST_FOREACH(double lp, energy_logprob)
+		logprob += lp;
 	
 	return logprob;
 }
@@ -152,11 +152,19 @@ EnergyDependentSurfaceInjector::GetLogGenerationProbability(const I3Particle &ax
 	// We used the flux to do rejection sampling in zenith and multiplicity. Evaluate
 	// the properly-normalized PDF here.
 	double logprob = flux_->GetLog(surface_->GetMinDepth(), coszen, m) - GetZenithNorm();
+	std::vector<double> radius;
+	radius.reserve(m);
 	BOOST_FOREACH(const BundleEntry &track, bundlespec) {
-		if (m > 1)
-			logprob += radialDistribution_->GetLog(h, coszen, m, track.radius);
+		radius.push_back(track.radius);
 		logprob += energyGenerator_->GetLog(track.energy);
 	}
+	if (m > 1) {
+		std::vector<double> radial_logprob(m);
+		radialDistribution_->GetLogBatch(h, coszen, m, m, radius.data(),
+		    radial_logprob.data());
+		BOOST_FOREACH(double lp, radial_logprob)
+			logprob += lp;
+	}
 	
 	// We only distributed events over the target surface, not the entire injection surface
 	return logprob - std::log(surface->GetAcceptance());
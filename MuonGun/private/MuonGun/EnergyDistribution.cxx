@@ -24,6 +24,14 @@ EnergyDistribution::operator()(double d, double ct,
 	return std::exp(GetLog(d, ct, m, r, log_value(std::log(e))));
 }
 
+void
+EnergyDistribution::GetLogBatch(double d, double ct, unsigned m, size_t n,
+    const double *r, const double *loge, double *logprob) const
+{
+	for (size_t i=0; i < n; i++)
+		logprob[i] = GetLog(d, ct, m, r[i], log_value(loge[i]));
+}
+
 double
 EnergyDistribution::Integrate(double d, double ct, 
     unsigned m, double r_min, double r_max, double e_min, double e_max) const
@@ -107,6 +115,42 @@ SplineEnergyDistribution::GetLog(double depth, double cos_theta,
 	return logprob;
 }
 
+void
+SplineEnergyDistribution::GetLogBatch(double depth, double cos_theta,
+    unsigned multiplicity, size_t n, const double *radius,
+    const double *log_energy, double *logprob) const
+{
+	if (multiplicity < 2) {
+		EnergyDistribution::GetLogBatch(depth, cos_theta, multiplicity,
+		    n, radius, log_energy, logprob);
+		return;
+	}
+	
+	// Gather the muons inside the domain, and evaluate them all at once
+	// at the common depth, zenith angle, and multiplicity
+	const double fixed[3] = {cos_theta, depth, static_cast<double>(multiplicity)};
+	std::vector<double> coords;
+	std::vector<size_t> index;
+	coords.reserve(2*n);
+	index.reserve(n);
+	for (size_t i=0; i < n; i++) {
+		logprob[i] = -std::numeric_limits<double>::infinity();
+		if (radius[i] < 0 || radius[i] > GetMaxRadius() ||
+		    log_energy[i] < minLog_ || log_energy[i] > maxLog_)
+			continue;
+		coords.push_back(radius[i]);
+		coords.push_back(log_energy[i]);
+		index.push_back(i);
+	}
+	std::vector<double> values(index.size());
+	bundles_.EvalBatch(fixed, 3, index.size(), coords.data(), values.data());
+	
+	// Bundle spline is fit to log(dP/dr^2 dlogE)
+	for (size_t j=0; j < index.size(); j++)
+		if (!std::isnan(values[j]))
+			logprob[index[j]] = values[j] + std::log(2*radius[index[j]]);
+}
+
 std::vector<std::pair<double,double> >
 SplineEnergyDistribution::Generate(I3RandomService &rng, double depth,
     double cos_theta, unsigned multiplicity, unsigned nsamples) const
@@ -48,6 +48,8 @@ NaturalRateInjector::serialize(Archive &ar, unsigned version)
 	ar & make_nvp("Flux", flux_);
 	ar & make_nvp("EnergyRadiusDistribution", energyDistribution_);
 	ar & make_nvp("TotalRate", totalRate_);
+	if (Archive::is_loading::value)
+		CalculateTotalRate();
 }
 
 NaturalRateInjector::NaturalRateInjector()
@@ -93,7 +95,7 @@ NaturalRateInjector::SetSurface(SamplingSurfacePtr p)
 {
 	assert(p);
 	surface_ = p;
-	totalRate_ = NAN;
+	CalculateTotalRate();
 }
 
 void
@@ -101,7 +103,7 @@ NaturalRateInjector::SetFlux(FluxPtr p)
 {
 	assert(p);
 	flux_ = p;
-	totalRate_ = NAN;
+	CalculateTotalRate();
 }
 
 void
@@ -118,15 +120,24 @@ NaturalRateInjector::SetEnergyDistribution(EnergyDistributionPtr e)
 }
 
 
+void
+NaturalRateInjector::CalculateTotalRate()
+{
+	// Filled here rather than on first use, so that weights may be
+	// calculated from several threads at once
+	totalRate_ = NAN;
+	if (!(surface_ && flux_))
+		return;
+	
+	totalRate_ = 0;
+	for (unsigned m = flux_->GetMinMultiplicity(); m <= flux_->GetMaxMultiplicity(); m++) {
+		totalRate_ += surface_->IntegrateFlux(boost::bind(boost::cref(*flux_), _1, _2, m));
+	}
+}
+
 double
 NaturalRateInjector::GetTotalRate() const
 {
-	if (std::isnan(totalRate_) && surface_ && flux_) {
-		totalRate_ = 0;
-		for (unsigned m = flux_->GetMinMultiplicity(); m <= flux_->GetMaxMultiplicity(); m++) {
-			totalRate_ += surface_->IntegrateFlux(boost::bind(boost::cref(*flux_), _1, _2, m));
-		}
-	}
 	return totalRate_;
 }
 
@@ -204,10 +215,17 @@ NaturalRateInjector::GetLogGenerationProbability(const I3Particle &axis,
 	// We used the flux to do rejection sampling in depth, zenith, and
 	// multiplicity. Evaluate the properly-normalized PDF here.
 	double logprob = flux_->GetLog(h, coszen, m) - std::log(GetTotalRate());
+	std::vector<double> radius, log_energy, energy_logprob(m);
+	radius.reserve(m);
+	log_energy.reserve(m);
 	BOOST_FOREACH(const BundleEntry &track, bundlespec) {
-		logprob += energyDistribution_->GetLog(h, coszen, m, track.radius,
-		    EnergyDistribution::log_value(std::log(track.energy)));
+		radius.push_back(track.radius);
+		log_energy.push_back(std::log(track.energy));
 	}
+	energyDistribution_->GetLogBatch(h, coszen, m, m, radius.data(),
+	    log_energy.data(), energy_logprob.data());
+	BOOST_FOREACH(double lp, energy_logprob)
+		logprob += lp;
 	
 	return logprob;
 }
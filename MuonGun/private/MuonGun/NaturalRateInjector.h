@@ -55,13 +55,16 @@ public:
 	
 	/**
 	 * Integrate the configured flux over the sampling surface, summing over
-	 * all allowed multiplicities.
+	 * all allowed multiplicities. The integral is taken when the surface or
+	 * flux is set.
 	 *
 	 * @returns a rate in units of @f$ [s^{-1}] @f$
 	 */
 	double GetTotalRate() const;
 
 protected:
+	void CalculateTotalRate();
+
 	/**
 	 * Draw a sample from the distribution of shower impact points
 	 *
@@ -84,7 +87,7 @@ protected:
 	FluxPtr flux_;
 	EnergyDistributionPtr energyDistribution_;
 	
-	mutable double totalRate_;
+	double totalRate_;
 
 };
 
@@ -24,6 +24,14 @@ RadialDistribution::operator()(double depth, double cos_theta,
 		return std::exp(GetLog(depth, cos_theta, N, radius));
 }
 
+void
+RadialDistribution::GetLogBatch(double depth, double cos_theta,
+    unsigned N, size_t n, const double *radius, double *logprob) const
+{
+	for (size_t i=0; i < n; i++)
+		logprob[i] = GetLog(depth, cos_theta, N, radius[i]);
+}
+
 BMSSRadialDistribution::BMSSRadialDistribution() : rho0a_(-1.786), rho0b_(28.26),
     rho1_(-1.06), theta0_(1.3), f_(10.4), alpha0a_(-0.448), alpha0b_(4.969),
     alpha1a_(0.0194), alpha1b_(0.276), rmax_(250*I3Units::m) {};
@@ -114,6 +122,21 @@ SplineRadialDistribution::GetLog(double depth, double cos_theta,
 		return std::log(2*radius) + logprob;
 }
 
+void
+SplineRadialDistribution::GetLogBatch(double depth, double cos_theta,
+    unsigned N, size_t n, const double *radius, double *logprob) const
+{
+	const double fixed[3] = {cos_theta, depth, static_cast<double>(N)};
+	spline_.EvalBatch(fixed, 3, n, radius, logprob);
+	for (size_t i=0; i < n; i++) {
+		if (std::isnan(logprob[i]))
+			logprob[i] = -std::numeric_limits<double>::infinity();
+		else
+			// Spline is fit to log(dP/dr^2)
+			logprob[i] += std::log(2*radius[i]);
+	}
+}
+
 double
 SplineRadialDistribution::Generate(I3RandomService &rng, double depth,
     double cos_theta, unsigned N) const
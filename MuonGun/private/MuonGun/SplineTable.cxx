@@ -1,5 +1,9 @@
+#include <algorithm>
 #include <cerrno>
+#include <cmath>
+#include <limits>
 #include <stdexcept>
+#include <vector>
 #include <MuonGun/SplineTable.h>
 #include <icetray/I3Logging.h>
 #include <serialization/binary_object.hpp>
@@ -10,6 +14,43 @@ extern "C" {
 
 namespace I3MuonGun {
 
+namespace {
+
+// The same search as tablesearchcenters(), for a single dimension
+int
+searchcenter(const struct splinetable &table, int dim, double x, int &center)
+{
+	const double *knots = table.knots[dim];
+	const int order = table.order[dim];
+	
+	if (x <= knots[0] || x > knots[table.nknots[dim]-1])
+		return -1;
+	
+	if (x < knots[order]) {
+		center = order;
+		return 0;
+	} else if (x >= knots[table.naxes[dim]]) {
+		center = int(table.naxes[dim])-1;
+		return 0;
+	}
+	
+	int min = order, max = int(table.nknots[dim])-2;
+	do {
+		center = (max+min)/2;
+		if (x < knots[center])
+			max = center-1;
+		else
+			min = center+1;
+	} while (x < knots[center] || x >= knots[center+1]);
+	
+	if (center == table.naxes[dim])
+		center--;
+	
+	return 0;
+}
+
+}
+
 SplineTable::SplineTable() : bias_(0)
 {
   memset(&table_, 0, sizeof(struct splinetable));
@@ -74,6 +115,101 @@ SplineTable::Eval(double *coordinates, double *result) const
 	return 0;
 }
 
+int
+SplineTable::EvalBatch(const double *fixed, unsigned nfixed, size_t n,
+    const double *points, double *results) const
+{
+	const unsigned ndim = GetNDim();
+	if (nfixed > ndim)
+		throw std::out_of_range("More fixed coordinates than dimensions");
+	const unsigned nfree = ndim-nfixed;
+	
+	int maxdegree = 0;
+	for (unsigned i=0; i < ndim; i++)
+		maxdegree = std::max(maxdegree, table_.order[i]+1);
+	std::vector<int> centers(ndim);
+	std::vector<float> localbasis(ndim*maxdegree);
+	
+	// Flatten the tensor product over the fixed dimensions into a list of
+	// (weight, offset) pairs
+	std::vector<std::pair<double, size_t> > terms(1, std::make_pair(1., size_t(0)));
+	for (unsigned i=0; i < nfixed; i++) {
+		if (searchcenter(table_, i, fixed[i], centers[i]) != 0) {
+			std::fill(results, results+n, std::numeric_limits<double>::quiet_NaN());
+			return EINVAL;
+		}
+		float *basis = &localbasis[i*maxdegree];
+		bsplvb_simple(table_.knots[i], table_.nknots[i], fixed[i],
+		    centers[i], table_.order[i]+1, basis);
+		std::vector<std::pair<double, size_t> > product;
+		product.reserve(terms.size()*(table_.order[i]+1));
+		for (const auto &term : terms)
+			for (int j=0; j <= table_.order[i]; j++)
+				product.push_back(std::make_pair(term.first*basis[j],
+				    term.second + (centers[i]-table_.order[i]+j)*table_.strides[i]));
+		terms.swap(product);
+	}
+	
+	// Coefficients of the free dimensions, summed over the fixed ones
+	std::vector<size_t> cellstride(nfree+1, 1);
+	for (unsigned d=nfree; d > 0; d--)
+		cellstride[d-1] = cellstride[d]*table_.naxes[nfixed+d-1];
+	std::vector<double> reduced(cellstride[0]);
+	std::vector<char> known(cellstride[0], 0);
+	
+	int status = 0;
+	std::vector<int> k(nfree);
+	for (size_t p=0; p < n; p++) {
+		const double *x = points + p*nfree;
+		bool inside = true;
+		for (unsigned d=0; d < nfree && inside; d++) {
+			const unsigned i = nfixed+d;
+			if (searchcenter(table_, i, x[d], centers[i]) != 0)
+				inside = false;
+			else
+				bsplvb_simple(table_.knots[i], table_.nknots[i], x[d],
+				    centers[i], table_.order[i]+1, &localbasis[i*maxdegree]);
+		}
+		if (!inside) {
+			results[p] = std::numeric_limits<double>::quiet_NaN();
+			status = EINVAL;
+			continue;
+		}
+		
+		double result = 0;
+		std::fill(k.begin(), k.end(), 0);
+		while (true) {
+			size_t cell = 0, offset = 0;
+			double weight = 1;
+			for (unsigned d=0; d < nfree; d++) {
+				const unsigned i = nfixed+d;
+				const size_t pos = centers[i]-table_.order[i]+k[d];
+				cell += pos*cellstride[d+1];
+				offset += pos*table_.strides[i];
+				weight *= localbasis[i*maxdegree+k[d]];
+			}
+			if (!known[cell]) {
+				double coefficient = 0;
+				for (const auto &term : terms)
+					coefficient += term.first*table_.coefficients[term.second+offset];
+				reduced[cell] = coefficient;
+				known[cell] = 1;
+			}
+			result += weight*reduced[cell];
+			
+			// Advance to the next basis function of the free dimensions
+			int d = int(nfree)-1;
+			while (d >= 0 && ++k[d] > table_.order[nfixed+d])
+				k[d--] = 0;
+			if (d < 0)
+				break;
+		}
+		results[p] = result - bias_;
+	}
+	
+	return status;
+}
+
 std::pair<double, double>
 SplineTable::GetExtents(int dim) const
 {
@@ -40,6 +40,31 @@ public:
 	 */
 	int Eval(double *x, double *result) const;
 
+	/**
+	 * @brief Evaluate the spline surface at many points that share
+	 *        their leading coordinates
+	 *
+	 * The basis functions of the leading (fixed) dimensions are
+	 * calculated only once, and the coefficients are summed over them
+	 * only once for every knot cell of the remaining dimensions that is
+	 * actually visited. This is much cheaper than repeated calls to Eval()
+	 * when e.g. all muons of a bundle are evaluated at the same depth,
+	 * zenith angle and multiplicity. The result is the same as that of
+	 * Eval() up to single-precision rounding. Intended for tables with
+	 * few free dimensions, as the cache spans their full coefficient grid.
+	 *
+	 * @param[in]  fixed   The first nfixed coordinates, shared by all points
+	 * @param[in]  nfixed  The number of shared coordinates
+	 * @param[in]  n       The number of points
+	 * @param[in]  points  The remaining GetNDim()-nfixed coordinates of
+	 *                     each point, point by point
+	 * @param[out] results Where to store the n results. Points outside
+	 *                     the table are set to NaN.
+	 * @returns 0 if all points were inside the table
+	 */
+	int EvalBatch(const double *fixed, unsigned nfixed, size_t n,
+	    const double *points, double *results) const;
+
 	/** @brief Return the number of dimensions of the spline surface */
 	unsigned GetNDim() const { return unsigned(table_.ndim); };
 	
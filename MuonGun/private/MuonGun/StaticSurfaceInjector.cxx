@@ -55,6 +55,8 @@ StaticSurfaceInjector::serialize(Archive &ar, unsigned version)
 	ar & make_nvp("RadialDistribution", radialDistribution_);
 	ar & make_nvp("MaxFlux", maxFlux_);
 	ar & make_nvp("TotalRate", totalRate_);
+	if (Archive::is_loading::value)
+		CalculateNormalization();
 }
 
 StaticSurfaceInjector::StaticSurfaceInjector()
@@ -105,18 +107,16 @@ void
 StaticSurfaceInjector::SetSurface(SamplingSurfacePtr p)
 {
 	surface_ = p;
-	totalRate_ = NAN;
-	zenithNorm_ = NAN;
 	CalculateMaxFlux();
+	CalculateNormalization();
 }
 
 void
 StaticSurfaceInjector::SetFlux(FluxPtr p)
 {
 	flux_ = p;
-	totalRate_ = NAN;
-	zenithNorm_ = NAN;
 	CalculateMaxFlux();
+	CalculateNormalization();
 }
 
 void
@@ -126,28 +126,34 @@ StaticSurfaceInjector::CalculateMaxFlux()
 		maxFlux_ = (*flux_)(surface_->GetMinDepth(), 1., 1u)*surface_->GetMaximumArea();
 }
 
+void
+StaticSurfaceInjector::CalculateNormalization()
+{
+	// Filled here rather than on first use, so that weights may be
+	// calculated from several threads at once
+	totalRate_ = NAN;
+	zenithNorm_ = NAN;
+	if (!(surface_ && flux_))
+		return;
+	
+	totalRate_ = 0;
+	zenithNorm_ = 0;
+	for (unsigned m = flux_->GetMinMultiplicity(); m <= flux_->GetMaxMultiplicity(); m++) {
+		totalRate_ += surface_->IntegrateFlux(boost::bind(boost::cref(*flux_), _1, _2, m));
+		zenithNorm_ += Integrate(boost::bind(boost::cref(*flux_), surface_->GetMinDepth(), _1, m), 0, 1);
+	}
+	zenithNorm_ = std::log(zenithNorm_);
+}
+
 double
 StaticSurfaceInjector::GetTotalRate() const
 {
-	if (std::isnan(totalRate_) && surface_ && flux_) {
-		totalRate_ = 0;
-		for (unsigned m = flux_->GetMinMultiplicity(); m <= flux_->GetMaxMultiplicity(); m++) {
-			totalRate_ += surface_->IntegrateFlux(boost::bind(boost::cref(*flux_), _1, _2, m));
-		}
-	}
 	return totalRate_;
 }
 
 double
 StaticSurfaceInjector::GetZenithNorm() const
 {
-	if (std::isnan(zenithNorm_) && surface_ && flux_) {
-		zenithNorm_ = 0;
-		for (unsigned m = flux_->GetMinMultiplicity(); m <= flux_->GetMaxMultiplicity(); m++) {
-			zenithNorm_ += Integrate(boost::bind(boost::cref(*flux_), surface_->GetMinDepth(), _1, m), 0, 1);
-		}
-		zenithNorm_ = std::log(zenithNorm_);
-	}
 	return zenithNorm_;
 }
 
@@ -230,11 +236,19 @@ StaticSurfaceInjector::GetLogGenerationProbability(const I3Particle &axis,
 	// We used the flux to do rejection sampling in zenith and multiplicity. Evaluate
 	// the properly-normalized PDF here.
 	double logprob = flux_->GetLog(surface_->GetMinDepth(), coszen, m) - GetZenithNorm();
+	std::vector<double> radius;
+	radius.reserve(m);
 	BOOST_FOREACH(const BundleEntry &track, bundlespec) {
-		if (m > 1)
-			logprob += radialDistribution_->GetLog(h, coszen, m, track.radius);
+		radius.push_back(track.radius);
 		logprob += energyGenerator_->GetLog(track.energy);
 	}
+	if (m > 1) {
+		std::vector<double> radial_logprob(m);
+		radialDistribution_->GetLogBatch(h, coszen, m, m, radius.data(),
+		    radial_logprob.data());
+		BOOST_FOREACH(double lp, radial_logprob)
+			logprob += lp;
+	}
 	
 	return logprob - std::log(surface_->GetAcceptance());
 }
@@ -57,7 +57,8 @@ public:
 	
 	/**
 	 * Integrate the configured flux over the sampling surface, summing over
-	 * all allowed multiplicities.
+	 * all allowed multiplicities. The integral is taken when the surface or
+	 * flux is set.
 	 *
 	 * @returns a rate in units of @f$ [s^{-1}] @f$
 	 */
@@ -77,6 +78,11 @@ protected:
 	void FillMCTree(I3RandomService &rng, const std::pair<I3Particle, unsigned> &axis, I3MCTree &, BundleConfiguration &) const;
 	
 	void CalculateMaxFlux();
+	/**
+	 * Calculate the total rate and the zenith normalization. This has to
+	 * be done again whenever the surface or flux changes.
+	 */
+	void CalculateNormalization();
 	
 	/**
 	 * Get the normalization term for relative weighting of zenith
@@ -98,7 +104,7 @@ protected:
 	RadialDistributionPtr radialDistribution_;
 	
 	double maxFlux_;
-	mutable double totalRate_, zenithNorm_;
+	double totalRate_, zenithNorm_;
 
 };
 
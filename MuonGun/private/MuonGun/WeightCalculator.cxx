@@ -24,11 +24,28 @@
 #include <phys-services/I3Calculator.h>
 #include <boost/make_shared.hpp>
 #include <boost/numeric/ublas/vector.hpp>
+#include <boost/thread.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
 
 namespace I3MuonGun {
 
 double
 WeightCalculator::GetWeight(const I3Particle &axis, const BundleConfiguration &bundlespec) const
+{
+	bool nonfinite = false;
+	double weight = GetFlaggedWeight(axis, bundlespec, nonfinite);
+	if (nonfinite)
+		log_warn("Log Energy weight of a least one muon is -inf, weight will be 0!");
+	
+	return weight;
+}
+
+double
+WeightCalculator::GetFlaggedWeight(const I3Particle &axis,
+    const BundleConfiguration &bundlespec, bool &nonfinite) const
 {
 	std::pair<double, double> steps = surface_->GetIntersection(axis.GetPos(), axis.GetDir());
 	// This shower axis doesn't intersect the sampling surface. Bail.
@@ -41,18 +58,84 @@ WeightCalculator::GetWeight(const I3Particle &axis, const BundleConfiguration &b
 	
 	double rate = flux_->GetLog(h, coszen, m) - generator_->GetLogGeneratedEvents(axis, bundlespec);
 	
-	BOOST_FOREACH(const BundleEntry &track, bundlespec){
-		double logprob = energy_->GetLog(h, coszen, m, track.radius,
-		    EnergyDistribution::log_value(std::log(track.energy)));
-		if (!std::isfinite(logprob)){
-                    log_warn("Log Energy weight of a least one muon is -inf, weight will be 0!");
-                }
-		rate += logprob;
-        }
+	// Evaluate the energy distribution for all muons of the bundle at once
+	std::vector<double> radius, log_energy, logprob(m);
+	radius.reserve(m);
+	log_energy.reserve(m);
+	BOOST_FOREACH(const BundleEntry &track, bundlespec) {
+		radius.push_back(track.radius);
+		log_energy.push_back(std::log(track.energy));
+	}
+	energy_->GetLogBatch(h, coszen, m, m, radius.data(), log_energy.data(), logprob.data());
+	BOOST_FOREACH(double lp, logprob) {
+		if (!std::isfinite(lp))
+			nonfinite = true;
+		rate += lp;
+	}
 	// assert(std::isfinite(std::exp(rate)));
 	return std::exp(rate);
 }
 
+std::vector<double>
+WeightCalculator::GetWeights(const std::vector<I3Particle> &axes,
+    const std::vector<BundleConfiguration> &bundles, unsigned nthreads) const
+{
+	if (axes.size() != bundles.size())
+		log_fatal("Got %zu bundle axes, but %zu bundle configurations",
+		    axes.size(), bundles.size());
+	
+	const size_t n = axes.size();
+	std::vector<double> weights(n);
+	// Flag events with a non-finite energy weight instead of warning
+	// from the workers, which may run without the Python GIL. The calling
+	// thread warns once at the end.
+	std::vector<char> nonfinite(n, false);
+	if (nthreads == 0)
+		nthreads = std::max(1u, boost::thread::hardware_concurrency());
+	nthreads = unsigned(std::min(size_t(nthreads), n));
+	if (nthreads < 2) {
+		for (size_t i=0; i < n; i++) {
+			bool flag = false;
+			weights[i] = GetFlaggedWeight(axes[i], bundles[i], flag);
+			nonfinite[i] = flag;
+		}
+	} else {
+		// The flux model and the generator are only read, so the threads
+		// can share them. Events are handed out one at a time, as the cost
+		// grows with the multiplicity.
+		std::atomic<size_t> next(0);
+		std::exception_ptr error;
+		boost::mutex error_mutex;
+		boost::thread_group threads;
+		for (unsigned t=0; t < nthreads; t++) {
+			threads.create_thread([&]() {
+				try {
+					for (size_t i = next++; i < n; i = next++) {
+						bool flag = false;
+						weights[i] = GetFlaggedWeight(axes[i], bundles[i], flag);
+						nonfinite[i] = flag;
+					}
+				} catch (...) {
+					boost::mutex::scoped_lock lock(error_mutex);
+					if (!error)
+						error = std::current_exception();
+					next = n;
+				}
+			});
+		}
+		threads.join_all();
+		if (error)
+			std::rethrow_exception(error);
+	}
+	
+	size_t nbad = std::count(nonfinite.begin(), nonfinite.end(), true);
+	if (nbad > 0)
+		log_warn("Log Energy weight of a least one muon is -inf in %zu of %zu "
+		    "events, their weights will be 0!", nbad, n);
+	
+	return weights;
+}
+
 // Possibly throw-away utility function: "track" muons to a fixed surface using the
 // same method as WeightCalculatorModule
 std::vector<I3Particle>
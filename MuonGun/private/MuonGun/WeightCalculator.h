@@ -65,12 +65,31 @@ public:
 	 * @returns a weight in units of @f$ [s^{-1}] @f$
 	 */
 	double GetWeight(const I3Particle &axis, const BundleConfiguration &bundle) const;
+	
+	/**
+	 * Calculate weights for a whole table of events, e.g. read back
+	 * from a MuonBundleConverter table. The events are distributed over
+	 * several threads; the result does not depend on their number.
+	 *
+	 * @param[in] axes     The bundle axis of each event
+	 * @param[in] bundles  The radial offset and energy of each muon
+	 *                     in each event
+	 * @param[in] nthreads The number of threads to use. 0 means one
+	 *                     per hardware thread.
+	 * @returns a weight in units of @f$ [s^{-1}] @f$ for each event
+	 */
+	std::vector<double> GetWeights(const std::vector<I3Particle> &axes,
+	    const std::vector<BundleConfiguration> &bundles, unsigned nthreads=1) const;
 	 
 	SamplingSurfaceConstPtr GetSurface() { return surface_; }
 	void SetSurface(SamplingSurfacePtr s) { surface_ = s; }
 
 protected:
 	WeightCalculator() {}
+	/** Like GetWeight(), but flag non-finite energy weights instead of warning */
+	double GetFlaggedWeight(const I3Particle &axis, const BundleConfiguration &bundle,
+	    bool &nonfinite) const;
+	
 	SamplingSurfaceConstPtr surface_;
 	FluxConstPtr flux_;
 	RadialDistributionConstPtr radius_;
@@ -0,0 +1,117 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+
+#include <boost/make_shared.hpp>
+#include <boost/thread.hpp>
+
+#include <MuonGun/WeightCalculator.h>
+#include <MuonGun/StaticSurfaceInjector.h>
+#include <MuonGun/Flux.h>
+#include <MuonGun/RadialDistribution.h>
+#include <MuonGun/EnergyDistribution.h>
+#include <MuonGun/Cylinder.h>
+#include <phys-services/I3GSLRandomService.h>
+
+using namespace I3MuonGun;
+
+// Measures the throughput of WeightCalculator on random muon bundles,
+// event by event with GetWeight() and with GetWeights() on an increasing
+// number of threads, using the spline tables of a model in
+// $I3_BUILD/MuonGun/resources/tables (eg. GaisserH4a_atmod12_SIBYLL).
+
+namespace {
+
+double
+seconds_since(const std::chrono::steady_clock::time_point &start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main(int argc,char** argv)
+{
+  const char *I3_BUILD = getenv("I3_BUILD");
+  if(!I3_BUILD)
+    {
+      std::cerr << "I3_BUILD is not set" << std::endl;
+      return(1);
+    }
+
+  std::string base = argc > 1 ? argv[1] : "GaisserH4a_atmod12_SIBYLL";
+  size_t nevents = argc > 2 ? atoi(argv[2]) : 10000;
+  unsigned passes = argc > 3 ? atoi(argv[3]) : 5;
+  if(nevents == 0 || passes == 0)
+    {
+      std::cerr << "usage: " << argv[0]
+                << " [model] [events] [passes]" << std::endl;
+      return(1);
+    }
+
+  std::string tabledir = std::string(I3_BUILD) + "/MuonGun/resources/tables/";
+  BundleModel model(
+      boost::make_shared<SplineFlux>(tabledir + base + ".single_flux.fits",
+                                     tabledir + base + ".bundle_flux.fits"),
+      boost::make_shared<SplineRadialDistribution>(tabledir + base + ".radius.fits"),
+      boost::make_shared<SplineEnergyDistribution>(tabledir + base + ".single_energy.fits",
+                                                   tabledir + base + ".bundle_energy.fits"));
+  boost::shared_ptr<StaticSurfaceInjector> generator =
+    boost::make_shared<StaticSurfaceInjector>(boost::make_shared<Cylinder>(1600, 800),
+        model.flux, boost::make_shared<OffsetPowerLaw>(2, 500, 10, 1e5), model.radius);
+  WeightCalculator weighter(model, generator);
+
+  // random bundles, all of which hit the cylinder
+  I3GSLRandomService rng(1);
+  std::vector<I3Particle> axes(nevents);
+  std::vector<BundleConfiguration> bundles(nevents);
+  size_t nmuons = 0;
+  for(size_t i = 0 ; i < nevents ; i++)
+    {
+      axes[i].SetPos(rng.Uniform(-500, 500), rng.Uniform(-500, 500), 900);
+      axes[i].SetDir(std::acos(rng.Uniform(0.1, 1)), rng.Uniform(0, 2*M_PI));
+      const unsigned m = 1 + unsigned(rng.Uniform(0, 30));
+      for(unsigned j = 0 ; j < m ; j++)
+        bundles[i].push_back(BundleEntry(m > 1 ? rng.Uniform(0, 100) : 0,
+            std::exp(rng.Uniform(std::log(10), std::log(1e5)))));
+      nmuons += m;
+    }
+  std::cout << "Weighting " << passes << " x " << nevents << " events ("
+            << nmuons << " muons each pass) with " << base << std::endl;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  double sum = 0;
+  for(unsigned pass = 0 ; pass < passes ; pass++)
+    for(size_t i = 0 ; i < nevents ; i++)
+      sum += weighter.GetWeight(axes[i], bundles[i]);
+  double seconds = seconds_since(start);
+  std::cout << "  GetWeight:              " << seconds << " s, "
+            << passes * nevents / seconds << " events/s" << std::endl;
+
+  unsigned maxthreads = std::max(1u, boost::thread::hardware_concurrency());
+  for(unsigned nthreads = 1 ; nthreads <= maxthreads ; nthreads *= 2)
+    {
+      start = std::chrono::steady_clock::now();
+      double threadsum = 0;
+      for(unsigned pass = 0 ; pass < passes ; pass++)
+        {
+          std::vector<double> weights = weighter.GetWeights(axes, bundles, nthreads);
+          for(size_t i = 0 ; i < nevents ; i++)
+            threadsum += weights[i];
+        }
+      seconds = seconds_since(start);
+      std::cout << "  GetWeights, " << nthreads << " threads:"
+                << std::string(nthreads < 10 ? 2 : 1, ' ') << seconds << " s, "
+                << passes * nevents / seconds << " events/s" << std::endl;
+      if(!(threadsum == sum || (std::isnan(threadsum) && std::isnan(sum))))
+        {
+          std::cerr << "GetWeights disagrees with GetWeight: "
+                    << threadsum << " != " << sum << std::endl;
+          return(1);
+        }
+    }
+
+  return(0);
+}
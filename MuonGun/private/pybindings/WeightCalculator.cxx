@@ -43,13 +43,22 @@ get(const BOOST_NUMPY::ndarray &a, int i0, int i1)
 	return *reinterpret_cast<T*>(a.get_data() + i0*a.strides(0) + i1*a.strides(1));
 }
 
+class ScopedGILRelease {
+public:
+	ScopedGILRelease() : state_(PyEval_SaveThread()) {}
+	~ScopedGILRelease() { PyEval_RestoreThread(state_); }
+private:
+	PyThreadState *state_;
+};
+
 }
 
 // An adapter function to use the standard WeightCalculator with Numpy arrays,
 // most likely from tableio/hdfwriter
 object
 GetWeight(const WeightCalculator& weighter, object &xo, object &yo, object &zo,
-    object &zeno, object &azio, object &mo, object &eno, object &rado)
+    object &zeno, object &azio, object &mo, object &eno, object &rado,
+    unsigned nthreads)
 {
 	using namespace BOOST_NUMPY;
 	
@@ -83,20 +92,31 @@ GetWeight(const WeightCalculator& weighter, object &xo, object &yo, object &zo,
 	    throw(std::runtime_error("shape mismatch!"));
 	
 	ndarray weights = zeros(x.get_nd(), x.get_shape(), dtype::get_builtin<double>());	
-	I3Particle axis;
+	std::vector<I3Particle> axes(nrows);
+	std::vector<BundleConfiguration> specs(nrows);
 	for (int i=0; i < nrows; i++) {
 		
 		int m = get<uint32_t>(mult, i);
-		BundleConfiguration spec;
+		BundleConfiguration &spec = specs[i];
 		for (int j=0; j < std::min(ncols, m); j++) {
 			spec.push_back(BundleEntry(
 			    get<float>(radii, i, j), get<float>(energies, i, j)));
 		}
-		axis.SetPos(get<double>(x, i), get<double>(y, i), get<double>(z, i));
-		axis.SetDir(get<double>(zen, i), get<double>(azi, i));
-		
-		reinterpret_cast<double*>(weights.get_data())[i] = weighter.GetWeight(axis, spec);
+		axes[i].SetPos(get<double>(x, i), get<double>(y, i), get<double>(z, i));
+		axes[i].SetDir(get<double>(zen, i), get<double>(azi, i));
+	}
+	
+	std::vector<double> result;
+	if (nthreads == 1) {
+		result = weighter.GetWeights(axes, specs, nthreads);
+	} else {
+		// Worker threads can't call back into Python, so this only works
+		// for models and generators implemented in C++
+		ScopedGILRelease gil;
+		result = weighter.GetWeights(axes, specs, nthreads);
 	}
+	std::copy(result.begin(), result.end(),
+	    reinterpret_cast<double*>(weights.get_data()));
 	
 	return weights.scalarize();
 }
@@ -119,7 +139,10 @@ void register_WeightCalculator()
 	    .def("__call__", &WeightCalculator::GetWeight)
 #ifdef USE_NUMPY
 	    .def("__call__", &GetWeight, (bp::arg("x"), "y", "z", "zenith", "azimuth",
-	        "multiplicity", "energies", "radii"))
+	        "multiplicity", "energies", "radii", bp::arg("nthreads")=1),
+	        "Calculate weights for arrays of events, using nthreads threads "
+	        "(0 for one per hardware thread). Multiple threads require a model "
+	        "and generator implemented in C++.")
 #endif
 	    #define PROPS (Surface)
 	    BOOST_PP_SEQ_FOR_EACH(WRAP_PROP, WeightCalculator, PROPS)
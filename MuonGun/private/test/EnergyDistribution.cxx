@@ -59,3 +59,41 @@ TEST(Sampling)
 		std::vector<pair> vals = model.energy->Generate(rng, depth, ct, m, 1000);
 	}
 }
+
+// GetLogBatch gives the same as GetLog muon by muon, including muons
+// outside the tables
+TEST(Batch)
+{
+	using namespace I3MuonGun;
+	
+	I3GSLRandomService rng(2);
+	BundleModel model = load_model("GaisserH4a_atmod12_SIBYLL");
+	
+	const double depth = 2.1, ct = 0.7;
+	const size_t n = 200;
+	std::vector<double> radius(n), log_energy(n), energy_batch(n), radial_batch(n);
+	for (unsigned m = 1; m < 40; m += 6) {
+		for (size_t i=0; i < n; i++) {
+			radius[i] = rng.Uniform(-10, 1.2*model.energy->GetMaxRadius());
+			log_energy[i] = rng.Uniform(0, 16);
+		}
+		model.energy->GetLogBatch(depth, ct, m, n, &radius[0], &log_energy[0], &energy_batch[0]);
+		model.radius->GetLogBatch(depth, ct, m, n, &radius[0], &radial_batch[0]);
+		for (size_t i=0; i < n; i++) {
+			double scalar = model.energy->GetLog(depth, ct, m, radius[i],
+			    EnergyDistribution::log_value(log_energy[i]));
+			if (std::isfinite(scalar)) {
+				ENSURE_DISTANCE(energy_batch[i], scalar, 1e-4);
+			} else {
+				ENSURE_EQUAL(energy_batch[i], scalar);
+			}
+			
+			scalar = model.radius->GetLog(depth, ct, m, radius[i]);
+			if (std::isfinite(scalar)) {
+				ENSURE_DISTANCE(radial_batch[i], scalar, 1e-4);
+			} else {
+				ENSURE(!std::isfinite(radial_batch[i]));
+			}
+		}
+	}
+}
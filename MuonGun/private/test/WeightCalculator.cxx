@@ -0,0 +1,116 @@
+#include <I3Test.h>
+
+#include "MuonGun/WeightCalculator.h"
+#include "MuonGun/StaticSurfaceInjector.h"
+#include "MuonGun/EnergyDistribution.h"
+#include "MuonGun/Cylinder.h"
+#include "phys-services/I3GSLRandomService.h"
+#include "common.h"
+
+#include <boost/make_shared.hpp>
+
+TEST_GROUP(WeightCalculator);
+
+namespace {
+
+// Random bundles, all of which hit the cylinder
+void
+make_events(I3RandomService &rng, size_t n, std::vector<I3Particle> &axes,
+    std::vector<I3MuonGun::BundleConfiguration> &bundles)
+{
+	axes.resize(n);
+	bundles.resize(n);
+	for (size_t i=0; i < n; i++) {
+		axes[i].SetPos(rng.Uniform(-500, 500), rng.Uniform(-500, 500), 900);
+		axes[i].SetDir(std::acos(rng.Uniform(0.1, 1)), rng.Uniform(0, 2*M_PI));
+		const unsigned m = 1 + unsigned(rng.Uniform(0, 30));
+		for (unsigned j=0; j < m; j++)
+			bundles[i].push_back(I3MuonGun::BundleEntry(m > 1 ? rng.Uniform(0, 100) : 0,
+			    std::exp(rng.Uniform(std::log(10), std::log(1e5)))));
+	}
+}
+
+}
+
+// Compare the bundle energy distribution evaluated muon by muon, as
+// GetWeight() used to do, to one batch per bundle
+TEST(BundleBatch)
+{
+	using namespace I3MuonGun;
+	
+	BundleModel model = load_model("GaisserH4a_atmod12_SIBYLL");
+	I3GSLRandomService rng(4);
+	std::vector<I3Particle> axes;
+	std::vector<BundleConfiguration> bundles;
+	make_events(rng, 2000, axes, bundles);
+	
+	const double depth = 2.;
+	std::vector<double> scalar(axes.size(), 0.), batch(axes.size(), 0.);
+	for (size_t i=0; i < axes.size(); i++) {
+		const double ct = std::cos(axes[i].GetDir().GetZenith());
+		const unsigned m = unsigned(bundles[i].size());
+		for (const BundleEntry &track : bundles[i])
+			scalar[i] += model.energy->GetLog(depth, ct, m, track.radius,
+			    EnergyDistribution::log_value(std::log(track.energy)));
+	}
+	
+	std::vector<double> radius, log_energy, logprob;
+	for (size_t i=0; i < axes.size(); i++) {
+		const double ct = std::cos(axes[i].GetDir().GetZenith());
+		const unsigned m = unsigned(bundles[i].size());
+		radius.clear();
+		log_energy.clear();
+		logprob.resize(m);
+		for (const BundleEntry &track : bundles[i]) {
+			radius.push_back(track.radius);
+			log_energy.push_back(std::log(track.energy));
+		}
+		model.energy->GetLogBatch(depth, ct, m, m, &radius[0], &log_energy[0], &logprob[0]);
+		for (double lp : logprob)
+			batch[i] += lp;
+	}
+	
+	for (size_t i=0; i < axes.size(); i++) {
+		if (std::isfinite(scalar[i])) {
+			ENSURE_DISTANCE(batch[i], scalar[i], 1e-4*bundles[i].size());
+		} else {
+			ENSURE_EQUAL(batch[i], scalar[i]);
+		}
+	}
+}
+
+// The threaded driver gives the same weights as the event-by-event calls,
+// for any number of threads. The first call goes to a fresh generator, so
+// that nothing has been filled in by a serial call beforehand.
+TEST(GetWeights)
+{
+	using namespace I3MuonGun;
+	
+	BundleModel model = load_model("GaisserH4a_atmod12_SIBYLL");
+	boost::shared_ptr<StaticSurfaceInjector> generator =
+	    boost::make_shared<StaticSurfaceInjector>(boost::make_shared<Cylinder>(1600, 800),
+	    model.flux, boost::make_shared<OffsetPowerLaw>(2, 500, 10, 1e5), model.radius);
+	WeightCalculator weighter(model, generator);
+	
+	I3GSLRandomService rng(3);
+	std::vector<I3Particle> axes;
+	std::vector<BundleConfiguration> bundles;
+	make_events(rng, 2000, axes, bundles);
+	
+	std::vector<double> first = weighter.GetWeights(axes, bundles, 4);
+	
+	std::vector<double> expected(axes.size());
+	for (size_t i=0; i < axes.size(); i++)
+		expected[i] = weighter.GetWeight(axes[i], bundles[i]);
+	
+	ENSURE_EQUAL(first.size(), expected.size());
+	for (size_t i=0; i < axes.size(); i++)
+		ENSURE(first[i] == expected[i] || (std::isnan(first[i]) && std::isnan(expected[i])));
+	
+	for (unsigned nthreads = 0; nthreads < 5; nthreads++) {
+		std::vector<double> weights = weighter.GetWeights(axes, bundles, nthreads);
+		ENSURE_EQUAL(weights.size(), expected.size());
+		for (size_t i=0; i < axes.size(); i++)
+			ENSURE(weights[i] == expected[i] || (std::isnan(weights[i]) && std::isnan(expected[i])));
+	}
+}
@@ -50,6 +50,21 @@ public:
 	virtual double GetLog(double depth, double cos_theta,
 	    unsigned multiplicity, double radius, log_value log_energy) const = 0;
 
+	/**
+	 * @brief Evaluate GetLog() for n muons of the same bundle
+	 *
+	 * @param[in]  depth        vertical depth in km
+	 * @param[in]  cos_theta    cosine of zenith angle
+	 * @param[in]  multiplicity number of muons in the bundle
+	 * @param[in]  n            number of muons to evaluate
+	 * @param[in]  radius       distance of each muon to the bundle axis
+	 * @param[in]  log_energy   logarithm of the energy of each muon
+	 * @param[out] logprob      where to store the n log probabilities
+	 */
+	virtual void GetLogBatch(double depth, double cos_theta,
+	    unsigned multiplicity, size_t n, const double *radius,
+	    const double *log_energy, double *logprob) const;
+
 	/// Sample *samples* (radius, energy) pairs
 	virtual std::vector<std::pair<double,double> > Generate(I3RandomService &rng,
 	    double depth, double cos_theta, unsigned multiplicity, unsigned samples) const = 0;
@@ -84,6 +99,10 @@ public:
 	SplineEnergyDistribution(const std::string &singles, const std::string &bundles);
 	double GetLog(double depth, double cos_theta, 
 	    unsigned multiplicity, double radius, log_value log_energy) const;
+	/// Evaluates the bundle spline once per bundle instead of once per muon
+	virtual void GetLogBatch(double depth, double cos_theta,
+	    unsigned multiplicity, size_t n, const double *radius,
+	    const double *log_energy, double *logprob) const override;
 	std::vector<std::pair<double,double> > Generate(I3RandomService &rng,
 	    double depth, double cos_theta, unsigned multiplicity, unsigned samples) const;
 	virtual double GetMaxRadius() const override;
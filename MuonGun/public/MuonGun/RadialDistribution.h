@@ -44,6 +44,20 @@ public:
 	virtual double GetLog(double depth, double cos_theta,
 	    unsigned multiplicity, double radius) const = 0;
 	
+	/**
+	 * @brief Evaluate GetLog() for n muons of the same bundle
+	 *
+	 * @param[in]  depth        vertical depth in km
+	 * @param[in]  cos_theta    cosine of zenith angle
+	 * @param[in]  multiplicity number of muons in the bundle
+	 * @param[in]  n            number of muons to evaluate
+	 * @param[in]  radius       distance of each muon to the bundle axis
+	 * @param[out] logprob      where to store the n log probabilities
+	 */
+	virtual void GetLogBatch(double depth, double cos_theta,
+	    unsigned multiplicity, size_t n, const double *radius,
+	    double *logprob) const;
+	
 	/**
 	 * @brief Draw a sample from the distribution of radii
 	 *
@@ -103,6 +117,10 @@ public:
 	SplineRadialDistribution(const std::string&);
 	double GetLog(double depth, double cos_theta,
 	    unsigned multiplicity, double radius) const;
+	/// Evaluates the spline once per bundle instead of once per muon
+	virtual void GetLogBatch(double depth, double cos_theta,
+	    unsigned multiplicity, size_t n, const double *radius,
+	    double *logprob) const override;
 	double Generate(I3RandomService &rng, double depth, double cos_theta,
 	    unsigned multiplicity) const;
 	
@@ -163,6 +163,8 @@ SetupSContext(const I3OMGeoMap &omGeoMap)
         sContext_.GetSDataMap()->GetMemSizeOfMapArray());
 
     I3SeededRTSDataMapPtr sDataMap = sContext_.GetSDataMap();
+    const OMKeyHasher &omKeyHasher = sDataMap->GetOMKeyHasher();
+    sContext_.ResetNeighborOMHashes(omKeyHasher.GetSize());
 
     uint32_t count = 0;
 
@@ -227,6 +229,10 @@ SetupSContext(const I3OMGeoMap &omGeoMap)
 
                 sData.dustlayerCorrectionLength_ = dustlayerCorrectionLength;
 
+                // Record the OM link in the per-OM neighbor lists.
+                sContext_.AddNeighborOMHashes(
+                    omKeyHasher.HashOMKey(srcOMKey), omKeyHasher.HashOMKey(dstOMKey));
+
                 log_trace("Set ST configuration for OM link %s-%s to %s",
                     srcOMKey.str().c_str(), dstOMKey.str().c_str(), stConfig.str().c_str()
                 );
@@ -27,6 +27,9 @@
 #ifndef STTOOLS_ALGORITHMS_SEEDEDRT_I3SEEDEDRTSCONTEXT_H_INCLUDED
 #define STTOOLS_ALGORITHMS_SEEDEDRT_I3SEEDEDRTSCONTEXT_H_INCLUDED
 
+#include <stdint.h>
+#include <vector>
+
 #include "icetray/I3PointerTypedefs.h"
 
 #include "STTools/OMKeyPairMap.h"
@@ -68,11 +71,42 @@ class I3SeededRTSContext
         maxDustlayerCorrectionLength_ = l;
     }
 
+    //__________________________________________________________________________
+    /** Returns the hashes of all OMs that have a configured OM link with the
+     *  OM of the given hash, i.e. its spatial neighbors.
+     */
+    inline
+    const std::vector<uint32_t>& GetNeighborOMHashes(uint32_t omHash) const {
+        return neighborOMHashes_[omHash];
+    }
+
+    //__________________________________________________________________________
+    /** Removes all neighbor relations and prepares the neighbor lists for
+     *  nOMs OM hashes.
+     */
+    void ResetNeighborOMHashes(uint32_t nOMs) {
+        neighborOMHashes_.assign(nOMs, std::vector<uint32_t>());
+    }
+
+    //__________________________________________________________________________
+    /** Records that the two OMs of the given hashes have a configured OM link.
+     */
+    void AddNeighborOMHashes(uint32_t omHash1, uint32_t omHash2) {
+        neighborOMHashes_[omHash1].push_back(omHash2);
+        if(omHash2 != omHash1) {
+            neighborOMHashes_[omHash2].push_back(omHash1);
+        }
+    }
+
   protected:
     //__________________________________________________________________________
     /// The maximal dustlayer correction length calculated for the spatial data
     /// map.
     double maxDustlayerCorrectionLength_;
+
+    /// The spatial neighbors of each OM, indexed by the OM hash of the spatial
+    /// data map's OMKeyHasher.
+    std::vector< std::vector<uint32_t> > neighborOMHashes_;
 };
 
 I3_POINTER_TYPEDEFS(I3SeededRTSContext);
@@ -524,10 +524,36 @@ doSelectRTHitsIteration(
     return nTotSelectedHits;
 }
 
+//______________________________________________________________________________
+/** Compares the time of a hit, given by its index within an ST hit info
+ *  series, with a given time.
+ */
+template <class HitType>
+struct hitIndexTimeLess
+{
+    const std::vector< I3SeededRTSTHitInfo<HitType> > &stHitInfoSeries_;
+
+    hitIndexTimeLess(const std::vector< I3SeededRTSTHitInfo<HitType> > &stHitInfoSeries)
+      : stHitInfoSeries_(stHitInfoSeries)
+    {}
+
+    bool operator()(uint32_t idx, double time) const {
+        return (stHitInfoSeries_[idx].GetHitTime() < time);
+    }
+};
+
 //______________________________________________________________________________
 /** Does the iterative seededRT procedure of adding RT hits to the selections
- *  of already selected hits. This function makes use of the
- *  ``doSelectRTHitsIteration`` function.
+ *  of already selected hits.
+ *
+ *  It selects the same hits as repeated calls of ``doSelectRTHitsIteration``
+ *  would do, but it only visits candidate hits which are on spatial neighbor
+ *  OMs (see I3SeededRTSContext::GetNeighborOMHashes) of the hits selected
+ *  during the previous iteration, and within the maximal RT time window of
+ *  them.
+ *
+ *  @note The given ST hit info series must be ascended time ordered in hit
+ *        time!
  */
 template <class HitType>
 uint32_t
@@ -549,25 +575,103 @@ doIterativeSelectRTHitsProcedure(
         return countSelectedSTHits<HitType>(stHitInfoSeries);
     }
 
-    int32_t nIterations = 0;
-    uint32_t nTotSelectedHitsOld = 0;
-    uint32_t nTotSelectedHitsNew = 0;
+    const I3SeededRTSContext &sContext = stConfigService.GetSContext();
+    const OMKeyHasher &omKeyHasher = sContext.GetSDataMap()->GetOMKeyHasher();
+
+    const double max_dt = stConfigService.GetMaxRTTime() +
+                          sContext.GetMaxDustlayerCorrectionLength()/I3Constants::c_ice;
+
+    const bool allowSelfCoincidence = stConfigService.GetAllowSelfCoincidence();
+
+    // Index the hits by OM. As stHitInfoSeries is time ordered, so are the
+    // hit lists of each OM. The hits selected so far form the first frontier.
+    std::vector< std::vector<uint32_t> > omHits(omKeyHasher.GetSize());
+    std::vector<uint32_t> omHashes(stHitInfoSeries.size());
+    std::vector<uint32_t> frontier;
+    uint32_t nTotSelectedHits = 0;
+    for(uint32_t idx = 0; idx < stHitInfoSeries.size(); ++idx)
+    {
+        omHashes[idx] = omKeyHasher.HashOMKey(stHitInfoSeries[idx].GetOMKey());
+        omHits[omHashes[idx]].push_back(idx);
+        if(stHitInfoSeries[idx].IsHitSelected())
+        {
+            frontier.push_back(idx);
+            ++nTotSelectedHits;
+        }
+    }
 
+    const hitIndexTimeLess<HitType> timeLess(stHitInfoSeries);
+    std::vector<uint32_t> newFrontier;
+    int32_t nIterations = 0;
     do
     {
         ++nIterations;
-        nTotSelectedHitsOld = nTotSelectedHitsNew;
-        log_debug("Starting iteration #%d",
-            nIterations);
-        nTotSelectedHitsNew = doSelectRTHitsIteration(stConfigService, stHitInfoSeries);
-        log_debug("NTotSelectedHitsOld: %u, NTotSelectedHitsNew: %u",
-            nTotSelectedHitsOld, nTotSelectedHitsNew);
+        log_debug("Starting iteration #%d", nIterations);
+        newFrontier.clear();
+
+        // Check the unselected hits within the RT time window on the spatial
+        // neighbor OMs of each hit selected by the previous iteration.
+        std::vector<uint32_t>::const_iterator srcIter;
+        for(srcIter = frontier.begin(); srcIter != frontier.end(); ++srcIter)
+        {
+            const I3SeededRTSTHitInfo<HitType> &srcHit = stHitInfoSeries[*srcIter];
+            const OMKey &srcOMKey = srcHit.GetOMKey();
+            const double srcTime = srcHit.GetHitTime();
+
+            const std::vector<uint32_t> &neighbors = sContext.GetNeighborOMHashes(omHashes[*srcIter]);
+            std::vector<uint32_t>::const_iterator nbIter;
+            for(nbIter = neighbors.begin(); nbIter != neighbors.end(); ++nbIter)
+            {
+                const std::vector<uint32_t> &dstHits = omHits[*nbIter];
+                std::vector<uint32_t>::const_iterator dstIter = std::lower_bound(
+                    dstHits.begin(), dstHits.end(), srcTime - max_dt, timeLess);
+                for(; dstIter != dstHits.end(); ++dstIter)
+                {
+                    I3SeededRTSTHitInfo<HitType> &dstHit = stHitInfoSeries[*dstIter];
+                    if(dstHit.GetHitTime() > srcTime + max_dt) {
+                        break;
+                    }
+                    if(dstHit.IsHitSelected() || dstHit.IsHitNewlySelected()) {
+                        continue;
+                    }
+
+                    const OMKey &dstOMKey = dstHit.GetOMKey();
+                    if(!allowSelfCoincidence && equivalent(srcOMKey, dstOMKey)) {
+                        continue;
+                    }
+
+                    const I3SeededRTSData &sData = stConfigService.GetSDataForOMLink(srcOMKey, dstOMKey);
+                    if(sData.stConfig_ != NULL &&
+                       areTimesInTemporalCausalConnection(
+                           srcTime, dstHit.GetHitTime(),
+                           sData.stConfig_->GetRTTime(), sData.dustlayerCorrectionLength_)
+                      )
+                    {
+                        dstHit.SetIsHitNewlySelected(true);
+                        newFrontier.push_back(*dstIter);
+                    }
+                }
+            }
+        }
+
+        // Promote the newly selected hits, they form the next frontier.
+        std::vector<uint32_t>::const_iterator newIter;
+        for(newIter = newFrontier.begin(); newIter != newFrontier.end(); ++newIter)
+        {
+            stHitInfoSeries[*newIter].SetIsHitNewlySelected(false);
+            stHitInfoSeries[*newIter].SetIsHitSelected(true);
+        }
+        nTotSelectedHits += newFrontier.size();
+        frontier.swap(newFrontier);
+
+        log_debug("NTotSelectedHits: %u, newly selected: %zu",
+            nTotSelectedHits, frontier.size());
     }
-    while((nTotSelectedHitsOld < nTotSelectedHitsNew) &&
-          (maxNIterations == -1 || (maxNIterations > 0 && nIterations < maxNIterations))
+    while(!frontier.empty() &&
+          (maxNIterations == -1 || nIterations < maxNIterations)
          );
 
-    return nTotSelectedHitsNew;
+    return nTotSelectedHits;
 }
 
 //______________________________________________________________________________
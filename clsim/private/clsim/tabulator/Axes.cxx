@@ -25,12 +25,17 @@
  */
 
 #include "icetray/I3Units.h"
+#include "dataclasses/I3Constants.h"
+#include "dataclasses/physics/I3Particle.h"
+#include "phys-services/I3RandomService.h"
 #include "clsim/tabulator/Axes.h"
 #include "clsim/I3CLSimHelperToFloatString.h"
 #include "opencl/I3CLSimHelperLoadProgramSource.h"
 
 #include <boost/foreach.hpp>
 
+#include <cmath>
+
 namespace {
 
 std::string 
@@ -42,14 +47,72 @@ loadKernel(const std::string& name, bool header=false)
     return I3CLSimHelper::LoadProgramSource(kernelBaseDir+name+ext);
 }
 
+inline double
+dot(const double a[3], const double b[3])
+{
+	return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+}
+
 }
 
 namespace clsim {
 
 namespace tabulator {
 
+ReferenceSource::ReferenceSource(const I3Particle &source,
+    double minInvGroupVel_, double tanThetaC_)
+    : minInvGroupVel(minInvGroupVel_), tanThetaC(tanThetaC_)
+{
+	posAndTime[0] = source.GetPos().GetX();
+	posAndTime[1] = source.GetPos().GetY();
+	posAndTime[2] = source.GetPos().GetZ();
+	posAndTime[3] = source.GetTime();
+	
+	const I3Direction &sdir = source.GetDir();
+	dir[0] = sdir.GetX();
+	dir[1] = sdir.GetY();
+	dir[2] = sdir.GetZ();
+	
+	double perpz = hypot(dir[0], dir[1]);
+	if (perpz > 0.) {
+		perpDir[0] = -dir[0]*dir[2]/perpz;
+		perpDir[1] = -dir[1]*dir[2]/perpz;
+		perpDir[2] = perpz;
+	} else {
+		perpDir[0] = 1.;
+		perpDir[1] = 0.;
+		perpDir[2] = 0.;
+	}
+}
+
+void
+ScatterDirectionByAngle(double cosa, double sina, double dir[3], double randomNumber)
+{
+	// randomize direction of scattering (rotation around old direction axis)
+	const double b = 2*M_PI*randomNumber;
+	const double cosb = std::cos(b);
+	const double sinb = std::sin(b);
+	
+	// Rotate new direction into absolute frame of reference
+	const double sinth = std::sqrt(std::max(0., 1.-dir[2]*dir[2]));
+	if (sinth > 0.) {
+		const double old[3] = {dir[0], dir[1], dir[2]};
+		dir[0] = old[0]*cosa - (old[1]*cosb + old[2]*old[0]*sinb)*sina/sinth;
+		dir[1] = old[1]*cosa + (old[0]*cosb - old[2]*old[1]*sinb)*sina/sinth;
+		dir[2] = old[2]*cosa + sina*sinb*sinth;
+	} else {
+		dir[0] = sina*cosb;
+		dir[1] = sina*sinb;
+		dir[2] = (dir[2] < 0) ? -cosa : cosa;
+	}
+	
+	const double norm = std::sqrt(dot(dir, dir));
+	for (unsigned i = 0; i < 3; i++)
+		dir[i] /= norm;
+}
+
 Axes::Axes(const std::vector<value_type> &axes) : axes_(axes), n_dim_(axes_.size()),
-    shape_(n_dim_), strides_(n_dim_)
+    shape_(n_dim_), strides_(n_dim_), scale_(n_dim_), offset_(n_dim_)
 {
 	int i = n_dim_-1;
 	// NB: every axis has an over- and an under-flow bin.
@@ -60,6 +123,13 @@ Axes::Axes(const std::vector<value_type> &axes) : axes_(axes), n_dim_(axes_.size
 		strides_[i] = strides_[i+1]*shape_[i+1];
 	}
 	n_bins_ = strides_[0]*shape_[0];
+	
+	// same mapping as GetIndexCode()
+	for (i = 0; i < int(n_dim_); i++) {
+		scale_[i] = axes_[i]->GetNBins()/(axes_[i]->InverseTransform(axes_[i]->GetMax())
+		    - axes_[i]->InverseTransform(axes_[i]->GetMin()));
+		offset_[i] = scale_[i]*axes_[i]->InverseTransform(axes_[i]->GetMin());
+	}
 }
 
 Axes::~Axes()
@@ -86,6 +156,21 @@ Axes::GetBinIndexFunction() const
 	return ss.str();
 }
 
+size_t
+Axes::GetBinIndex(const double *coords) const
+{
+	size_t index = 0;
+	for (unsigned i = 0; i < n_dim_; i++) {
+		// clamp to the under- and overflow bins, like the generated code
+		const double bin = std::floor(scale_[i]*axes_[i]->InverseTransform(coords[i]) - offset_[i]);
+		const int n = axes_[i]->GetNBins();
+		const int idx = !(bin >= -1) ? -1 : (bin > n ? n : int(bin));
+		index += strides_[i]*(idx+1);
+	}
+	
+	return index;
+}
+
 std::string
 Axes::GenerateBinningCode() const
 {
@@ -118,6 +203,55 @@ SphericalAxes::GetBoundsCheckFunction() const
 	return ss.str();
 }
 
+void
+SphericalAxes::GetCoordinates(const ReferenceSource &source,
+    const double posAndTime[4], const double dir[3],
+    I3RandomService &rng, double *coords) const
+{
+	double pos[4];
+	for (unsigned i = 0; i < 4; i++)
+		pos[i] = posAndTime[i] - source.posAndTime[i];
+	const double l = dot(pos, source.dir);
+	double rho[3];
+	for (unsigned i = 0; i < 3; i++)
+		rho[i] = pos[i] - l*source.dir[i];
+	const double n_rho = std::sqrt(dot(rho, rho));
+	
+	// radius
+	coords[0] = std::sqrt(dot(pos, pos));
+	// azimuth
+	double azimuth = (n_rho > 0) ?
+	    std::acos(std::max(-1., std::min(1., dot(rho, source.perpDir)/n_rho)))/I3Units::degree : 0;
+	if (at(1)->GetMax() > 180.) {
+		// resolve the direction of rho for tables that extend to 360 degrees
+		const double cross[3] = {
+		    rho[1]*source.perpDir[2] - rho[2]*source.perpDir[1],
+		    rho[2]*source.perpDir[0] - rho[0]*source.perpDir[2],
+		    rho[0]*source.perpDir[1] - rho[1]*source.perpDir[0] };
+		if (dot(cross, source.dir) > 0)
+			azimuth = 360. - azimuth;
+	}
+	coords[1] = azimuth;
+	// cos(polar angle)
+	coords[2] = (coords[0] > 0) ? l/coords[0] : 0;
+	// delay time
+	coords[3] = pos[3] - coords[0]*source.minInvGroupVel;
+	if (GetNDim() > 4) {
+		// cosine of the impact angle, averaged over the DOM cross-section
+		// (see spherical_coordinates.c.cl)
+		double impactDir[3] = {dir[0], dir[1], dir[2]};
+		const double sina = std::sqrt(rng.Uniform());
+		ScatterDirectionByAngle(std::sqrt(1-sina*sina), sina, impactDir, rng.Uniform());
+		coords[4] = (coords[0] > 0) ? dot(impactDir, pos)/coords[0] : 1;
+	}
+}
+
+bool
+SphericalAxes::IsOutOfBounds(const double *coords) const
+{
+	return (coords[3] > at(3)->GetMax()) || (coords[0] > at(0)->GetMax());
+}
+
 double
 SphericalAxes::GetBinVolume(const std::vector<size_t> &idxs) const
 {
@@ -151,6 +285,49 @@ CylindricalAxes::GetBoundsCheckFunction() const
 	return ss.str();
 }
 
+void
+CylindricalAxes::GetCoordinates(const ReferenceSource &source,
+    const double posAndTime[4], const double dir[3],
+    I3RandomService &rng, double *coords) const
+{
+	double pos[4];
+	for (unsigned i = 0; i < 4; i++)
+		pos[i] = posAndTime[i] - source.posAndTime[i];
+	const double l = dot(pos, source.dir);
+	double rho[3];
+	for (unsigned i = 0; i < 3; i++)
+		rho[i] = pos[i] - l*source.dir[i];
+	
+	// perpendicular distance
+	coords[0] = std::sqrt(dot(rho, rho));
+	// azimuth (in radians, like the OpenCL implementation)
+	coords[1] = (coords[0] > 0) ?
+	    std::acos(std::max(-1., std::min(1., dot(rho, source.perpDir)/coords[0]))) : 0;
+	// depth of closest approach
+	coords[2] = source.posAndTime[2] + l*source.dir[2];
+	// delay time
+	coords[3] = pos[3] - (l + coords[0]*source.tanThetaC)/I3Constants::c;
+	if (GetNDim() > 4) {
+		// cosine of the impact angle w.r.t. the nominal Cherenkov emission
+		// point, averaged over the DOM cross-section
+		// (see cylindrical_coordinates.c.cl)
+		double impactDir[3] = {dir[0], dir[1], dir[2]};
+		const double sina = std::sqrt(rng.Uniform());
+		ScatterDirectionByAngle(std::sqrt(1-sina*sina), sina, impactDir, rng.Uniform());
+		double cpos[3];
+		for (unsigned i = 0; i < 3; i++)
+			cpos[i] = pos[i] - (l - coords[0]/source.tanThetaC)*source.dir[i];
+		const double cdist = std::sqrt(dot(cpos, cpos));
+		coords[4] = (cdist > 0) ? dot(impactDir, cpos)/cdist : 1;
+	}
+}
+
+bool
+CylindricalAxes::IsOutOfBounds(const double *coords) const
+{
+	return (coords[3] > at(3)->GetMax());
+}
+
 double
 CylindricalAxes::GetBinVolume(const std::vector<size_t> &idxs) const
 {
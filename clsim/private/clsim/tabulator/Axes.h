@@ -30,6 +30,9 @@
 #include "icetray/I3PointerTypedefs.h"
 #include "clsim/tabulator/Axis.h"
 
+I3_FORWARD_DECLARATION(I3RandomService);
+I3_FORWARD_DECLARATION(I3Particle);
+
 #include <vector>
 #include <string>
 
@@ -39,6 +42,24 @@ namespace clsim {
 
 namespace tabulator {
 
+/// Host-side equivalent of I3CLSimReferenceParticle in the OpenCL kernels,
+/// together with the medium constants the coordinate transforms need
+struct ReferenceSource {
+	ReferenceSource(const I3Particle &source, double minInvGroupVel, double tanThetaC);
+	/// x,y,z,time
+	double posAndTime[4];
+	double dir[3];
+	double perpDir[3];
+	/// inverse of the maximum group velocity
+	double minInvGroupVel;
+	/// tangent of the Cherenkov angle at the minimum phase index
+	double tanThetaC;
+};
+
+/// Rotate *dir* by an angle with cosine *cosa* about a random axis
+/// perpendicular to it (host-side twin of scatterDirectionByAngle).
+void ScatterDirectionByAngle(double cosa, double sina, double dir[3], double randomNumber);
+
 /// The Axes encapsulates the coordinate system used for binning photon paths.
 class Axes : boost::noncopyable {
 public:
@@ -61,6 +82,17 @@ public:
 	/// into source-relative positions and calculate the corresponding index
 	/// in the flattened bin-content array.
 	std::string GenerateBinningCode() const;
+	
+	/// Calculate the source-relative coordinates of a photon at *posAndTime*
+	/// travelling along *dir* and store the first GetNDim() in *coords*.
+	/// This is the host-side equivalent of the generated OpenCL code.
+	virtual void GetCoordinates(const ReferenceSource &source,
+	    const double posAndTime[4], const double dir[3],
+	    I3RandomService &rng, double *coords) const = 0;
+	/// Return true if a photon at *coords* has exited the recording volume
+	virtual bool IsOutOfBounds(const double *coords) const = 0;
+	/// Index of *coords* in the flattened bin-content array
+	size_t GetBinIndex(const double *coords) const;
 
 	/// Calculate the volume (in m^3) of the cell at index multiIndex in
 	/// the bin-content array
@@ -86,6 +118,8 @@ private:
 	size_t n_bins_;
 	std::vector<size_t> shape_;
 	std::vector<size_t> strides_;
+	/// map the inverse-transformed coordinate onto bin numbers
+	std::vector<double> scale_, offset_;
 };
 
 I3_POINTER_TYPEDEFS(Axes);
@@ -97,6 +131,10 @@ public:
 	SphericalAxes(const std::vector<value_type> &axes) : Axes(axes) {}
 	
 	virtual double GetBinVolume(const std::vector<size_t> &multiIndex) const;
+	virtual void GetCoordinates(const ReferenceSource &source,
+	    const double posAndTime[4], const double dir[3],
+	    I3RandomService &rng, double *coords) const;
+	virtual bool IsOutOfBounds(const double *coords) const;
 	
 protected:
 	virtual std::string GetCoordinateFunction() const;
@@ -113,6 +151,10 @@ public:
 	CylindricalAxes(const std::vector<value_type> &axes) : Axes(axes) {}
 	
 	virtual double GetBinVolume(const std::vector<size_t> &multiIndex) const;
+	virtual void GetCoordinates(const ReferenceSource &source,
+	    const double posAndTime[4], const double dir[3],
+	    I3RandomService &rng, double *coords) const;
+	virtual bool IsOutOfBounds(const double *coords) const;
 protected:
 	virtual std::string GetCoordinateFunction() const;
 	virtual std::string GetBoundsCheckFunction() const;
@@ -28,6 +28,8 @@
 #include "clsim/tabulator/Axes.h"
 
 #include "clsim/function/I3CLSimFunctionConstant.h"
+#include "clsim/function/I3CLSimScalarField.h"
+#include "clsim/function/I3CLSimVectorTransform.h"
 
 #include "opencl/I3CLSimHelperMath.h"
 #include "opencl/I3CLSimHelperGenerateMediumPropertiesSource.h"
@@ -37,6 +39,7 @@
 #include "clsim/I3CLSimLightSourceToStepConverterUtils.h"
 #include "clsim/I3CLSimHelperToFloatString.h"
 #include "clsim/cl.hpp"
+#include "phys-services/I3GSLRandomService.h"
 
 #include <fitsio.h>
 #include <fitsio2.h>
@@ -44,6 +47,10 @@
 #include <boost/foreach.hpp>
 #include <boost/make_shared.hpp>
 
+#include <cstdio>
+#include <limits>
+#include <unistd.h>
+
 namespace  {
 
 std::string 
@@ -129,13 +136,59 @@ I3CLSimStepToTableConverter::I3CLSimStepToTableConverter(I3CLSimOpenCLDevice dev
     I3CLSimMediumPropertiesConstPtr mediumProperties, I3CLSimSpectrumTableConstPtr spectrumTable,
     double referenceArea,
     I3CLSimFunctionConstPtr wavelengthAcceptance, I3CLSimFunctionConstPtr angularAcceptance,
-    I3RandomServicePtr rng) : entriesPerStream_(entriesPerStream), stepQueue_(1), run_(true),
+    I3RandomServicePtr rng) : entriesPerStream_(entriesPerStream), stepQueue_(1),
     domArea_(referenceArea), stepLength_(1.), axes_(axes),
     numPhotons_(0), sumOfPhotonWeights_(0.)
 {
-	std::vector<I3CLSimRandomValueConstPtr> wavelengthGenerators;
+	pending_.count = 0;
+	Initialize(I3CLSimOpenCLDeviceSeries(1, device), 0, entriesPerStream,
+	    storeSquaredWeights, mediumProperties, spectrumTable,
+	    wavelengthAcceptance, angularAcceptance, rng);
+}
+
+I3CLSimStepToTableConverter::I3CLSimStepToTableConverter(const I3CLSimOpenCLDeviceSeries &devices,
+    clsim::tabulator::AxesConstPtr axes, size_t entriesPerStream, bool storeSquaredWeights,
+    I3CLSimMediumPropertiesConstPtr mediumProperties, I3CLSimSpectrumTableConstPtr spectrumTable,
+    double referenceArea,
+    I3CLSimFunctionConstPtr wavelengthAcceptance, I3CLSimFunctionConstPtr angularAcceptance,
+    I3RandomServicePtr rng) : entriesPerStream_(entriesPerStream), stepQueue_(1),
+    domArea_(referenceArea), stepLength_(1.), axes_(axes),
+    numPhotons_(0), sumOfPhotonWeights_(0.)
+{
+	pending_.count = 0;
+	Initialize(devices, 0, entriesPerStream, storeSquaredWeights,
+	    mediumProperties, spectrumTable, wavelengthAcceptance,
+	    angularAcceptance, rng);
+}
+
+I3CLSimStepToTableConverter::I3CLSimStepToTableConverter(unsigned numThreads,
+    clsim::tabulator::AxesConstPtr axes, bool storeSquaredWeights,
+    I3CLSimMediumPropertiesConstPtr mediumProperties, I3CLSimSpectrumTableConstPtr spectrumTable,
+    double referenceArea,
+    I3CLSimFunctionConstPtr wavelengthAcceptance, I3CLSimFunctionConstPtr angularAcceptance,
+    I3RandomServicePtr rng) : entriesPerStream_(0), stepQueue_(1),
+    domArea_(referenceArea), stepLength_(1.), axes_(axes),
+    numPhotons_(0), sumOfPhotonWeights_(0.)
+{
+	pending_.count = 0;
+	if (numThreads == 0)
+		numThreads = std::max(1u, boost::thread::hardware_concurrency());
+	Initialize(I3CLSimOpenCLDeviceSeries(), numThreads, 0, storeSquaredWeights,
+	    mediumProperties, spectrumTable, wavelengthAcceptance,
+	    angularAcceptance, rng);
+}
+
+void
+I3CLSimStepToTableConverter::Initialize(const I3CLSimOpenCLDeviceSeries &devices,
+    unsigned numThreads, size_t entriesPerStream, bool storeSquaredWeights,
+    I3CLSimMediumPropertiesConstPtr mediumProperties, I3CLSimSpectrumTableConstPtr spectrumTable,
+    I3CLSimFunctionConstPtr wavelengthAcceptance, I3CLSimFunctionConstPtr angularAcceptance,
+    I3RandomServicePtr rng)
+{
+	if (devices.empty() && numThreads == 0)
+		log_fatal("No OpenCL devices configured");
 	
-	wavelengthGenerators.push_back(I3CLSimModuleHelper::makeCherenkovWavelengthGenerator
+	wavelengthGenerators_.push_back(I3CLSimModuleHelper::makeCherenkovWavelengthGenerator
 	                                (wavelengthAcceptance,
 	                                 false /*generateCherenkovPhotonsWithoutDispersion_*/,
 	                                 mediumProperties
@@ -162,7 +215,7 @@ I3CLSimStepToTableConverter::I3CLSimStepToTableConverter(I3CLSimOpenCLDevice dev
 
 	    for (std::size_t i=1;i<spectrumTable->size();++i)
 	    {
-	        wavelengthGenerators.push_back(I3CLSimModuleHelper::makeWavelengthGenerator
+	        wavelengthGenerators_.push_back(I3CLSimModuleHelper::makeWavelengthGenerator
 	                                        ((*spectrumTable)[i],
 	                                         wavelengthAcceptance,
 	                                         mediumProperties
@@ -174,6 +227,39 @@ I3CLSimStepToTableConverter::I3CLSimStepToTableConverter(I3CLSimOpenCLDevice dev
 	             spectrumTable->size()-1);
 	}
 	
+	minimumRefractiveIndex_ = GetMinimumRefractiveIndex(*mediumProperties);
+	
+	binContent_.resize(axes_->GetNBins(), 0);
+	if (storeSquaredWeights)
+		squaredWeights_.resize(axes_->GetNBins(), 0);
+	
+	if (devices.empty()) {
+		// propagate on the host instead
+		if (mediumProperties->HasBirefringence())
+			log_fatal("Photon propagation without OpenCL does not support birefringence");
+		mediumProperties_ = mediumProperties;
+		angularAcceptance_ = angularAcceptance;
+		// one step per bunch, like the OpenCL workers
+		maxNumWorkitems_ = 1;
+		
+		for (unsigned i = 0; i < numThreads; i++) {
+			WorkerPtr worker = boost::make_shared<Worker>();
+			// seed every stream before any worker starts, so that no two
+			// threads touch the random service at the same time
+			worker->rng = boost::make_shared<I3GSLRandomService>(
+			    rng->Integer(std::numeric_limits<unsigned>::max()));
+			worker->binContent.resize(binContent_.size(), 0);
+			worker->squaredWeights.resize(squaredWeights_.size(), 0);
+			workers_.push_back(worker);
+		}
+		log_info_stream("Propagating photons with " << numThreads << " host threads");
+		
+		BOOST_FOREACH(WorkerPtr &worker, workers_)
+			worker->thread = boost::thread(boost::bind(&I3CLSimStepToTableConverter::PropagateSteps, this, worker));
+		return;
+	}
+	
+	// everything but the math preamble, which depends on the device
 	std::vector<std::string> sources;
 	
 	const std::string I3_BUILD(getenv("I3_BUILD"));
@@ -192,17 +278,15 @@ I3CLSimStepToTableConverter::I3CLSimStepToTableConverter(I3CLSimOpenCLDevice dev
 		preamble << "#define TABULATE_IMPACT_ANGLE\n";
 	preamble << "#define TABLE_ENTRIES_PER_STREAM " << entriesPerStream_ << "\n";
 	preamble << "#define VOLUME_MODE_STEP "<<I3CLSimHelper::ToFloatString(stepLength_)<<"\n";
-	minimumRefractiveIndex_ = GetMinimumRefractiveIndex(*mediumProperties);
 	
 	preamble << "__constant floating_t min_invGroupVel = " << I3CLSimHelper::ToFloatString(
 	    minimumRefractiveIndex_.first/I3Constants::c) << ";\n";
 	preamble << "__constant floating_t tan_thetaC = " << I3CLSimHelper::ToFloatString(
 	    std::sqrt(minimumRefractiveIndex_.second*minimumRefractiveIndex_.second-1.)) << ";\n";
 	
-	sources.push_back(I3CLSimHelper::GetMathPreamble(device, false /* single precision for now */));
 	sources.push_back(preamble.str());
 	sources.push_back(I3CLSimHelper::LoadProgramSource(kernelBaseDir+"/mwcrng_kernel.cl"));
-	sources.push_back(I3CLSimHelper::GenerateWavelengthGeneratorSource(wavelengthGenerators));
+	sources.push_back(I3CLSimHelper::GenerateWavelengthGeneratorSource(wavelengthGenerators_));
 	sources.push_back(wavelengthAcceptance->GetOpenCLFunction("getWavelengthBias"));
 	sources.push_back(I3CLSimHelper::GenerateMediumPropertiesSource(*mediumProperties));
 	sources.push_back(angularAcceptance->GetOpenCLFunction("getAngularAcceptance"));
@@ -211,10 +295,6 @@ I3CLSimStepToTableConverter::I3CLSimStepToTableConverter(I3CLSimOpenCLDevice dev
 	sources.push_back(axes_->GenerateBinningCode());
 	sources.push_back(loadKernel("propagation_kernel", false));
 	
-	binContent_.resize(axes_->GetNBins(), 0);
-	if (storeSquaredWeights)
-		squaredWeights_.resize(axes->GetNBins(), 0);
-	
 #ifndef NDEBUG
 	std::stringstream source;
 	BOOST_FOREACH(std::string &part, sources)
@@ -227,24 +307,31 @@ I3CLSimStepToTableConverter::I3CLSimStepToTableConverter(I3CLSimOpenCLDevice dev
 	}
 #endif
 
+	maxNumWorkitems_ = 0;
+	BOOST_FOREACH(const I3CLSimOpenCLDevice &clsimDevice, devices)
 	{
-		VECTOR_CLASS<cl::Device> devices(1, *(device.GetDeviceHandle()));
+		WorkerPtr worker = boost::make_shared<Worker>();
+		
+		VECTOR_CLASS<cl::Device> clDevices(1, *(clsimDevice.GetDeviceHandle()));
 		cl_context_properties properties[] = 
-		{ CL_CONTEXT_PLATFORM, (cl_context_properties)(*(device.GetPlatformHandle()))(), 0};
+		{ CL_CONTEXT_PLATFORM, (cl_context_properties)(*(clsimDevice.GetPlatformHandle()))(), 0};
 		
-		context_ = cl::Context(devices, properties);
+		worker->context = cl::Context(clDevices, properties);
 		
 		std::string BuildOptions;
 		BuildOptions += "-cl-mad-enable";
 
+		const std::string mathPreamble =
+		    I3CLSimHelper::GetMathPreamble(clsimDevice, false /* single precision for now */);
 		cl::Program::Sources source;
+		source.push_back(std::make_pair(mathPreamble.c_str(), mathPreamble.size()));
 		BOOST_FOREACH(const std::string &part, sources)
 			source.push_back(std::make_pair(part.c_str(), part.size()));
 		
-		cl::Device device = devices[0];
-		cl::Program program(context_, source);
+		cl::Device device = clDevices[0];
+		cl::Program program(worker->context, source);
 		try {
-			program.build(devices, BuildOptions.c_str());
+			program.build(clDevices, BuildOptions.c_str());
 		} catch (cl::Error &err) {
 	        std::string deviceName = device.getInfo<CL_DEVICE_NAME>();
 	        log_error("  * build status on %s\"", deviceName.c_str());
@@ -256,17 +343,32 @@ I3CLSimStepToTableConverter::I3CLSimStepToTableConverter(I3CLSimOpenCLDevice dev
 			log_fatal_stream(err.what() << ": " << err.errstr());
 		}
 		
-		commandQueue_ = cl::CommandQueue(context_, device, CL_QUEUE_PROFILING_ENABLE);
+		worker->commandQueue = cl::CommandQueue(worker->context, device, CL_QUEUE_PROFILING_ENABLE);
 		
-		cl::Kernel kernel(program, "propKernel");
+		worker->kernel = cl::Kernel(program, "propKernel");
 		
-		maxNumWorkitems_ = std::min(kernel.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(device), size_t(1));
-		log_debug_stream("max work group size " << maxNumWorkitems_);
+		size_t numWorkitems = std::min(worker->kernel.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(device), size_t(1));
+		if (maxNumWorkitems_ == 0 || numWorkitems < maxNumWorkitems_)
+			maxNumWorkitems_ = numWorkitems;
+		log_debug_stream("max work group size " << numWorkitems);
 		log_debug_stream(device.getInfo<CL_DEVICE_NAME>() << " max memory "<<device.getInfo<CL_DEVICE_MAX_MEM_ALLOC_SIZE>());
 		
-		harvesterThread_ = boost::thread(boost::bind(&I3CLSimStepToTableConverter::FetchSteps, this, kernel, rng));
+		worker->binContent.resize(binContent_.size(), 0);
+		worker->squaredWeights.resize(squaredWeights_.size(), 0);
+		
+		workers_.push_back(worker);
 	}
 	
+	// Draw the RNG state for every stream before any worker starts, so
+	// that no two threads touch the random service at the same time.
+	BOOST_FOREACH(WorkerPtr &worker, workers_) {
+		worker->mwcX.resize(maxNumWorkitems_);
+		worker->mwcA.resize(maxNumWorkitems_);
+		init_MWC_RNG(&worker->mwcX[0], &worker->mwcA[0], maxNumWorkitems_, rng);
+	}
+	
+	BOOST_FOREACH(WorkerPtr &worker, workers_)
+		worker->thread = boost::thread(boost::bind(&I3CLSimStepToTableConverter::FetchSteps, this, worker));
 }
 
 I3CLSimStepToTableConverter::~I3CLSimStepToTableConverter()
@@ -279,30 +381,50 @@ I3CLSimStepToTableConverter::EnqueueSteps(I3CLSimStepSeriesConstPtr steps, I3Par
 {
 	if (!steps)
 		return;
-	BOOST_FOREACH(const I3CLSimStep &step, *steps) {
+	BOOST_FOREACH(const I3CLSimStep &step, *steps)
 		numPhotons_ += step.GetNumPhotons();
-		sumOfPhotonWeights_ += step.GetNumPhotons()*step.GetWeight();
-	}
 	
+	{
+		boost::unique_lock<boost::mutex> lock(pending_.mutex);
+		pending_.count++;
+	}
 	stepQueue_.Put(bunch_t(steps, reference));
 }
 
 void
 I3CLSimStepToTableConverter::Finish()
 {
-	if (harvesterThread_.joinable()) {
-		run_ = false;
-		log_debug("Finish");
-		harvesterThread_.join();
+	if (workers_.empty())
+		return;
+	
+	log_debug("Finish");
+	// one stop marker for each harvester thread
+	BOOST_FOREACH(WorkerPtr &worker, workers_) {
+		if (worker->thread.joinable())
+			stepQueue_.Put(bunch_t());
 	}
+	BOOST_FOREACH(WorkerPtr &worker, workers_) {
+		if (worker->thread.joinable())
+			worker->thread.join();
+	}
+	
+	// merge the partial tables
+	BOOST_FOREACH(WorkerPtr &worker, workers_) {
+		for (size_t i = 0; i < binContent_.size(); i++)
+			binContent_[i] += worker->binContent[i];
+		for (size_t i = 0; i < squaredWeights_.size(); i++)
+			squaredWeights_[i] += worker->squaredWeights[i];
+		sumOfPhotonWeights_ += worker->sumOfPhotonWeights;
+	}
+	workers_.clear();
 }
 
 namespace {
 
 struct DeviceBuffers {
 	DeviceBuffers() {};
-	DeviceBuffers(cl::Context, I3RandomServicePtr, size_t streams,
-	    size_t entriesPerStream);
+	DeviceBuffers(cl::Context, std::vector<uint64_t> &mwcX,
+	    std::vector<uint32_t> &mwcA, size_t entriesPerStream);
 	struct {
 		cl::Buffer x, a;
 	} mwc; 
@@ -313,13 +435,10 @@ struct DeviceBuffers {
 };
 
 DeviceBuffers::DeviceBuffers(cl::Context context,
-    I3RandomServicePtr rng, size_t streams, size_t entriesPerStream)
+    std::vector<uint64_t> &xv, std::vector<uint32_t> &av, size_t entriesPerStream)
 {
-	std::vector<uint64_t> xv(streams);
-	std::vector<uint32_t> av(streams);
-	
-	init_MWC_RNG(&xv[0], &av[0], streams, rng);
-	
+	const size_t streams = xv.size();
+	assert(av.size() == streams);
 
 	mwc.x = cl::Buffer(context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
 	    streams*sizeof(uint64_t), &xv[0]);
@@ -389,10 +508,11 @@ struct KernelStatistics {
 }
 
 void
-I3CLSimStepToTableConverter::FetchSteps(cl::Kernel kernel, I3RandomServicePtr rng)
+I3CLSimStepToTableConverter::FetchSteps(WorkerPtr worker)
 {
-	
-	DeviceBuffers buffers(context_, rng, maxNumWorkitems_, entriesPerStream_);
+	cl::Kernel &kernel = worker->kernel;
+	cl::CommandQueue &commandQueue = worker->commandQueue;
+	DeviceBuffers buffers(worker->context, worker->mwcX, worker->mwcA, entriesPerStream_);
 
 	// Set kernel arguments
 	uint args = 0;
@@ -414,19 +534,19 @@ I3CLSimStepToTableConverter::FetchSteps(cl::Kernel kernel, I3RandomServicePtr rn
 	
 		// Work on either the remainder of the last bunch or the next bunch
 		// in the queue
-		if (!bunch.first && !stepQueue_.GetNonBlocking(bunch)) {
-			if (run_) {
-				continue;
-			} else {
+		if (!bunch.first) {
+			bunch = stepQueue_.Get();
+			if (!bunch.first)
 				return;
-			}
 		}
 		
 		size_t n_photons = 0;
 		size_t real_steps = 0;
+		double photonWeights = 0;
 		BOOST_FOREACH(const I3CLSimStep &step, *bunch.first) {
 			if (step.GetNumPhotons() > 0) {
 				n_photons += step.GetNumPhotons();
+				photonWeights += step.GetNumPhotons()*step.GetWeight();
 				real_steps++;
 			}
 		}
@@ -437,19 +557,19 @@ I3CLSimStepToTableConverter::FetchSteps(cl::Kernel kernel, I3RandomServicePtr rn
 		
 		const size_t items = bunch.first->size();
 		assert(items <= maxNumWorkitems_);
-		commandQueue_.enqueueWriteBuffer(buffers.inputSteps, CL_FALSE, 0,
+		commandQueue.enqueueWriteBuffer(buffers.inputSteps, CL_FALSE, 0,
 		    items*sizeof(I3CLSimStep), &(*bunch.first)[0], NULL, &buffersFilled[0]);
 		
 		I3CLSimReferenceParticle ref(*bunch.second);
-		commandQueue_.enqueueWriteBuffer(buffers.referenceSource, CL_FALSE, 0,
+		commandQueue.enqueueWriteBuffer(buffers.referenceSource, CL_FALSE, 0,
 		    sizeof(I3CLSimReferenceParticle), &ref, NULL, &buffersFilled[1]);
 		
-		commandQueue_.enqueueFillBuffer<uint32_t>(buffers.numEntries, 0u /*pattern*/,
+		commandQueue.enqueueFillBuffer<uint32_t>(buffers.numEntries, 0u /*pattern*/,
 		    0 /*offset*/, items*sizeof(uint32_t) /*size*/, NULL, &buffersFilled[2]);
-		commandQueue_.flush();
+		commandQueue.flush();
 		
 		try {
-		commandQueue_.enqueueNDRangeKernel(kernel, cl::NullRange,
+		commandQueue.enqueueNDRangeKernel(kernel, cl::NullRange,
 		    cl::NDRange(items), cl::NDRange(maxNumWorkitems_),
 		    &buffersFilled, &kernelFinished[0]);
 		} catch (cl::Error &err) {
@@ -457,14 +577,14 @@ I3CLSimStepToTableConverter::FetchSteps(cl::Kernel kernel, I3RandomServicePtr rn
 			throw;
 		}
 	
-		commandQueue_.enqueueReadBuffer(buffers.inputSteps, CL_FALSE, 0,
+		commandQueue.enqueueReadBuffer(buffers.inputSteps, CL_FALSE, 0,
 		    items*sizeof(I3CLSimStep), &osteps[0], &kernelFinished, &buffersRead[0]);
-		commandQueue_.enqueueReadBuffer(buffers.numEntries, CL_FALSE, 0,
+		commandQueue.enqueueReadBuffer(buffers.numEntries, CL_FALSE, 0,
 		    items*sizeof(uint32_t), &numEntries[0], &kernelFinished, &buffersRead[1]);
-		commandQueue_.enqueueReadBuffer(buffers.outputEntries, CL_FALSE, 0,
+		commandQueue.enqueueReadBuffer(buffers.outputEntries, CL_FALSE, 0,
 		    items*entriesPerStream_*sizeof(I3CLSimTableEntry), &tableEntries[0], &kernelFinished, &buffersRead[2]);
 
-		commandQueue_.flush();
+		commandQueue.flush();
 	
 		cl::Event::waitForEvents(buffersRead);
 		
@@ -478,6 +598,7 @@ I3CLSimStepToTableConverter::FetchSteps(cl::Kernel kernel, I3RandomServicePtr rn
 					rsteps = I3CLSimStepSeriesPtr(new I3CLSimStepSeries);
 				rsteps->push_back(osteps[i]);
 				n_photons -= osteps[i].GetNumPhotons();
+				photonWeights -= osteps[i].GetNumPhotons()*osteps[i].GetWeight();
 				misses++;
 			}
 		}
@@ -494,53 +615,248 @@ I3CLSimStepToTableConverter::FetchSteps(cl::Kernel kernel, I3RandomServicePtr rn
 			// No steps ran out of space; reset the work list.
 			bunch.first.reset();
 		}
+		const bool bunchDone = !bunch.first;
 		
 
-		for (size_t i = 0; i < items; i++) {
-			size_t size = numEntries[i];
-			size_t offset = i*entriesPerStream_;
-			for (size_t j = 0; j < size; j++) {
-				binContent_[tableEntries[offset+j].index] += tableEntries[offset+j].weight;
-			}
-			if (squaredWeights_.size() > 0) {
+		{
+			// bin contents and weight sum are updated together so that
+			// checkpoints always see a consistent table
+			boost::unique_lock<boost::mutex> lock(worker->mutex);
+			std::vector<float> &binContent = worker->binContent;
+			std::vector<float> &squaredWeights = worker->squaredWeights;
+			for (size_t i = 0; i < items; i++) {
+				size_t size = numEntries[i];
+				size_t offset = i*entriesPerStream_;
 				for (size_t j = 0; j < size; j++) {
-					squaredWeights_[tableEntries[offset+j].index] += std::pow(tableEntries[offset+j].weight, 2);
+					binContent[tableEntries[offset+j].index] += tableEntries[offset+j].weight;
+				}
+				if (squaredWeights.size() > 0) {
+					for (size_t j = 0; j < size; j++) {
+						squaredWeights[tableEntries[offset+j].index] += std::pow(tableEntries[offset+j].weight, 2);
+					}
 				}
 			}
+			worker->sumOfPhotonWeights += photonWeights;
+		}
+		if (bunchDone) {
+			boost::unique_lock<boost::mutex> lock(pending_.mutex);
+			if (--pending_.count == 0)
+				pending_.cv.notify_all();
 		}
 		
 		stats.Record(kernelFinished[0], n_photons, real_steps, misses);
 	} // while (1)
 }
 
-void
-I3CLSimStepToTableConverter::Normalize()
+namespace {
+
+// number of absorption lengths to follow each photon for, like
+// PROPAGATE_FOR_FIXED_NUMBER_OF_ABSORPTION_LENGTHS in the OpenCL kernel
+const double absorptionLengthsToPropagate = 42.;
+
+// single-precision EPSILON of the OpenCL kernel
+const double propagationEpsilon = 1e-5;
+
+inline void
+transformDirection(const I3CLSimVectorTransform &transform, double dir[3])
 {
-	const unsigned ndim = axes_->GetNDim();
-	const std::vector<size_t> shape = axes_->GetShape();
-	const std::vector<size_t> strides = axes_->GetStrides();
-	std::vector<size_t> idxs(ndim, 0);
+	std::vector<double> vec(dir, dir+3);
+	vec = transform.ApplyTransform(vec);
+	std::copy(vec.begin(), vec.end(), dir);
+}
 
-	// NB: assume that the first 3 dimensions are spatial
-	const size_t spatial_stride = strides[2];
-	for (size_t offset = 0; offset < binContent_.size(); offset += spatial_stride) {
-		// unravel index
-		for (unsigned j=0; j < ndim; j++) {
-			// each dimension has an under- and an overflow bin.
-			idxs[j] = std::min(std::max(int(offset/strides[j] % shape[j])-1, 0), int(shape[j]-3));
-			assert(idxs[j] < shape[j]-2);
+}
+
+void
+I3CLSimStepToTableConverter::PropagateSteps(WorkerPtr worker)
+{
+	using clsim::tabulator::ScatterDirectionByAngle;
+	
+	I3RandomService &rng = *worker->rng;
+	const I3CLSimMediumProperties &medium = *mediumProperties_;
+	const I3CLSimFunction &angularAcceptance = *angularAcceptance_;
+	const I3CLSimRandomValue &scatteringCosAngle = *medium.GetScatteringCosAngleDistribution();
+	const I3CLSimScalarField &directionalAbsLenCorrection = *medium.GetDirectionalAbsorptionLengthCorrection();
+	const I3CLSimVectorTransform &preScatterTransform = *medium.GetPreScatterDirectionTransform();
+	const I3CLSimVectorTransform &postScatterTransform = *medium.GetPostScatterDirectionTransform();
+	const I3CLSimScalarField &tiltZShift = *medium.GetIceTiltZShift();
+	const std::vector<double> noParameters;
+	
+	const int numLayers = medium.GetLayersNum();
+	const double layerHeight = medium.GetLayersHeight();
+	const double layerZStart = medium.GetLayersZStart();
+	const bool tabulateImpactAngle = axes_->GetNDim() > 4;
+	const double minInvGroupVel = minimumRefractiveIndex_.first/I3Constants::c;
+	const double tanThetaC = std::sqrt(minimumRefractiveIndex_.second*minimumRefractiveIndex_.second-1.);
+	
+	// find the layer of a given z position (clamped to the medium)
+	auto findLayer = [&](double z) {
+		return std::min(std::max(int((z-layerZStart)/layerHeight), 0), numLayers-1);
+	};
+	
+	std::vector<double> coords(axes_->GetNDim());
+	
+	while (1) {
+		bunch_t bunch = stepQueue_.Get();
+		if (!bunch.first)
+			return;
+		
+		const clsim::tabulator::ReferenceSource source(*bunch.second, minInvGroupVel, tanThetaC);
+		double photonWeights = 0;
+		
+		// the whole bunch is binned at once, so checkpoints always see a
+		// consistent table
+		boost::unique_lock<boost::mutex> lock(worker->mutex);
+		std::vector<float> &binContent = worker->binContent;
+		std::vector<float> &squaredWeights = worker->squaredWeights;
+		
+		BOOST_FOREACH(const I3CLSimStep &step, *bunch.first) {
+			if (step.GetNumPhotons() == 0)
+				continue;
+			photonWeights += step.GetNumPhotons()*step.GetWeight();
+			
+			if (step.GetSourceType() >= wavelengthGenerators_.size())
+				log_fatal_stream("Step has source type " << unsigned(step.GetSourceType())
+				    << ", but only " << wavelengthGenerators_.size() << " spectra are configured");
+			const I3CLSimRandomValue &wavelengthGenerator = *wavelengthGenerators_[step.GetSourceType()];
+			
+			const double stepDir[3] = {
+			    std::sin(step.GetDirTheta())*std::cos(step.GetDirPhi()),
+			    std::sin(step.GetDirTheta())*std::sin(step.GetDirPhi()),
+			    std::cos(step.GetDirTheta()) };
+			
+			for (uint32_t photon = 0; photon < step.GetNumPhotons(); photon++) {
+				// create a new photon somewhere along the step
+				const double shift = step.GetLength()*rng.Uniform();
+				double posAndTime[4] = {
+				    step.GetPosX() + stepDir[0]*shift,
+				    step.GetPosY() + stepDir[1]*shift,
+				    step.GetPosZ() + stepDir[2]*shift,
+				    step.GetTime() + shift/(I3Constants::c*step.GetBeta()) };
+				double dir[3] = {stepDir[0], stepDir[1], stepDir[2]};
+				const double wlen = wavelengthGenerator.SampleFromDistribution(worker->rng, noParameters);
+				if (step.GetSourceType() == 0) {
+					// rotate Cherenkov photons onto the Cherenkov cone
+					const int layer = findLayer(posAndTime[2]);
+					const double cosCherenkov = std::min(1.,
+					    1./(step.GetBeta()*medium.GetPhaseRefractiveIndex(layer)->GetValue(wlen)));
+					ScatterDirectionByAngle(cosCherenkov, std::sqrt(1.-cosCherenkov*cosCherenkov),
+					    dir, rng.Uniform());
+				}
+				
+				const double invGroupVel = medium.GetGroupRefractiveIndexOverride(0)->GetValue(wlen)/I3Constants::c;
+				// randomize the first sub-step
+				double prevStepRemainder = stepLength_*(1.-rng.Uniform());
+				double absLensLeft = absorptionLengthsToPropagate;
+				double depthPropagated = 0.;
+				
+				while (absLensLeft >= propagationEpsilon) {
+					// track the photon to the next scattering point through
+					// the layers, along the lines of the PPC kernel
+					const double effectiveZ = posAndTime[2]
+					    - tiltZShift.GetValue(posAndTime[0], posAndTime[1], posAndTime[2]);
+					const int currentLayer = findLayer(effectiveZ);
+					
+					const double absLenCorrection = directionalAbsLenCorrection.GetValue(dir[0], dir[1], dir[2]);
+					absLensLeft *= absLenCorrection;
+					
+					double mediumBoundary = currentLayer*layerHeight + layerZStart
+					    + ((dir[2] < 0) ? 0. : layerHeight);
+					const double scaStepLeft = -std::log(1.-rng.Uniform());
+					double scaLen = medium.GetScatteringLength(currentLayer)->GetValue(wlen);
+					double absLen = medium.GetAbsorptionLength(currentLayer)->GetValue(wlen);
+					double ais = (dir[2]*scaStepLeft - (mediumBoundary-effectiveZ)/scaLen)/layerHeight;
+					double aia = (dir[2]*absLensLeft - (mediumBoundary-effectiveZ)/absLen)/layerHeight;
+					
+					int j = currentLayer;
+					if (dir[2] < 0) {
+						while (j > 0 && ais < 0 && aia < 0) {
+							--j;
+							mediumBoundary -= layerHeight;
+							scaLen = medium.GetScatteringLength(j)->GetValue(wlen);
+							absLen = medium.GetAbsorptionLength(j)->GetValue(wlen);
+							ais += 1./scaLen;
+							aia += 1./absLen;
+						}
+					} else {
+						while (j < numLayers-1 && ais > 0 && aia > 0) {
+							++j;
+							mediumBoundary += layerHeight;
+							scaLen = medium.GetScatteringLength(j)->GetValue(wlen);
+							absLen = medium.GetAbsorptionLength(j)->GetValue(wlen);
+							ais -= 1./scaLen;
+							aia -= 1./absLen;
+						}
+					}
+					
+					double distancePropagated, distanceToAbsorption;
+					if (j == currentLayer || std::abs(dir[2]) < propagationEpsilon) {
+						distancePropagated = scaStepLeft*scaLen;
+						distanceToAbsorption = absLensLeft*absLen;
+					} else {
+						distancePropagated = (ais*layerHeight*scaLen + mediumBoundary - effectiveZ)/dir[2];
+						distanceToAbsorption = (aia*layerHeight*absLen + mediumBoundary - effectiveZ)/dir[2];
+					}
+					if (distanceToAbsorption < distancePropagated) {
+						distancePropagated = distanceToAbsorption;
+						absLensLeft = 0.;
+					} else {
+						absLensLeft = (distanceToAbsorption-distancePropagated)/absLen;
+					}
+					absLensLeft /= absLenCorrection;
+					
+					// record the path in sub-steps, weighted by the
+					// angular acceptance and the survival probability
+					const double impactWeight = tabulateImpactAngle ?
+					    step.GetWeight() : step.GetWeight()*angularAcceptance.GetValue(dir[2]);
+					const double thisStepDepth = absorptionLengthsToPropagate-absLensLeft-depthPropagated;
+					double d = prevStepRemainder;
+					bool stop = false;
+					for (; d < distancePropagated; d += stepLength_) {
+						const double samplePos[4] = {
+						    posAndTime[0] + d*dir[0],
+						    posAndTime[1] + d*dir[1],
+						    posAndTime[2] + d*dir[2],
+						    posAndTime[3] + d*invGroupVel };
+						axes_->GetCoordinates(source, samplePos, dir, rng, &coords[0]);
+						if (axes_->IsOutOfBounds(&coords[0])) {
+							stop = true;
+							break;
+						}
+						const size_t index = axes_->GetBinIndex(&coords[0]);
+						const float weight = impactWeight
+						    *std::exp(-(depthPropagated + (d/distancePropagated)*thisStepDepth));
+						binContent[index] += weight;
+						if (!squaredWeights.empty())
+							squaredWeights[index] += weight*weight;
+					}
+					prevStepRemainder = d - distancePropagated;
+					if (stop)
+						absLensLeft = 0.;
+					depthPropagated = absorptionLengthsToPropagate-absLensLeft;
+					
+					for (unsigned i = 0; i < 3; i++)
+						posAndTime[i] += dir[i]*distancePropagated;
+					posAndTime[3] += invGroupVel*distancePropagated;
+					
+					if (absLensLeft >= propagationEpsilon) {
+						// not yet absorbed; scatter
+						transformDirection(preScatterTransform, dir);
+						const double cosScatAngle = scatteringCosAngle.SampleFromDistribution(worker->rng, noParameters);
+						ScatterDirectionByAngle(cosScatAngle,
+						    std::sqrt(std::max(0., 1.-cosScatAngle*cosScatAngle)), dir, rng.Uniform());
+						transformDirection(postScatterTransform, dir);
+					}
+				}
+			}
 		}
-		assert(idxs[ndim-1] == 0);
-		
-		// apply volume normalization to each spatial cell
-		double norm = axes_->GetBinVolume(idxs)/(stepLength_*domArea_);
-		for (size_t i=0; i < spatial_stride; i++)
-			binContent_[i+offset] /= norm;
-		// apply to squared weights as well if needed
-		if (squaredWeights_.size() > 0) {
-			norm *= norm;
-			for (size_t i=0; i < spatial_stride; i++)
-				squaredWeights_[i+offset] /= norm;
+		worker->sumOfPhotonWeights += photonWeights;
+		lock.unlock();
+		
+		{
+			boost::unique_lock<boost::mutex> lock(pending_.mutex);
+			if (--pending_.count == 0)
+				pending_.cv.notify_all();
 		}
 	}
 }
@@ -594,6 +910,179 @@ void write_pixels(fitsfile *fits, std::vector<size_t> &shape,
 }
 
 
+void
+I3CLSimStepToTableConverter::Normalize()
+{
+	const unsigned ndim = axes_->GetNDim();
+	const std::vector<size_t> shape = axes_->GetShape();
+	const std::vector<size_t> strides = axes_->GetStrides();
+
+	// NB: assume that the first 3 dimensions are spatial
+	const size_t spatial_stride = strides[2];
+	const size_t ncells = binContent_.size()/spatial_stride;
+	
+	// spatial cells are independent; normalize them in parallel
+	auto normalizeCells = [&](size_t firstCell, size_t lastCell) {
+		std::vector<size_t> idxs(ndim, 0);
+		for (size_t cell = firstCell; cell < lastCell; cell++) {
+			const size_t offset = cell*spatial_stride;
+			// unravel index
+			for (unsigned j=0; j < ndim; j++) {
+				// each dimension has an under- and an overflow bin.
+				idxs[j] = std::min(std::max(int(offset/strides[j] % shape[j])-1, 0), int(shape[j]-3));
+				assert(idxs[j] < shape[j]-2);
+			}
+			assert(idxs[ndim-1] == 0);
+			
+			// apply volume normalization to each spatial cell
+			double norm = axes_->GetBinVolume(idxs)/(stepLength_*domArea_);
+			for (size_t i=0; i < spatial_stride; i++)
+				binContent_[i+offset] /= norm;
+			// apply to squared weights as well if needed
+			if (squaredWeights_.size() > 0) {
+				norm *= norm;
+				for (size_t i=0; i < spatial_stride; i++)
+					squaredWeights_[i+offset] /= norm;
+			}
+		}
+	};
+	
+	const size_t nthreads = std::max(1u, std::min(boost::thread::hardware_concurrency(), unsigned(ncells)));
+	const size_t chunk = (ncells+nthreads-1)/nthreads;
+	boost::thread_group threads;
+	for (size_t first = 0; first < ncells; first += chunk)
+		threads.create_thread(boost::bind<void>(normalizeCells, first, std::min(first+chunk, ncells)));
+	threads.join_all();
+}
+
+void
+I3CLSimStepToTableConverter::WriteCheckpoint(const std::string &path, uint64_t numFrames)
+{
+	{
+		// wait for the harvesters to bin everything enqueued so far
+		boost::unique_lock<boost::mutex> lock(pending_.mutex);
+		while (pending_.count > 0)
+			pending_.cv.wait(lock);
+	}
+	
+	std::vector<float> binContent(binContent_);
+	std::vector<float> squaredWeights(squaredWeights_);
+	double sumOfPhotonWeights = sumOfPhotonWeights_;
+	BOOST_FOREACH(WorkerPtr &worker, workers_) {
+		boost::unique_lock<boost::mutex> lock(worker->mutex);
+		for (size_t i = 0; i < binContent.size(); i++)
+			binContent[i] += worker->binContent[i];
+		for (size_t i = 0; i < squaredWeights.size(); i++)
+			squaredWeights[i] += worker->squaredWeights[i];
+		sumOfPhotonWeights += worker->sumOfPhotonWeights;
+	}
+	
+	// write to a temporary file first, so that an interrupted write
+	// never clobbers the previous checkpoint
+	const std::string tmpPath = path + ".tmp";
+	fitsfile *fits;
+	int error = 0;
+	
+	unlink(tmpPath.c_str());
+	fits_create_diskfile(&fits, tmpPath.c_str(), &error);
+	if (error != 0) {
+		log_fatal_stream("Could not create " << tmpPath << ": " << error_text(error));
+	}
+	
+	std::vector<size_t> shape(axes_->GetShape());
+	create_image(fits, shape);
+	write_pixels(fits, shape, binContent);
+	fits_write_key(fits, TDOUBLE, "SUMW", &sumOfPhotonWeights,
+	    "sum of photon weights", &error);
+	LONGLONG numPhotons = numPhotons_;
+	fits_write_key(fits, TLONGLONG, "NPHOTONS", &numPhotons,
+	    "number of photons", &error);
+	LONGLONG frames = numFrames;
+	fits_write_key(fits, TLONGLONG, "NFRAMES", &frames,
+	    "number of frames in the table", &error);
+	if (error != 0) {
+		log_fatal_stream("Could not write checkpoint header keywords: " << error_text(error));
+	}
+	if (squaredWeights.size() > 0) {
+		create_image(fits, shape, "ERRORS");
+		write_pixels(fits, shape, squaredWeights);
+	}
+	
+	fits_close_file(fits, &error);
+	if (error != 0) {
+		log_fatal_stream("Could not close " << tmpPath << ": " << error_text(error));
+	}
+	if (rename(tmpPath.c_str(), path.c_str()) != 0) {
+		log_fatal_stream("Could not move " << tmpPath << " to " << path);
+	}
+	log_info_stream("Wrote checkpoint with "<<sumOfPhotonWeights<<" weighted photons from "
+	    <<numFrames<<" frames to "<<path);
+}
+
+uint64_t
+I3CLSimStepToTableConverter::ReadCheckpoint(const std::string &path)
+{
+	fitsfile *fits;
+	int error = 0;
+	
+	fits_open_diskfile(&fits, path.c_str(), READONLY, &error);
+	if (error != 0) {
+		log_fatal_stream("Could not open " << path << ": " << error_text(error));
+	}
+	
+	const std::vector<size_t> shape(axes_->GetShape());
+	std::vector<long> naxes(shape.size()+1, 0);
+	int naxis = 0;
+	fits_get_img_dim(fits, &naxis, &error);
+	fits_get_img_size(fits, naxes.size(), &naxes[0], &error);
+	if (error != 0) {
+		log_fatal_stream("Could not read image dimensions from " << path << ": " << error_text(error));
+	}
+	if (size_t(naxis) != shape.size() || !std::equal(shape.rbegin(), shape.rend(), naxes.begin(),
+	    [](size_t a, long b) { return long(a) == b; }))
+		log_fatal_stream(path << " has a different binning than this table");
+	
+	double sumOfPhotonWeights = 0;
+	LONGLONG numPhotons = 0, numFrames = 0;
+	fits_read_key(fits, TDOUBLE, "SUMW", &sumOfPhotonWeights, NULL, &error);
+	fits_read_key(fits, TLONGLONG, "NPHOTONS", &numPhotons, NULL, &error);
+	fits_read_key(fits, TLONGLONG, "NFRAMES", &numFrames, NULL, &error);
+	if (error != 0) {
+		log_fatal_stream(path << " is not a checkpoint: " << error_text(error));
+	}
+	
+	std::vector<float> pixels(binContent_.size());
+	std::vector<long> fpixel(shape.size(), 1);
+	int anynul = 0;
+	fits_read_pix(fits, TFLOAT, &fpixel[0], pixels.size(), NULL,
+	    &pixels[0], &anynul, &error);
+	if (error != 0) {
+		log_fatal_stream("Could not read bin contents from " << path << ": " << error_text(error));
+	}
+	for (size_t i = 0; i < binContent_.size(); i++)
+		binContent_[i] += pixels[i];
+	
+	if (squaredWeights_.size() > 0) {
+		char extname[] = "ERRORS";
+		fits_movnam_hdu(fits, IMAGE_HDU, extname, 0, &error);
+		fits_read_pix(fits, TFLOAT, &fpixel[0], pixels.size(), NULL,
+		    &pixels[0], &anynul, &error);
+		if (error != 0) {
+			log_fatal_stream("Could not read squared weights from " << path << ": " << error_text(error));
+		}
+		for (size_t i = 0; i < squaredWeights_.size(); i++)
+			squaredWeights_[i] += pixels[i];
+	}
+	sumOfPhotonWeights_ += sumOfPhotonWeights;
+	numPhotons_ += numPhotons;
+	
+	fits_close_file(fits, &error);
+	log_info_stream("Resuming from "<<path<<" with "<<sumOfPhotonWeights
+	    <<" weighted photons from "<<numFrames<<" frames");
+	
+	return numFrames;
+}
+
 void I3CLSimStepToTableConverter::WriteFITSFile(const std::string &path, boost::python::dict tableHeader)
 {
 	fitsfile *fits;
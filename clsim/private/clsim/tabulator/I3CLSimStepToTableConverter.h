@@ -43,6 +43,15 @@
 #include <boost/noncopyable.hpp>
 #include <boost/thread.hpp>
 
+/**
+ * @brief Propagates photons from steps and bins them into a table
+ *
+ * Each configured OpenCL device (GPU or CPU) is fed from a common step
+ * queue by its own harvester thread, which accumulates into a private
+ * copy of the table. The partial tables are merged in Finish().
+ * Without OpenCL devices, a pool of host threads propagates the photons
+ * itself and fills the same per-thread tables.
+ */
 class I3CLSimStepToTableConverter : boost::noncopyable {
 public:
 	I3CLSimStepToTableConverter(I3CLSimOpenCLDevice device,
@@ -54,6 +63,29 @@ public:
 	    I3CLSimFunctionConstPtr wavelengthAcceptance,
 	    I3CLSimFunctionConstPtr angularAcceptance,
 	    I3RandomServicePtr rng);
+	I3CLSimStepToTableConverter(const I3CLSimOpenCLDeviceSeries &devices,
+	    clsim::tabulator::AxesConstPtr axes, size_t entriesPerStream,
+	    bool storeSquaredWeights,
+	    I3CLSimMediumPropertiesConstPtr medium,
+	    I3CLSimSpectrumTableConstPtr spectrumTable,
+	    double referenceArea,
+	    I3CLSimFunctionConstPtr wavelengthAcceptance,
+	    I3CLSimFunctionConstPtr angularAcceptance,
+	    I3RandomServicePtr rng);
+	/**
+	 * Propagate photons on the host with *numThreads* threads (0 to use
+	 * one per core) instead of an OpenCL device. This does not support
+	 * ice models with birefringence.
+	 */
+	I3CLSimStepToTableConverter(unsigned numThreads,
+	    clsim::tabulator::AxesConstPtr axes,
+	    bool storeSquaredWeights,
+	    I3CLSimMediumPropertiesConstPtr medium,
+	    I3CLSimSpectrumTableConstPtr spectrumTable,
+	    double referenceArea,
+	    I3CLSimFunctionConstPtr wavelengthAcceptance,
+	    I3CLSimFunctionConstPtr angularAcceptance,
+	    I3RandomServicePtr rng);
 	virtual ~I3CLSimStepToTableConverter();
 	void EnqueueSteps(I3CLSimStepSeriesConstPtr, I3ParticleConstPtr);
 	void Finish();
@@ -62,21 +94,70 @@ public:
 	
 	void WriteFITSFile(const std::string &fname,
 	    boost::python::dict tableHeader);
+	
+	/**
+	 * Write the raw (unnormalized) table accumulated so far, together
+	 * with the number of frames it contains. Blocks until all steps
+	 * enqueued so far have been binned, so the caller must not enqueue
+	 * steps concurrently.
+	 */
+	void WriteCheckpoint(const std::string &fname, uint64_t numFrames);
+	/**
+	 * Add the contents of a checkpoint written by WriteCheckpoint() with
+	 * the same binning, e.g. to resume an interrupted run. Must be called
+	 * before Finish().
+	 *
+	 * @returns the number of frames contained in the checkpoint
+	 */
+	uint64_t ReadCheckpoint(const std::string &fname);
 private:
 	
-	void FetchSteps(cl::Kernel, I3RandomServicePtr);
+	/// Per-device OpenCL state (or host RNG) and partial table
+	struct Worker {
+		Worker() : sumOfPhotonWeights(0.) {}
+		cl::Context context;
+		cl::CommandQueue commandQueue;
+		cl::Kernel kernel;
+		/// initial MWC RNG state, drawn up front for reproducibility
+		std::vector<uint64_t> mwcX;
+		std::vector<uint32_t> mwcA;
+		/// random stream of a host worker, seeded up front for reproducibility
+		I3RandomServicePtr rng;
+		std::vector<float> binContent;
+		std::vector<float> squaredWeights;
+		double sumOfPhotonWeights;
+		boost::mutex mutex;
+		boost::thread thread;
+	};
+	typedef boost::shared_ptr<Worker> WorkerPtr;
+	
+	void Initialize(const I3CLSimOpenCLDeviceSeries &devices,
+	    unsigned numThreads,
+	    size_t entriesPerStream, bool storeSquaredWeights,
+	    I3CLSimMediumPropertiesConstPtr medium,
+	    I3CLSimSpectrumTableConstPtr spectrumTable,
+	    I3CLSimFunctionConstPtr wavelengthAcceptance,
+	    I3CLSimFunctionConstPtr angularAcceptance,
+	    I3RandomServicePtr rng);
+	void FetchSteps(WorkerPtr);
+	/// host-side equivalent of FetchSteps() and the TABULATE kernel
+	void PropagateSteps(WorkerPtr);
 	
 	float GetBinVolume(size_t i);
 	void Normalize();
 	
-	cl::Context context_;
-	cl::CommandQueue commandQueue_;
+	std::vector<WorkerPtr> workers_;
 	size_t maxWorkgroupSize_, maxNumWorkitems_, entriesPerStream_;
 	
+	/// an empty bunch tells a harvester thread to exit
 	typedef std::pair<I3CLSimStepSeriesConstPtr, I3ParticleConstPtr> bunch_t;
 	I3CLSimQueue<bunch_t> stepQueue_;
-	boost::thread harvesterThread_;
-	bool run_;
+	/// number of enqueued bunches that have not been binned completely
+	struct {
+		boost::mutex mutex;
+		boost::condition_variable cv;
+		size_t count;
+	} pending_;
 	
 	double domArea_;
 	double stepLength_;
@@ -86,12 +167,17 @@ private:
 	clsim::tabulator::AxesConstPtr axes_;
 	std::vector<float> binContent_;
 	std::vector<float> squaredWeights_;
-	// double rather than an integer because steps have weights
 	uint64_t numPhotons_;
+	// double rather than an integer because steps have weights
 	double sumOfPhotonWeights_;
 	/// number of Photonics photons represented by each clsim photon
 	double spectralBiasFactor_;
 	
+	/// what the host workers need to propagate photons
+	I3CLSimMediumPropertiesConstPtr mediumProperties_;
+	I3CLSimFunctionConstPtr angularAcceptance_;
+	std::vector<I3CLSimRandomValueConstPtr> wavelengthGenerators_;
+	
 	SET_LOGGER("I3CLSimStepToTableConverter");
 };
 
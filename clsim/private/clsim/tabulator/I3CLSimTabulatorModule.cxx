@@ -70,12 +70,17 @@ private:
 	I3CLSimOpenCLDeviceSeries openCLDeviceList_;
 	double referenceArea_;
 	size_t photonsPerBunch_, entriesPerPhoton_;
+	unsigned numberOfThreads_;
 	bool recordErrors_;
 	
 	I3CLSimLightSourceToStepConverterPtr particleToStepsConverter_;
 	boost::scoped_ptr<I3CLSimStepToTableConverter> tabulator_;
 	
 	std::string tablePath_;
+	std::string checkpointPath_;
+	unsigned checkpointInterval_, framesSinceCheckpoint_;
+	/// frames already contained in the checkpoint we resumed from
+	uint64_t framesToSkip_, framesSkipped_;
 	boost::python::dict tableHeader_;
 	clsim::tabulator::AxesPtr axes_;
 	
@@ -83,9 +88,11 @@ private:
 	struct {
 		boost::mutex mutex;
 		boost::condition_variable cv;
+		/// frames handed to the step converter / whose steps reached the tabulator
+		uint64_t queued, harvested;
 	} semaphore;
+	/// reference particle of each frame, a null pointer stops the harvester
 	I3CLSimQueue<I3ParticleConstPtr> sourceQueue_;
-	bool run_;
 	
 	SET_LOGGER("I3CLSimTabulatorModule");
 };
@@ -93,8 +100,9 @@ private:
 I3_MODULE(I3CLSimTabulatorModule);
 
 I3CLSimTabulatorModule::I3CLSimTabulatorModule(const I3Context &ctx)
-    : I3Module(ctx), run_(true)
+    : I3Module(ctx), framesSinceCheckpoint_(0), framesToSkip_(0), framesSkipped_(0)
 {
+	semaphore.queued = semaphore.harvested = 0;
 	AddOutBox("OutBox");
 	
 	AddParameter("MCTreeName", "", "I3MCTree");
@@ -107,12 +115,19 @@ I3CLSimTabulatorModule::I3CLSimTabulatorModule(const I3Context &ctx)
 	AddParameter("ParameterizationList","", parameterizationList_);
 	AddParameter("SpectrumTable", "", spectrumTable_);
 	AddParameter("OpenCLDeviceList", "", openCLDeviceList_);
+	AddParameter("NumberOfThreads", "Number of host threads that propagate "
+	    "photons if OpenCLDeviceList is empty (0: one per core)", 0u);
 	AddParameter("PhotonsPerBunch", "", 200);
 	AddParameter("EntriesPerPhoton", "", 3000);
 	AddParameter("Filename", "", "");
 	AddParameter("RecordErrors", "", false);
 	AddParameter("TableHeader", "", boost::python::dict());
 	AddParameter("Axes", "", axes_);
+	AddParameter("CheckpointFilename", "Periodically save the raw table and the "
+	    "number of processed frames here. If the file exists, tabulation resumes "
+	    "from it and skips the frames it already contains; use a different random "
+	    "seed for the resumed run. The file is removed once the table is written.", "");
+	AddParameter("CheckpointInterval", "Number of frames between checkpoints", 100);
 }
 
 void I3CLSimTabulatorModule::Configure()
@@ -127,12 +142,15 @@ void I3CLSimTabulatorModule::Configure()
 	GetParameter("ParameterizationList",parameterizationList_);
 	GetParameter("SpectrumTable", spectrumTable_);
 	GetParameter("OpenCLDeviceList",openCLDeviceList_);
+	GetParameter("NumberOfThreads", numberOfThreads_);
 	GetParameter("PhotonsPerBunch", photonsPerBunch_);
 	GetParameter("EntriesPerPhoton", entriesPerPhoton_);
 	GetParameter("Filename", tablePath_);
 	GetParameter("RecordErrors", recordErrors_);
 	GetParameter("TableHeader", tableHeader_);
 	GetParameter("Axes", axes_);
+	GetParameter("CheckpointFilename", checkpointPath_);
+	GetParameter("CheckpointInterval", checkpointInterval_);
 	
 	if (tablePath_.empty())
 		log_fatal("You must specify an output filename!");
@@ -145,15 +163,23 @@ void I3CLSimTabulatorModule::Configure()
 	}
 	fs::remove(tablePath_);
 	
-	if (openCLDeviceList_.size() == 0)
-		log_fatal_stream("No OpenCL devices provided. Does your OpenCL runtime support CPUs?");
-	
-	tabulator_.reset(
-	    new I3CLSimStepToTableConverter(
-	    openCLDeviceList_[0], axes_, entriesPerPhoton_*photonsPerBunch_,
-	    recordErrors_,
-	    mediumProperties_, spectrumTable_, referenceArea_,
-	    wavelengthGenerationBias_, angularAcceptance_, randomService_));
+	if (openCLDeviceList_.size() == 0) {
+		log_info("No OpenCL devices provided, propagating photons on the host");
+		tabulator_.reset(
+		    new I3CLSimStepToTableConverter(
+		    numberOfThreads_, axes_, recordErrors_,
+		    mediumProperties_, spectrumTable_, referenceArea_,
+		    wavelengthGenerationBias_, angularAcceptance_, randomService_));
+	} else {
+		tabulator_.reset(
+		    new I3CLSimStepToTableConverter(
+		    openCLDeviceList_, axes_, entriesPerPhoton_*photonsPerBunch_,
+		    recordErrors_,
+		    mediumProperties_, spectrumTable_, referenceArea_,
+		    wavelengthGenerationBias_, angularAcceptance_, randomService_));
+	}
+	if (!checkpointPath_.empty() && fs::exists(checkpointPath_))
+		framesToSkip_ = tabulator_->ReadCheckpoint(checkpointPath_);
 	
 	particleToStepsConverter_ =
 	    I3CLSimModuleHelper::initializeGeant4(randomService_,
@@ -196,9 +222,8 @@ namespace {
 void I3CLSimTabulatorModule::Finish()
 {
 	log_trace("finish called");
-	run_ = false;
-	if (!particleToStepsConverter_->BarrierActive())
-		particleToStepsConverter_->EnqueueBarrier();
+	// stop the harvester once it is done with the last frame
+	sourceQueue_.Put(I3ParticleConstPtr());
 	{
 		// Release the GIL while we wait
 		ScopedGILRelease release;
@@ -207,6 +232,9 @@ void I3CLSimTabulatorModule::Finish()
 	}
 	
 	tabulator_->WriteFITSFile(tablePath_, tableHeader_);
+	// the run is complete, a rerun must not resume from here
+	if (!checkpointPath_.empty())
+		fs::remove(checkpointPath_);
 }
 
 I3CLSimTabulatorModule::~I3CLSimTabulatorModule()
@@ -220,6 +248,8 @@ void I3CLSimTabulatorModule::HarvestSteps()
 	// Get the first reference source. This will block until something is
 	// added to the queue.
 	I3ParticleConstPtr reference = sourceQueue_.Get();
+	if (!reference)
+		return;
 	for (;;) {
 		I3CLSimStepSeriesConstPtr steps;
 		bool barrierWasJustReset=false;
@@ -232,14 +262,17 @@ void I3CLSimTabulatorModule::HarvestSteps()
 		}
 		
 		if (barrierWasJustReset) {
-			if (!run_) {
-				log_trace("Exiting on barrier");
+			{
+				boost::unique_lock<boost::mutex> lock(semaphore.mutex);
+				semaphore.harvested++;
+			}
+			// Signal main thread to continue
+			semaphore.cv.notify_one();
+			// Get the reference source for the next frame
+			reference = sourceQueue_.Get();
+			if (!reference) {
+				log_trace("Exiting after the last frame");
 				return;
-			} else {
-				// Signal main thread to continue
-				semaphore.cv.notify_one();
-				// Get the reference source for the next frame
-				reference = sourceQueue_.Get();
 			}
 		}
 	}
@@ -248,6 +281,12 @@ void I3CLSimTabulatorModule::HarvestSteps()
 
 void I3CLSimTabulatorModule::DAQ(I3FramePtr frame)
 {
+	// these frames are already in the checkpoint we resumed from
+	if (framesSkipped_ < framesToSkip_) {
+		framesSkipped_++;
+		return;
+	}
+	
 	I3MCTreeConstPtr mctree;
 	I3CLSimFlasherPulseSeriesConstPtr flashers;
 	I3ParticleConstPtr reference = frame->Get<I3ParticleConstPtr>("ReferenceParticle");
@@ -259,10 +298,18 @@ void I3CLSimTabulatorModule::DAQ(I3FramePtr frame)
 		ScopedGILRelease release;
 		// Wait for steps from the previous event to be consumed
 		boost::unique_lock<boost::mutex> lock(semaphore.mutex);
-		while (particleToStepsConverter_->BarrierActive())
+		while (semaphore.harvested < semaphore.queued)
 			semaphore.cv.wait(lock);
 	}
 	
+	if (!checkpointPath_.empty() && checkpointInterval_ > 0
+	    && ++framesSinceCheckpoint_ >= checkpointInterval_) {
+		ScopedGILRelease release;
+		// all previous frames have been handed to the tabulator
+		tabulator_->WriteCheckpoint(checkpointPath_, framesToSkip_ + semaphore.queued);
+		framesSinceCheckpoint_ = 0;
+	}
+	
 	// Enqueue a copy to ensure that the deleter does not invoke the Python interpreter
 	sourceQueue_.Put(I3ParticlePtr(new I3Particle(*reference)));
 	if ((mctree = frame->Get<I3MCTreeConstPtr>(mctreeName_))) {
@@ -278,6 +325,10 @@ void I3CLSimTabulatorModule::DAQ(I3FramePtr frame)
 		}
 	}
 
+	{
+		boost::unique_lock<boost::mutex> lock(semaphore.mutex);
+		semaphore.queued++;
+	}
 	particleToStepsConverter_->EnqueueBarrier();
 }
 
@@ -161,6 +161,7 @@ def I3CLSimTabulatePhotons(tray, name,
                        AngularAcceptance=None,
                        UseHoleIceParameterization=True,
                        OverrideApproximateNumberOfWorkItems=None,
+                       NumberOfThreads=None,
                        ExtraArgumentsToI3CLSimModule=dict(),
                        If=lambda f: True
                        ):
@@ -282,6 +283,10 @@ def I3CLSimTabulatePhotons(tray, name,
     :param OverrideApproximateNumberOfWorkItems:
         Allows to override the auto-detection for the maximum number of parallel work items.
         You should only change this if you know what you are doing.
+    :param NumberOfThreads:
+        If not None, propagate photons with this many host threads (0 for
+        one per core) instead of on OpenCL devices. This works without
+        any OpenCL device, but does not support birefringent ice models.
     :param If:
         Python function to use as conditional execution test for segment modules.        
     """
@@ -405,13 +410,17 @@ def I3CLSimTabulatePhotons(tray, name,
         # no spectrum table is necessary when only using the Cherenkov spectrum
         spectrumTable = None
 
-    openCLDevices = configureOpenCLDevices(
-        UseGPUs=UseGPUs,
-        UseCPUs=UseCPUs,
-        OverrideApproximateNumberOfWorkItems=OverrideApproximateNumberOfWorkItems,
-        DoNotParallelize=DoNotParallelize,
-        UseOnlyDeviceNumber=UseOnlyDeviceNumber
-	)
+    if NumberOfThreads is None:
+        openCLDevices = configureOpenCLDevices(
+            UseGPUs=UseGPUs,
+            UseCPUs=UseCPUs,
+            OverrideApproximateNumberOfWorkItems=OverrideApproximateNumberOfWorkItems,
+            DoNotParallelize=DoNotParallelize,
+            UseOnlyDeviceNumber=UseOnlyDeviceNumber
+            )
+    else:
+        # an empty device list makes the module propagate on the host
+        openCLDevices = []
     
     tray.AddModule("I3CLSimTabulatorModule", name + "_clsim",
                    MCTreeName=clSimMCTreeName,
@@ -425,6 +434,7 @@ def I3CLSimTabulatePhotons(tray, name,
                    ParameterizationList=particleParameterizations,
                    # MaxNumParallelEvents=ParallelEvents,
                    OpenCLDeviceList=openCLDevices,
+                   NumberOfThreads=NumberOfThreads or 0,
                    **ExtraArgumentsToI3CLSimModule
                    )
     
@@ -434,7 +444,8 @@ def I3CLSimTabulatePhotons(tray, name,
 def TabulatePhotonsFromSource(tray, name, PhotonSource="cascade", Zenith=0.*I3Units.degree, Azimuth=0.*I3Units.degree, ZCoordinate=0.*I3Units.m,
     Energy=1.*I3Units.GeV, FlasherWidth=127, FlasherBrightness=127, Seed=12345, NEvents=100,
     IceModel='spice_mie', DisableTilt=False, Filename="", TabulateImpactAngle=False,
-    PhotonPrescale=1, Axes=None, Directions=None, Sensor='DOM', RecordErrors=False):
+    PhotonPrescale=1, Axes=None, Directions=None, Sensor='DOM', RecordErrors=False,
+    CheckpointFilename="", CheckpointInterval=100, NumberOfThreads=None):
     
     """
     Tabulate the distribution of photoelectron yields on IceCube DOMs from various
@@ -484,6 +495,11 @@ def TabulatePhotonsFromSource(tray, name, PhotonSource="cascade", Zenith=0.*I3Un
                  If None, an appropriate default will be chosen based on **PhotonSource**.
     :param Directions: a set of directions to allow table generation for multiple sources.
                  If None, only one direction given by **Zenith** and **Azimuth** is used.
+    :param CheckpointFilename: periodically save the raw table here. If the file
+                 exists, an interrupted run resumes from it; pass a different **Seed**.
+    :param CheckpointInterval: number of events between checkpoints
+    :param NumberOfThreads: if not None, propagate photons with this many host
+                 threads (0 for one per core) instead of an OpenCL CPU device
        """
 
     # check sanity of args
@@ -682,7 +698,9 @@ def TabulatePhotonsFromSource(tray, name, PhotonSource="cascade", Zenith=0.*I3Un
         DoNotParallelize=True,                      # no multithreading
         UseGeant4=False,
         OverrideApproximateNumberOfWorkItems=1,     # if you *would* use multi-threading, this would be the maximum number of jobs to run in parallel (OpenCL is free to split them)
+        NumberOfThreads=NumberOfThreads,
         ExtraArgumentsToI3CLSimModule=dict(Filename=Filename, TableHeader=header,
-            Axes=Axes, PhotonsPerBunch=200, EntriesPerPhoton=5000, RecordErrors=RecordErrors),
+            Axes=Axes, PhotonsPerBunch=200, EntriesPerPhoton=5000, RecordErrors=RecordErrors,
+            CheckpointFilename=CheckpointFilename, CheckpointInterval=CheckpointInterval),
         MediumProperties=parseIceModel(expandvars("$I3_BUILD/ice-models/resources/models/" + IceModel), disableTilt=DisableTilt),
     )
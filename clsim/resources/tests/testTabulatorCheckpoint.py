@@ -0,0 +1,85 @@
+#!/usr/bin/env python
+
+"""
+Interrupt a tabulation run after it wrote a checkpoint, resume it, and check
+that the resumed table contains every event exactly once and that the
+checkpoint is removed once the table is complete.
+"""
+
+from __future__ import print_function
+import os
+import sys
+import shutil
+import subprocess
+import tempfile
+import threading
+import time
+
+from I3Tray import I3Tray
+from icecube import icetray, dataclasses, clsim
+
+try:
+    from icecube.clsim.tablemaker.tabulator import TabulatePhotonsFromSource
+    from icecube.photospline.photonics import FITSTable
+except ImportError as e:
+    print("skipping: %s" % e)
+    sys.exit(0)
+
+if not [d for d in clsim.I3CLSimOpenCLDevice.GetAllDevices() if d.cpu]:
+    print("skipping: no OpenCL CPU device")
+    sys.exit(0)
+
+try:
+    import pyfits
+except ImportError:
+    import astropy.io.fits as pyfits
+
+def tabulate(filename, seed, nevents, checkpoint=""):
+    axes = clsim.tabulator.SphericalAxes([
+        clsim.tabulator.PowerAxis(0, 100, 10, 2),
+        clsim.tabulator.LinearAxis(0, 180, 6),
+        clsim.tabulator.LinearAxis(-1, 1, 10),
+        clsim.tabulator.PowerAxis(0, 1000, 10, 2),
+    ])
+    tray = I3Tray()
+    tray.AddSegment(TabulatePhotonsFromSource, "tabulator",
+        PhotonSource="cascade", Energy=1.*icetray.I3Units.GeV, Seed=seed,
+        NEvents=nevents, Filename=filename, Axes=axes,
+        CheckpointFilename=checkpoint, CheckpointInterval=2)
+    tray.Execute()
+
+if len(sys.argv) > 1 and sys.argv[1] == "interrupt":
+    # simulate a job that is killed as soon as its first checkpoint exists
+    filename, checkpoint = sys.argv[2:4]
+    def kill():
+        while not os.path.exists(checkpoint):
+            time.sleep(0.01)
+        os._exit(0)
+    watcher = threading.Thread(target=kill)
+    watcher.daemon = True
+    watcher.start()
+    tabulate(filename, 1, 1000, checkpoint)
+    sys.exit(1)
+
+tmpdir = tempfile.mkdtemp()
+try:
+    checkpoint = os.path.join(tmpdir, "checkpoint.fits")
+    subprocess.check_call([sys.executable, __file__, "interrupt",
+        os.path.join(tmpdir, "interrupted.fits"), checkpoint])
+    assert os.path.exists(checkpoint), "interrupted run left a checkpoint"
+    frames = pyfits.getheader(checkpoint)["NFRAMES"]
+    assert frames > 0, "checkpoint contains processed frames"
+    
+    nevents = frames + 3
+    tabulate(os.path.join(tmpdir, "resumed.fits"), 2, nevents, checkpoint)
+    assert not os.path.exists(checkpoint), "checkpoint is removed after the table was written"
+    
+    tabulate(os.path.join(tmpdir, "reference.fits"), 3, nevents)
+    
+    resumed = FITSTable.load(os.path.join(tmpdir, "resumed.fits")).header["n_photons"]
+    reference = FITSTable.load(os.path.join(tmpdir, "reference.fits")).header["n_photons"]
+    print("%d events resumed after %d: %g photons, uninterrupted: %g photons" % (nevents, frames, resumed, reference))
+    # replaying the frames in the checkpoint would add at least 1/4 more
+    assert abs(resumed/reference - 1) < 0.05, "resumed table contains every event once"
+finally:
+    shutil.rmtree(tmpdir)
@@ -0,0 +1,59 @@
+#!/usr/bin/env python
+
+"""
+Tabulate a few cascades with host threads instead of an OpenCL device and
+check that both the bin contents and the squared weights are filled. If an
+OpenCL CPU device is available, check that it yields the same total as the
+host threads.
+"""
+
+from __future__ import print_function
+import os
+import sys
+import shutil
+import tempfile
+
+from I3Tray import I3Tray
+from icecube import icetray, dataclasses, clsim
+
+try:
+    from icecube.clsim.tablemaker.tabulator import TabulatePhotonsFromSource
+except ImportError as e:
+    print("skipping: %s" % e)
+    sys.exit(0)
+
+try:
+    import pyfits
+except ImportError:
+    import astropy.io.fits as pyfits
+import numpy
+
+def tabulate(filename, seed, nthreads):
+    axes = clsim.tabulator.SphericalAxes([
+        clsim.tabulator.PowerAxis(0, 100, 10, 2),
+        clsim.tabulator.LinearAxis(0, 180, 6),
+        clsim.tabulator.LinearAxis(-1, 1, 10),
+        clsim.tabulator.PowerAxis(0, 1000, 10, 2),
+    ])
+    tray = I3Tray()
+    tray.AddSegment(TabulatePhotonsFromSource, "tabulator",
+        PhotonSource="cascade", Energy=1.*icetray.I3Units.GeV, Seed=seed,
+        NEvents=5, Filename=filename, Axes=axes, RecordErrors=True,
+        NumberOfThreads=nthreads)
+    tray.Execute()
+    hdus = pyfits.open(filename)
+    return hdus[0].data, hdus["ERRORS"].data
+
+tmpdir = tempfile.mkdtemp()
+try:
+    values, errors = tabulate(os.path.join(tmpdir, "host.fits"), 1, 2)
+    assert numpy.isfinite(values).all() and numpy.isfinite(errors).all()
+    assert values.sum() > 0, "host threads fill the table"
+    assert errors.sum() > 0 and (errors[values == 0] == 0).all(), "host threads fill the squared weights"
+
+    if [d for d in clsim.I3CLSimOpenCLDevice.GetAllDevices() if d.cpu]:
+        reference, _ = tabulate(os.path.join(tmpdir, "opencl.fits"), 2, None)
+        print("host threads: %g, OpenCL: %g" % (values.sum(), reference.sum()))
+        assert abs(values.sum()/reference.sum() - 1) < 0.1, "host threads agree with OpenCL"
+finally:
+    shutil.rmtree(tmpdir)
@@ -17,6 +17,7 @@
 #include <dataclasses/I3MapOMKeyUnion.h>
 #include <dataclasses/I3RecoPulseSeriesMapApplySPECorrection.h>
 #include <dataclasses/physics/I3RecoPulseSeriesMapCombineByModule.h>
+#include <dataclasses/physics/I3RecoPulseSeriesMapFlat.h>
 #include <dataclasses/physics/I3RecoHit.h>
 #include <dataclasses/physics/I3RecoPulse.h>
 #include <dataclasses/payload/I3SuperDST.h>
@@ -30,9 +31,9 @@ static I3RecoPulseSeriesMapPtr HitsAsPulses(I3RecoHitSeriesMapConstPtr hits);
 
 /*
  * Only a little bit evil: Specialize the I3Frame::Get() to apply
- * a mask behind the scenes. This lets client code treat masks
- * and SuperDST payloads (and masked SuperDST payloads)
- * just like I3RecoPulseSeriesMaps.
+ * a mask behind the scenes. This lets client code treat masks,
+ * SuperDST payloads (and masked SuperDST payloads) and flattened
+ * pulse maps just like I3RecoPulseSeriesMaps.
  */ 
 template <>
 I3RecoPulseSeriesMapConstPtr
@@ -71,6 +72,12 @@ I3Frame::Get(const std::string& name, void*, void*) const
 			return combined->Apply(*this);
 	}
 	
+	I3RecoPulseSeriesMapFlatConstPtr flat = 
+	    boost::dynamic_pointer_cast<const I3RecoPulseSeriesMapFlat>(focp);
+	
+	if (flat)
+		return flat->Unpack();
+	
 	I3SuperDSTConstPtr superdst = 
 	    boost::dynamic_pointer_cast<const I3SuperDST>(focp);
 	
@@ -451,30 +451,66 @@ I3RecoPulseSeriesMapMask::operator!=(const I3RecoPulseSeriesMapMask &other) cons
 	return !operator==(other);
 }
 
+static bool
+SameObject(const I3FrameObjectConstPtr &current,
+    const boost::weak_ptr<const I3FrameObject> &cached)
+{
+	return cached.lock() == current;
+}
+
 boost::shared_ptr<const I3RecoPulseSeriesMap>
 I3RecoPulseSeriesMapMask::Apply(const I3Frame &frame) const
 {
-	if (masked_)
-		return masked_;
+	/* Walk up to the first ancestor that is not a mask */
+	std::vector<I3FrameObjectConstPtr> inputs;
+	std::string root = key_;
+	I3RecoPulseSeriesMapMaskConstPtr parent;
+	while ((parent = frame.Get<I3RecoPulseSeriesMapMaskConstPtr>(root))) {
+		if (inputs.size() >= frame.size())
+			log_fatal("The mask chain starting at '%s' is circular!",
+			    key_.c_str());
+		inputs.push_back(parent);
+		root = parent->GetSource();
+	}
 	
 	boost::shared_ptr<const I3RecoPulseSeriesMap> source =
-	    frame.Get<boost::shared_ptr<const I3RecoPulseSeriesMap> >(key_);
+	    frame.Get<boost::shared_ptr<const I3RecoPulseSeriesMap> >(root);
 	
 	if (!source)
-		log_fatal("The map named '%s' doesn't exist in the frame!\n", key_.c_str());
-	if (source->size() != omkey_mask_.size())
+		log_fatal("The map named '%s' doesn't exist in the frame!\n", root.c_str());
+	inputs.push_back(source);
+	
+	if (masked_ && masked_inputs_.size() == inputs.size() &&
+	    std::equal(inputs.begin(), inputs.end(), masked_inputs_.begin(),
+	    SameObject))
+		return masked_;
+	
+	if (inputs.size() == 1)
+		masked_ = ApplyTo(*source, root);
+	else
+		masked_ = Repoint(frame, root)->ApplyTo(*source, root);
+	masked_inputs_.assign(inputs.begin(), inputs.end());
+	
+	return masked_;
+}
+
+I3RecoPulseSeriesMapPtr
+I3RecoPulseSeriesMapMask::ApplyTo(const I3RecoPulseSeriesMap &source,
+    const std::string &name) const
+{
+	if (source.size() != omkey_mask_.size())
 		log_fatal("This mask was made from a map with %zu keys, but "
 		    "the map named '%s' has %zu keys.", omkey_mask_.size(),
-		    key_.c_str(), source->size());
+		    name.c_str(), source.size());
 	
-	masked_ = boost::make_shared<I3RecoPulseSeriesMap>();
+	I3RecoPulseSeriesMapPtr masked = boost::make_shared<I3RecoPulseSeriesMap>();
 	
-	I3RecoPulseSeriesMap::const_iterator source_it = source->begin();
-	I3RecoPulseSeriesMap::iterator inserter = masked_->begin();
+	I3RecoPulseSeriesMap::const_iterator source_it = source.begin();
+	I3RecoPulseSeriesMap::iterator inserter = masked->begin();
 	std::list<bitmask>::const_iterator list_it = element_masks_.begin();
 	unsigned omkey_idx = 0;
 	
-	for ( ; source_it != source->end(); source_it++, omkey_idx++) {
+	for ( ; source_it != source.end(); source_it++, omkey_idx++) {
 		
 		if (!omkey_mask_.get(omkey_idx))
 			continue;
@@ -498,13 +534,13 @@ I3RecoPulseSeriesMapMask::Apply(const I3Frame &frame) const
 			if (list_it->get(idx))
 				target_vec.push_back(*source_vit);
 				
-		inserter = masked_->insert(inserter,
+		inserter = masked->insert(inserter,
 		    std::make_pair(source_it->first, target_vec));
 			
 		list_it++;
 	}
 	
-	return masked_;
+	return masked;
 }
 
 struct null_deleter
@@ -561,7 +597,15 @@ I3RecoPulseSeriesMapMask::CollapseLevel(const I3Frame &frame) const
 	    source_idx++) {
 		if (source->omkey_mask_.get(source_idx)) {
 			if (source_element->any()) {
+				if (idx >= omkey_mask_.size())
+					log_fatal("This mask was made from a map with %zu keys, but "
+					    "the mask named '%s' selects more.", omkey_mask_.size(),
+					    key_.c_str());
 				if (omkey_mask_.get(idx)) {
+					if (element->size() != source_element->sum())
+						log_fatal("A mask has %zu entries for an OM where "
+						    "the mask named '%s' selects %u.", element->size(),
+						    key_.c_str(), source_element->sum());
 					unsigned pidx = 0;
 					for (unsigned source_pidx = 0; source_pidx < source_element->size(); source_pidx++) {
 						if (source_element->get(source_pidx)) {
@@ -589,6 +633,11 @@ I3RecoPulseSeriesMapMask::CollapseLevel(const I3Frame &frame) const
 		}
 	}
 	
+	if (idx != omkey_mask_.size())
+		log_fatal("This mask was made from a map with %zu keys, but "
+		    "the mask named '%s' selects %u.", omkey_mask_.size(),
+		    key_.c_str(), idx);
+	
 	return collapsed;
 }
 
@@ -31,17 +31,27 @@ I3RecoPulseSeriesMapUnion::Apply(const I3Frame &frame) const
 	typedef Pair::second_type Series;
 	typedef Series::value_type Element;
 	
-	if (unified_)
-		return unified_;
-	
-	unified_ = boost::make_shared<Map>();
-	
+	std::vector<MapConstPtr> sources;
 	BOOST_FOREACH(const std::string &key, keys_) {
 		MapConstPtr pmap = frame.Get<MapConstPtr>(key);
 		if (!pmap)
 			log_fatal("Couldn't find '%s' in the frame!",
 			    key.c_str());
-		
+		sources.push_back(pmap);
+	}
+	
+	if (unified_ && unified_inputs_.size() == sources.size()) {
+		bool same = true;
+		for (size_t i = 0; i < sources.size() && same; i++)
+			same = (unified_inputs_[i].lock() == sources[i]);
+		if (same)
+			return unified_;
+	}
+	
+	unified_ = boost::make_shared<Map>();
+	unified_inputs_.assign(sources.begin(), sources.end());
+	
+	BOOST_FOREACH(const MapConstPtr &pmap, sources) {
 		BOOST_FOREACH(const Pair &pair, *pmap) {
 			Series &univec = (*unified_)[pair.first];
 			BOOST_FOREACH(const Element &element, pair.second)
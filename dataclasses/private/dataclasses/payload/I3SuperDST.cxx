@@ -293,76 +293,140 @@ I3SuperDST::I3SuperDST(const I3RecoPulseSeriesMap &pulses)
 	InitDebug();
 }
 
-/* Expand charge stamps into fake I3RecoPulses */
-I3RecoPulseSeriesMapConstPtr
-I3SuperDST::Unpack() const
+void
+I3SuperDSTPulseColumns::clear()
 {
-	if (unpacked_)
-		return unpacked_;
+	doms.clear();
+	offsets.clear();
+	times.clear();
+	charges.clear();
+	widths.clear();
+	flags.clear();
+}
+
+namespace {
+
+/* Orders indices into a time column like TimeOrdering orders pulses */
+struct IndexTimeOrdering {
+	const double *times;
+	IndexTimeOrdering(const double *t) : times(t) {}
+	bool operator()(uint32_t i, uint32_t j) const
+	{ return times[i] < times[j]; }
+};
+
+}
 
+/* Expand charge stamps into columns of fake I3RecoPulses */
+void
+I3SuperDST::UnpackColumns(I3SuperDSTPulseColumns &columns) const
+{
 	std::vector<I3SuperDSTChargeStamp>::const_iterator stamp_it;
 	std::list<I3SuperDSTReadout>::const_iterator readout_it;
-	double t_ref;
 	
-	unpacked_ = I3RecoPulseSeriesMapPtr(new I3RecoPulseSeriesMap);
-
-	t_ref = tmin_;
+	columns.clear();
+	
+	/* The DOMs in map order, and the number of pulses on each */
+	for (readout_it = readouts_.begin(); readout_it != readouts_.end(); readout_it++)
+		columns.doms.push_back(readout_it->om_);
+	std::sort(columns.doms.begin(), columns.doms.end());
+	columns.doms.erase(std::unique(columns.doms.begin(), columns.doms.end()),
+	    columns.doms.end());
 	
+	columns.offsets.assign(columns.doms.size()+1, 0);
+	columns.readout_doms_.clear();
 	for (readout_it = readouts_.begin(); readout_it != readouts_.end(); readout_it++) {
-		int flags = (readout_it->kind_ == I3SuperDSTChargeStamp::HLC) ?
+		uint32_t dom = std::lower_bound(columns.doms.begin(),
+		    columns.doms.end(), readout_it->om_) - columns.doms.begin();
+		columns.readout_doms_.push_back(dom);
+		columns.offsets[dom+1] += readout_it->stamps_.size();
+	}
+	for (size_t i = 1; i < columns.offsets.size(); i++)
+		columns.offsets[i] += columns.offsets[i-1];
+	
+	const size_t npulses = columns.offsets.back();
+	columns.times.resize(npulses);
+	columns.charges.resize(npulses);
+	columns.widths.resize(npulses);
+	columns.flags.resize(npulses);
+	
+	/* 
+	 * Fill in the pulses in readout order, like pushing them onto the
+	 * DOM's series. order_ holds the next free slot of each DOM.
+	 */
+	columns.order_.assign(columns.offsets.begin(), columns.offsets.end()-1);
+	double t_ref = tmin_;
+	std::vector<uint32_t>::const_iterator dom_it = columns.readout_doms_.begin();
+	for (readout_it = readouts_.begin(); readout_it != readouts_.end();
+	    readout_it++, dom_it++) {
+		uint8_t flags = (readout_it->kind_ == I3SuperDSTChargeStamp::HLC) ?
 		    I3RecoPulse::ATWD | I3RecoPulse::FADC | I3RecoPulse::LC : I3RecoPulse::FADC;
-		I3RecoPulseSeries &target = unpacked_->operator[](readout_it->om_);
+		uint32_t &slot = columns.order_[*dom_it];
 		
 		t_ref += readout_it->GetTime();
 		double t_ref_internal = t_ref;
 		
-		stamp_it = readout_it->stamps_.begin();
-		
-		if (stamp_it != readout_it->stamps_.end()) {
-			I3RecoPulse pulse;
-			
-			pulse.SetTime(t_ref);
-			pulse.SetCharge(stamp_it->GetCharge());
-			pulse.SetWidth(stamp_it->GetWidth());
-			pulse.SetFlags(flags);
-			target.push_back(pulse);
-			
-			stamp_it++;
-		}
-	
-		for ( ; stamp_it != readout_it->stamps_.end(); stamp_it++) {
-			I3RecoPulse pulse;
-			
-			t_ref_internal += stamp_it->GetTime();
-			pulse.SetTime(t_ref_internal);
-			pulse.SetCharge(stamp_it->GetCharge());
-			pulse.SetWidth(stamp_it->GetWidth());
-			pulse.SetFlags(flags);
-			target.push_back(pulse);
+		for (stamp_it = readout_it->stamps_.begin();
+		    stamp_it != readout_it->stamps_.end(); stamp_it++, slot++) {
+			if (stamp_it != readout_it->stamps_.begin())
+				t_ref_internal += stamp_it->GetTime();
+			columns.times[slot] = (stamp_it == readout_it->stamps_.begin()) ?
+			    t_ref : t_ref_internal;
+			columns.charges[slot] = stamp_it->GetCharge();
+			columns.widths[slot] = stamp_it->GetWidth();
+			columns.flags[slot] = flags;
 		}
 	}
 
-	BOOST_FOREACH(I3RecoPulseSeriesMap::value_type &target, *unpacked_) {
-		std::sort(target.second.begin(), target.second.end(), 
-		    I3SuperDSTRecoPulseUtils::TimeOrdering);
+	for (size_t dom = 0; dom < columns.doms.size(); dom++) {
+		const uint32_t begin = columns.offsets[dom];
+		const uint32_t end = columns.offsets[dom+1];
+		if (begin == end)
+			continue;
+		
+		/* 
+		 * Sort by time. Sorting indices with the same comparisons gives
+		 * the same order as sorting the pulses themselves, ties included.
+		 */
+		columns.order_.resize(end-begin);
+		for (uint32_t i = 0; i < end-begin; i++)
+			columns.order_[i] = i;
+		std::sort(columns.order_.begin(), columns.order_.end(),
+		    IndexTimeOrdering(&columns.times[0] + begin));
+		
+		columns.time_scratch_.assign(columns.times.begin()+begin,
+		    columns.times.begin()+end);
+		columns.charge_scratch_.assign(columns.charges.begin()+begin,
+		    columns.charges.begin()+end);
+		columns.width_scratch_.assign(columns.widths.begin()+begin,
+		    columns.widths.begin()+end);
+		columns.flag_scratch_.assign(columns.flags.begin()+begin,
+		    columns.flags.begin()+end);
+		for (uint32_t i = 0; i < end-begin; i++) {
+			columns.times[begin+i] = columns.time_scratch_[columns.order_[i]];
+			columns.charges[begin+i] = columns.charge_scratch_[columns.order_[i]];
+			columns.widths[begin+i] = columns.width_scratch_[columns.order_[i]];
+			columns.flags[begin+i] = columns.flag_scratch_[columns.order_[i]];
+		}
 
-		I3RecoPulseSeries::iterator prev, current, next;
-		prev = target.second.end();
-		current = target.second.begin();
+		std::vector<double> &times = columns.times;
+		std::vector<float> &widths = columns.widths;
+		uint32_t prev, current, next;
+		prev = end;
+		current = begin;
 		next = current+1;
 		bool merge = false;
 		/* Ensure that pulses do not overlap. */
-		while (next < target.second.end()) {
-			current->SetWidth(std::min(current->GetWidth(),
-			    float(next->GetTime()-current->GetTime())));
-			if (current->GetWidth() == 0 || merge) {
-				if (prev != target.second.end()) {
+		while (next < end) {
+			widths[current] = std::min(widths[current],
+			    float(times[next]-times[current]));
+			if (widths[current] == 0 || merge) {
+				if (prev != end) {
 					/* Merge widths with previous pulse */
-					if (prev->GetWidth() == 0 && current->GetWidth() > 0)
-						prev->SetWidth(current->GetWidth());
-					current->SetWidth(prev->GetWidth()/2.);
-					prev->SetWidth(prev->GetWidth()/2.);
-					current->SetTime(prev->GetTime()+prev->GetWidth());
+					if (widths[prev] == 0 && widths[current] > 0)
+						widths[prev] = widths[current];
+					widths[current] = widths[prev]/2.;
+					widths[prev] = widths[prev]/2.;
+					times[current] = times[prev]+widths[prev];
 					merge = false;
 				} else {
 					merge = true;
@@ -374,12 +438,37 @@ I3SuperDST::Unpack() const
 			current++;
 			next = current+1;
 		}
-		if (merge && prev != target.second.end()) {
-			if (prev->GetWidth() == 0 && current->GetWidth() > 0)
-				prev->SetWidth(current->GetWidth());
-			current->SetWidth(prev->GetWidth()/2.);
-			prev->SetWidth(prev->GetWidth()/2.);
-			current->SetTime(prev->GetTime()+prev->GetWidth());
+		if (merge && prev != end) {
+			if (widths[prev] == 0 && widths[current] > 0)
+				widths[prev] = widths[current];
+			widths[current] = widths[prev]/2.;
+			widths[prev] = widths[prev]/2.;
+			times[current] = times[prev]+widths[prev];
+		}
+	}
+}
+
+/* Expand charge stamps into fake I3RecoPulses */
+I3RecoPulseSeriesMapConstPtr
+I3SuperDST::Unpack() const
+{
+	if (unpacked_)
+		return unpacked_;
+
+	I3SuperDSTPulseColumns columns;
+	UnpackColumns(columns);
+	
+	unpacked_ = I3RecoPulseSeriesMapPtr(new I3RecoPulseSeriesMap);
+	for (size_t dom = 0; dom < columns.doms.size(); dom++) {
+		I3RecoPulseSeries &target = unpacked_->insert(unpacked_->end(),
+		    std::make_pair(columns.doms[dom], I3RecoPulseSeries()))->second;
+		target.resize(columns.offsets[dom+1]-columns.offsets[dom]);
+		for (uint32_t i = columns.offsets[dom]; i < columns.offsets[dom+1]; i++) {
+			I3RecoPulse &pulse = target[i-columns.offsets[dom]];
+			pulse.SetTime(columns.times[i]);
+			pulse.SetCharge(columns.charges[i]);
+			pulse.SetWidth(columns.widths[i]);
+			pulse.SetFlags(columns.flags[i]);
 		}
 	}
 	
@@ -0,0 +1,181 @@
+/**
+ *  $Id$
+ *
+ *  Copyright (C) 2020
+ *  the IceCube Collaboration <http://www.icecube.wisc.edu>
+ *
+ */
+
+#include "dataclasses/physics/I3RecoPulseSeriesMapFlat.h"
+#include "boost/make_shared.hpp"
+#include <algorithm>
+#include <limits>
+
+I3RecoPulseSeriesMapFlat::I3RecoPulseSeriesMapFlat()
+  : offsets_(1, 0) {}
+
+I3RecoPulseSeriesMapFlat::I3RecoPulseSeriesMapFlat(
+  const I3RecoPulseSeriesMap &pulses)
+{
+  size_t npulses = 0;
+  for (const auto &pair : pulses)
+    npulses += pair.second.size();
+  if (npulses > std::numeric_limits<uint32_t>::max())
+    log_fatal("Can't flatten %zu pulses", npulses);
+
+  keys_.reserve(pulses.size());
+  offsets_.reserve(pulses.size()+1);
+  times_.reserve(npulses);
+  charges_.reserve(npulses);
+  widths_.reserve(npulses);
+  flags_.reserve(npulses);
+
+  offsets_.push_back(0);
+  for (const auto &pair : pulses) {
+    // an empty series still has an entry in the map, so keep it here too
+    keys_.push_back(pair.first);
+    for (const I3RecoPulse &pulse : pair.second) {
+      times_.push_back(pulse.GetTime());
+      charges_.push_back(pulse.GetCharge());
+      widths_.push_back(pulse.GetWidth());
+      flags_.push_back(pulse.GetFlags());
+    }
+    offsets_.push_back(times_.size());
+  }
+}
+
+int
+I3RecoPulseSeriesMapFlat::Find(const OMKey &key) const
+{
+  std::vector<OMKey>::const_iterator it =
+      std::lower_bound(keys_.begin(), keys_.end(), key);
+  if (it == keys_.end() || *it != key)
+    return -1;
+  return it - keys_.begin();
+}
+
+I3RecoPulse
+I3RecoPulseSeriesMapFlat::GetPulse(size_t i) const
+{
+  I3RecoPulse pulse;
+  pulse.SetTime(times_[i]);
+  pulse.SetCharge(charges_[i]);
+  pulse.SetWidth(widths_[i]);
+  pulse.SetFlags(flags_[i]);
+  return pulse;
+}
+
+I3RecoPulseSeriesMapConstPtr
+I3RecoPulseSeriesMapFlat::Unpack() const
+{
+  if (unpacked_)
+    return unpacked_;
+
+  I3RecoPulseSeriesMapPtr pulses = boost::make_shared<I3RecoPulseSeriesMap>();
+  // keys are sorted, so every insertion goes at the end
+  for (size_t i = 0; i < keys_.size(); i++) {
+    I3RecoPulseSeries &series =
+        pulses->insert(pulses->end(), std::make_pair(keys_[i],
+        I3RecoPulseSeries()))->second;
+    series.reserve(offsets_[i+1]-offsets_[i]);
+    for (uint32_t j = offsets_[i]; j < offsets_[i+1]; j++)
+      series.push_back(GetPulse(j));
+  }
+
+  // save in cache
+  unpacked_ = pulses;
+
+  return pulses;
+}
+
+bool
+I3RecoPulseSeriesMapFlat::operator==(const I3RecoPulseSeriesMapFlat& other) const
+{
+  return (keys_ == other.keys_ && offsets_ == other.offsets_ &&
+      times_ == other.times_ && charges_ == other.charges_ &&
+      widths_ == other.widths_ && flags_ == other.flags_);
+}
+
+bool
+I3RecoPulseSeriesMapFlat::operator!=(const I3RecoPulseSeriesMapFlat& other) const
+{
+  return !(*this == other);
+}
+
+std::ostream& I3RecoPulseSeriesMapFlat::Print(std::ostream& os) const
+{
+  os << "[I3RecoPulseSeriesMapFlat: " << GetNumberOfPulses() << " pulses on "
+     << GetNumberOfDOMs() << " DOMs]";
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const I3RecoPulseSeriesMapFlat& flat)
+{
+  return(flat.Print(os));
+}
+
+template <class Archive>
+void
+I3RecoPulseSeriesMapFlat::save(Archive& ar, unsigned version) const
+{
+  // store the keys as columns too, so that every field is a plain array
+  std::vector<int32_t> strings(keys_.size());
+  std::vector<uint32_t> oms(keys_.size());
+  std::vector<uint8_t> pmts(keys_.size());
+  for (size_t i = 0; i < keys_.size(); i++) {
+    strings[i] = keys_[i].GetString();
+    oms[i] = keys_[i].GetOM();
+    pmts[i] = keys_[i].GetPMT();
+  }
+
+  ar & make_nvp("I3FrameObject", base_object<I3FrameObject>(*this));
+  ar & make_nvp("Strings", strings);
+  ar & make_nvp("OMs", oms);
+  ar & make_nvp("PMTs", pmts);
+  ar & make_nvp("Offsets", offsets_);
+  ar & make_nvp("Times", times_);
+  ar & make_nvp("Charges", charges_);
+  ar & make_nvp("Widths", widths_);
+  ar & make_nvp("Flags", flags_);
+}
+
+template <class Archive>
+void
+I3RecoPulseSeriesMapFlat::load(Archive& ar, unsigned version)
+{
+  if (version > I3RecoPulseSeriesMapFlat_version_)
+    log_fatal("Attempting to read version %u from file but running version "
+        "%u of I3RecoPulseSeriesMapFlat class.", version,
+        I3RecoPulseSeriesMapFlat_version_);
+
+  std::vector<int32_t> strings;
+  std::vector<uint32_t> oms;
+  std::vector<uint8_t> pmts;
+
+  ar & make_nvp("I3FrameObject", base_object<I3FrameObject>(*this));
+  ar & make_nvp("Strings", strings);
+  ar & make_nvp("OMs", oms);
+  ar & make_nvp("PMTs", pmts);
+  ar & make_nvp("Offsets", offsets_);
+  ar & make_nvp("Times", times_);
+  ar & make_nvp("Charges", charges_);
+  ar & make_nvp("Widths", widths_);
+  ar & make_nvp("Flags", flags_);
+
+  if (oms.size() != strings.size() || pmts.size() != strings.size() ||
+      offsets_.size() != strings.size()+1 || offsets_.front() != 0 ||
+      offsets_.back() != times_.size() || charges_.size() != times_.size() ||
+      widths_.size() != times_.size() || flags_.size() != times_.size())
+    log_fatal("Inconsistent column sizes in serialized I3RecoPulseSeriesMapFlat");
+  for (size_t i = 0; i < strings.size(); i++)
+    if (offsets_[i] > offsets_[i+1])
+      log_fatal("Offsets of serialized I3RecoPulseSeriesMapFlat are not sorted");
+
+  keys_.clear();
+  keys_.reserve(strings.size());
+  for (size_t i = 0; i < strings.size(); i++)
+    keys_.push_back(OMKey(strings[i], oms[i], pmts[i]));
+  unpacked_.reset();
+}
+
+I3_SPLIT_SERIALIZABLE(I3RecoPulseSeriesMapFlat);
@@ -0,0 +1,41 @@
+
+#include <dataclasses/physics/I3RecoPulseSeriesMapFlat.h>
+#include <icetray/python/dataclass_suite.hpp>
+
+namespace bp = boost::python;
+
+I3RecoPulseSeriesMapPtr
+underhanded_unpack(const I3RecoPulseSeriesMapFlat& flat)
+{
+  return boost::const_pointer_cast<I3RecoPulseSeriesMap>(flat.Unpack());
+}
+
+// No converter exists for std::vector<uint8_t>; hand out a ListUShort
+std::vector<uint16_t>
+get_flags(const I3RecoPulseSeriesMapFlat& flat)
+{
+  return std::vector<uint16_t>(flat.GetFlags().begin(), flat.GetFlags().end());
+}
+
+void register_I3RecoPulseSeriesMapFlat()
+{
+  bp::class_<I3RecoPulseSeriesMapFlat, bp::bases<I3FrameObject>,
+      I3RecoPulseSeriesMapFlatPtr>("I3RecoPulseSeriesMapFlat",
+      "An I3RecoPulseSeriesMap stored as contiguous arrays of pulse properties",
+      bp::init<const I3RecoPulseSeriesMap &>(bp::args("pulses")))
+    .def(bp::init<>())
+    .def("unpack", &underhanded_unpack, "Expand into an I3RecoPulseSeriesMap.")
+    .def("find", &I3RecoPulseSeriesMapFlat::Find, "Index of the given DOM in keys, or -1 if it is not in the map.")
+    .add_property("keys", bp::make_function(&I3RecoPulseSeriesMapFlat::GetKeys, bp::return_value_policy<bp::copy_const_reference>()))
+    .add_property("offsets", bp::make_function(&I3RecoPulseSeriesMapFlat::GetOffsets, bp::return_value_policy<bp::copy_const_reference>()))
+    .add_property("times", bp::make_function(&I3RecoPulseSeriesMapFlat::GetTimes, bp::return_value_policy<bp::copy_const_reference>()))
+    .add_property("charges", bp::make_function(&I3RecoPulseSeriesMapFlat::GetCharges, bp::return_value_policy<bp::copy_const_reference>()))
+    .add_property("widths", bp::make_function(&I3RecoPulseSeriesMapFlat::GetWidths, bp::return_value_policy<bp::copy_const_reference>()))
+    .add_property("flags", &get_flags)
+    .add_property("n_doms", &I3RecoPulseSeriesMapFlat::GetNumberOfDOMs)
+    .add_property("n_pulses", &I3RecoPulseSeriesMapFlat::GetNumberOfPulses)
+    .def(bp::dataclass_suite<I3RecoPulseSeriesMapFlat>())
+    ;
+
+  register_pointer_conversions<I3RecoPulseSeriesMapFlat>();
+}
@@ -29,6 +29,25 @@ unpack_pulses(const I3SuperDST &self)
 		return I3RecoPulseSeriesMapPtr();
 }
 
+boost::shared_ptr<I3SuperDSTPulseColumns>
+unpack_columns(const I3SuperDST &self)
+{
+	boost::shared_ptr<I3SuperDSTPulseColumns> columns(new I3SuperDSTPulseColumns);
+	self.UnpackColumns(*columns);
+	return columns;
+}
+
+template <typename T, std::vector<T> I3SuperDSTPulseColumns::*column>
+bp::list
+get_column(const I3SuperDSTPulseColumns &self)
+{
+	bp::list values;
+	for (typename std::vector<T>::const_iterator it = (self.*column).begin();
+	    it != (self.*column).end(); it++)
+		values.append(*it);
+	return values;
+}
+
 I3TriggerHierarchyPtr
 unpack_triggers(const I3SuperDSTTriggerSeries &self, const I3DetectorStatus &status)
 {
@@ -47,6 +66,8 @@ register_I3SuperDST()
 		.def(bp::init<const I3RecoPulseSeriesMap &>(bp::args("pulses")))
 		.def("unpack", &unpack_pulses, bp::args("self"), "Unpack the compressed event data "
 		    "into I3RecoPulses.")
+		.def("unpack_columns", &unpack_columns, bp::args("self"), "Unpack the compressed "
+		    "event data into per-pulse columns, without building a pulse map.")
 	        .def( freeze() )
 		#define RO_PROPS (EncodedSizes)
 		BOOST_PP_SEQ_FOR_EACH(WRAP_PROP_RO, I3SuperDST, RO_PROPS)
@@ -55,6 +76,18 @@ register_I3SuperDST()
 		;
 	register_pointer_conversions<I3SuperDST>();
 	
+	bp::class_<I3SuperDSTPulseColumns, boost::shared_ptr<I3SuperDSTPulseColumns> >(
+	    "I3SuperDSTPulseColumns", "Pulses of an I3SuperDST, one column per quantity. "
+	    "The pulses on doms[i] are those in [offsets[i], offsets[i+1]).")
+		.add_property("doms", &get_column<OMKey, &I3SuperDSTPulseColumns::doms>)
+		.add_property("offsets", &get_column<uint32_t, &I3SuperDSTPulseColumns::offsets>)
+		.add_property("times", &get_column<double, &I3SuperDSTPulseColumns::times>)
+		.add_property("charges", &get_column<float, &I3SuperDSTPulseColumns::charges>)
+		.add_property("widths", &get_column<float, &I3SuperDSTPulseColumns::widths>)
+		.add_property("flags", &get_column<uint8_t, &I3SuperDSTPulseColumns::flags>)
+		.def("__len__", &I3SuperDSTPulseColumns::GetNumberOfPulses)
+	;
+	
 	bp::class_<I3SuperDSTTrigger >(
 	    "I3SuperDSTTrigger", bp::no_init)
 		.def(bp::init<const I3Trigger &, const I3DetectorStatus &>(bp::args("trigger","status")))
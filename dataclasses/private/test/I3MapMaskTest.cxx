@@ -149,6 +149,87 @@ TEST(Repoint)
 	ENSURE_EQUAL(stripped.GetSum(), 1u);
 }
 
+TEST(ApplyChain)
+{
+	I3RecoPulseSeriesMapPtr pulses = manufacture_pulsemap();
+	
+	I3Frame frame;
+	frame.Put("foo", pulses);
+	I3RecoPulseSeriesMapMaskPtr mask =
+	    boost::make_shared<I3RecoPulseSeriesMapMask>(frame, "foo");
+	mask->Set(pulses->begin()->first, 2, false);
+	mask->Set(boost::next(pulses->begin())->first, 0, false);
+	frame.Put("foomask", mask);
+	
+	I3RecoPulseSeriesMapMaskPtr submask =
+	    boost::make_shared<I3RecoPulseSeriesMapMask>(frame, "foomask");
+	submask->Set(pulses->begin()->first, 2, false);
+	submask->Set(boost::next(pulses->begin())->first, 7, false);
+	frame.Put("submask", submask);
+	
+	I3RecoPulseSeriesMapMaskPtr subsubmask =
+	    boost::make_shared<I3RecoPulseSeriesMapMask>(frame, "submask");
+	subsubmask->Set(pulses->begin()->first, false);
+	frame.Put("subsubmask", subsubmask);
+	
+	/* Apply each level to a materialized copy of its parent */
+	I3Frame stepwise;
+	stepwise.Put("foo", pulses);
+	stepwise.Put("foomask", boost::make_shared<I3RecoPulseSeriesMap>(
+	    *mask->Apply(frame)));
+	stepwise.Put("submask", boost::make_shared<I3RecoPulseSeriesMap>(
+	    *submask->Apply(stepwise)));
+	I3RecoPulseSeriesMapConstPtr expected = subsubmask->Apply(stepwise);
+	
+	I3RecoPulseSeriesMapConstPtr masked =
+	    frame.Get<I3RecoPulseSeriesMapConstPtr>("subsubmask");
+	ENSURE(masked != expected, "Cache is not reused for a different frame");
+	ENSURE_EQUAL(masked->size(), 1u);
+	ENSURE_EQUAL(masked->size(), expected->size());
+	ENSURE_EQUAL(masked->begin()->first, expected->begin()->first);
+	ENSURE_EQUAL(masked->begin()->second.size(), 7u);
+	ENSURE(masked->begin()->second == expected->begin()->second);
+}
+
+TEST(ApplyCache)
+{
+	I3RecoPulseSeriesMapPtr pulses = manufacture_pulsemap();
+	
+	I3Frame frame;
+	frame.Put("foo", pulses);
+	I3RecoPulseSeriesMapMaskPtr mask =
+	    boost::make_shared<I3RecoPulseSeriesMapMask>(frame, "foo");
+	mask->Set(pulses->begin()->first, 0, false);
+	frame.Put("foomask", mask);
+	I3RecoPulseSeriesMapMaskPtr submask =
+	    boost::make_shared<I3RecoPulseSeriesMapMask>(frame, "foomask");
+	frame.Put("submask", submask);
+	
+	I3RecoPulseSeriesMapConstPtr masked = mask->Apply(frame);
+	I3RecoPulseSeriesMapConstPtr submasked = submask->Apply(frame);
+	ENSURE(mask->Apply(frame) == masked, "Result is reused");
+	ENSURE(submask->Apply(frame) == submasked, "Result is reused");
+	ENSURE_EQUAL(masked->begin()->second.front().GetTime(), 2.0);
+	
+	/* Replace the source map with one of the same shape */
+	I3RecoPulseSeriesMapPtr shifted = manufacture_pulsemap();
+	BOOST_FOREACH(I3RecoPulseSeriesMap::value_type &pair, *shifted)
+		BOOST_FOREACH(I3RecoPulse &pulse, pair.second)
+			pulse.SetTime(pulse.GetTime() + 100);
+	frame.Delete("foo");
+	frame.Put("foo", shifted);
+	
+	ENSURE(mask->Apply(frame) != masked, "Result is recomputed");
+	ENSURE_EQUAL(mask->Apply(frame)->begin()->second.front().GetTime(), 102.0);
+	ENSURE_EQUAL(submask->Apply(frame)->begin()->second.front().GetTime(), 102.0);
+	
+	/* Modifying the mask invalidates the result */
+	masked = mask->Apply(frame);
+	mask->Set(pulses->begin()->first, 1, false);
+	ENSURE(mask->Apply(frame) != masked, "Result is recomputed");
+	ENSURE_EQUAL(mask->Apply(frame)->begin()->second.front().GetTime(), 112.0);
+}
+
 TEST(ApplyAutomagically)
 {
 	I3RecoPulseSeriesMapPtr pulses = manufacture_pulsemap();
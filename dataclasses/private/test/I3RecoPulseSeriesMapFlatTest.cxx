@@ -0,0 +1,133 @@
+#include <I3Test.h>
+
+#include <dataclasses/physics/I3RecoPulseSeriesMapFlat.h>
+#include <dataclasses/I3MapOMKeyMask.h>
+#include <dataclasses/I3MapOMKeyUnion.h>
+#include "boost/make_shared.hpp"
+#include "boost/interprocess/streams/vectorstream.hpp"
+
+TEST_GROUP(I3RecoPulseSeriesMapFlat);
+
+static I3RecoPulseSeriesMapPtr
+manufacture_pulsemap()
+{
+	I3RecoPulseSeriesMapPtr pulses = boost::make_shared<I3RecoPulseSeriesMap>();
+	I3RecoPulse p;
+	for (int i = 0; i < 3; i++) {
+		p.SetTime(10*i);
+		p.SetCharge(1.5+i);
+		p.SetWidth(2+i);
+		p.SetFlags(i % 2 ? I3RecoPulse::LC : I3RecoPulse::ATWD);
+		(*pulses)[OMKey(21,30)].push_back(p);
+		if (i < 2)
+			(*pulses)[OMKey(2,1)].push_back(p);
+	}
+	(*pulses)[OMKey(5,5)];
+	return pulses;
+}
+
+static void
+ensure_same(const I3RecoPulseSeriesMap &a, const I3RecoPulseSeriesMap &b)
+{
+	ENSURE_EQUAL(a.size(), b.size());
+	I3RecoPulseSeriesMap::const_iterator ia = a.begin(), ib = b.begin();
+	for ( ; ia != a.end(); ia++, ib++) {
+		ENSURE_EQUAL(ia->first, ib->first);
+		ENSURE_EQUAL(ia->second.size(), ib->second.size());
+		for (size_t i = 0; i < ia->second.size(); i++)
+			ENSURE(ia->second[i] == ib->second[i]);
+	}
+}
+
+TEST(Layout)
+{
+	I3RecoPulseSeriesMapFlat flat(*manufacture_pulsemap());
+
+	ENSURE_EQUAL(flat.GetNumberOfDOMs(), 3u);
+	ENSURE_EQUAL(flat.GetNumberOfPulses(), 5u);
+	ENSURE_EQUAL(flat.GetOffsets().size(), 4u);
+	ENSURE_EQUAL(flat.GetOffsets()[0], 0u);
+	ENSURE_EQUAL(flat.GetOffsets()[1], 2u);
+	ENSURE_EQUAL(flat.GetOffsets()[2], 2u, "Empty series are kept");
+	ENSURE_EQUAL(flat.GetOffsets()[3], 5u);
+	ENSURE_EQUAL(flat.Find(OMKey(21,30)), 2);
+	ENSURE_EQUAL(flat.Find(OMKey(5,5)), 1, "Empty series can be found");
+	ENSURE_EQUAL(flat.Find(OMKey(1,1)), -1);
+	ENSURE_EQUAL(flat.GetTimes()[4], 20.);
+	ENSURE_EQUAL(flat.GetCharges()[1], 2.5f);
+
+	I3RecoPulseSeriesMapFlat empty;
+	ENSURE_EQUAL(empty.GetOffsets().size(), 1u);
+	ENSURE(empty.Unpack()->empty());
+}
+
+TEST(Unpack)
+{
+	I3RecoPulseSeriesMapPtr pulses = manufacture_pulsemap();
+	I3RecoPulseSeriesMapFlat flat(*pulses);
+
+	ensure_same(*pulses, *flat.Unpack());
+	ENSURE(flat.Unpack() == flat.Unpack(), "Unpacked map is cached");
+}
+
+TEST(FrameGet)
+{
+	I3RecoPulseSeriesMapPtr pulses = manufacture_pulsemap();
+	I3Frame frame;
+	frame.Put("Pulses", pulses);
+	frame.Put("FlatPulses", boost::make_shared<I3RecoPulseSeriesMapFlat>(*pulses));
+
+	I3RecoPulseSeriesMapConstPtr unpacked =
+	    frame.Get<I3RecoPulseSeriesMapConstPtr>("FlatPulses");
+	ENSURE((bool)unpacked);
+	ensure_same(*pulses, *unpacked);
+
+	// masks and unions see the flat map as an ordinary pulse map
+	I3RecoPulseSeriesMapMaskPtr mask =
+	    boost::make_shared<I3RecoPulseSeriesMapMask>(frame, "FlatPulses");
+	mask->Set(OMKey(2,1), false);
+	frame.Put("MaskedPulses", mask);
+	I3RecoPulseSeriesMapConstPtr masked =
+	    frame.Get<I3RecoPulseSeriesMapConstPtr>("MaskedPulses");
+	ENSURE((bool)masked);
+	ENSURE(masked->find(OMKey(2,1)) == masked->end());
+	ENSURE_EQUAL(masked->find(OMKey(21,30))->second.size(), 3u);
+
+	I3RecoPulseSeriesMapMaskPtr complement =
+	    boost::make_shared<I3RecoPulseSeriesMapMask>(frame, "FlatPulses");
+	complement->Set(OMKey(21,30), false);
+	frame.Put("ComplementPulses", complement);
+
+	std::vector<std::string> keys;
+	keys.push_back("MaskedPulses");
+	keys.push_back("ComplementPulses");
+	frame.Put("UnitedPulses",
+	    boost::make_shared<I3RecoPulseSeriesMapUnion>(frame, keys));
+	I3RecoPulseSeriesMapConstPtr united =
+	    frame.Get<I3RecoPulseSeriesMapConstPtr>("UnitedPulses");
+	ENSURE((bool)united);
+	ENSURE_EQUAL(united->find(OMKey(2,1))->second.size(), 2u);
+	ENSURE_EQUAL(united->find(OMKey(21,30))->second.size(), 3u);
+}
+
+TEST(Serialization)
+{
+	I3RecoPulseSeriesMapPtr pulses = manufacture_pulsemap();
+	I3Frame frame;
+	frame.Put("FlatPulses", boost::make_shared<I3RecoPulseSeriesMapFlat>(*pulses));
+
+	namespace ip = boost::interprocess;
+	ip::basic_vectorstream<std::vector<char> > archive_stream;
+	frame.save(archive_stream);
+	archive_stream.reserve(0);
+
+	I3Frame newframe;
+	newframe.load(archive_stream);
+
+	I3RecoPulseSeriesMapFlatConstPtr flat =
+	    newframe.Get<I3RecoPulseSeriesMapFlatConstPtr>("FlatPulses");
+	ENSURE((bool)flat);
+	ENSURE(*flat == I3RecoPulseSeriesMapFlat(*pulses));
+	ensure_same(*pulses,
+	    *newframe.Get<I3RecoPulseSeriesMapConstPtr>("FlatPulses"));
+}
@@ -2,6 +2,7 @@
 
 #include <sys/time.h>
 #include <numeric>
+#include <limits>
 
 #include "icetray/OMKey.h"
 #include "icetray/I3Tray.h"
@@ -500,6 +501,77 @@ TEST(Unpacking)
 	}
 }
 
+TEST(UnpackColumns)
+{
+	I3SuperDSTPulseColumns columns;
+	
+	for (unsigned event = 0; event < 3; event++) {
+		I3RecoPulseSeriesMap pulsemap;
+		for (int string = 1; string < 5; string++) {
+			for (unsigned om = 1; om < 10; om += event+1) {
+				OMKey key(string, om);
+				double t = uniform(0, 1000);
+				/* 
+				 * Keep the pulses apart so that the overlap fix-up
+				 * leaves them alone and only discretization remains.
+				 */
+				for (unsigned i = 0; i < 6; i++) {
+					I3RecoPulse p;
+					t += uniform(25, 60);
+					p.SetTime(t);
+					p.SetCharge(uniform(0.1, 9.0));
+					p.SetWidth(uniform(1.0, 20.0));
+					p.SetFlags(i < 3 ? I3RecoPulse::LC : 0);
+					pulsemap[key].push_back(p);
+				}
+			}
+		}
+		
+		/* The same columns object is refilled for every event */
+		I3SuperDST(pulsemap).UnpackColumns(columns);
+		
+		ENSURE_EQUAL(columns.GetNumberOfDOMs(), pulsemap.size());
+		ENSURE_EQUAL(columns.offsets.size(), pulsemap.size()+1);
+		
+		size_t dom = 0, npulses = 0;
+		I3RecoPulseSeriesMap::const_iterator map_it = pulsemap.begin();
+		for ( ; map_it != pulsemap.end(); map_it++, dom++) {
+			ENSURE_EQUAL(columns.doms[dom], map_it->first);
+			ENSURE_EQUAL(columns.offsets[dom+1]-columns.offsets[dom],
+			    map_it->second.size());
+			for (size_t i = 0; i < map_it->second.size(); i++) {
+				const I3RecoPulse &pulse = map_it->second[i];
+				size_t j = columns.offsets[dom]+i;
+				ENSURE_DISTANCE(columns.times[j], pulse.GetTime(),
+				    std::numeric_limits<float>::epsilon()
+				    + I3SuperDST::DecodeTime(1)/2.0, "Leading-edge "
+				    "times agree to within discretization error");
+				
+				uint32_t w = I3SuperDST::EncodeWidth(pulse.GetWidth(), 31);
+				double epsilon = I3SuperDST::DecodeWidth(w+1)
+				    - I3SuperDST::DecodeWidth(w);
+				ENSURE_DISTANCE(columns.widths[j], pulse.GetWidth(),
+				    epsilon/2.0, "Widths agree to within discretization");
+				
+				uint32_t l = I3SuperDST::EncodeCharge(pulse.GetCharge(), 31);
+				epsilon = I3SuperDST::DecodeCharge(l+1)
+				    - I3SuperDST::DecodeCharge(l);
+				epsilon *= (1.+std::numeric_limits<float>::epsilon())/2.;
+				ENSURE_DISTANCE(columns.charges[j], pulse.GetCharge(),
+				    epsilon, "Charges agree to within discretization");
+				
+				/* LC pulses come back as HLC, the rest as SLC */
+				unsigned flags = (pulse.GetFlags() & I3RecoPulse::LC) ?
+				    (I3RecoPulse::ATWD | I3RecoPulse::FADC | I3RecoPulse::LC) :
+				    I3RecoPulse::FADC;
+				ENSURE_EQUAL(unsigned(columns.flags[j]), flags);
+			}
+			npulses += map_it->second.size();
+		}
+		ENSURE_EQUAL(columns.GetNumberOfPulses(), npulses);
+	}
+}
+
 static void
 TestRoundTrip(std::string filename, std::string hlc_name, std::string slc_name, unsigned nframes)
 {
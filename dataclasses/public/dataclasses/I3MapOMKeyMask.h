@@ -13,7 +13,9 @@
 #include <functional>
 #include <string>
 #include <list>
+#include <vector>
 #include <boost/foreach.hpp>
+#include <boost/weak_ptr.hpp>
 #include <boost/function.hpp>
 #include <boost/dynamic_bitset.hpp> 
 
@@ -68,7 +70,11 @@ public:
 	void SetNone();
 	
 	/*
-	 * Apply the mask to the target map in the frame.
+	 * Apply the mask to the target map in the frame. If the source is
+	 * itself a mask, the chain is collapsed onto the first ancestor that
+	 * is not a mask, so the intermediate maps are never built. The result
+	 * is cached until the mask is modified or the objects it was computed
+	 * from are replaced.
 	 */
 	boost::shared_ptr<const I3RecoPulseSeriesMap> Apply(const I3Frame &frame) const;
 	
@@ -162,8 +168,13 @@ private:
 	std::list<bitmask> element_masks_;
 	I3RecoPulseSeriesMapConstPtr source_;
 	mutable I3RecoPulseSeriesMapPtr masked_;
+	/* The masks between this one and the root map, then the root map */
+	mutable std::vector<boost::weak_ptr<const I3FrameObject> > masked_inputs_;
 	
-	inline void ResetCache() { masked_.reset(); }
+	inline void ResetCache() { masked_.reset(); masked_inputs_.clear(); }
+	
+	I3RecoPulseSeriesMapPtr ApplyTo(const I3RecoPulseSeriesMap &source,
+	    const std::string &name) const;
 
 	int FindKey(const OMKey &key, std::list<bitmask>::iterator &list_it,
 	    const I3RecoPulseSeriesMap::mapped_type **vec);
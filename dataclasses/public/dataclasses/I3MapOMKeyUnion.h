@@ -13,6 +13,8 @@
 #include <functional>
 #include <string>
 #include <list>
+#include <vector>
+#include <boost/weak_ptr.hpp>
 #include "icetray/I3FrameObject.h"
 #include "icetray/OMKey.h"
 #include "icetray/I3Frame.h"
@@ -31,6 +33,10 @@ public:
 	
 	std::ostream& Print(std::ostream&) const override;
 	
+	/*
+	 * Merge the source maps. The result is cached until one of the
+	 * source maps in the frame is replaced.
+	 */
 	I3RecoPulseSeriesMapConstPtr Apply(const I3Frame&) const;
 	std::vector<std::string> GetSources() const { return keys_; }
     
@@ -39,6 +45,7 @@ public:
 private:
 	std::vector<std::string> keys_;
 	mutable I3RecoPulseSeriesMapPtr unified_;
+	mutable std::vector<boost::weak_ptr<const I3RecoPulseSeriesMap> > unified_inputs_;
 	
 	friend class icecube::serialization::access;
 	template <class Archive> void serialize(Archive& ar, unsigned version);
@@ -116,6 +116,41 @@ struct I3SuperDSTReadout {
 };
 
 
+/**
+ * Pulses of an I3SuperDST as parallel arrays, in the same order and with the
+ * same values as the I3RecoPulseSeriesMap returned by I3SuperDST::Unpack().
+ * The pulses of doms[i] are the entries offsets[i] up to offsets[i+1].
+ *
+ * Filling the same object for every event reuses its storage, so once the
+ * arrays have grown no memory is allocated at all.
+ *
+ * @see I3SuperDST::UnpackColumns()
+ */
+class I3SuperDSTPulseColumns {
+public:
+	std::vector<OMKey> doms;
+	std::vector<uint32_t> offsets;
+	std::vector<double> times;
+	std::vector<float> charges;
+	std::vector<float> widths;
+	std::vector<uint8_t> flags;
+
+	size_t GetNumberOfDOMs() const { return doms.size(); };
+	size_t GetNumberOfPulses() const { return times.size(); };
+	void clear();
+
+private:
+	/* Scratch space for I3SuperDST::UnpackColumns() */
+	std::vector<uint32_t> readout_doms_;
+	std::vector<uint32_t> order_;
+	std::vector<double> time_scratch_;
+	std::vector<float> charge_scratch_;
+	std::vector<float> width_scratch_;
+	std::vector<uint8_t> flag_scratch_;
+
+	friend class I3SuperDST;
+};
+
 class I3SuperDST : public I3FrameObject {
 public:
 	I3SuperDST() : version_(i3superdst_version_) { InitDebug(); };
@@ -135,6 +170,13 @@ public:
 	 * a single map.
 	 */
 	I3RecoPulseSeriesMapConstPtr Unpack() const;
+
+	/**
+	 * Expand charge stamps into columns of pulse times, charges, widths and
+	 * flags, without building a pulse map. The result is the same as
+	 * that of Unpack().
+	 */
+	void UnpackColumns(I3SuperDSTPulseColumns &columns) const;
 	
 	I3MapKeyVectorInt GetEncodedSizes() const;
 	
@@ -0,0 +1,96 @@
+/**
+ *  $Id$
+ *
+ *  Copyright (C) 2020
+ *  the IceCube Collaboration <http://www.icecube.wisc.edu>
+ *
+ */
+
+#ifndef DATACLASSES_I3RecoPulseSeriesMapFlat_H_INCLUDED
+#define DATACLASSES_I3RecoPulseSeriesMapFlat_H_INCLUDED
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "icetray/I3FrameObject.h"
+#include "icetray/OMKey.h"
+#include "icetray/serialization.h"
+#include "dataclasses/physics/I3RecoPulse.h"
+
+static const unsigned I3RecoPulseSeriesMapFlat_version_ = 0;
+
+/**
+ * @brief An I3RecoPulseSeriesMap stored as flat arrays.
+ *
+ * The pulses of all DOMs are kept in one set of contiguous columns
+ * (times, charges, widths, flags), ordered by DOM. The pulses of the
+ * i-th DOM are those between GetOffsets()[i] and GetOffsets()[i+1].
+ * Code that wants to loop over every pulse can do so without touching
+ * the per-DOM vectors of an I3RecoPulseSeriesMap, and serialization
+ * writes a handful of arrays.
+ *
+ * I3Frame::Get<I3RecoPulseSeriesMapConstPtr>() transparently unpacks this
+ * object, so it can be used anywhere a pulse map is expected, including
+ * as the source of an I3RecoPulseSeriesMapMask or I3RecoPulseSeriesMapUnion.
+ */
+class I3RecoPulseSeriesMapFlat : public I3FrameObject {
+public:
+  I3RecoPulseSeriesMapFlat();
+  explicit I3RecoPulseSeriesMapFlat(const I3RecoPulseSeriesMap &pulses);
+
+  std::ostream& Print(std::ostream&) const override;
+
+  /**
+   * @brief Expand into an I3RecoPulseSeriesMap. The map is built on
+   *        first use and cached.
+   */
+  I3RecoPulseSeriesMapConstPtr Unpack() const;
+
+  size_t GetNumberOfDOMs() const { return keys_.size(); }
+  size_t GetNumberOfPulses() const { return times_.size(); }
+
+  /**
+   * @brief Index of the given DOM in GetKeys(), or -1 if it is not in
+   *        the map. A DOM with an empty series is kept (so that Unpack()
+   *        reproduces the original map) and has an empty range of pulses.
+   */
+  int Find(const OMKey &key) const;
+
+  /// DOMs in the map, in increasing order
+  const std::vector<OMKey>& GetKeys() const { return keys_; }
+  /// Index of the first pulse of each DOM, followed by the number of pulses
+  const std::vector<uint32_t>& GetOffsets() const { return offsets_; }
+  const std::vector<double>& GetTimes() const { return times_; }
+  const std::vector<float>& GetCharges() const { return charges_; }
+  const std::vector<float>& GetWidths() const { return widths_; }
+  const std::vector<uint8_t>& GetFlags() const { return flags_; }
+
+  /// Reconstruct the i-th pulse of the flattened series
+  I3RecoPulse GetPulse(size_t i) const;
+
+  bool operator==(const I3RecoPulseSeriesMapFlat&) const;
+  bool operator!=(const I3RecoPulseSeriesMapFlat&) const;
+private:
+  std::vector<OMKey> keys_;
+  std::vector<uint32_t> offsets_;
+  std::vector<double> times_;
+  std::vector<float> charges_;
+  std::vector<float> widths_;
+  std::vector<uint8_t> flags_;
+
+  mutable I3RecoPulseSeriesMapPtr unpacked_;
+
+  friend class icecube::serialization::access;
+  template <class Archive> void save(Archive& ar, unsigned version) const;
+  template <class Archive> void load(Archive& ar, unsigned version);
+  I3_SERIALIZATION_SPLIT_MEMBER();
+
+  SET_LOGGER("I3RecoPulseSeriesMapFlat");
+};
+
+std::ostream& operator<<(std::ostream&, const I3RecoPulseSeriesMapFlat&);
+
+I3_CLASS_VERSION(I3RecoPulseSeriesMapFlat, I3RecoPulseSeriesMapFlat_version_);
+I3_POINTER_TYPEDEFS(I3RecoPulseSeriesMapFlat);
+
+#endif // DATACLASSES_I3RecoPulseSeriesMapFlat_H_INCLUDED
@@ -12,6 +12,7 @@
  *   of the Earth.
  */
 
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -46,7 +47,8 @@ EarthModelService::EarthModelService(const I3Context &c)
     fIceCapTypeString_("SimpleIceCap"),
     fIceCapSimpleAngle_(20.0*I3Units::degree),
     fIceCapSimpleRadius_(-1), // will be recaluclated if needed 
-    fIceCapSimpleZshift_(0) // must be zero, will be recalculated if needed
+    fIceCapSimpleZshift_(0), // must be zero, will be recalculated if needed
+    fAnalyticColumnDepth_(false)
 {
    log_debug("Constructing EarthModelService");
 
@@ -84,6 +86,12 @@ EarthModelService::EarthModelService(const I3Context &c)
                 "coordinate, measured from ice surface",  
                 fDetDepth_);
 
+   AddParameter("AnalyticColumnDepth", "Compute column depths along a "
+                "path by integrating the density polynomial of each layer "
+                "in closed form instead of numerically. Exact up to "
+                "rounding, and much faster for long paths.",
+                fAnalyticColumnDepth_);
+
 }
 
 //__________________________________________________________
@@ -107,7 +115,8 @@ EarthModelService::EarthModelService(
       fIceCapTypeString_(icecapname),
       fIceCapSimpleAngle_(icecapangle),
       fIceCapSimpleRadius_(-1), // will be recaluclated if needed 
-      fIceCapSimpleZshift_(0) // must be zero, will be recalculated if needed
+      fIceCapSimpleZshift_(0), // must be zero, will be recalculated if needed
+      fAnalyticColumnDepth_(false)
 {
    Init();
 }
@@ -173,6 +182,7 @@ void EarthModelService::Configure()
    GetParameter("IceCapType", fIceCapTypeString_);
    GetParameter("IceCapSimpleAngle", fIceCapSimpleAngle_);
    GetParameter("DetectorDepth", fDetDepth_);
+   GetParameter("AnalyticColumnDepth", fAnalyticColumnDepth_);
 
    Init();
 
@@ -472,9 +482,106 @@ const double EarthModelService::GetColumnDepthInCGS(
   I3Position from_pos=GetEarthCoordPosFromDetCoordPos(from_posI3);
   I3Position to_pos=GetEarthCoordPosFromDetCoordPos(to_posI3); 
 
+  if (fAnalyticColumnDepth_)
+     return AnalyticColumnDepthInCGS(from_pos, to_pos);
+
   return IntegrateDensityInCGS(from_pos, to_pos, PATH);
 }
 
+//________________________________________________________________
+// Integral of sum_n params[n]*r^n ds over [s0, s1], where
+// r = sqrt(b2 + s^2) is the distance to the center of a sphere and
+// s the coordinate along a straight line measured from its point of
+// closest approach. With I_n = int r^n ds,
+//   I_n = s*r^n/(n+1) + n*b2/(n+1)*I_(n-2),
+//   I_0 = s,  I_(-1) = asinh(s/b).
+static double PolynomialPathIntegral(const std::vector<double> &params,
+                                     double b2, double s0, double s1)
+{
+   const double r0 = sqrt(b2 + s0*s0);
+   const double r1 = sqrt(b2 + s1*s1);
+
+   // differences I_n(s1) - I_n(s0) of the previous two orders
+   double prev2 = 0; // I_(-1), only ever needed multiplied by b2
+   if (b2 > 0) {
+      const double b = sqrt(b2);
+      prev2 = asinh(s1/b) - asinh(s0/b);
+   }
+   double prev1 = s1 - s0; // I_0
+
+   double sum = params.empty() ? 0 : params[0]*prev1;
+   double p0 = 1, p1 = 1; // r0^n, r1^n
+   for (unsigned int n = 1; n < params.size(); ++n) {
+      p0 *= r0;
+      p1 *= r1;
+      double cur = (s1*p1 - s0*p0 + n*b2*prev2)/(n + 1);
+      sum += params[n]*cur;
+      prev2 = prev1;
+      prev1 = cur;
+   }
+   return sum;
+}
+
+//________________________________________________________________
+double EarthModelService::AnalyticColumnDepthInCGS(
+                 const  I3Position &from_posCE,
+                 const  I3Position &to_posCE) const
+{
+   const double len = (to_posCE - from_posCE).Magnitude();
+   if (len <= 0 || fEarthParams_.empty())
+      return 0;
+   const I3Direction dirCE(to_posCE - from_posCE);
+
+   //
+   // distances along the path at which it crosses a layer boundary.
+   // between two of them GetEarthParam does not change.
+   //
+   std::vector<double> crossings;
+   crossings.reserve(2*(fEarthParams_.size() + fIceParams_.size()) + 2);
+   crossings.push_back(0);
+   crossings.push_back(len);
+
+   const EarthParamMap* layers[2] = {&fEarthParams_, &fIceParams_};
+   for (int i = 0; i < 2; ++i) {
+      BOOST_FOREACH(const EarthParamMap::value_type &layer, *layers[i]) {
+         const EarthParam &ep = layer.second;
+         const I3Position q = from_posCE - I3Position(0, 0, ep.fZOffset_);
+         const double disc = ep.fUpperRadius_*ep.fUpperRadius_
+                             - q.Cross(dirCE).Mag2();
+         if (disc <= 0)
+            continue;
+         const double h = sqrt(disc);
+         const double qd = q*dirCE;
+         if (-qd - h > 0 && -qd - h < len)
+            crossings.push_back(-qd - h);
+         if (-qd + h > 0 && -qd + h < len)
+            crossings.push_back(-qd + h);
+      }
+   }
+   std::sort(crossings.begin(), crossings.end());
+
+   const double atmoRadius = fEarthParams_.rbegin()->second.fUpperRadius_;
+   double depth = 0;
+   for (unsigned int i = 0; i+1 < crossings.size(); ++i) {
+      const double t0 = crossings[i];
+      const double t1 = crossings[i+1];
+      if (t1 <= t0)
+         continue;
+
+      const I3Position mid = from_posCE + 0.5*(t0 + t1)*dirCE;
+      if (mid.Magnitude() > atmoRadius)
+         continue; // nothing to integrate outside of the atmosphere
+
+      const EarthParam &ep = GetEarthParam(mid);
+      const I3Position q = from_posCE - I3Position(0, 0, ep.fZOffset_);
+      const double qd = q*dirCE;
+      depth += PolynomialPathIntegral(ep.fParams_, q.Cross(dirCE).Mag2(),
+                                      t0 + qd, t1 + qd);
+   }
+
+   return depth * M_TO_CM;
+}
+
 //________________________________________________________________
 const double EarthModelService::FlatDepthCalculator(
                  const  I3Position &from_posCE,
@@ -133,6 +133,7 @@ void register_EarthModelService()
      .add_property("detector_depth", &EarthModelService::GetDetectorDepth, &EarthModelService::SetDetectorDepth)
      .add_property("ice_cap_type_string", &get_ice_cap_type_string, set_ice_cap_type_string)
      .add_property("ice_cap_simple_angle", &EarthModelService::GetIceCapSimpleAngle, &EarthModelService::SetIceCapSimpleAngle)
+     .add_property("analytic_column_depth", &EarthModelService::GetAnalyticColumnDepth, &EarthModelService::SetAnalyticColumnDepth)
 
      .add_property("moho_boundary", &EarthModelService::GetMohoBoundary)
      .add_property("rock_ice_boundary", &EarthModelService::GetRockIceBoundary)
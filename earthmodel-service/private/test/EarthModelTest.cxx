@@ -175,6 +175,35 @@ TEST(TestColumnDepthCalculation){
   }
 }
 
+TEST(AnalyticColumnDepth){
+  //The closed-form layer integral must agree with the numerical one,
+  //for paths through the core, along the ice cap and out of the atmosphere
+  const char* icecaps[2] = {"SimpleIceCap", "IceSheet"};
+  for(int i=0; i<2; i++){
+    EarthModelService prem;
+    prem.SetIceCapTypeString(icecaps[i]);
+    prem.SetIceCapSimpleAngle(20*I3Units::degree);
+    ENSURE(!prem.GetAnalyticColumnDepth());
+
+    const I3Position center(0,0,0);
+    for(double zenith=0; zenith<=M_PI; zenith+=M_PI/20){
+      for(double dist=100; dist<2e7; dist*=7){
+        I3Direction dir(zenith,0.3);
+        I3Position start=center+I3Position(300,-200,100);
+        I3Position end=start-dist*dir;
+        prem.SetAnalyticColumnDepth(false);
+        double numerical=prem.GetColumnDepthInCGS(start,end);
+        prem.SetAnalyticColumnDepth(true);
+        double analytic=prem.GetColumnDepthInCGS(start,end);
+        ENSURE_DISTANCE(analytic,numerical,1e-4*numerical+1.0,
+                        "closed-form column depth matches numerical integral");
+        ENSURE_DISTANCE(prem.GetColumnDepthInCGS(end,start),analytic,1e-6*analytic,
+                        "column depth does not depend on direction");
+      }
+    }
+  }
+}
+
 TEST(LeptonRange_test){
   EarthModelService prem;
   
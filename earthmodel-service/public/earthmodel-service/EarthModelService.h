@@ -224,6 +224,10 @@ class EarthModelService : public I3ServiceBase
     * @param[in] from_posI3 from position in I3 coordinate
     *
     * @param[in] to_posI3 to position in I3 coordinate
+    *
+    * If AnalyticColumnDepth is set, the path is split at every layer
+    * boundary and the polynomial density of each layer is integrated
+    * in closed form instead of numerically (see IntegrateDensityInCGS).
     */
    const double GetColumnDepthInCGS(
                     const  I3Position &from_posI3,
@@ -492,6 +496,11 @@ class EarthModelService : public I3ServiceBase
     */
    void SetDetectorXY(double x, double y);
 
+   /**
+    * Use the closed-form layer integral in GetColumnDepthInCGS
+    */
+   void SetAnalyticColumnDepth(bool b) { fAnalyticColumnDepth_ = b; }
+
    //----------
    // getters
    //----------
@@ -521,6 +530,11 @@ class EarthModelService : public I3ServiceBase
     */
    const double GetIceCapSimpleAngle() const { return fIceCapSimpleAngle_; }
 
+   /**
+    * Is the closed-form layer integral used in GetColumnDepthInCGS?
+    */
+   bool GetAnalyticColumnDepth() const { return fAnalyticColumnDepth_; }
+
    /**
     * Get Boundary [m]
     */
@@ -609,6 +623,22 @@ class EarthModelService : public I3ServiceBase
                                     const I3Position &topos_CE,
                                     double density,
                                     IntegType intg_type) const;
+
+   /**
+    * @brief Column depth along a straight path, integrated exactly
+    *
+    * Every layer is a sphere (around the Earth center or, for ice,
+    * around the shifted ice cap center) whose density is a polynomial
+    * in the distance to that center, so between two boundary crossings
+    * the integral has a closed form. Matter beyond the atmosphere is
+    * ignored, as in IntegrateDensityInCGS.
+    *
+    * @param[in] from_posCE from position in Earth centered coordinate
+    * @param[in] to_posCE to position in Earth centered coordinate
+    * @return column depth [g/cm2]
+    */
+   double AnalyticColumnDepthInCGS(const I3Position &from_posCE,
+                                   const I3Position &to_posCE) const;
    
    /**
     * @brief A dummy variable used as a sink for ignored results.
@@ -657,6 +687,9 @@ class EarthModelService : public I3ServiceBase
    double  fIceCapSimpleRadius_; // [m] radius of shpere of simple icecap
    double  fIceCapSimpleZshift_; // [m] z-pos of icecap sphere
 
+   // integrate column depths in closed form rather than numerically
+   bool    fAnalyticColumnDepth_;
+
    // density data map  
    EarthParamMap    fEarthParams_;
    EarthParamMap    fIceParams_;
@@ -0,0 +1,157 @@
+#include <frame_object_diff/ChangedOMKeys.h>
+
+#include <algorithm>
+#include <iterator>
+#include <boost/foreach.hpp>
+
+namespace {
+
+/**
+ * Append the keys that are in only one of the maps or whose values differ.
+ */
+template <typename Map>
+void CompareAll(const Map& a, const Map& b,
+    std::vector<typename Map::key_type>& out)
+{
+  typename Map::const_iterator ia = a.begin();
+  typename Map::const_iterator ib = b.begin();
+  while (ia != a.end() || ib != b.end()) {
+    if (ib == b.end() || (ia != a.end() && ia->first < ib->first)) {
+      out.push_back(ia->first);
+      ia++;
+    } else if (ia == a.end() || ib->first < ia->first) {
+      out.push_back(ib->first);
+      ib++;
+    } else {
+      if (ia->second != ib->second)
+        out.push_back(ia->first);
+      ia++;
+      ib++;
+    }
+  }
+}
+
+/**
+ * Same as CompareAll, but only for the given keys.
+ */
+template <typename Map>
+void CompareKeys(const Map& a, const Map& b,
+    const std::vector<typename Map::key_type>& keys,
+    std::vector<typename Map::key_type>& out)
+{
+  BOOST_FOREACH(const typename Map::key_type& k, keys) {
+    typename Map::const_iterator ia = a.find(k);
+    typename Map::const_iterator ib = b.find(k);
+    if (ia == a.end() && ib == b.end())
+      continue;
+    if (ia == a.end() || ib == b.end() || ia->second != ib->second)
+      out.push_back(k);
+  }
+}
+
+template <typename K>
+std::vector<K> Union(const std::vector<K>& a, const std::vector<K>& b)
+{
+  std::vector<K> keys;
+  keys.reserve(a.size()+b.size());
+  std::set_union(a.begin(), a.end(), b.begin(), b.end(),
+      std::back_inserter(keys));
+  return keys;
+}
+
+/**
+ * Append the OMKeys of the tanks of the given stations, as found in either map.
+ */
+void AddTanks(const I3StationGeoMap& a, const I3StationGeoMap& b,
+    const std::vector<int>& stations, std::vector<OMKey>& out)
+{
+  BOOST_FOREACH(int s, stations) {
+    const I3StationGeoMap* maps[2] = {&a, &b};
+    BOOST_FOREACH(const I3StationGeoMap* m, maps) {
+      I3StationGeoMap::const_iterator i = m->find(s);
+      if (i == m->end())
+        continue;
+      BOOST_FOREACH(const I3TankGeo& tank, i->second)
+        out.insert(out.end(), tank.omKeyList_.begin(), tank.omKeyList_.end());
+    }
+  }
+}
+
+I3VectorOMKeyPtr Finish(std::vector<OMKey>& keys)
+{
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  I3VectorOMKeyPtr result(new I3VectorOMKey);
+  result->assign(keys.begin(), keys.end());
+  return result;
+}
+
+}
+
+I3VectorOMKeyPtr ChangedOMKeys(const I3Geometry& a, const I3Geometry& b)
+{
+  std::vector<OMKey> keys;
+  CompareAll(a.omgeo, b.omgeo, keys);
+  std::vector<int> stations;
+  CompareAll(a.stationgeo, b.stationgeo, stations);
+  AddTanks(a.stationgeo, b.stationgeo, stations, keys);
+  return Finish(keys);
+}
+
+I3VectorOMKeyPtr ChangedOMKeys(const I3Calibration& a, const I3Calibration& b)
+{
+  std::vector<OMKey> keys;
+  CompareAll(a.domCal, b.domCal, keys);
+  CompareAll(a.vemCal, b.vemCal, keys);
+  return Finish(keys);
+}
+
+I3VectorOMKeyPtr ChangedOMKeys(const I3DetectorStatus& a,
+    const I3DetectorStatus& b)
+{
+  std::vector<OMKey> keys;
+  CompareAll(a.domStatus, b.domStatus, keys);
+  return Finish(keys);
+}
+
+I3VectorOMKeyPtr ChangedOMKeys(const I3GeometryDiff& diff_a,
+    const I3GeometryDiff& diff_b, const I3Geometry& a, const I3Geometry& b)
+{
+  std::vector<OMKey> keys;
+  CompareKeys(a.omgeo, b.omgeo,
+      Union(diff_a.omgeo.GetChangedKeys(), diff_b.omgeo.GetChangedKeys()),
+      keys);
+  std::vector<int> stations;
+  CompareKeys(a.stationgeo, b.stationgeo,
+      Union(diff_a.stationgeo.GetChangedKeys(),
+          diff_b.stationgeo.GetChangedKeys()),
+      stations);
+  AddTanks(a.stationgeo, b.stationgeo, stations, keys);
+  return Finish(keys);
+}
+
+I3VectorOMKeyPtr ChangedOMKeys(const I3CalibrationDiff& diff_a,
+    const I3CalibrationDiff& diff_b, const I3Calibration& a,
+    const I3Calibration& b)
+{
+  std::vector<OMKey> keys;
+  CompareKeys(a.domCal, b.domCal,
+      Union(diff_a.domCal.GetChangedKeys(), diff_b.domCal.GetChangedKeys()),
+      keys);
+  CompareKeys(a.vemCal, b.vemCal,
+      Union(diff_a.vemCal.GetChangedKeys(), diff_b.vemCal.GetChangedKeys()),
+      keys);
+  return Finish(keys);
+}
+
+I3VectorOMKeyPtr ChangedOMKeys(const I3DetectorStatusDiff& diff_a,
+    const I3DetectorStatusDiff& diff_b, const I3DetectorStatus& a,
+    const I3DetectorStatus& b)
+{
+  std::vector<OMKey> keys;
+  CompareKeys(a.domStatus, b.domStatus,
+      Union(diff_a.domStatus.GetChangedKeys(),
+          diff_b.domStatus.GetChangedKeys()),
+      keys);
+  return Finish(keys);
+}
@@ -0,0 +1,49 @@
+/**
+ *
+ * copyright  (C) 2020
+ * the icecube collaboration
+ * @version $Id$
+ * @file ChangedOMKeys.h
+ * @date $Date$
+ */
+
+#ifndef CHANGEDOMKEYS_H_INCLUDED
+#define CHANGEDOMKEYS_H_INCLUDED
+
+#include "dataclasses/I3Vector.h"
+#include "frame_object_diff/geometry/I3GeometryDiff.h"
+#include "frame_object_diff/calibration/I3CalibrationDiff.h"
+#include "frame_object_diff/status/I3DetectorStatusDiff.h"
+
+/**
+ * Find the OMKeys whose entries differ between two versions of a
+ * G, C or D frame object, so that code holding state derived from
+ * the old version only has to update those OMs.
+ *
+ * An OMKey is listed if it is present in only one of the objects or
+ * if its entries differ. For geometries, the OMKeys of the tanks of a
+ * changed station are listed too. Trigger status is not keyed by OMKey
+ * and is not compared. The result is sorted.
+ */
+
+/// Compare two complete objects
+I3VectorOMKeyPtr ChangedOMKeys(const I3Geometry& a, const I3Geometry& b);
+I3VectorOMKeyPtr ChangedOMKeys(const I3Calibration& a, const I3Calibration& b);
+I3VectorOMKeyPtr ChangedOMKeys(const I3DetectorStatus& a,
+    const I3DetectorStatus& b);
+
+/**
+ * Compare the objects a and b that the diffs diff_a and diff_b unpacked
+ * to from the same base. Only the entries that one of the diffs touches
+ * can differ, so the rest of the detector is not looked at.
+ */
+I3VectorOMKeyPtr ChangedOMKeys(const I3GeometryDiff& diff_a,
+    const I3GeometryDiff& diff_b, const I3Geometry& a, const I3Geometry& b);
+I3VectorOMKeyPtr ChangedOMKeys(const I3CalibrationDiff& diff_a,
+    const I3CalibrationDiff& diff_b, const I3Calibration& a,
+    const I3Calibration& b);
+I3VectorOMKeyPtr ChangedOMKeys(const I3DetectorStatusDiff& diff_a,
+    const I3DetectorStatusDiff& diff_b, const I3DetectorStatus& a,
+    const I3DetectorStatus& b);
+
+#endif // CHANGEDOMKEYS_H_INCLUDED
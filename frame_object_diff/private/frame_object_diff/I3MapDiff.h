@@ -11,6 +11,9 @@
 #define I3MAPDIFF_H_INCLUDED
 
 #include <cstddef>
+#include <algorithm>
+#include <iterator>
+#include <vector>
 
 #include "icetray/I3FrameObject.h"
 #include "dataclasses/I3String.h"
@@ -96,6 +99,24 @@ public:
     return Unpack(*base);
   }
   
+  /**
+   * Return the keys that this diff adds, changes or removes, in order.
+   */
+  std::vector<K> GetChangedKeys() const
+  {
+    std::vector<K> plus;
+    plus.reserve(plus_.size());
+    BOOST_FOREACH(const new_value_type& v, plus_)
+      plus.push_back(v.first);
+    std::vector<K> minus(minus_);
+    std::sort(minus.begin(), minus.end());
+    std::vector<K> keys;
+    keys.reserve(size());
+    std::merge(plus.begin(), plus.end(), minus.begin(), minus.end(),
+        std::back_inserter(keys));
+    return keys;
+  }
+
   /**
    * Return an iterator over the addition map.
    */
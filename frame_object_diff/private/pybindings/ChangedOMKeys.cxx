@@ -0,0 +1,45 @@
+/**
+ *
+ * copyright  (C) 2020
+ * the icecube collaboration
+ * @version $Id$
+ * @file ChangedOMKeys.cxx
+ * @date $Date$
+ */
+
+#include <frame_object_diff/ChangedOMKeys.h>
+#include <icetray/python/dataclass_suite.hpp>
+
+namespace bp = boost::python;
+
+// handle function overloads
+namespace {
+    I3VectorOMKeyPtr (*Geometry)(const I3Geometry&, const I3Geometry&)
+        = &ChangedOMKeys;
+    I3VectorOMKeyPtr (*Calibration)(const I3Calibration&, const I3Calibration&)
+        = &ChangedOMKeys;
+    I3VectorOMKeyPtr (*DetectorStatus)(const I3DetectorStatus&,
+        const I3DetectorStatus&) = &ChangedOMKeys;
+    I3VectorOMKeyPtr (*GeometryDiff)(const I3GeometryDiff&,
+        const I3GeometryDiff&, const I3Geometry&, const I3Geometry&)
+        = &ChangedOMKeys;
+    I3VectorOMKeyPtr (*CalibrationDiff)(const I3CalibrationDiff&,
+        const I3CalibrationDiff&, const I3Calibration&, const I3Calibration&)
+        = &ChangedOMKeys;
+    I3VectorOMKeyPtr (*DetectorStatusDiff)(const I3DetectorStatusDiff&,
+        const I3DetectorStatusDiff&, const I3DetectorStatus&,
+        const I3DetectorStatus&) = &ChangedOMKeys;
+}
+
+void register_ChangedOMKeys()
+{
+  const char* doc = "OMKeys whose entries differ between two G, C or D objects.";
+  const char* diff_doc = "OMKeys whose entries differ between the objects "
+      "a and b that diff_a and diff_b unpacked to from the same base.";
+  bp::def("changed_omkeys", Geometry, bp::args("a", "b"), doc);
+  bp::def("changed_omkeys", Calibration, bp::args("a", "b"), doc);
+  bp::def("changed_omkeys", DetectorStatus, bp::args("a", "b"), doc);
+  bp::def("changed_omkeys", GeometryDiff, bp::args("diff_a", "diff_b", "a", "b"), diff_doc);
+  bp::def("changed_omkeys", CalibrationDiff, bp::args("diff_a", "diff_b", "a", "b"), diff_doc);
+  bp::def("changed_omkeys", DetectorStatusDiff, bp::args("diff_a", "diff_b", "a", "b"), diff_doc);
+}
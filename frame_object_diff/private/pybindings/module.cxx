@@ -16,7 +16,7 @@ using namespace boost::python;
 #define REGISTER_THESE_THINGS \
     (I3GeometryDiff)(I3CalibrationDiff)(I3DOMCalibrationDiff) \
     (I3DetectorStatusDiff) \
-    (I3VectorDiff)(bitset)
+    (I3VectorDiff)(bitset)(ChangedOMKeys)
 
 #define I3_REGISTRATION_FN_DECL(r, data, t) void BOOST_PP_CAT(register_,t)();
 #define I3_REGISTER(r, data, t) BOOST_PP_CAT(register_,t)();
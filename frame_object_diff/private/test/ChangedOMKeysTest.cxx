@@ -0,0 +1,85 @@
+#include <I3Test.h>
+#include "frame_object_diff/ChangedOMKeys.h"
+
+
+TEST_GROUP(ChangedOMKeysTest);
+
+I3Geometry make_geometry()
+{
+  I3Geometry geo;
+  for (int om = 1; om <= 4; om++) {
+    I3OMGeo& omgeo = geo.omgeo[OMKey(1,om)];
+    omgeo.position = I3Position(0,0,-10*om);
+    omgeo.orientation = I3Orientation(0,0,-1,1,0,0);
+    omgeo.omtype = I3OMGeo::IceCube;
+    omgeo.area = 0.0444;
+  }
+  I3TankGeo tank;
+  tank.omKeyList_.push_back(OMKey(1,61));
+  tank.omKeyList_.push_back(OMKey(1,62));
+  geo.stationgeo[1].push_back(tank);
+  return geo;
+}
+
+TEST(geometry)
+{
+  I3Geometry base = make_geometry();
+  I3Geometry a = base;
+  a.omgeo[OMKey(1,1)].position = I3Position(1,0,-10);
+  I3Geometry b = base;
+  b.omgeo[OMKey(1,2)].position = I3Position(1,0,-20);
+  b.omgeo.erase(OMKey(1,3));
+  b.omgeo[OMKey(2,1)] = b.omgeo[OMKey(1,1)];
+  b.stationgeo[1][0].snowheight = 1;
+
+  std::vector<OMKey> expected;
+  expected.push_back(OMKey(1,1));
+  expected.push_back(OMKey(1,2));
+  expected.push_back(OMKey(1,3));
+  expected.push_back(OMKey(1,61));
+  expected.push_back(OMKey(1,62));
+  expected.push_back(OMKey(2,1));
+
+  I3VectorOMKeyPtr full = ChangedOMKeys(a, b);
+  ENSURE(*full == expected, "full comparison finds all changes");
+
+  I3GeometryDiff diff_a("base", base, a);
+  I3GeometryDiff diff_b("base", base, b);
+  I3VectorOMKeyPtr incremental = ChangedOMKeys(diff_a, diff_b, a, b);
+  ENSURE(*incremental == expected, "diff comparison finds all changes");
+
+  ENSURE(ChangedOMKeys(a, a)->empty(), "no changes");
+  ENSURE(ChangedOMKeys(diff_a, diff_a, a, a)->empty(), "no changes");
+}
+
+I3DOMStatus make_status(double hv)
+{
+  I3DOMStatus status;
+  status.lcWindowPre = 1000;
+  status.lcWindowPost = 1000;
+  status.pmtHV = hv;
+  status.speThreshold = 1;
+  status.dacTriggerBias0 = 850;
+  status.dacTriggerBias1 = 850;
+  status.dacFADCRef = 800;
+  status.mpeThreshold = 1;
+  return status;
+}
+
+TEST(status)
+{
+  I3DetectorStatus base;
+  for (int om = 1; om <= 4; om++)
+    base.domStatus[OMKey(1,om)] = make_status(1000+om);
+  I3DetectorStatus a = base;
+  a.domStatus[OMKey(1,4)] = make_status(0);
+  I3DetectorStatus b = a;
+  b.domStatus[OMKey(1,2)] = make_status(0);
+
+  I3DetectorStatusDiff diff_a("base", base, a);
+  I3DetectorStatusDiff diff_b("base", base, b);
+  I3VectorOMKeyPtr changed = ChangedOMKeys(diff_a, diff_b, a, b);
+  ENSURE_EQUAL(changed->size(), 1u);
+  ENSURE_EQUAL(changed->front(), OMKey(1,2));
+  ENSURE(*ChangedOMKeys(a, b) == *changed);
+}
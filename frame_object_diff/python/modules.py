@@ -98,9 +98,18 @@ class _AbstractUncompressor(icetray.I3ConditionalModule):
                             in frame (default disabled)
     :param frame_callback: (optional) Callback to receive uncompressed frames
                            instead of writing them in the frame stream.
+    :param changed_omkeys: (optional) Also write an I3VectorOMKey named
+                           <object name>ChangedOMKeys with the OMKeys whose
+                           entries differ from the previous frame of this
+                           type (default disabled)
     :param If: (optional) Callable to decide whether to run on the frame.
 
     If ``base_frame`` is not supplied, it is looked up from ``base_filename``.
+
+    With ``changed_omkeys``, modules that keep state derived from the
+    G, C or D frame can update only the listed OMs. The first frame lists
+    every OMKey. When two consecutive frames are diffs against the same
+    base, only the entries touched by either diff are compared.
     """
     def __init__(self,context,frame_type):
         super(_AbstractUncompressor,self).__init__(context)
@@ -109,6 +118,7 @@ class _AbstractUncompressor(icetray.I3ConditionalModule):
         self.AddParameter('base_frame','Frame from base filename to uncompress against',None)
         self.AddParameter('keep_compressed','Enable/disable keeping compressed objects in frame (default disabled)',True)
         self.AddParameter('frame_callback','Callback to receive uncompressed frames',None)
+        self.AddParameter('changed_omkeys','Write the OMKeys that changed since the previous frame (default disabled)',False)
         self.AddOutBox('OutBox')
 
     def Configure(self):
@@ -116,6 +126,8 @@ class _AbstractUncompressor(icetray.I3ConditionalModule):
         if not self.base_frame:
             raise Exception('base_frame required')
         self.keep_compressed = self.GetParameter('keep_compressed')
+        self.changed_omkeys = self.GetParameter('changed_omkeys')
+        self.previous = {}
         self.frame_callback = self.GetParameter('frame_callback')
         if self.frame_callback and not callable(self.frame_callback):
             raise Exception('frame_callback is not callable')
@@ -134,16 +146,25 @@ class _AbstractUncompressor(icetray.I3ConditionalModule):
             # attempt to uncompress everything in the frame
             if self.frame_callback:
                 new_frame = icetray.I3Frame(frame.Stop)
+            unpacked = set()
             for k in frame.keys():
                 if frame.get_stop(k) == self.frame_type:
                     if k.endswith('Diff'):
                         try:
                             new_k = k.replace('Diff','')
-                            obj = frame[k].unpack(base_frame[new_k])
+                            diff = frame[k]
+                            obj = diff.unpack(base_frame[new_k])
                             if self.frame_callback:
                                 new_frame[new_k] = obj
                             else:
                                 frame[new_k] = obj
+                            if self.changed_omkeys:
+                                changed = self.ChangedOMKeys(new_k,diff,base_frame,obj)
+                                if self.frame_callback:
+                                    new_frame[new_k+'ChangedOMKeys'] = changed
+                                else:
+                                    frame[new_k+'ChangedOMKeys'] = changed
+                                unpacked.add(new_k)
                             if not self.keep_compressed:
                                 del frame[k]
                         except Exception as e:
@@ -154,11 +175,32 @@ class _AbstractUncompressor(icetray.I3ConditionalModule):
                     elif self.frame_callback:
                         new_frame[k] = frame[k]
 
+            # anything not unpacked here can't be compared against later
+            for name in list(self.previous):
+                if name not in unpacked:
+                    del self.previous[name]
+
             if self.frame_callback:
                 self.frame_callback(new_frame)
 
         self.PushFrame(frame)
 
+    def ChangedOMKeys(self, name, diff, base_frame, obj):
+        """
+        Find the OMKeys of obj that differ from the previous object
+        delivered under name.
+        """
+        previous = self.previous.get(name)
+        self.previous[name] = (diff, base_frame, obj)
+        if previous is None:
+            return frame_object_diff.changed_omkeys(obj.__class__(), obj)
+        prev_diff, prev_base_frame, prev_obj = previous
+        if (prev_base_frame is base_frame and
+            prev_diff.base_filename == diff.base_filename):
+            return frame_object_diff.changed_omkeys(prev_diff, diff,
+                                                    prev_obj, obj)
+        return frame_object_diff.changed_omkeys(prev_obj, obj)
+
 class GeometryCompressor(_AbstractCompressor):
     __doc__ = '\n'.join(_AbstractCompressor.__doc__.split('\n')[2:])
     def __init__(self,context):
@@ -91,6 +91,7 @@ def uncompress(tray, name,
                base_frames={},
                keep_compressed=False,
                frame_callback=None,
+               changed_omkeys=False,
                If=lambda f:True):
     """
     A general uncompressor for GCD frames. The reverse of compress.
@@ -100,6 +101,8 @@ def uncompress(tray, name,
     :param base_frames: (optional) Pre-existing copy of GCD frames in a dictionary.
     :param keep_compressed: (optional) Keep the compressed objects (default False).
     :param frame_callback: (optional) Function callback which receives the uncompressed frames.
+    :param changed_omkeys: (optional) Write the OMKeys that changed since the previous
+                           G, C or D frame as <object name>ChangedOMKeys (default False).
     :param If: (optional) Callable to decide whether to run on the frame.
 
     If frame_callback is enabled, uncompressed objects will not be written
@@ -152,18 +155,21 @@ def uncompress(tray, name,
                    base_frame=partial(get,'Geometry'),
                    keep_compressed=keep_compressed,
                    frame_callback=frame_callback,
+                   changed_omkeys=changed_omkeys,
                    If=If)
 
     tray.AddModule(modules.CalibrationUncompressor,name+'_Calibration',
                    base_frame=partial(get,'Calibration'),
                    keep_compressed=keep_compressed,
                    frame_callback=frame_callback,
+                   changed_omkeys=changed_omkeys,
                    If=If)
 
     tray.AddModule(modules.DetectorStatusUncompressor,name+'_DetectorStatus',
                    base_frame=partial(get,'DetectorStatus'),
                    keep_compressed=keep_compressed,
                    frame_callback=frame_callback,
+                   changed_omkeys=changed_omkeys,
                    If=If)
 
 
@@ -215,10 +221,12 @@ def inline_compress(tray, name, If=lambda f:True):
                    If = my_If)
 
 @icetray.traysegment
-def inline_uncompress(tray, name, If=lambda f:True):
+def inline_uncompress(tray, name, changed_omkeys=False, If=lambda f:True):
     """
     An inline uncompressor for GCD frames. The reverse of inline_compress.
 
+    :param changed_omkeys: (optional) Write the OMKeys that changed since the previous
+                           G, C or D frame as <object name>ChangedOMKeys (default False).
     :param If: (optional) Callable to decide whether to run on the frame.
     """
     gcd_streams = [icetray.I3Frame.Geometry,
@@ -246,14 +254,17 @@ def inline_uncompress(tray, name, If=lambda f:True):
     tray.AddModule(modules.GeometryUncompressor,name+'_Geometry',
                    base_frame=partial(get,'Geometry'),
                    keep_compressed=False,
+                   changed_omkeys=changed_omkeys,
                    If=my_If)
 
     tray.AddModule(modules.CalibrationUncompressor,name+'_Calibration',
                    base_frame=partial(get,'Calibration'),
                    keep_compressed=False,
+                   changed_omkeys=changed_omkeys,
                    If=my_If)
 
     tray.AddModule(modules.DetectorStatusUncompressor,name+'_DetectorStatus',
                    base_frame=partial(get,'DetectorStatus'),
                    keep_compressed=False,
+                   changed_omkeys=changed_omkeys,
                    If=my_If)
@@ -265,8 +265,9 @@ void I3G4TankResponse::BeginEvent(const I3Particle& primary)
 
 bool I3G4TankResponse::TrackParticle(const ExtendedI3Particle& particle, HitHistoCollection& hitHC, HitHistoCollection& cherHitCollection)
 {
+  I3Particle entry;
   if (GeoFunctions::IntersectCylinder(GetX(), GetY(), GetZ(), GetVirtualTankHeight(),
-                                      GetVirtualTankRadius(), particle))
+                                      GetVirtualTankRadius(), particle, entry))
   {
     if (vemCounter_ < VEM_THRESHOLD) {
       particlesBeforeThreshold_++;
@@ -275,47 +276,8 @@ bool I3G4TankResponse::TrackParticle(const ExtendedI3Particle& particle, HitHist
       return true;
     }
     
-    g4Interface_->InjectParticle(particle);
-    
-    // Loop over all active DOMs in tank
-    double sum_vem = 0.;
-    int num_vem = 0;
-    std::map<OMKey, double>::const_iterator pePerVEM_iter;
-    for (pePerVEM_iter=pePerVEM_.begin(); pePerVEM_iter!=pePerVEM_.end(); ++pePerVEM_iter)
-    {
-      const OMKey& omKey = pePerVEM_iter->first;
-      ExtendedI3Particle iceTrack(particle); // copy constructor preserves ParticleID
-      iceTrack.SetTime(particle.GetTime() + g4Tank_->GetTime_I3(omKey));
-      iceTrack.SetShape(I3Particle::MCTrack);
-
-      double vem_mean = 0.;
-      double cher_mean = 0.;
-      if (cherenkovMethod_) {
-        if (cherenkovWeighting_) {
-          cher_mean = g4Tank_->GetNumCherenkovWeight(omKey);
-          vem_mean = cher_mean / WEIGHTED_PHOTONS_PER_VEM;
-        } else {
-          cher_mean = g4Tank_->GetNumCherenkov(omKey);
-          vem_mean = cher_mean / PHOTONS_PER_VEM;
-        }
-      } else {
-        cher_mean = g4Tank_->GetEDep_I3(omKey);
-        vem_mean = cher_mean / MEV_PER_VEM;
-      }
-      sum_vem += vem_mean;
-      if (vem_mean > 0) num_vem++;
-      
-      // Calculate mean number of photoelectrons according to actual VEM calibration
-      double npe_mean = vem_mean * pePerVEM_iter->second * chargeScale_;
-      
-      // Dial npe according to Poisson distribution
-      int num_hits = randomService_->Poisson(npe_mean);
-
-      cherHitCollection.GetHitHisto(omKey).Fill(iceTrack.GetStartTime(), int(cher_mean), iceTrack);
-      GenerateHits(num_hits, iceTrack, hitHC.GetHitHisto(omKey));
-      //log_warn("DOM: %s, VEM: %.2f, ",omKey.str().c_str(), vem_mean);
-    }
-    if (num_vem > 0) vemCounter_ += sum_vem / num_vem;
+    const double vem = ParticleResponse(particle, entry, hitHC, cherHitCollection);
+    if (vem > 0) vemCounter_ += vem;
     else return false;
 
     return true;
@@ -329,6 +291,52 @@ bool I3G4TankResponse::TrackParticle(const ExtendedI3Particle& particle, HitHist
 }
 
 
+double I3G4TankResponse::Geant4Response(const ExtendedI3Particle& particle, HitHistoCollection& hitHC, HitHistoCollection& cherHitCollection)
+{
+  g4Interface_->InjectParticle(particle);
+  
+  // Loop over all active DOMs in tank
+  double sum_vem = 0.;
+  int num_vem = 0;
+  std::map<OMKey, double>::const_iterator pePerVEM_iter;
+  for (pePerVEM_iter=pePerVEM_.begin(); pePerVEM_iter!=pePerVEM_.end(); ++pePerVEM_iter)
+  {
+    const OMKey& omKey = pePerVEM_iter->first;
+    ExtendedI3Particle iceTrack(particle); // copy constructor preserves ParticleID
+    iceTrack.SetTime(particle.GetTime() + g4Tank_->GetTime_I3(omKey));
+    iceTrack.SetShape(I3Particle::MCTrack);
+
+    double vem_mean = 0.;
+    double cher_mean = 0.;
+    if (cherenkovMethod_) {
+      if (cherenkovWeighting_) {
+        cher_mean = g4Tank_->GetNumCherenkovWeight(omKey);
+        vem_mean = cher_mean / WEIGHTED_PHOTONS_PER_VEM;
+      } else {
+        cher_mean = g4Tank_->GetNumCherenkov(omKey);
+        vem_mean = cher_mean / PHOTONS_PER_VEM;
+      }
+    } else {
+      cher_mean = g4Tank_->GetEDep_I3(omKey);
+      vem_mean = cher_mean / MEV_PER_VEM;
+    }
+    sum_vem += vem_mean;
+    if (vem_mean > 0) num_vem++;
+    
+    // Calculate mean number of photoelectrons according to actual VEM calibration
+    double npe_mean = vem_mean * pePerVEM_iter->second * chargeScale_;
+    
+    // Dial npe according to Poisson distribution
+    int num_hits = randomService_->Poisson(npe_mean);
+
+    cherHitCollection.GetHitHisto(omKey).Fill(iceTrack.GetStartTime(), int(cher_mean), iceTrack);
+    GenerateHits(num_hits, iceTrack, hitHC.GetHitHisto(omKey));
+    //log_warn("DOM: %s, VEM: %.2f, ",omKey.str().c_str(), vem_mean);
+  }
+  return num_vem > 0 ? sum_vem / num_vem : 0.;
+}
+
+
 void I3G4TankResponse::GenerateHits(int npe, const ExtendedI3Particle& p, HitHisto& hitHisto)
 {
   if (npe == 0)
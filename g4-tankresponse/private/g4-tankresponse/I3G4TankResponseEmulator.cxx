@@ -0,0 +1,201 @@
+/**
+ * Copyright (C) 2020
+ * The IceCube collaboration
+ * ID: $Id$
+ *
+ * @file I3G4TankResponseEmulator.cxx
+ * @version $Revision$
+ * @date $Date$
+ *
+ * $LastChangedBy$
+ */
+
+
+#include <topsimulator/interface/I3IceTopResponseFactory.h>
+#include <g4-tankresponse/g4classes/G4IceTopTank.h>
+#include <g4-tankresponse/I3G4TankResponseEmulator.h>
+#include <phys-services/I3RandomService.h>
+
+#include <boost/weak_ptr.hpp>
+
+#include <cmath>
+#include <map>
+
+/**
+ * A table shared by all tanks. When recording, it is written out once the
+ * last tank is gone.
+ */
+struct I3G4TankResponseEmulator::SharedTable
+{
+  I3TankResponseTablePtr table;
+  std::string output;
+
+  ~SharedTable()
+  {
+    if (!output.empty())
+      table->Write(output);
+  }
+};
+
+namespace {
+  std::map<std::string, boost::weak_ptr<I3G4TankResponseEmulator::SharedTable> > sharedTables;
+}
+
+
+I3G4TankResponseEmulator::I3G4TankResponseEmulator(I3Configuration& config, const I3Context& context, const TankKey& tankKey):
+  I3G4TankResponse(config, context, tankKey),
+  tableFile_(""), recordFile_(""), minEntries_(100),
+  numEmulated_(0), numTracked_(0)
+{
+  AddParameter("ResponseTable",
+               "Table of the tank response written in RecordTable mode. "
+               "If empty, all particles are tracked with Geant4.",
+               tableFile_);
+  AddParameter("RecordTable",
+               "Track all particles with Geant4 and record the response table into this file.",
+               recordFile_);
+  AddParameter("MinTableEntries",
+               "Particles in table bins with fewer entries are tracked with Geant4.",
+               minEntries_);
+}
+
+
+I3G4TankResponseEmulator::~I3G4TankResponseEmulator()
+{
+  if (numEmulated_ + numTracked_ > 0)
+    log_debug_stream("Tank " << tankKey_ << ": " << numEmulated_ << " particles emulated, "
+                     << numTracked_ << " tracked with Geant4");
+}
+
+
+I3TankResponseTable::SignalMethod I3G4TankResponseEmulator::GetSignalMethod() const
+{
+  if (!cherenkovMethod_)
+    return I3TankResponseTable::EnergyDeposit;
+  return cherenkovWeighting_ ? I3TankResponseTable::WeightedCherenkov : I3TankResponseTable::Cherenkov;
+}
+
+
+void I3G4TankResponseEmulator::Configure()
+{
+  I3G4TankResponse::Configure();
+
+  GetParameter("ResponseTable", tableFile_);
+  GetParameter("RecordTable", recordFile_);
+  GetParameter("MinTableEntries", minEntries_);
+
+  if (!tableFile_.empty() && !recordFile_.empty())
+    log_fatal("Set either ResponseTable or RecordTable, not both");
+
+  const std::string& key = recordFile_.empty() ? tableFile_ : recordFile_;
+  if (key.empty()) {
+    log_info(" + Response table           : DISABLED");
+    return;
+  }
+
+  table_ = sharedTables[key].lock();
+  if (!table_) {
+    table_ = boost::shared_ptr<SharedTable>(new SharedTable);
+    if (recordFile_.empty()) {
+      table_->table = I3TankResponseTablePtr(new I3TankResponseTable(tableFile_));
+    } else {
+      table_->table = I3TankResponseTablePtr(new I3TankResponseTable(GetSignalMethod()));
+      table_->output = recordFile_;
+    }
+    sharedTables[key] = table_;
+  }
+
+  if (table_->table->GetSignalMethod() != GetSignalMethod())
+    log_fatal("Response table %s was made with a different CherenkovMethod/CherenkovWeighting", key.c_str());
+
+  if (recordFile_.empty())
+    log_info(" + Response table           : %s (min. %u entries)", tableFile_.c_str(), minEntries_);
+  else
+    log_info(" + Response table           : RECORDING to %s", recordFile_.c_str());
+}
+
+
+double I3G4TankResponseEmulator::Geant4Delay(const ExtendedI3Particle& particle, const I3Particle& entry) const
+{
+  double sum = 0.;
+  int n = 0;
+  std::map<OMKey, double>::const_iterator pePerVEM_iter;
+  for (pePerVEM_iter=pePerVEM_.begin(); pePerVEM_iter!=pePerVEM_.end(); ++pePerVEM_iter)
+  {
+    const OMKey& omKey = pePerVEM_iter->first;
+    double signal = 0.;
+    if (cherenkovMethod_)
+      signal = cherenkovWeighting_ ? g4Tank_->GetNumCherenkovWeight(omKey) : g4Tank_->GetNumCherenkov(omKey);
+    else
+      signal = g4Tank_->GetEDep_I3(omKey);
+    const double time = g4Tank_->GetTime_I3(omKey);
+    if (signal > 0 && std::isfinite(time)) {
+      sum += particle.GetTime() + time - entry.GetTime();
+      n++;
+    }
+  }
+  return n > 0 ? sum / n : 0.;
+}
+
+
+double I3G4TankResponseEmulator::ParticleResponse(const ExtendedI3Particle& particle, const I3Particle& entry,
+                                                  HitHistoCollection& hitHC, HitHistoCollection& cherHitCollection)
+{
+  if (!table_)
+    return Geant4Response(particle, hitHC, cherHitCollection);
+
+  I3TankResponseTable& table = *table_->table;
+  const int bin = table.GetBin(particle, GetSnowHeight());
+
+  if (!table_->output.empty()) {
+    const double vem = Geant4Response(particle, hitHC, cherHitCollection);
+    if (bin >= 0)
+      table.Fill(bin, vem, Geant4Delay(particle, entry));
+    numTracked_++;
+    return vem;
+  }
+
+  if (bin < 0 || table.GetEntries(bin) < minEntries_) {
+    numTracked_++;
+    return Geant4Response(particle, hitHC, cherHitCollection);
+  }
+
+  numEmulated_++;
+  const double vem = table.SampleVEM(bin, *randomService_);
+  if (!(vem > 0))
+    return 0.;
+
+  double cherPerVEM = 0.;
+  switch (table.GetSignalMethod()) {
+  case I3TankResponseTable::Cherenkov:
+    cherPerVEM = PHOTONS_PER_VEM;
+    break;
+  case I3TankResponseTable::WeightedCherenkov:
+    cherPerVEM = WEIGHTED_PHOTONS_PER_VEM;
+    break;
+  case I3TankResponseTable::EnergyDeposit:
+    cherPerVEM = MEV_PER_VEM;
+    break;
+  }
+
+  // Same signal and time in all DOMs of the tank
+  const double time = entry.GetTime() + table.GetMeanDelay(bin);
+  std::map<OMKey, double>::const_iterator pePerVEM_iter;
+  for (pePerVEM_iter=pePerVEM_.begin(); pePerVEM_iter!=pePerVEM_.end(); ++pePerVEM_iter)
+  {
+    const OMKey& omKey = pePerVEM_iter->first;
+    ExtendedI3Particle iceTrack(particle); // copy constructor preserves ParticleID
+    iceTrack.SetTime(time);
+    iceTrack.SetShape(I3Particle::MCTrack);
+
+    double npe_mean = vem * pePerVEM_iter->second * chargeScale_;
+    int num_hits = randomService_->Poisson(npe_mean);
+
+    cherHitCollection.GetHitHisto(omKey).Fill(iceTrack.GetStartTime(), int(vem * cherPerVEM), iceTrack);
+    GenerateHits(num_hits, iceTrack, hitHC.GetHitHisto(omKey));
+  }
+  return vem;
+}
+
+
+I3_SERVICE_FACTORY(I3IceTopResponseFactory<I3G4TankResponseEmulator>);
@@ -0,0 +1,212 @@
+/**
+ * Copyright (C) 2020
+ * The IceCube collaboration
+ * ID: $Id$
+ *
+ * @file I3TankResponseTable.cxx
+ * @version $Revision$
+ * @date $Date$
+ *
+ * $LastChangedBy$
+ */
+
+
+#include <g4-tankresponse/I3TankResponseTable.h>
+#include <phys-services/I3RandomService.h>
+#include <icetray/I3Units.h>
+
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+namespace {
+  const char* HEADER = "I3TankResponseTable";
+  const int VERSION = 1;
+
+  void ReadAxis(std::istream& in, const std::string& name, I3TankResponseTable::Axis& axis)
+  {
+    std::string tag;
+    in >> tag >> axis.n >> axis.min >> axis.max;
+    if (!in || tag != name || axis.n == 0 || !(axis.max > axis.min))
+      log_fatal("Bad or missing axis \"%s\" in tank response table", name.c_str());
+  }
+
+  void WriteAxis(std::ostream& out, const std::string& name, const I3TankResponseTable::Axis& axis)
+  {
+    out << name << " " << axis.n << " " << axis.min << " " << axis.max << "\n";
+  }
+}
+
+
+int I3TankResponseTable::Axis::Bin(double x) const
+{
+  if (!(x >= min && x <= max))
+    return -1;
+  return std::min(int(n - 1), int(n*(x - min)/(max - min)));
+}
+
+
+I3TankResponseTable::I3TankResponseTable(SignalMethod method):
+  method_(method),
+  logEnergy_(25, -3., 2.),
+  cosZenith_(5, 0., 1.),
+  snowHeight_(10, 0., 2.5*I3Units::m),
+  logVEM_(50, -3., 2.)
+{
+  Allocate();
+}
+
+
+I3TankResponseTable::I3TankResponseTable(const std::string& path)
+{
+  std::ifstream in(path.c_str());
+  if (!in)
+    log_fatal("Unable to open tank response table %s", path.c_str());
+
+  std::string header;
+  int version, method;
+  in >> header >> version >> method;
+  if (!in || header != HEADER)
+    log_fatal("%s is not a tank response table", path.c_str());
+  if (version != VERSION)
+    log_fatal("Tank response table %s has version %d, expected %d", path.c_str(), version, VERSION);
+  if (method < EnergyDeposit || method > WeightedCherenkov)
+    log_fatal("Unknown signal method %d in tank response table %s", method, path.c_str());
+  method_ = SignalMethod(method);
+
+  ReadAxis(in, "logenergy", logEnergy_);
+  ReadAxis(in, "coszenith", cosZenith_);
+  ReadAxis(in, "snowheight", snowHeight_);
+  ReadAxis(in, "logvem", logVEM_);
+  Allocate();
+
+  // Only the filled bins are stored
+  const size_t nsignal = logVEM_.n + 1;
+  size_t bin;
+  while (in >> bin) {
+    if (bin >= NumBins())
+      log_fatal("Bin %zu out of range in tank response table %s", bin, path.c_str());
+    in >> entries_[bin] >> signals_[bin] >> delaySum_[bin];
+    for (size_t i = 0; i < nsignal; ++i)
+      in >> counts_[bin*nsignal + i];
+    if (!in)
+      log_fatal("Truncated tank response table %s", path.c_str());
+  }
+  if (!in.eof())
+    log_fatal("Unable to parse tank response table %s", path.c_str());
+}
+
+
+void I3TankResponseTable::Allocate()
+{
+  entries_.assign(NumBins(), 0);
+  signals_.assign(NumBins(), 0);
+  delaySum_.assign(NumBins(), 0.);
+  counts_.assign(NumBins()*(logVEM_.n + 1), 0);
+}
+
+
+void I3TankResponseTable::Write(const std::string& path) const
+{
+  std::ofstream out(path.c_str());
+  if (!out) {
+    log_error("Unable to write tank response table %s", path.c_str());
+    return;
+  }
+  out.precision(std::numeric_limits<double>::digits10 + 2);
+
+  out << HEADER << " " << VERSION << " " << int(method_) << "\n";
+  WriteAxis(out, "logenergy", logEnergy_);
+  WriteAxis(out, "coszenith", cosZenith_);
+  WriteAxis(out, "snowheight", snowHeight_);
+  WriteAxis(out, "logvem", logVEM_);
+
+  const size_t nsignal = logVEM_.n + 1;
+  for (size_t bin = 0; bin < NumBins(); ++bin) {
+    if (entries_[bin] == 0)
+      continue;
+    out << bin << " " << entries_[bin] << " " << signals_[bin] << " " << delaySum_[bin];
+    for (size_t i = 0; i < nsignal; ++i)
+      out << " " << counts_[bin*nsignal + i];
+    out << "\n";
+  }
+  log_info("Wrote tank response table %s", path.c_str());
+}
+
+
+unsigned I3TankResponseTable::ParticleClass(I3Particle::ParticleType type)
+{
+  switch (type) {
+  case I3Particle::Gamma:
+    return 0;
+  case I3Particle::EPlus:
+  case I3Particle::EMinus:
+    return 1;
+  case I3Particle::MuPlus:
+  case I3Particle::MuMinus:
+    return 2;
+  default:
+    break;
+  }
+  return 3;
+}
+
+
+int I3TankResponseTable::GetBin(const I3Particle& particle, double snowHeight) const
+{
+  const int e = logEnergy_.Bin(std::log10(particle.GetEnergy()/I3Units::GeV));
+  const int c = cosZenith_.Bin(std::abs(particle.GetDir().GetZ()));
+  const int s = snowHeight_.Bin(snowHeight);
+  if (e < 0 || c < 0 || s < 0)
+    return -1;
+  return ((int(ParticleClass(particle.GetType()))*logEnergy_.n + e)*cosZenith_.n + c)*snowHeight_.n + s;
+}
+
+
+void I3TankResponseTable::Fill(int bin, double vem, double delay)
+{
+  entries_.at(bin)++;
+  unsigned long* counts = &counts_[bin*(logVEM_.n + 1)];
+  if (!(vem > 0)) {
+    counts[0]++;
+    return;
+  }
+  // Signals outside of the axis go to the first and last bin
+  const double x = std::log10(vem);
+  int i = logVEM_.Bin(x);
+  if (i < 0)
+    i = (x < logVEM_.min) ? 0 : logVEM_.n - 1;
+  counts[i + 1]++;
+  signals_[bin]++;
+  delaySum_[bin] += delay;
+}
+
+
+double I3TankResponseTable::SampleVEM(int bin, I3RandomService& rng) const
+{
+  const unsigned long n = entries_.at(bin);
+  if (n == 0)
+    return 0.;
+  const unsigned long* counts = &counts_[bin*(logVEM_.n + 1)];
+  unsigned long k = rng.Integer(n);
+  if (k < counts[0])
+    return 0.;
+  k -= counts[0];
+  for (unsigned i = 0; i < logVEM_.n; ++i) {
+    if (k < counts[i + 1]) {
+      // uniform in log10(VEM) within the bin
+      const double width = (logVEM_.max - logVEM_.min)/logVEM_.n;
+      return std::pow(10., logVEM_.min + (i + rng.Uniform())*width);
+    }
+    k -= counts[i + 1];
+  }
+  log_fatal("Inconsistent counts in bin %d of the tank response table", bin);
+  return 0.;
+}
+
+
+double I3TankResponseTable::GetMeanDelay(int bin) const
+{
+  const unsigned long n = signals_.at(bin);
+  return n > 0 ? delaySum_[bin]/n : 0.;
+}
@@ -0,0 +1,88 @@
+#include <I3Test.h>
+
+#include <g4-tankresponse/I3TankResponseTable.h>
+#include <phys-services/I3GSLRandomService.h>
+#include <dataclasses/physics/I3Particle.h>
+#include <icetray/I3Units.h>
+
+#include <cmath>
+#include <cstdio>
+
+TEST_GROUP(I3TankResponseTable);
+
+namespace {
+  I3Particle MakeParticle(I3Particle::ParticleType type, double energy, double zenith)
+  {
+    I3Particle particle;
+    particle.SetType(type);
+    particle.SetEnergy(energy);
+    particle.SetDir(zenith, 0.);
+    return particle;
+  }
+}
+
+TEST(Binning)
+{
+  I3TankResponseTable table(I3TankResponseTable::Cherenkov);
+  const I3Particle muon = MakeParticle(I3Particle::MuMinus, 4*I3Units::GeV, 0.);
+
+  ENSURE(table.GetBin(muon, 0.) >= 0);
+  ENSURE_EQUAL(table.GetBin(muon, 0.), table.GetBin(MakeParticle(I3Particle::MuPlus, 4*I3Units::GeV, 0.), 0.));
+  ENSURE(table.GetBin(muon, 0.) != table.GetBin(MakeParticle(I3Particle::EMinus, 4*I3Units::GeV, 0.), 0.));
+  ENSURE(table.GetBin(muon, 0.) != table.GetBin(muon, 1.*I3Units::m));
+
+  // outside of the table
+  ENSURE_EQUAL(table.GetBin(MakeParticle(I3Particle::MuMinus, 1*I3Units::TeV, 0.), 0.), -1);
+  ENSURE_EQUAL(table.GetBin(muon, 10*I3Units::m), -1);
+}
+
+TEST(Sampling)
+{
+  I3TankResponseTable table(I3TankResponseTable::Cherenkov);
+  I3GSLRandomService rng(1);
+  const int bin = table.GetBin(MakeParticle(I3Particle::Gamma, 10*I3Units::MeV, 0.3), 0.5*I3Units::m);
+
+  ENSURE_EQUAL(table.GetEntries(bin), 0ul);
+  ENSURE_EQUAL(table.SampleVEM(bin, rng), 0.);
+
+  for (int i = 0; i < 10; ++i)
+    table.Fill(bin, 0., 0.);
+  ENSURE_EQUAL(table.SampleVEM(bin, rng), 0.);
+
+  // all signals in the bin of 1.2 VEM
+  const I3TankResponseTable::Axis& axis = table.GetLogVEMAxis();
+  const int i = axis.Bin(std::log10(1.2));
+  const double width = (axis.max - axis.min)/axis.n;
+  table = I3TankResponseTable(I3TankResponseTable::Cherenkov);
+  for (int j = 0; j < 10; ++j)
+    table.Fill(bin, 1.2, 10*I3Units::ns + j);
+  ENSURE_DISTANCE(table.GetMeanDelay(bin), 14.5*I3Units::ns, 1e-9);
+  for (int j = 0; j < 100; ++j) {
+    const double vem = table.SampleVEM(bin, rng);
+    ENSURE(vem >= std::pow(10., axis.min + i*width));
+    ENSURE(vem <= std::pow(10., axis.min + (i + 1)*width));
+  }
+}
+
+TEST(ReadWrite)
+{
+  I3TankResponseTable table(I3TankResponseTable::WeightedCherenkov);
+  I3GSLRandomService rng(2);
+  const int bin = table.GetBin(MakeParticle(I3Particle::EPlus, 50*I3Units::MeV, 0.7), 0.2*I3Units::m);
+  for (int j = 0; j < 100; ++j)
+    table.Fill(bin, j % 3 ? rng.Uniform(0.01, 10.) : 0., rng.Uniform(5., 20.));
+
+  const std::string path = "I3TankResponseTable_test.txt";
+  table.Write(path);
+  I3TankResponseTable copy(path);
+  std::remove(path.c_str());
+
+  ENSURE_EQUAL(copy.GetSignalMethod(), I3TankResponseTable::WeightedCherenkov);
+  ENSURE_EQUAL(copy.GetBin(MakeParticle(I3Particle::EPlus, 50*I3Units::MeV, 0.7), 0.2*I3Units::m), bin);
+  ENSURE_EQUAL(copy.GetEntries(bin), 100ul);
+  ENSURE_DISTANCE(copy.GetMeanDelay(bin), table.GetMeanDelay(bin), 1e-9);
+
+  I3GSLRandomService rng1(3), rng2(3);
+  for (int j = 0; j < 100; ++j)
+    ENSURE_EQUAL(copy.SampleVEM(bin, rng1), table.SampleVEM(bin, rng2));
+}
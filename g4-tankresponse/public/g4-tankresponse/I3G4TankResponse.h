@@ -74,6 +74,20 @@ class I3G4TankResponse : public I3TankResponse
  private:
   bool IntersectTank(const I3Particle& particle, double margin);
 
+ protected:
+  /**
+   * Generate the hits of a particle which entered the virtual tank (at the
+   * position and time of entry). Returns the mean signal of the DOMs in VEM,
+   * 0 if there is none. The default tracks the particle with Geant4.
+   */
+  virtual double ParticleResponse(const ExtendedI3Particle& particle, const I3Particle& entry,
+                                  HitHistoCollection& hitHC, HitHistoCollection& cherHitCollection)
+  { return Geant4Response(particle, hitHC, cherHitCollection); }
+
+  /// Track a particle with Geant4 and generate its hits, see ParticleResponse
+  double Geant4Response(const ExtendedI3Particle& particle, HitHistoCollection& hitHC,
+                        HitHistoCollection& cherHitCollection);
+
   void GenerateHits(int npe, const ExtendedI3Particle& particle, HitHisto& hitHisto);
 
   double tauZirco_;
@@ -0,0 +1,67 @@
+/**
+ * Copyright (C) 2020
+ * The IceCube collaboration
+ * ID: $Id$
+ *
+ * @file I3G4TankResponseEmulator.h
+ * @version $Revision$
+ * @date $Date$
+ *
+ * $LastChangedBy$
+ */
+
+
+#ifndef _TOPSIM_I3G4TANKRESPONSEEMULATOR_H_
+#define _TOPSIM_I3G4TANKRESPONSEEMULATOR_H_
+
+#include <g4-tankresponse/I3G4TankResponse.h>
+#include <g4-tankresponse/I3TankResponseTable.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <string>
+
+/**
+ * I3G4TankResponse which draws the signal of single particles from a table
+ * instead of tracking them with Geant4.
+ *
+ * The table (see I3TankResponseTable) is recorded with the same service in
+ * "RecordTable" mode, in which every particle is tracked with Geant4. When
+ * emulating, particles which fall outside of the table, or into a bin with
+ * too few entries, are still tracked with Geant4. Both DOMs of a tank get the
+ * same signal, and the dependence on the impact point is averaged over.
+ */
+class I3G4TankResponseEmulator : public I3G4TankResponse
+{
+ public:
+  I3G4TankResponseEmulator(I3Configuration& config, const I3Context& context, const TankKey& tankKey);
+  ~I3G4TankResponseEmulator();
+
+  void Configure();
+
+ protected:
+  double ParticleResponse(const ExtendedI3Particle& particle, const I3Particle& entry,
+                          HitHistoCollection& hitHC, HitHistoCollection& cherHitCollection);
+
+ private:
+  struct SharedTable;
+
+  I3TankResponseTable::SignalMethod GetSignalMethod() const;
+
+  /// Mean delay of the light in the DOMs after the last Geant4 run, with respect to the entry time
+  double Geant4Delay(const ExtendedI3Particle& particle, const I3Particle& entry) const;
+
+  std::string tableFile_;
+  std::string recordFile_;
+  unsigned int minEntries_;
+
+  boost::shared_ptr<SharedTable> table_;
+  unsigned long numEmulated_;
+  unsigned long numTracked_;
+
+  SET_LOGGER("I3G4TankResponseEmulator");
+};
+
+I3_POINTER_TYPEDEFS(I3G4TankResponseEmulator);
+
+#endif
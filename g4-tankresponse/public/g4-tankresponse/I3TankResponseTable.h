@@ -0,0 +1,105 @@
+/**
+ * Copyright (C) 2020
+ * The IceCube collaboration
+ * ID: $Id$
+ *
+ * @file I3TankResponseTable.h
+ * @version $Revision$
+ * @date $Date$
+ *
+ * $LastChangedBy$
+ */
+
+
+#ifndef _TOPSIM_I3TANKRESPONSETABLE_H_
+#define _TOPSIM_I3TANKRESPONSETABLE_H_
+
+#include <dataclasses/physics/I3Particle.h>
+#include <icetray/I3Logging.h>
+#include <icetray/I3PointerTypedefs.h>
+
+#include <string>
+#include <vector>
+
+I3_FORWARD_DECLARATION(I3RandomService);
+
+/**
+ * Tabulated response of an IceTop tank to single particles, as recorded from
+ * Geant4 runs with I3G4TankResponseEmulator.
+ *
+ * The table is binned in particle class (gamma, e+-, mu+-, everything else),
+ * log10(E/GeV), cos(zenith) and snow height. Each bin holds the distribution
+ * of the signal (mean VEM of the DOMs, in log10 bins plus one bin for no
+ * signal) of particles that intersect the virtual tank cylinder, and the mean
+ * delay of the light with respect to the time the particle enters it.
+ */
+class I3TankResponseTable
+{
+ public:
+  struct Axis {
+    unsigned n;
+    double min;
+    double max;
+
+    Axis(unsigned n_ = 1, double min_ = 0, double max_ = 1) : n(n_), min(min_), max(max_) {}
+    /// Bin of x, -1 if outside [min, max]
+    int Bin(double x) const;
+  };
+
+  /// How the signal was obtained from Geant4, see I3G4TankResponse
+  enum SignalMethod { EnergyDeposit = 0, Cherenkov = 1, WeightedCherenkov = 2 };
+
+  static const unsigned NUM_CLASSES = 4;
+
+  /// An empty table with the default binning, to be filled
+  I3TankResponseTable(SignalMethod method);
+
+  /// Read a table written with Write()
+  I3TankResponseTable(const std::string& path);
+
+  void Write(const std::string& path) const;
+
+  SignalMethod GetSignalMethod() const { return method_; }
+
+  /// Index of the bin of a particle in a tank with the given snow height, -1 if outside the table
+  int GetBin(const I3Particle& particle, double snowHeight) const;
+
+  /// Number of particles recorded in a bin
+  unsigned long GetEntries(int bin) const { return entries_.at(bin); }
+
+  /// Record the signal (in VEM) and the delay of the light for a particle
+  void Fill(int bin, double vem, double delay);
+
+  /// Draw a signal in VEM from the distribution of a bin (0 for no signal)
+  double SampleVEM(int bin, I3RandomService& rng) const;
+
+  /// Mean delay of the light in a bin, with respect to the time the particle enters the tank
+  double GetMeanDelay(int bin) const;
+
+  const Axis& GetLogEnergyAxis() const { return logEnergy_; }
+  const Axis& GetCosZenithAxis() const { return cosZenith_; }
+  const Axis& GetSnowHeightAxis() const { return snowHeight_; }
+  const Axis& GetLogVEMAxis() const { return logVEM_; }
+
+ private:
+  static unsigned ParticleClass(I3Particle::ParticleType type);
+  size_t NumBins() const { return NUM_CLASSES*logEnergy_.n*cosZenith_.n*snowHeight_.n; }
+  void Allocate();
+
+  SignalMethod method_;
+  Axis logEnergy_;
+  Axis cosZenith_;
+  Axis snowHeight_;
+  Axis logVEM_;
+
+  std::vector<unsigned long> entries_;
+  std::vector<unsigned long> counts_; // NumBins() x (logVEM_.n + 1), no signal first
+  std::vector<unsigned long> signals_;
+  std::vector<double> delaySum_;
+
+  SET_LOGGER("I3TankResponseTable");
+};
+
+I3_POINTER_TYPEDEFS(I3TankResponseTable);
+
+#endif
@@ -34,6 +34,7 @@
 #include "gulliver/I3EventHypothesis.h"
 #include "gulliver/I3Gulliver.h"
 #include "gulliver/I3LogLikelihoodFit.h"
+#include "gulliver/utilities/ParallelFit.h"
 #include "gulliver/utilities/ordinal.h"
 
 #include "phys-services/I3RandomService.h"
@@ -48,6 +49,9 @@ static const char* tweakservice_optionname = "IterationTweakService";
 static const char* randomservice_optionname = "RandomService";
 static const char* coszenithrange_optionname = "CosZenithRange";
 static const char* niter_optionname = "NIterations";
+static const char* workerpar_optionname = "WorkerParametrizations";
+static const char* workerllh_optionname = "WorkerLogLikelihoods";
+static const char* workermini_optionname = "WorkerMinimizers";
 
 // TODO not implemented yet
 // static const char* minangdiff_optionname = "MinimumAngularDifference";
@@ -124,6 +128,28 @@ I3IterativeFitter::I3IterativeFitter(const I3Context& ctx)
                  "Number of iterations",
                  nIterations_);
 
+    AddParameter(workerpar_optionname,
+                 "Names of additional parametrization services, one per "
+                 "worker thread. Together with \"WorkerLogLikelihoods\" and "
+                 "\"WorkerMinimizers\" this makes the module run the "
+                 "iterations of each seed in parallel: one thread uses the "
+                 "services given above, and every further thread uses one "
+                 "entry of each of the three lists. The worker services must "
+                 "be separate instances, configured like the main ones and "
+                 "implemented in C++, and the minimizers must be reentrant "
+                 "(e.g. I3GSLSimplex, not Minuit).",
+                 workerParametrizations_);
+
+    AddParameter(workerllh_optionname,
+                 "Names of additional log-likelihood services, one per worker "
+                 "thread (see \"WorkerParametrizations\")",
+                 workerLikelihoods_);
+
+    AddParameter(workermini_optionname,
+                 "Names of additional minimizer services, one per worker "
+                 "thread (see \"WorkerParametrizations\")",
+                 workerMinimizers_);
+
     // TODO not implemented yet
     // minDifference_ = 0.0;
     // AddParameter(minangdiff_optionname,
@@ -157,6 +183,9 @@ void I3IterativeFitter::Configure()
     GetParameter(niter_optionname, nIterations_);
     GetParameter("NonStdName", nonStdName_);
     GetParameter("OutputName", fitName_);
+    GetParameter(workerpar_optionname, workerParametrizations_);
+    GetParameter(workerllh_optionname, workerLikelihoods_);
+    GetParameter(workermini_optionname, workerMinimizers_);
     // TODO not implemented yet
     // GetParameter(nsol_optionname, nMaxSolutions_);
     // GetParameter(minangdiff_optionname, nMaxSolutions_);
@@ -205,6 +234,13 @@ void I3IterativeFitter::Configure()
 
     assert(fitterCore_);
 
+    fitterCores_ = MakeWorkerGullivers(
+        context_, fitterCore_, workerParametrizations_, workerLikelihoods_,
+        workerMinimizers_, GetName());
+
+    log_debug("(%s) Configured %zu fitter thread(s).",
+              GetName().c_str(), fitterCores_.size());
+
     // TODO not implemented yet
     // log_debug("(%s) Will store max. %d solutions (after sorting by "
     //           "likelihood).", GetName().c_str(), nMaxSolutions_);
@@ -299,7 +335,10 @@ void I3IterativeFitter::Geometry(I3FramePtr frame)
     log_debug("(%s) Welcome to Geometry method.", GetName().c_str());
 
     const I3Geometry& geometry = frame->Get<I3Geometry>();
-    fitterCore_->SetGeometry(geometry);
+    for (unsigned int i = 0; i < fitterCores_.size(); ++i)
+    {
+        fitterCores_[i]->SetGeometry(geometry);
+    }
     PushFrame(frame, "OutBox");
 
     log_debug("(%s) Leaving Geometry method.", GetName().c_str());
@@ -384,6 +423,12 @@ void I3IterativeFitter::Physics(I3FramePtr frame)
 
     int ndof = fitterCore_->SetEvent(*frame);
 
+    // the frame is not thread safe, so the workers get the event here
+    for (unsigned int i = 1; i < fitterCores_.size(); ++i)
+    {
+        fitterCores_[i]->SetEvent(*frame);
+    }
+
     I3LogLikelihoodFitPtr bestFit;
 
     if (nseeds == 0)
@@ -474,10 +519,15 @@ I3LogLikelihoodFitPtr I3IterativeFitter::BestFit(unsigned int nseeds)
             Fit(i + 1, 0, initialFit, goodFits);
         }
 
-        // then fit iteratively with randomized directions
+        // then fit iteratively with randomized directions; the seeds are
+        // generated up front, in order, since the services and the random
+        // number generator are not thread safe
         std::pair<double, double> seedNormDir = GetNormDir(
             seed.particle->GetDir());
 
+        std::vector<I3LogLikelihoodFitPtr> fits(nIterations_);
+        std::vector<I3EventHypothesis> backups;
+        backups.reserve(nIterations_);
         for (unsigned int j = 0; j < nIterations_; ++j)
         {
             I3LogLikelihoodFitPtr fit = boost::make_shared<I3LogLikelihoodFit>(
@@ -507,7 +557,22 @@ I3LogLikelihoodFitPtr I3IterativeFitter::BestFit(unsigned int nseeds)
             tweakService_->Tweak(*(fit->hypothesis_));
             assert(fit->hypothesis_->particle->GetShape() != I3Particle::Null);
 
-            Fit(i + 1, j + 1, fit, goodFits);
+            // if new fit fails put the old one back
+            backups.push_back(seedService_->GetCopy(*(fit->hypothesis_)));
+            fits[j] = fit;
+        }
+
+        // not std::vector<bool>, threads write to neighbouring elements
+        std::vector<char> success(nIterations_);
+        ParallelFit(fitterCores_, nIterations_,
+                    [&](I3Gulliver& core, size_t j)
+        {
+            success[j] = core.Fit(fits[j]);
+        });
+
+        for (unsigned int j = 0; j < nIterations_; ++j)
+        {
+            AddFit(i + 1, j + 1, success[j], backups[j], fits[j], goodFits);
         }
     }
 
@@ -515,7 +580,8 @@ I3LogLikelihoodFitPtr I3IterativeFitter::BestFit(unsigned int nseeds)
 
     if (goodFits.size() > 0)
     {
-        std::sort(goodFits.begin(), goodFits.end());
+        // ties go to the earliest seed and iteration
+        std::stable_sort(goodFits.begin(), goodFits.end());
         bestFit = boost::make_shared<I3LogLikelihoodFit>(goodFits.front());
 
         const I3LogLikelihoodFit& worstFit = goodFits.back();
@@ -554,6 +620,15 @@ void I3IterativeFitter::Fit(int seed, int iteration, I3LogLikelihoodFitPtr fit,
 
     bool success = fitterCore_->Fit(fit);
 
+    AddFit(seed, iteration, success, backup, fit, goodFits);
+}
+
+//-----------------------------------------------------------------------------
+void I3IterativeFitter::AddFit(int seed, int iteration, bool success,
+                               const I3EventHypothesis& backup,
+                               I3LogLikelihoodFitPtr fit,
+                               std::vector<I3LogLikelihoodFit>& goodFits)
+{
     if (success)
     {
         ++nSuccessFits_;
@@ -27,6 +27,7 @@
 #include "gulliver/I3EventHypothesis.h"
 #include "gulliver/I3Gulliver.h"
 #include "gulliver/I3LogLikelihoodFit.h"
+#include "gulliver/utilities/ParallelFit.h"
 #include "gulliver/utilities/ordinal.h"
 
 #include "icetray/I3ConditionalModule.h"
@@ -110,6 +111,28 @@ I3SimpleFitter::I3SimpleFitter(const I3Context& ctx) : I3ConditionalModule(ctx)
                  "reported in \"Single\" mode.",
                  traceModeString_);
 
+    AddParameter("WorkerParametrizations",
+                 "Names of additional parametrization services, one per "
+                 "worker thread. Together with \"WorkerLogLikelihoods\" and "
+                 "\"WorkerMinimizers\" this makes the module fit the seeds "
+                 "in parallel: one thread uses the services given above, and "
+                 "every further thread uses one entry of each of the three "
+                 "lists. The worker services must be separate instances, "
+                 "configured like the main ones and implemented in C++, and "
+                 "the minimizers must be reentrant (e.g. I3GSLSimplex, not "
+                 "Minuit).",
+                 workerParametrizations_);
+
+    AddParameter("WorkerLogLikelihoods",
+                 "Names of additional log-likelihood services, one per worker "
+                 "thread (see \"WorkerParametrizations\")",
+                 workerLikelihoods_);
+
+    AddParameter("WorkerMinimizers",
+                 "Names of additional minimizer services, one per worker "
+                 "thread (see \"WorkerParametrizations\")",
+                 workerMinimizers_);
+
     eventNr_ = 0;
     nSeeds_ = 0;
     nSuccessFits_ = 0;
@@ -128,6 +151,9 @@ void I3SimpleFitter::Configure()
     GetParameter("StoragePolicy", storagePolicyString_);
     GetParameter("NonStdName", nonStdName_);
     GetParameter("TraceMode", traceModeString_);
+    GetParameter("WorkerParametrizations", workerParametrizations_);
+    GetParameter("WorkerLogLikelihoods", workerLikelihoods_);
+    GetParameter("WorkerMinimizers", workerMinimizers_);
 
     if (minimizer_)
     {
@@ -173,6 +199,13 @@ void I3SimpleFitter::Configure()
 
     assert(fitterCore_);
 
+    fitterCores_ = MakeWorkerGullivers(
+        context_, fitterCore_, workerParametrizations_, workerLikelihoods_,
+        workerMinimizers_, GetName());
+
+    log_debug("(%s) Configured %zu fitter thread(s).",
+              GetName().c_str(), fitterCores_.size());
+
     log_debug("(%s) Configured result mode: \"%s\"",
               GetName().c_str(), storagePolicyString_.c_str());
 
@@ -243,7 +276,10 @@ void I3SimpleFitter::Geometry(I3FramePtr frame)
               GetName().c_str());
 
     const I3Geometry& geometry = frame->Get<I3Geometry>(geometryName_);
-    fitterCore_->SetGeometry(geometry);
+    for (unsigned int i = 0; i < fitterCores_.size(); ++i)
+    {
+        fitterCores_[i]->SetGeometry(geometry);
+    }
 
     PushFrame(frame, "OutBox");
     log_debug("(%s) Leaving I3SimpleFitter Geometry.", GetName().c_str());
@@ -359,13 +395,39 @@ I3LogLikelihoodFitPtr I3SimpleFitter::Fit(
     I3LogLikelihoodFitParamsVectPtr params,
     std::vector<I3VectorDoublePtr>& traces)
 {
-    std::vector<I3LogLikelihoodFit> goodFits;
+    // The frame and the seed service are not thread safe, so the event is
+    // handed to the fitter cores and the seeds are copied out up front.
+    for (unsigned int i = 0; i < fitterCores_.size(); ++i)
+    {
+        fitterCores_[i]->SetEvent(*frame);
+    }
+
+    std::vector<I3EventHypothesis> seeds;
+    seeds.reserve(nseeds);
     for (unsigned int i = 0; i < nseeds; ++i)
     {
-        I3EventHypothesis seed = seedService_->GetSeed(i);
-        assert(seed.particle->GetShape() != I3Particle::Null);
+        seeds.push_back(seedService_->GetSeed(i));
+        assert(seeds.back().particle->GetShape() != I3Particle::Null);
+    }
+
+    std::vector<I3LogLikelihoodFitPtr> fits(nseeds);
+    std::vector<I3VectorDoublePtr> seedTraces(nseeds);
+    ParallelFit(fitterCores_, nseeds, [&](I3Gulliver& core, size_t i)
+    {
+        fits[i] = Fit(core, seeds[i]);
+
+        if ((traceMode_ == TRACE_SINGLE && i == 0) ||
+                traceMode_ == TRACE_ALL)
+        {
+            seedTraces[i] = core.GetTrace();
+        }
+    });
 
-        I3LogLikelihoodFitPtr fit = Fit(frame, seed);
+    // collect the results in seed order, whichever thread did the fit
+    std::vector<I3LogLikelihoodFit> goodFits;
+    for (unsigned int i = 0; i < nseeds; ++i)
+    {
+        I3LogLikelihoodFitPtr fit = fits[i];
 
         if (fit->hypothesis_->particle->GetFitStatus() == I3Particle::OK)
         {
@@ -376,7 +438,7 @@ I3LogLikelihoodFitPtr I3SimpleFitter::Fit(
         if ((traceMode_ == TRACE_SINGLE && i == 0) ||
                 traceMode_ == TRACE_ALL)
         {
-            traces.push_back(fitterCore_->GetTrace());
+            traces.push_back(seedTraces[i]);
         }
 
         std::ostringstream prefix;
@@ -414,7 +476,8 @@ I3LogLikelihoodFitPtr I3SimpleFitter::Fit(
 
     if (goodFits.size() > 0)
     {
-        std::sort(goodFits.begin(), goodFits.end());
+        // ties go to the earliest seed
+        std::stable_sort(goodFits.begin(), goodFits.end());
 
         if (storagePolicy_ == ONLY_BEST_FIT)
         {
@@ -463,7 +526,7 @@ I3LogLikelihoodFitPtr I3SimpleFitter::Fit(
 }
 
 //-----------------------------------------------------------------------------
-I3LogLikelihoodFitPtr I3SimpleFitter::Fit(I3FramePtr frame,
+I3LogLikelihoodFitPtr I3SimpleFitter::Fit(I3Gulliver& core,
                                           const I3EventHypothesis& seed)
 {
     I3LogLikelihoodFitPtr fit = boost::make_shared<I3LogLikelihoodFit>(seed);
@@ -485,10 +548,10 @@ I3LogLikelihoodFitPtr I3SimpleFitter::Fit(I3FramePtr frame,
 
     if (traceMode_ != TRACE_NONE)
     {
-        fitterCore_->Trace();
+        core.Trace();
     }
 
-    bool success = fitterCore_->Fit(*frame, fit);
+    bool success = core.Fit(fit);
 
     log_debug("(%s) %s: x=%.2fm, y=%.2fm, z=%.2fm, t=%.2fns theta=%.2fdeg, "
               "phi=%.2fdeg, energy=%.2eGeV length=%.2fm, status=%s,",
@@ -104,6 +104,21 @@
  * Sobol. Both sequences are implemented in GSL (@c gsl_qrng_sobol and
  * @c gsl_qrng_niederreiter_2).
  *
+ *
+ * Parallel Iterations
+ *
+ * The iterations for a seed are independent fits, so they can be run on
+ * several threads. Each thread needs its own likelihood, parametrization and
+ * minimizer service; the additional ones are listed with the
+ * "WorkerLogLikelihoods", "WorkerParametrizations" and "WorkerMinimizers"
+ * options. The fit with the unmodified seed is done first, since the
+ * iterations start from its vertex. The iteration seeds are generated
+ * sequentially and the results are collected in iteration order. The
+ * minimizers must be reentrant (I3MinimizerBase::IsReentrant(); e.g. the
+ * GSL minimizers, but not Minuit), otherwise the module refuses to run
+ * with workers. With reentrant services that are configured alike, the
+ * output is the same as with a single thread.
+ *
  * @sa <a href="http://www.gnu.org/software/gsl/manual/html_node/Quasi_002drandom-number-generator-algorithms.html">Sobol and Niederreiter_2 in GSL</a>
  *
  */
@@ -128,6 +143,10 @@ class I3IterativeFitter : public I3ConditionalModule
         /// The core Gulliver object for basic tracks
         I3GulliverPtr fitterCore_;
 
+        /// The core Gulliver objects for all fitter threads, first is the
+        /// main one
+        std::vector<I3GulliverPtr> fitterCores_;
+
         /// Random service to generate random directions.
         I3RandomServicePtr randomService_;
 
@@ -150,6 +169,10 @@ class I3IterativeFitter : public I3ConditionalModule
         std::vector<double> cosZenithRange_;
         /// Fit name; used to store results in the frame.
         std::string fitName_;
+        /// Names of the services of the additional fitter threads
+        std::vector<std::string> workerParametrizations_;
+        std::vector<std::string> workerLikelihoods_;
+        std::vector<std::string> workerMinimizers_;
         // TODO not implemented yet
         // /// Minimum angular difference between stored solutions
         // double minDifference_;
@@ -200,6 +223,14 @@ class I3IterativeFitter : public I3ConditionalModule
         void Fit(int seed, int iteration, I3LogLikelihoodFitPtr fit,
                  std::vector<I3LogLikelihoodFit>& goodFits);
 
+        /**
+         * Bookkeeping after a fit: store it in a vector (if successful),
+         * otherwise restore the hypothesis from the backup
+         */
+        void AddFit(int seed, int iteration, bool success,
+                    const I3EventHypothesis& backup, I3LogLikelihoodFitPtr fit,
+                    std::vector<I3LogLikelihoodFit>& goodFits);
+
         SET_LOGGER("I3IterativeFitter");
 
 }; // end of the class definition
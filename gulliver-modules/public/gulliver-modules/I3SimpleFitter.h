@@ -79,7 +79,7 @@ class I3SimpleFitter : public I3ConditionalModule
         I3SimpleFitter(const I3SimpleFitter& source);
         I3SimpleFitter& operator=(const I3SimpleFitter& source);
 
-        I3LogLikelihoodFitPtr Fit(I3FramePtr frame,
+        I3LogLikelihoodFitPtr Fit(I3Gulliver& core,
                                   const I3EventHypothesis& seed);
 
         I3LogLikelihoodFitPtr Fit(I3FramePtr frame, unsigned int nseeds,
@@ -90,6 +90,10 @@ class I3SimpleFitter : public I3ConditionalModule
         /// The core Gulliver object for basic tracks
         I3GulliverPtr fitterCore_;
 
+        /// The core Gulliver objects for all fitter threads, first is the
+        /// main one
+        std::vector<I3GulliverPtr> fitterCores_;
+
         /// Type to specify tracing option
         enum TraceModeType
         {
@@ -127,6 +131,10 @@ class I3SimpleFitter : public I3ConditionalModule
         std::string traceModeString_;
         /// Option to store fit tracing information (for debugging)
         TraceModeType traceMode_;
+        /// Names of the services of the additional fitter threads
+        std::vector<std::string> workerParametrizations_;
+        std::vector<std::string> workerLikelihoods_;
+        std::vector<std::string> workerMinimizers_;
 
         std::string fitName_;
         std::string geometryName_;
@@ -0,0 +1,104 @@
+#!/usr/bin/env python
+
+import unittest
+from I3Tray import *
+import icecube
+from icecube import icetray, dataio, dataclasses, lilliput, gulliver
+import icecube.gulliver_modules
+
+#These tests check the parallel fits of I3SimpleFitter: minimizers that
+#keep global state (like Minuit) must be refused when worker threads are
+#requested, and reentrant ones must give the same result as a single thread
+
+SEEDNAMES=["Seed%d" % i for i in range(6)]
+LLHNAME="TestLikelihood"
+PARAMNAME="TestParametrization"
+OUTPUTNAME="SimpleFitterOut"
+
+class PutSeedsInFrame(icetray.I3Module):
+
+  def __init__(self,ctx):
+    icetray.I3Module.__init__(self,ctx)
+
+  def Physics(self, frame):
+    for i, name in enumerate(SEEDNAMES):
+      particle = dataclasses.I3Particle()
+      particle.dir = dataclasses.I3Direction(0.1+0.4*i, 0.3*i)
+      particle.pos = dataclasses.I3Position(10.*i, -5.*i, 2.*i)
+      particle.time = 100.*i
+      particle.energy = 1
+      particle.fit_status = dataclasses.I3Particle.FitStatus.OK
+      frame[name] = particle
+    self.PushFrame(frame)
+
+#Adds the services for the main fitter core and nworkers workers, and
+#returns the names of the worker services
+def AddServices(tray, minimizer, nworkers, **minimizer_args):
+  names = {"par":[], "llh":[], "mini":[]}
+  for i in range(nworkers+1):
+    suffix = "" if i == 0 else "_worker%d" % i
+    tray.AddService("I3TestParametrizationFactory", PARAMNAME+suffix)
+    tray.AddService("I3TestLikelihoodFactory", LLHNAME+suffix,
+                    LikelihoodValue=-10.,
+                    Multiplicity=10)
+    tray.AddService(minimizer, "Minimizer"+suffix, **minimizer_args)
+    if i > 0:
+      names["par"].append(PARAMNAME+suffix)
+      names["llh"].append(LLHNAME+suffix)
+      names["mini"].append("Minimizer"+suffix)
+  return names
+
+def MakeTray(minimizer, nworkers, results, **minimizer_args):
+  tray = I3Tray()
+  names = AddServices(tray, minimizer, nworkers, **minimizer_args)
+  tray.AddService("I3BasicSeedServiceFactory", "seeds",
+                  FirstGuesses=SEEDNAMES)
+  tray.AddModule("BottomlessSource", "BS", Stream=icetray.I3Frame.Physics)
+  tray.AddModule(PutSeedsInFrame, "PutSeedsInFrame")
+  tray.AddModule("I3SimpleFitter", "SimpleFitter",
+                 SeedService="seeds",
+                 Minimizer="Minimizer",
+                 Parametrization=PARAMNAME,
+                 LogLikelihood=LLHNAME,
+                 OutputName=OUTPUTNAME,
+                 StoragePolicy="AllFitsAndFitParams",
+                 WorkerParametrizations=names["par"],
+                 WorkerLogLikelihoods=names["llh"],
+                 WorkerMinimizers=names["mini"])
+  #compare the fits as strings, failed fits have NaNs
+  def collect(frame):
+    fits = frame[OUTPUTNAME+"Vect"]
+    results.append([str((p.fit_status, p.pos.x, p.pos.y, p.pos.z,
+                         p.dir.zenith, p.dir.azimuth, p.time)) for p in fits])
+  tray.AddModule(collect, "collect", Streams=[icetray.I3Frame.Physics])
+  return tray
+
+class TestSimpleFitterThreads(unittest.TestCase):
+
+  #Minuit keeps its state in globals, so it must not run on several threads
+  def test_minuit_workers_refused(self):
+    results = []
+    tray = MakeTray("I3GulliverMinuitFactory", 2, results,
+                    Algorithm="SIMPLEX")
+    with self.assertRaises(RuntimeError):
+      tray.Execute(3)
+    self.assertEqual(results, [])
+
+  #Minuit without workers still runs on the calling thread
+  def test_minuit_single_thread(self):
+    results = []
+    tray = MakeTray("I3GulliverMinuitFactory", 0, results,
+                    Algorithm="SIMPLEX")
+    tray.Execute(3)
+    self.assertEqual(len(results), 3)
+    self.assertEqual(len(results[0]), len(SEEDNAMES))
+
+  #GSL simplex is reentrant: with workers the fits are the same as without
+  def test_gsl_simplex_workers(self):
+    single, parallel = [], []
+    MakeTray("I3GSLSimplexFactory", 0, single).Execute(3)
+    MakeTray("I3GSLSimplexFactory", 3, parallel).Execute(3)
+    self.assertEqual(len(single), 3)
+    self.assertEqual(single, parallel)
+
+unittest.main()
@@ -0,0 +1,57 @@
+#include <I3Test.h>
+
+#include <cmath>
+#include "gulliver/utilities/Dual.h"
+
+using gulliver::Dual;
+
+TEST_GROUP(Dual)
+
+namespace {
+
+// some expression using every operation, templated like a likelihood would be
+template <typename T>
+T f(const T& x, const T& y)
+{
+    using std::atan2; using std::hypot; using std::acos; using std::exp;
+    using std::log; using std::sqrt; using std::pow; using std::fabs;
+    using std::sin; using std::cos;
+    return atan2(y, x) + hypot(x, y)*acos(x)/exp(y) + pow(x, 3.)
+        - 2./sqrt(x)*log(x) + fabs(y)*sin(x) - cos(y)/(1. + x*y);
+}
+
+}
+
+// derivatives agree with central differences
+TEST(CompareNumerical)
+{
+    const double x = 0.3, y = -0.7, h = 1e-6;
+    const Dual<2> r = f(Dual<2>::Variable(0, x), Dual<2>::Variable(1, y));
+
+    ENSURE_DISTANCE(r.value, f(x, y), 1e-14, "value should be unchanged");
+    ENSURE_DISTANCE(r.d[0], (f(x+h, y) - f(x-h, y))/(2*h), 1e-6,
+                    "derivative with respect to x");
+    ENSURE_DISTANCE(r.d[1], (f(x, y+h) - f(x, y-h))/(2*h), 1e-6,
+                    "derivative with respect to y");
+}
+
+// Chain lifts functions for which only the derivative is known
+TEST(Chain)
+{
+    const Dual<1> x = Dual<1>::Variable(0, 2.);
+    const Dual<1> y = (3.*x).Chain(std::erf(6.), 2./std::sqrt(M_PI)*std::exp(-36.));
+    ENSURE_EQUAL(y.value, std::erf(6.));
+    ENSURE_DISTANCE(y.d[0], 6./std::sqrt(M_PI)*std::exp(-36.), 1e-30);
+}
+
+// comparisons and branches only look at the value
+TEST(Comparisons)
+{
+    const Dual<1> x = Dual<1>::Variable(0, -2.);
+    ENSURE(x < 0.);
+    ENSURE(x < Dual<1>(1.));
+    ENSURE(!(x >= -1.));
+    ENSURE_EQUAL(fabs(x).value, 2.);
+    ENSURE_EQUAL(fabs(x).d[0], -1.);
+    ENSURE_EQUAL(gulliver::Value(x), -2.);
+}
@@ -125,6 +125,21 @@ public:
         minimizer_ = m;
     }
 
+    /// get the parametrization service
+    I3ParametrizationBasePtr GetParametrization() const {
+        return parametrization_;
+    }
+
+    /// get the event log-likelihood service
+    I3EventLogLikelihoodBasePtr GetLogLikelihood() const {
+        return eventllh_;
+    }
+
+    /// get the minimizer service
+    I3MinimizerBasePtr GetMinimizer() const {
+        return minimizer_;
+    }
+
     /**
      * Set up gradient support, checking that both the parametrization 
      * and likelihood also support that. If not, then this throws a
@@ -103,6 +103,16 @@ public:
      */
     virtual bool UsesGradient(){return false;}
 
+    /**
+     * Whether separate instances of this minimizer may run Minimize()
+     * at the same time on different threads. A minimizer that keeps
+     * state outside of the instance (file-static variables, globals
+     * like TMinuit's gMinuit, or the static locals of f2c-translated
+     * code) must return false, which is the default.
+     * @sa MakeWorkerGullivers
+     */
+    virtual bool IsReentrant() const {return false;}
+
 };
 
 I3_POINTER_TYPEDEFS( I3MinimizerBase );
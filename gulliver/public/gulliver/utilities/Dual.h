@@ -0,0 +1,176 @@
+#ifndef DUAL_H_INCLUDED
+#define DUAL_H_INCLUDED
+
+/**
+ *  copyright  (C) 2020
+ *  the icecube collaboration
+ *  $Id$
+ *
+ *  @file
+ *  @version $Revision$
+ *  @date $Date$
+ */
+
+#include <array>
+#include <cmath>
+
+namespace gulliver {
+
+/**
+ * @class Dual
+ * @brief Forward mode automatic differentiation with N independent variables.
+ *
+ * A Dual carries a value and its partial derivatives with respect to N
+ * variables. Code which is written as a template over its scalar type
+ * (with @c using @c std::sqrt etc. so that argument dependent lookup
+ * finds the overloads below) can be evaluated once with Dual<N> instead
+ * of double and then yields the value and the exact gradient in one go.
+ * Likelihood services can use this to implement
+ * I3EventLogLikelihoodBase::GetLogLikelihoodWithGradient and
+ * parametrizations to implement I3ParametrizationBase::ApplyChainRule
+ * without deriving the Jacobians by hand.
+ *
+ * Comparisons only look at the value, so branches are followed as for
+ * plain doubles. Functions which are not differentiable somewhere (fabs,
+ * sqrt at zero, ...) return the one-sided derivative there.
+ */
+template <unsigned N>
+struct Dual {
+    double value;
+    std::array<double, N> d;
+
+    Dual(double v = 0.) : value(v) { d.fill(0.); }
+
+    /// The i-th independent variable, with value v
+    static Dual Variable(unsigned i, double v) {
+        Dual x(v);
+        x.d[i] = 1.;
+        return x;
+    }
+
+    /**
+     * Apply a function for which only the value f and the derivative dfdx
+     * at @c value are known: this is how opaque functions (GSL, boost
+     * special functions, tables) enter a dual computation.
+     */
+    Dual Chain(double f, double dfdx) const {
+        Dual r(f);
+        for (unsigned i = 0; i < N; ++i) r.d[i] = dfdx*d[i];
+        return r;
+    }
+
+    Dual& operator+=(const Dual& b) {
+        value += b.value;
+        for (unsigned i = 0; i < N; ++i) d[i] += b.d[i];
+        return *this;
+    }
+    Dual& operator-=(const Dual& b) {
+        value -= b.value;
+        for (unsigned i = 0; i < N; ++i) d[i] -= b.d[i];
+        return *this;
+    }
+    Dual& operator*=(const Dual& b) {
+        for (unsigned i = 0; i < N; ++i) d[i] = d[i]*b.value + value*b.d[i];
+        value *= b.value;
+        return *this;
+    }
+    Dual& operator/=(const Dual& b) {
+        value /= b.value;
+        for (unsigned i = 0; i < N; ++i) d[i] = (d[i] - value*b.d[i])/b.value;
+        return *this;
+    }
+    Dual& operator+=(double b) { value += b; return *this; }
+    Dual& operator-=(double b) { value -= b; return *this; }
+    Dual& operator*=(double b) {
+        value *= b;
+        for (unsigned i = 0; i < N; ++i) d[i] *= b;
+        return *this;
+    }
+    Dual& operator/=(double b) {
+        value /= b;
+        for (unsigned i = 0; i < N; ++i) d[i] /= b;
+        return *this;
+    }
+};
+
+/// The value of a scalar, for code templated over double and Dual
+inline double Value(double x) { return x; }
+template <unsigned N> double Value(const Dual<N>& x) { return x.value; }
+
+template <unsigned N> Dual<N> operator-(Dual<N> a) { a *= -1.; return a; }
+template <unsigned N> Dual<N> operator+(Dual<N> a, const Dual<N>& b) { return a += b; }
+template <unsigned N> Dual<N> operator-(Dual<N> a, const Dual<N>& b) { return a -= b; }
+template <unsigned N> Dual<N> operator*(Dual<N> a, const Dual<N>& b) { return a *= b; }
+template <unsigned N> Dual<N> operator/(Dual<N> a, const Dual<N>& b) { return a /= b; }
+template <unsigned N> Dual<N> operator+(Dual<N> a, double b) { return a += b; }
+template <unsigned N> Dual<N> operator-(Dual<N> a, double b) { return a -= b; }
+template <unsigned N> Dual<N> operator*(Dual<N> a, double b) { return a *= b; }
+template <unsigned N> Dual<N> operator/(Dual<N> a, double b) { return a /= b; }
+template <unsigned N> Dual<N> operator+(double a, Dual<N> b) { return b += a; }
+template <unsigned N> Dual<N> operator-(double a, const Dual<N>& b) { return -b + a; }
+template <unsigned N> Dual<N> operator*(double a, Dual<N> b) { return b *= a; }
+template <unsigned N> Dual<N> operator/(double a, const Dual<N>& b) {
+    return b.Chain(a/b.value, -a/(b.value*b.value));
+}
+
+template <unsigned N> bool operator<(const Dual<N>& a, const Dual<N>& b) { return a.value < b.value; }
+template <unsigned N> bool operator>(const Dual<N>& a, const Dual<N>& b) { return a.value > b.value; }
+template <unsigned N> bool operator<=(const Dual<N>& a, const Dual<N>& b) { return a.value <= b.value; }
+template <unsigned N> bool operator>=(const Dual<N>& a, const Dual<N>& b) { return a.value >= b.value; }
+template <unsigned N> bool operator<(const Dual<N>& a, double b) { return a.value < b; }
+template <unsigned N> bool operator>(const Dual<N>& a, double b) { return a.value > b; }
+template <unsigned N> bool operator<=(const Dual<N>& a, double b) { return a.value <= b; }
+template <unsigned N> bool operator>=(const Dual<N>& a, double b) { return a.value >= b; }
+template <unsigned N> bool operator<(double a, const Dual<N>& b) { return a < b.value; }
+template <unsigned N> bool operator>(double a, const Dual<N>& b) { return a > b.value; }
+template <unsigned N> bool operator<=(double a, const Dual<N>& b) { return a <= b.value; }
+template <unsigned N> bool operator>=(double a, const Dual<N>& b) { return a >= b.value; }
+
+template <unsigned N> Dual<N> sqrt(const Dual<N>& x) {
+    const double s = std::sqrt(x.value);
+    return x.Chain(s, s > 0 ? 0.5/s : 0.);
+}
+template <unsigned N> Dual<N> exp(const Dual<N>& x) {
+    const double e = std::exp(x.value);
+    return x.Chain(e, e);
+}
+template <unsigned N> Dual<N> log(const Dual<N>& x) {
+    return x.Chain(std::log(x.value), 1./x.value);
+}
+template <unsigned N> Dual<N> pow(const Dual<N>& x, double p) {
+    const double f = std::pow(x.value, p);
+    return x.Chain(f, p == 0 ? 0. : p*std::pow(x.value, p - 1));
+}
+template <unsigned N> Dual<N> sin(const Dual<N>& x) {
+    return x.Chain(std::sin(x.value), std::cos(x.value));
+}
+template <unsigned N> Dual<N> cos(const Dual<N>& x) {
+    return x.Chain(std::cos(x.value), -std::sin(x.value));
+}
+template <unsigned N> Dual<N> acos(const Dual<N>& x) {
+    const double s = std::sqrt(1. - x.value*x.value);
+    return x.Chain(std::acos(x.value), s > 0 ? -1./s : 0.);
+}
+template <unsigned N> Dual<N> fabs(const Dual<N>& x) {
+    return x.value < 0 ? -x : x;
+}
+template <unsigned N> Dual<N> atan2(const Dual<N>& y, const Dual<N>& x) {
+    const double r2 = x.value*x.value + y.value*y.value;
+    Dual<N> r(std::atan2(y.value, x.value));
+    if (r2 > 0)
+        for (unsigned i = 0; i < N; ++i)
+            r.d[i] = (x.value*y.d[i] - y.value*x.d[i])/r2;
+    return r;
+}
+template <unsigned N> Dual<N> hypot(const Dual<N>& x, const Dual<N>& y) {
+    const double h = std::hypot(x.value, y.value);
+    Dual<N> r(h);
+    if (h > 0)
+        for (unsigned i = 0; i < N; ++i)
+            r.d[i] = (x.value*x.d[i] + y.value*y.d[i])/h;
+    return r;
+}
+
+}
+
+#endif /* DUAL_H_INCLUDED */
@@ -0,0 +1,184 @@
+#ifndef PARALLELFIT_H_INCLUDED
+#define PARALLELFIT_H_INCLUDED
+
+/**
+ *  copyright  (C) 2020
+ *  the icecube collaboration
+ *  $Id$
+ *
+ *  @file
+ *  @version $Revision$
+ *  @date $Date$
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include <boost/make_shared.hpp>
+#include <boost/thread.hpp>
+
+#include "icetray/I3Context.h"
+#include "icetray/I3Logging.h"
+#include "gulliver/I3Gulliver.h"
+
+/**
+ * Build the fitter cores for parallel fitting: the first core is
+ * @c main, every further core is made from one entry of each of the
+ * lists, the likelihoods and minimizers are looked up in the context.
+ *
+ * Services are stateful (the likelihood holds the event, the minimizer
+ * and the parametrization hold the current fit), so every worker
+ * needs its own instances. They should be configured identically to
+ * the main services, otherwise the result depends on which worker
+ * happened to do which fit. Services implemented in python can not be
+ * used by worker threads.
+ *
+ * Separate instances are not enough for minimizers that keep state
+ * outside of the instance, so worker cores are refused unless every
+ * minimizer declares itself reentrant (I3MinimizerBase::IsReentrant()).
+ * The likelihood and parametrization services must not share state
+ * between instances either; this can not be checked here.
+ */
+inline std::vector<I3GulliverPtr>
+MakeWorkerGullivers(const I3Context& context, I3GulliverPtr main,
+                    const std::vector<I3ParametrizationBasePtr>& parametrizations,
+                    const std::vector<std::string>& likelihoods,
+                    const std::vector<std::string>& minimizers,
+                    const std::string& name)
+{
+    if (parametrizations.size() != likelihoods.size() ||
+        minimizers.size() != likelihoods.size())
+    {
+        log_fatal("(%s) Got %zu worker parametrizations, %zu worker "
+                  "log-likelihoods and %zu worker minimizers; should be the "
+                  "same number of each.", name.c_str(),
+                  parametrizations.size(), likelihoods.size(),
+                  minimizers.size());
+    }
+
+    std::vector<I3GulliverPtr> cores(1, main);
+    for (size_t i = 0; i < likelihoods.size(); ++i)
+    {
+        I3ParametrizationBasePtr par = parametrizations[i];
+        I3EventLogLikelihoodBasePtr llh =
+            context.Get<I3EventLogLikelihoodBasePtr>(likelihoods[i]);
+        I3MinimizerBasePtr mini =
+            context.Get<I3MinimizerBasePtr>(minimizers[i]);
+
+        if (!par || !llh || !mini)
+        {
+            log_fatal("(%s) Problem with the services of worker %zu "
+                      "(log-likelihood \"%s\", minimizer \"%s\").",
+                      name.c_str(), i + 1, likelihoods[i].c_str(),
+                      minimizers[i].c_str());
+        }
+
+        for (size_t j = 0; j < cores.size(); ++j)
+        {
+            if (par == cores[j]->GetParametrization() ||
+                llh == cores[j]->GetLogLikelihood() ||
+                mini == cores[j]->GetMinimizer())
+            {
+                log_fatal("(%s) Worker %zu shares a service with worker %zu; "
+                          "every worker needs its own instances.",
+                          name.c_str(), i + 1, j);
+            }
+        }
+
+        cores.push_back(boost::make_shared<I3Gulliver>(par, llh, mini, name));
+    }
+
+    for (size_t j = 0; cores.size() > 1 && j < cores.size(); ++j)
+    {
+        I3MinimizerBasePtr mini = cores[j]->GetMinimizer();
+        if (!mini->IsReentrant())
+        {
+            log_fatal("(%s) The minimizer \"%s\" of worker %zu keeps state "
+                      "outside of its instance and can not run on several "
+                      "threads at once. Use a reentrant minimizer (e.g. "
+                      "I3GSLSimplex or I3GSLMultiMin) or no worker services.",
+                      name.c_str(), mini->GetName().c_str(), j);
+        }
+    }
+
+    return cores;
+}
+
+/// Same as above, with the parametrizations looked up in the context too
+inline std::vector<I3GulliverPtr>
+MakeWorkerGullivers(const I3Context& context, I3GulliverPtr main,
+                    const std::vector<std::string>& parametrizations,
+                    const std::vector<std::string>& likelihoods,
+                    const std::vector<std::string>& minimizers,
+                    const std::string& name)
+{
+    std::vector<I3ParametrizationBasePtr> pars;
+    for (size_t i = 0; i < parametrizations.size(); ++i)
+    {
+        pars.push_back(
+            context.Get<I3ParametrizationBasePtr>(parametrizations[i]));
+        if (!pars.back())
+        {
+            log_fatal("(%s) Problem with worker parametrization \"%s\".",
+                      name.c_str(), parametrizations[i].c_str());
+        }
+    }
+
+    return MakeWorkerGullivers(context, main, pars, likelihoods, minimizers,
+                               name);
+}
+
+/**
+ * Calls work(core, i) for every i in [0,n), with one thread per fitter
+ * core, so that a core is never used by two threads at once. Indices
+ * are handed out dynamically, as some fits take many more iterations
+ * than others. With a single core the loop runs on the calling thread.
+ * The first exception thrown by any call is rethrown on the calling
+ * thread.
+ *
+ * The work function should only touch its own index of any output, so
+ * that the result does not depend on the order in which the fits
+ * finish.
+ */
+template <typename Work>
+void ParallelFit(const std::vector<I3GulliverPtr>& cores, size_t n, Work work)
+{
+    size_t nThreads = std::min(cores.size(), n);
+    if (nThreads <= 1)
+    {
+        for (size_t i = 0; i < n; ++i)
+            work(*cores.front(), i);
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    std::exception_ptr error;
+    boost::mutex errorMutex;
+    boost::thread_group threads;
+    for (size_t t = 0; t < nThreads; ++t)
+    {
+        I3Gulliver* core = cores[t].get();
+        threads.create_thread([&, core]()
+        {
+            try
+            {
+                for (size_t i = next++; i < n; i = next++)
+                    work(*core, i);
+            }
+            catch (...)
+            {
+                boost::mutex::scoped_lock lock(errorMutex);
+                if (!error) error = std::current_exception();
+                next = n;
+            }
+        });
+    }
+    threads.join_all();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+#endif /* PARALLELFIT_H_INCLUDED */
@@ -232,7 +232,7 @@ I3MinimizerResult I3GSLMultiMin::Minimize(I3GulliverBase &g,
     if (!gslMinimizerType_) log_fatal("I3GSLMultiMin seems not to be configured correctly!");
 
     // we are going to check for errors ourselves, turn GSL error handling off
-    gsl_error_handler_t *old_gsl_error_handler = gsl_set_error_handler_off();
+    I3MinimizerUtils::GSLErrorHandlerOff gsl_error_handler_off;
 
 
     unsigned int Dimension = parspecs.size();
@@ -394,10 +394,6 @@ I3MinimizerResult I3GSLMultiMin::Minimize(I3GulliverBase &g,
         I3MinimizerUtils::CheckMinimum(*this, result, parspecs, g);
     }
 
-    // restore the previous GSL error handler
-    gsl_set_error_handler(old_gsl_error_handler);
-
-
     return result;
 };
 
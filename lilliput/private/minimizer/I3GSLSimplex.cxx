@@ -212,7 +212,7 @@ I3MinimizerResult I3GSLSimplex::Minimize(
         const std::vector<I3FitParameterInitSpecs> &parspecs ) {
 
     // we are going to check for errors ourselves, turn GSL error handling off
-    gsl_error_handler_t *old_gsl_error_handler = gsl_set_error_handler_off();
+    I3MinimizerUtils::GSLErrorHandlerOff gsl_error_handler_off;
 
     int Dimension = parspecs.size();
     assert( Dimension > 0 );
@@ -323,9 +323,6 @@ I3MinimizerResult I3GSLSimplex::Minimize(
         I3MinimizerUtils::CheckMinimum(*this, zeptognat,parspecs,g);
     }
 
-    // restore the previous GSL error handler
-    gsl_set_error_handler(old_gsl_error_handler);
-
     return zeptognat;
 };
 
@@ -14,8 +14,33 @@
 
 #include "minimizer/I3MinimizerUtils.h"
 
+#include <gsl/gsl_errno.h>
+#include <boost/thread/mutex.hpp>
+
 namespace I3MinimizerUtils {
 
+    namespace {
+        boost::mutex gslHandlerMutex;
+        unsigned int gslHandlerUsers = 0;
+        gsl_error_handler_t *gslPreviousHandler = NULL;
+    }
+
+    GSLErrorHandlerOff::GSLErrorHandlerOff()
+    {
+        boost::mutex::scoped_lock lock(gslHandlerMutex);
+        if ( gslHandlerUsers++ == 0 ){
+            gslPreviousHandler = gsl_set_error_handler_off();
+        }
+    }
+
+    GSLErrorHandlerOff::~GSLErrorHandlerOff()
+    {
+        boost::mutex::scoped_lock lock(gslHandlerMutex);
+        if ( --gslHandlerUsers == 0 ){
+            gsl_set_error_handler(gslPreviousHandler);
+        }
+    }
+
     void
     CheckMinimum(const I3ServiceBase &self, I3MinimizerResult &result,
         const std::vector<I3FitParameterInitSpecs> &parspecs, I3GulliverBase &llh)
@@ -43,6 +43,24 @@ namespace I3MinimizerUtils {
     void CheckMinimum(const I3ServiceBase & self, I3MinimizerResult & zeptognat,
         const std::vector<I3FitParameterInitSpecs> &parspecs, I3GulliverBase & gulliver);
 
+    /**
+     * @class GSLErrorHandlerOff
+     * Turns the GSL error handler off for the lifetime of the object, for
+     * minimizers that check the GSL status codes themselves. The handler
+     * is process-wide, so the guards keep a shared count: the first one
+     * turns it off and the last one restores the previous handler. This
+     * lets several GSL minimizers run on different threads at once,
+     * which saving and restoring the handler in each of them would not.
+     */
+    class GSLErrorHandlerOff {
+        public:
+            GSLErrorHandlerOff();
+            ~GSLErrorHandlerOff();
+        private:
+            GSLErrorHandlerOff(const GSLErrorHandlerOff&);
+            GSLErrorHandlerOff& operator=(const GSLErrorHandlerOff&);
+    };
+
     /**
      * @class ParameterWithInclusiveBounds
      * Bounded variables: some minimizers (such as GSL simplex) do not implement
@@ -25,6 +25,7 @@
 #include "dataclasses/I3Direction.h"
 #include "phys-services/I3Calculator.h"
 #include "gulliver/I3Gulliver.h"
+#include "gulliver/utilities/Dual.h"
 
 I3HalfSphereParametrization::I3HalfSphereParametrization (
             const std::string &name,
@@ -169,33 +170,24 @@ void I3HalfSphereParametrization::ApplyChainRule()
     const I3Direction& dir = gradient.GetDir();
     const I3Position& xyz = gradient.GetPos();
 
-    double p0(0), p1(0);
-    if (stepDir_ > 0) {
-        assert(par_.size()>=2);
-        p0 = par_[0];
-        p1 = par_[1];
-    }
-
     unsigned int ipar = 0;
 
-    // Calculate matrix to transform p0', p1' into theta', phi'. Ugly.
-    double newdirx = seedX_ + p0 * perp1X_ + p1 * perp2X_;
-    double newdiry = seedY_ + p0 * perp1Y_ + p1 * perp2Y_;
-    double newdirz = seedZ_ + p0 * perp1Z_ + p1 * perp2Z_;
-    double r = sqrt(newdirx*newdirx + newdiry*newdiry + newdirz*newdirz);
-
     // dL/dp0 = dL/dtheta * dtheta/dp0 + dL/dphi * dphi/dp0
     if (stepDir_ > 0) {
-    par_gradient_[ipar++] = dir.GetZenith()*(-newdirz*(newdirx*perp1X_ +
-     newdiry*perp1Y_) + perp1Z_*(newdirx*newdirx + newdiry*newdiry))/
-     (hypot(newdirx, newdiry)*r*r) +
-    dir.GetAzimuth()*(perp1Y_*newdirx - perp1X_*newdiry)/
-     (newdirx*newdirx + newdiry*newdiry);
-    par_gradient_[ipar++] = dir.GetZenith()*(-newdirz*(newdirx*perp2X_ +
-     newdiry*perp2Y_) + perp2Z_*(newdirx*newdirx + newdiry*newdiry))/
-     (hypot(newdirx, newdiry)*r*r) +
-    dir.GetAzimuth()*(perp2Y_*newdirx - perp2X_*newdiry)/
-     (newdirx*newdirx + newdiry*newdiry);
+        assert(par_.size()>=2);
+        typedef gulliver::Dual<2> Dual;
+        const Dual p0 = Dual::Variable(0, par_[0]);
+        const Dual p1 = Dual::Variable(1, par_[1]);
+        const Dual newdirx = seedX_ + p0 * perp1X_ + p1 * perp2X_;
+        const Dual newdiry = seedY_ + p0 * perp1Y_ + p1 * perp2Y_;
+        const Dual newdirz = seedZ_ + p0 * perp1Z_ + p1 * perp2Z_;
+        const Dual r = sqrt(newdirx*newdirx + newdiry*newdiry + newdirz*newdirz);
+        // the angles as I3Direction computes them (the offset of pi on the
+        // azimuth does not change the derivatives)
+        const Dual zenith = I3Constants::pi - acos(newdirz/r);
+        const Dual azimuth = atan2(newdiry, newdirx);
+        par_gradient_[ipar++] = dir.GetZenith()*zenith.d[0] + dir.GetAzimuth()*azimuth.d[0];
+        par_gradient_[ipar++] = dir.GetZenith()*zenith.d[1] + dir.GetAzimuth()*azimuth.d[1];
     }
 
     if ( varXYZ_ ){
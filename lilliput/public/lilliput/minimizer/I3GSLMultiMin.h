@@ -110,6 +110,9 @@ public:
     I3MinimizerResult Minimize(I3GulliverBase &g,
                                const std::vector<I3FitParameterInitSpecs> &parspecs ) ;
 
+    /// all state lives in the instance, so threads can each run one
+    virtual bool IsReentrant() const {return true;}
+
     /// set tolerance (what is "tolerance" supposed to be anyway ?)
     virtual double GetTolerance() const {return linesearchTolerance_;}
     virtual void SetTolerance(double newtol) {linesearchTolerance_ = newtol;}
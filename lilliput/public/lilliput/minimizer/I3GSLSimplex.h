@@ -75,6 +75,9 @@ public:
             I3GulliverBase &g,
             const std::vector<I3FitParameterInitSpecs> &parspecs ) ;
 
+    /// all state lives in the instance, so threads can each run one
+    bool IsReentrant() const { return true; }
+
     /// get the tolerance (of function value)
     double GetTolerance() const { return fvalTolerance_; }
 
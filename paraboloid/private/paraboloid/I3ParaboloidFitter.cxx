@@ -14,6 +14,8 @@
 #include <string>
 #include <sstream>
 #include <cmath>
+#include <algorithm>
+#include <limits>
 
 // my header
 #include "paraboloid/I3ParaboloidFitter.h"
@@ -33,6 +35,7 @@ I3_MODULE(I3ParaboloidFitter);
 #include "gulliver/I3MinimizerBase.h"
 #include "gulliver/I3EventHypothesis.h"
 #include "gulliver/utilities/ordinal.h"
+#include "gulliver/utilities/ParallelFit.h"
 #include "paraboloid/I3ParaboloidFitParams.h"
 
 
@@ -127,6 +130,35 @@ I3ParaboloidFitter::I3ParaboloidFitter(const I3Context& ctx) : I3ConditionalModu
                   "Default: no MC comparison.",
                   mcName_ );
 
+    AddParameter( "WorkerLogLikelihoods",
+                  "Names of additional LogLikelihood services, one per worker\n"
+                  "thread. Together with WorkerMinimizers this makes the\n"
+                  "vertex refits at the grid points run in parallel: one\n"
+                  "thread uses the services given above, every further thread\n"
+                  "uses one entry of each list. The worker services must be\n"
+                  "separate instances, configured like the main ones and\n"
+                  "implemented in C++, and the minimizers must be reentrant\n"
+                  "(e.g. I3GSLSimplex, not Minuit).",
+                  workerLikelihoods_ );
+
+    AddParameter( "WorkerMinimizers",
+                  "Names of additional minimizer services, one per worker\n"
+                  "thread (see WorkerLogLikelihoods).",
+                  workerMinimizers_ );
+
+    adaptiveGrid_ = false;
+    AddParameter( "AdaptiveGrid",
+                  "Evaluate only every other grid ring first (counting from\n"
+                  "the outermost one), then add the skipped rings next to\n"
+                  "the ring with the best likelihood (or next to the center,\n"
+                  "if that is best). The paraboloid is fitted to the\n"
+                  "evaluated rings only. At most ceil(N/2)+2 of the\n"
+                  "N=NumberOfSteps rings are fitted, so this saves nothing\n"
+                  "for NumberOfSteps <= 5; for larger NumberOfSteps it saves\n"
+                  "up to about half of the grid point fits, at the cost of\n"
+                  "a coarser sampling away from the minimum.",
+                  adaptiveGrid_ );
+
 }
 
 I3ParaboloidFitter::~I3ParaboloidFitter(){
@@ -163,6 +195,9 @@ void I3ParaboloidFitter::Configure(){
     GetParameter( "NumberOfSteps", nSteps_ );
     GetParameter( "NumberOfSamplingPoints", nSamplingPoints_ );
     GetParameter( "MCTruthName", mcName_ );
+    GetParameter( "WorkerLogLikelihoods", workerLikelihoods_ );
+    GetParameter( "WorkerMinimizers", workerMinimizers_ );
+    GetParameter( "AdaptiveGrid", adaptiveGrid_ );
 
     if (fitName_ == ""){
         log_warn( "Parameter \"OutputName\" of I3SimpleFitter instance \"%s\" was not set! "
@@ -226,6 +261,13 @@ void I3ParaboloidFitter::Configure(){
         log_info("No likelihood service configured");
         fatal=true;
     }
+    if (!(workerLikelihoods_.empty() && workerMinimizers_.empty()) &&
+        !(vertexStepSize_ > 0.)) {
+        log_error( "Module \"%s\": worker services are only used for the "
+                   "vertex refits, but vertex refitting is disabled",
+                   GetName().c_str() );
+        fatal=true;
+    }
     if (!seedService_) {
         log_info("No seed service configured");
         fatal=true;
@@ -274,6 +316,22 @@ void I3ParaboloidFitter::Configure(){
                 GetName()
             )
         );
+
+        // each worker gets its own vertex parametrization, with the same
+        // steps and bounds
+        std::vector<I3ParametrizationBasePtr> workerPars;
+        for ( unsigned int i = 0; i < workerLikelihoods_.size(); ++i ){
+            std::ostringstream name;
+            name << GetName() << "_vertexpar" << i+1;
+            workerPars.push_back( I3ParametrizationBasePtr(
+                new I3SimpleParametrization(
+                    name.str(), steps, absbounds, relbounds ) ) );
+        }
+        fitterCores_ = MakeWorkerGullivers( context_, fitterCore_, workerPars,
+                                            workerLikelihoods_,
+                                            workerMinimizers_, GetName() );
+        log_info( "(%s) Vertex refits on %zu thread(s).",
+                  GetName().c_str(), fitterCores_.size() );
     }
 
     if ( mcName_.empty() ){
@@ -304,6 +362,9 @@ void I3ParaboloidFitter::Geometry(I3FramePtr frame){
                 GetName().c_str());
     const I3Geometry& inicegeo = frame->Get< I3Geometry >();
     eventLLH_->SetGeometry(inicegeo);
+    for ( unsigned int i = 1; i < fitterCores_.size(); ++i ){
+        fitterCores_[i]->SetGeometry(inicegeo);
+    }
     PushFrame( frame, "OutBox" );
     log_debug( "(%s) Leaving I3Paraboloid Geometry().",
                GetName().c_str() );
@@ -515,10 +576,7 @@ int I3ParaboloidFitter::GetParaboloidDatapoints(const I3Frame &f, const I3EventH
     // mostly copied from sieglinde/reconstruction/SLParaboloidLogLH.cc
 
     // temporary data point added to ParabolaFit list
-    static ParaboloidImpl::XYTupel datapoint;
-    // azimuth/zenith coordinates relative to the seeding track
-    // (if rotated to pi/2;pi)
-    double azi_off, zen_off;
+    ParaboloidImpl::XYTupel datapoint;
     // azimuth/zenith coordinates in standard CO system
     double azimuth, zenith;
     // temporary vector representing the seed track
@@ -578,44 +636,125 @@ int I3ParaboloidFitter::GetParaboloidDatapoints(const I3Frame &f, const I3EventH
         gridSeedService_->SetEvent(f);
     }
 
+    // the frame is not thread safe, so the workers get the event here
+    // (the main likelihood got it in NDFOK)
+    for ( unsigned int i = 1; i < fitterCores_.size(); ++i ){
+        fitterCores_[i]->SetEvent(f);
+    }
+
+    // best likelihood for the center (index 0) and for each ring
+    // (NaN likelihoods count as infinitely bad, min_element can't order them)
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> ringLlh(nSteps_+1, inf);
+    ringLlh[0] = std::isnan(seedLlh_) ? inf : seedLlh_;
+
+    std::vector<int> rings;
+    if ( adaptiveGrid_ ){
+        for ( int ring = nSteps_; ring > 0; ring -= 2 ){
+            rings.push_back(ring);
+        }
+        std::reverse(rings.begin(), rings.end());
+    } else {
+        for ( unsigned int ring = 1; ring <= nSteps_; ++ring ){
+            rings.push_back(ring);
+        }
+    }
+
     int nFailures = 0;
-    // get next point
-    while ( grid_.GridNext(azi_off, zen_off, azimuth, zenith) > 0 ){
+    if ( GetRingDatapoints(seedcp, rings, nFailures, ringLlh) < 0 ){
+        return -1;
+    }
+
+    if ( adaptiveGrid_ ){
+        // refine next to the best ring; rings that were not evaluated are
+        // still at infinity, so they are never the best
+        int best = std::min_element(ringLlh.begin(), ringLlh.end()) - ringLlh.begin();
+        std::vector<int> refine;
+        for ( int ring = best-1; ring <= best+1; ring += 2 ){
+            if ( ring > 0 && ring <= int(nSteps_) &&
+                 std::find(rings.begin(), rings.end(), ring) == rings.end() ){
+                refine.push_back(ring);
+            }
+        }
+        log_debug( "(%s) best ring %d, refining %zu ring(s)",
+                   GetName().c_str(), best, refine.size() );
+        if ( GetRingDatapoints(seedcp, refine, nFailures, ringLlh) < 0 ){
+            return -1;
+        }
+    }
+
+    return 1;
+}
+
+// evaluate (vertex refit) the grid points on the given rings and add them
+// to the paraboloid data points, in ring and point order
+int I3ParaboloidFitter::GetRingDatapoints( const I3EventHypothesis &seedcp,
+                                           const std::vector<int> &rings,
+                                           int &nFailures,
+                                           std::vector<double> &ringLlh ){
+
+    const size_t nPoints = grid_.GetPtsOnCircle();
+    const size_t n = rings.size() * nPoints;
+    std::vector<ParaboloidImpl::XYTupel> datapoints(n);
+    std::vector<I3LogLikelihoodFitPtr> fits(n);
+    std::vector<double> llhpre(n, 0.);
+    std::vector<double> llhpost(n, 0.);
+
+    // prepare the grid seeds; the seed services are not thread safe
+    for ( size_t i = 0; i < n; ++i ){
+
+        // azimuth/zenith coordinates relative to the seeding track
+        // (if rotated to pi/2;pi), and in standard CO system
+        double azi_off, zen_off, azimuth, zenith;
+        grid_.GridPoint(rings[i/nPoints], i%nPoints,
+                        azi_off, zen_off, azimuth, zenith);
 
         // new copy from central gridpoint
-        fitptr->hypothesis_ = seedService_->GetCopyPtr( seedcp );
+        fits[i] = I3LogLikelihoodFitPtr(
+            new I3LogLikelihoodFit(seedService_->GetCopy(seedcp)));
+        I3EventHypothesis &hypothesis = *(fits[i]->hypothesis_);
 
         // put in the zenith+azimuth values from the grid
-        fitptr->hypothesis_->particle->SetDir(zenith,azimuth);
+        hypothesis.particle->SetDir(zenith,azimuth);
 
         // the grid datapoints are based on the coordinates rotated to the equator
-        datapoint.x[0] = zen_off;
-        datapoint.x[1] = azi_off;
+        datapoints[i].x[0] = zen_off;
+        datapoints[i].x[1] = azi_off;
 
-        double llhpre=0;
-        double llhpost=0;
         if ( nMaxMissingGridPoints_ > 0 ){
-            llhpre = -1.0 * eventLLH_->GetLogLikelihood(*(fitptr->hypothesis_));
+            llhpre[i] = -1.0 * eventLLH_->GetLogLikelihood(hypothesis);
         }
 
         // do vertex spacetime tweaks, if wanted.
         if ( gridSeedService_ ){
-            gridSeedService_->Tweak(*(fitptr->hypothesis_));
+            gridSeedService_->Tweak(hypothesis);
             if ( nMaxMissingGridPoints_ > 0 ){
-                llhpost = -1.0 * eventLLH_->GetLogLikelihood(*(fitptr->hypothesis_));
+                llhpost[i] = -1.0 * eventLLH_->GetLogLikelihood(hypothesis);
             }
         } else {
-            llhpost = llhpre;
+            llhpost[i] = llhpre[i];
         }
+    }
 
+    // the vertex refits are independent, so they can run in parallel
+    // (not std::vector<bool>, threads write to neighbouring elements)
+    std::vector<char> success(n, 0);
+    if ( fitterCore_ ){
+        ParallelFit(fitterCores_, n, [&](I3Gulliver &core, size_t i){
+            success[i] = core.Fit( fits[i] );
+        });
+    }
+
+    // collect the results in grid order, whichever thread did the fit
+    for ( size_t i = 0; i < n; ++i ){
+        I3LogLikelihoodFitPtr fitptr = fits[i];
 
         if ( fitterCore_ ){
-            bool success = fitterCore_->Fit( f, fitptr );
 
             // store results
-            if ( success ){
+            if ( success[i] ){
 
-                datapoint.y = fitptr->fitparams_->logl_;
+                datapoints[i].y = fitptr->fitparams_->logl_;
 
             } else {
 
@@ -633,14 +772,18 @@ int I3ParaboloidFitter::GetParaboloidDatapoints(const I3Frame &f, const I3EventH
                 // workaround: use llh value from grid seed
                 // (with or without tweak, whichever is best)
                 // hm. maybe nFailures is an interesting pbf parameter?
-                datapoint.y = (llhpre<llhpost) ? llhpre: llhpost;
+                datapoints[i].y = (llhpre[i]<llhpost[i]) ? llhpre[i]: llhpost[i];
 
             }
         } else {
-            datapoint.y = -1.0*eventLLH_->GetLogLikelihood( *(fitptr->hypothesis_) );
+            datapoints[i].y = -1.0*eventLLH_->GetLogLikelihood( *(fitptr->hypothesis_) );
         }
 
-        paraFit_.push_back(datapoint);
+        double &best = ringLlh[rings[i/nPoints]];
+        if ( !std::isnan(datapoints[i].y) ){
+            best = std::min(best, datapoints[i].y);
+        }
+        paraFit_.push_back(datapoints[i]);
     }
 
     return 1;
@@ -346,23 +346,34 @@ int ParaboloidImpl::GridStar::GridNext( double &Azi_Local, double &Zen_Local,
             return 0;
         }
 
-        // calculate stretch value for next circle
-        Stretch=(double)Count_Circles/(double)Number_Circles;
         Count_Points=0;
     }
 
-    // calculate position of next sampling point in local coordinate system
-    Azi_Local=Azi_Global=azimuth_table[Count_Points]*Stretch;
-    Zen_Local=Zen_Global=zenith_table[Count_Points]*Stretch;
+    GridPoint(Count_Circles, Count_Points,
+              Azi_Local, Zen_Local, Azi_Global, Zen_Global);
+
+    return Count_Circles;
+}
+
+// calculate local and global coordinates for a given point on a given
+// circle (circles count from 1, points from 0), independent of GridNext
+void ParaboloidImpl::GridStar::GridPoint( int Circle, int Point,
+                    double &Azi_Local, double &Zen_Local,
+                    double &Azi_Global, double &Zen_Global)
+{
+    // stretch value for this circle
+    double stretch=(double)Circle/(double)Number_Circles;
+
+    // calculate position of the sampling point in local coordinate system
+    Azi_Local=Azi_Global=azimuth_table[Point]*stretch;
+    Zen_Local=Zen_Global=zenith_table[Point]*stretch;
 
     // rotate local vector into global system
     localnet.Rotate(Azi_Global, Zen_Global);
 
     log_trace("circle=%d point=%d zenloc=%g zenglob=%g aziloc%g aziglob=%g",
-               Count_Circles, Count_Points,
+               Circle, Point,
                Zen_Local, Zen_Global, Azi_Local, Azi_Global);
-
-    return Count_Circles;
 }
 
 /*****************************************************************************
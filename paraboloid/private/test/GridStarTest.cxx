@@ -0,0 +1,33 @@
+#include <I3Test.h>
+#include <icetray/I3Units.h>
+#include "paraboloid/ParaboloidImpl.h"
+
+TEST_GROUP(GridStarTest)
+
+// GridPoint gives the same points as a GridNext scan, in any order
+TEST(GridPointMatchesGridNext){
+  I3Direction dir(1.1, 4.2);
+  ParaboloidImpl::GridStar scan, direct;
+  ENSURE(scan.Init(8, 3, 2*I3Units::degree, 3*I3Units::degree, dir) > 0);
+  ENSURE(direct.Init(8, 3, 2*I3Units::degree, 3*I3Units::degree, dir) > 0);
+  ENSURE_EQUAL(direct.GetNumberCircles(), 3);
+  ENSURE_EQUAL(direct.GetPtsOnCircle(), 8);
+
+  double azi_off, zen_off, azimuth, zenith;
+  int n = 0;
+  int circle;
+  while ( (circle = scan.GridNext(azi_off, zen_off, azimuth, zenith)) > 0 ){
+    int point = n % 8;
+    ENSURE_EQUAL(circle, n/8 + 1, "GridNext goes ring by ring");
+    // ask for the rings in reverse order
+    double azi_off2, zen_off2, azimuth2, zenith2;
+    direct.GridPoint(4 - circle, point, azi_off2, zen_off2, azimuth2, zenith2);
+    direct.GridPoint(circle, point, azi_off2, zen_off2, azimuth2, zenith2);
+    ENSURE_EQUAL(azi_off, azi_off2);
+    ENSURE_EQUAL(zen_off, zen_off2);
+    ENSURE_EQUAL(azimuth, azimuth2);
+    ENSURE_EQUAL(zenith, zenith2);
+    ++n;
+  }
+  ENSURE_EQUAL(n, 24);
+}
@@ -16,6 +16,7 @@
 
 // std lib stuff
 #include <string>
+#include <vector>
 
 // gulliver stuff
 #include "gulliver/I3Gulliver.h"
@@ -73,6 +74,17 @@
  * status tells you exactly what went wrong; this can help you to improve
  * the configuration of the fitter modules or to diagnose problems.
  *
+ * The vertex refits at the grid points are independent, so they can be
+ * run on several threads (each thread needs its own likelihood and
+ * minimizer service, see the WorkerLogLikelihoods and WorkerMinimizers
+ * options). As for the other parallel fitters, the minimizers must be
+ * reentrant (I3MinimizerBase::IsReentrant()), otherwise the module refuses
+ * the worker services. The grid seeds are prepared and the results are
+ * collected in grid order, so with reentrant services that are configured
+ * alike the result is the same as with a single thread.
+ * With the AdaptiveGrid option only every other ring is evaluated at
+ * first, and the remaining rings are only evaluated next to the best one.
+ *
  * The original ideas and implementation for the paraboloid fitter were by
  * Till Neunhoeffer.
  *
@@ -113,6 +125,9 @@ private:
      */
     I3GulliverPtr fitterCore_;
 
+    /// fitter cores for the grid point refits, the first one is fitterCore_
+    std::vector<I3GulliverPtr> fitterCores_;
+
     /// seed service for input track
     I3SeedServiceBasePtr seedService_;
 
@@ -131,6 +146,9 @@ private:
     double zenithReach_;              /// grid scale for zenith 
     unsigned int nSteps_;             /// number of grid rings around input direction
     unsigned int nSamplingPoints_;    /// number of grid points on each grid ring
+    std::vector<std::string> workerLikelihoods_; /// likelihood services of the additional threads
+    std::vector<std::string> workerMinimizers_;  /// minimizer services of the additional threads
+    bool adaptiveGrid_;               /// evaluate rings next to the best one only
 
     /// NDF: compute once, use anywhere during physics event
     int ndf_;
@@ -173,6 +191,12 @@ private:
     /// generate grid of directions
     int GetParaboloidDatapoints( const I3Frame& f, const I3EventHypothesis &hypothesis);
 
+    /// refit the grid points on some of the rings, track the best llh per ring
+    int GetRingDatapoints( const I3EventHypothesis &seedcp,
+                           const std::vector<int> &rings,
+                           int &nFailures,
+                           std::vector<double> &ringLlh );
+
     /// store direction error estimate
     int GetErrorsFromCurvature( I3ParaboloidFitParams &parabParam);
 
@@ -140,6 +140,9 @@ namespace ParaboloidImpl {
     
         int Init(int n_Pts_on_Circle, int n_Number_Circles, double n_Azi_Reach, double n_Zen_Reach, I3Direction &track); 
         int GridNext(double &Azi_Local, double &Zen_Local, double &Azi_Global, double &Zen_Global); 
+        void GridPoint(int Circle, int Point, double &Azi_Local, double &Zen_Local, double &Azi_Global, double &Zen_Global);
+        int GetNumberCircles() const {return Number_Circles;}
+        int GetPtsOnCircle() const {return Pts_on_Circle;}
     
         RotateLocalNet localnet;
     
@@ -147,7 +150,6 @@ namespace ParaboloidImpl {
         double Azi_Reach, Zen_Reach;
         int Number_Circles, Count_Circles;
         int Pts_on_Circle, Count_Points; 
-        double Stretch;
     
         std::vector<double> zenith_table;
         std::vector<double> azimuth_table;
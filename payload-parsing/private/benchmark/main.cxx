@@ -0,0 +1,128 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <chrono>
+#ifndef __APPLE_CC__
+#include <netinet/in.h>
+#else
+#include <sys/types.h>
+#include <machine/endian.h>
+#endif
+
+#include <boost/algorithm/string.hpp>
+
+#include <icetray/I3Frame.h>
+#include <dataclasses/physics/I3DOMLaunch.h>
+#include <payload-parsing/I3PayloadParsingEventDecoder.h>
+#include <phys-services/I3XMLOMKey2MBID.h>
+#include <phys-services/I3FileOMKey2MBID.h>
+
+using namespace boost::algorithm;
+
+// Measures the throughput of I3PayloadParsingEventDecoder on recorded
+// event payloads (eg. $I3_TESTDATA/payload-parser/payload_testdata/physics-v5.dat),
+// which for delta compressed data is dominated by delta_decode.
+
+int main(int argc,char** argv)
+{
+  if(argc < 3)
+    {
+      std::cerr << "usage: " << argv[0]
+                << " infile mainboard_id_mapping [passes]" << std::endl;
+      return(1);
+    }
+
+  std::string infile = argv[1];
+  std::string idfile = argv[2];
+  unsigned passes = argc > 3 ? atoi(argv[3]) : 10;
+
+  I3OMKey2MBID* idMap = NULL;
+  if (ends_with(idfile, ".txt"))
+    idMap = new I3FileOMKey2MBID(idfile);
+  else if (ends_with(idfile, ".xml") || ends_with(idfile, ".xml.gz"))
+    idMap = new I3XMLOMKey2MBID(idfile);
+  else {
+    std::cerr << "invalid mainboard ID to OMKey mapping" << std::endl;
+    return(1);
+  }
+
+  // read all events up front so that only the decoding is timed
+  std::ifstream ifs(infile.c_str());
+  std::vector<std::vector<char> > events;
+  size_t nbytes = 0;
+  uint32_t eventSize;
+  while(ifs.read((char *) &eventSize, 4))
+    {
+      eventSize = ntohl(eventSize);
+      if(eventSize < 4)
+        {
+          std::cerr << "bad event size " << eventSize << std::endl;
+          return(1);
+        }
+      events.push_back(std::vector<char>(eventSize));
+      ifs.seekg(-4, std::ios::cur);
+      if(!ifs.read(&(events.back()[0]), eventSize))
+        {
+          std::cerr << "truncated event in " << infile << std::endl;
+          return(1);
+        }
+      nbytes += eventSize;
+    }
+  std::cout << "Read " << events.size() << " events (" << nbytes
+            << " bytes) from " << infile << std::endl;
+  if(events.empty())
+    return(1);
+
+  I3PayloadParsingEventDecoder decoder(*idMap,
+      0,
+      "I3EventHeader",
+      "I3TriggerHierarchy",
+      std::vector<OMKey>(),
+      "Special",
+      "InIce",
+      "IceTop",
+      "RawData",
+      "Flasher",
+      "Beacon",
+      "LED",
+      "Test",
+      "Min_Bias");
+
+  size_t nlaunches = 0;
+  std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+  for(unsigned pass = 0 ; pass < passes ; pass++)
+    {
+      for(size_t i = 0 ; i < events.size() ; i++)
+        {
+          I3Frame frame(I3Frame::DAQ);
+          decoder.FillEvent(frame, events[i]);
+          if(pass > 0)
+            continue;
+          for(I3Frame::typename_iterator iter = frame.typename_begin();
+              iter != frame.typename_end();
+              iter++)
+            {
+              I3DOMLaunchSeriesMapConstPtr launches =
+                frame.Get<I3DOMLaunchSeriesMapConstPtr>(iter->first);
+              if(!launches)
+                continue;
+              for(I3DOMLaunchSeriesMap::const_iterator dom = launches->begin();
+                  dom != launches->end();
+                  dom++)
+                nlaunches += dom->second.size();
+            }
+        }
+    }
+  double seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - begin).count();
+  std::cout << "Decoded " << passes << " x " << events.size() << " events ("
+            << nlaunches << " launches each pass) in " << seconds << " s"
+            << std::endl;
+  std::cout << "  " << passes * events.size() / seconds << " events/s, "
+            << passes * nlaunches / seconds << " launches/s, "
+            << passes * nbytes / seconds / 1e6 << " MB/s" << std::endl;
+
+  delete idMap;
+  return(0);
+}
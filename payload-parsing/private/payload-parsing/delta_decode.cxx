@@ -3,6 +3,8 @@
 #include <payload-parsing/delta_decode.h>
 #include <payload-parsing/utility.h>
 #include <vector>
+#include <algorithm>
+#include <iterator>
 #include <dataclasses/physics/I3DOMLaunch.h>
 #include <getopt.h>
 #include <stdio.h>
@@ -19,6 +21,168 @@ using namespace std;
 
 namespace payload_parsing
 {
+  namespace
+  {
+    // Transitions of the delta compression, indexed by the number of bits
+    // per word: a word equal to flagWord switches to widerWord bits, a
+    // value smaller in magnitude than wastedValue to narrowerWord bits.
+    const int flagWord[12]          = {-1, 1, 2, 4, -1, -1, 32, -1, -1, -1, -1, -1};
+    const int wastedValue[12]       = { 0, 0, 1, 2,  0,  0,  4,  0,  0,  0,  0, 32};
+    const unsigned widerWord[12]    = { 0, 2, 3, 6,  0,  0, 11,  0,  0,  0,  0,  0};
+    const unsigned narrowerWord[12] = { 0, 0, 1, 2,  0,  0,  3,  0,  0,  0,  0,  6};
+
+    // the eight bytes at byte as a little endian word, zero padded past the
+    // end of the buffer
+    inline uint64_t load_le64(const std::vector<char>& buffer, size_t byte)
+    {
+      uint64_t word = 0;
+      if(byte + 8 <= buffer.size())
+      {
+        memcpy(&word, &buffer[byte], 8);
+#if defined(BOOST_BIG_ENDIAN)
+        word = endian_swap(word);
+#endif
+        return word;
+      }
+      for(size_t i = 0 ; byte + i < buffer.size() ; i++)
+        word |= uint64_t(static_cast<unsigned char>(buffer[byte + i])) << (8 * i);
+      return word;
+    }
+
+    // Every run of words of at most 3 bits that starts in a given byte of
+    // the stream, decoded ahead of time for each word size. Quiet parts of
+    // a waveform are coded in 1 to 3 bit words, so most of a waveform is
+    // decoded one byte at a time with a single lookup.
+    struct byte_decoding
+    {
+      int8_t deltas[8];
+      uint8_t nsamples;
+      uint8_t bits;
+      uint8_t bitsPerWord;
+    };
+
+    struct byte_decoding_table
+    {
+      byte_decoding entries[4][256];
+
+      byte_decoding_table()
+      {
+        for(unsigned width = 1 ; width <= 3 ; width++)
+        {
+          for(unsigned byte = 0 ; byte < 256 ; byte++)
+          {
+            byte_decoding& entry = entries[width][byte];
+            entry.nsamples = 0;
+            entry.bits = 0;
+            unsigned bitsPerWord = width;
+            while(bitsPerWord <= 3 && entry.bits + bitsPerWord <= 8)
+            {
+              int word = (byte >> entry.bits) & ((1u << bitsPerWord) - 1);
+              entry.bits += bitsPerWord;
+              if(word == flagWord[bitsPerWord])
+              {
+                bitsPerWord = widerWord[bitsPerWord];
+                continue;
+              }
+              int value = word - (((word >> (bitsPerWord - 1)) & 1) << bitsPerWord);
+              entry.deltas[entry.nsamples++] = value;
+              if(abs(value) < wastedValue[bitsPerWord])
+                bitsPerWord = narrowerWord[bitsPerWord];
+            }
+            entry.bitsPerWord = bitsPerWord;
+          }
+        }
+      }
+    };
+  }
+
+  size_t delta_decode_samples(const std::vector<char>& buffer,
+      unsigned start,
+      unsigned length,
+      int* waveform,
+      size_t nbins)
+  {
+    const uint64_t endBit = 
+      buffer.size() > start ? uint64_t(buffer.size() - start) * 8 : 0;
+    int remainingBits = length * 8;
+
+    // bits read since start, and the 64 bits cached from bit cacheBit on
+    uint64_t bit = 0;
+    uint64_t cacheBit = 0;
+    uint64_t cache = start < buffer.size() ? load_le64(buffer, start) : 0;
+
+    static const byte_decoding_table table;
+
+    unsigned bitsPerWord = 3;
+    int accummulatedWaveform = 0;
+    size_t waveformBin = 0;
+    size_t nextReset = 256;
+    // no reset within the samples of a table entry
+    size_t tableLimit = std::min(nbins, nextReset);
+
+    while(waveformBin < nbins)
+    {
+      if(bit - cacheBit + 11 > 64)
+      {
+        cacheBit = bit & ~uint64_t(7);
+        cache = load_le64(buffer, start + bit / 8);
+      }
+
+      // a whole byte of narrow words at once, as long as none of them can
+      // be the last word or lie past the end of the buffer
+      if(bitsPerWord <= 3 &&
+          waveformBin + 8 < tableLimit &&
+          (remainingBits > 8 + 11 || remainingBits <= 0) &&
+          bit + 8 <= endBit)
+      {
+        const byte_decoding& entry =
+          table.entries[bitsPerWord][(cache >> (bit - cacheBit)) & 0xff];
+        for(unsigned i = 0 ; i < entry.nsamples ; i++)
+        {
+          accummulatedWaveform += entry.deltas[i];
+          waveform[waveformBin++] = accummulatedWaveform;
+        }
+        bit += entry.bits;
+        remainingBits -= entry.bits;
+        bitsPerWord = entry.bitsPerWord;
+        continue;
+      }
+
+      // the bitbuffer loop compares (remaining - bitsPerWord) unsigned, so
+      // it only stops on running out of samples or on an exact fit
+      if(unsigned(remainingBits >= 0 ? remainingBits : 0) == bitsPerWord)
+        break;
+      if(bit >= endBit)
+        log_fatal("reading past the end of the buffer");
+
+      int word = (cache >> (bit - cacheBit)) & ((1u << bitsPerWord) - 1);
+      bit += bitsPerWord;
+      remainingBits -= bitsPerWord;
+
+      if(word == flagWord[bitsPerWord])
+      {
+        bitsPerWord = widerWord[bitsPerWord];
+        continue;
+      }
+
+      // sign extend the two's complement word
+      int value = word - (((word >> (bitsPerWord - 1)) & 1) << bitsPerWord);
+      accummulatedWaveform += value;
+      waveform[waveformBin++] = accummulatedWaveform;
+      if(abs(value) < wastedValue[bitsPerWord])
+        bitsPerWord = narrowerWord[bitsPerWord];
+
+      if(waveformBin == nextReset)
+      {
+        accummulatedWaveform = 0;
+        bitsPerWord = 3;
+        nextReset = nextReset < 256 + 128 + 128 + 128 ? nextReset + 128 : 0;
+        tableLimit = nextReset ? std::min(nbins, nextReset) : nbins;
+      }
+    }
+    return waveformBin;
+  }
+
   I3DOMLaunch::TriggerType eventTrigTypeToDOMLaunchDelta(int trigword)
   {
     if (trigword & 0x0) {
@@ -191,37 +355,18 @@ namespace payload_parsing
       log_fatal("The Charge Stamp has to be either InIce or IceTop...");
     }
 
-    bitbuffer bits(buffer, start + 8 + 50, hitsize - 8);
-
-    unsigned bitsPerWord = 3;
-
-    int accummulatedWaveform = 0;
-    size_t waveformBin = 0;
-
-    vector<int> decodedWaveform;
+    // the FADC and up to four ATWD channels, decoded in place
+    int decodedWaveform[256 + 128 + 128 + 128 + 128];
+    size_t nbins = 0;
     if(fadcAvail && atwdAvail)
     {
       launch.SetLCBit(true);
-      switch(atwdnch)
-      {
-        case 0:
-          decodedWaveform.resize(256 + 128, 0);
-          break;
-        case 1:
-          decodedWaveform.resize(256 + 128 + 128, 0);
-          break;
-        case 2:
-          decodedWaveform.resize(256 + 128 + 128 + 128, 0);
-          break;
-        case 3:
-          decodedWaveform.resize(256 + 128 + 128 + 128 + 128, 0);
-          break;
-      }
+      nbins = 256 + 128 * (atwdnch + 1);
     }
     else if(fadcAvail && !atwdAvail)
     {
       launch.SetLCBit(true);
-      decodedWaveform.resize(256, 0);
+      nbins = 256;
     }
     else if(!fadcAvail && !atwdAvail)
     {
@@ -229,88 +374,16 @@ namespace payload_parsing
       mode += I3DOMLaunch::SLC_READOUT;
       //log_error("TriggerType is SLC... I3DOMLaunch.h needs to be updated");
     }
+    std::fill(decodedWaveform, decodedWaveform + nbins, 0);
 
     I3DOMLaunch::TriggerMode triggermode = 
       static_cast<I3DOMLaunch::TriggerMode>(mode);
 
     launch.SetTriggerMode(triggermode);
 
-    unsigned bitsRetrieved = 0;
-
-    //cout<<"bitsPopped for call "<<calls<<endl;
-    if(fadcAvail || atwdAvail){
-      while(bits.remainingBits() - bitsPerWord > 0 && 
-          waveformBin < decodedWaveform.size())
-      {         
-        delta d = bits.pop(bitsPerWord);
-
-        //cout<<"bitsRetrieved:"<<bitsRetrieved<<endl;
-        //cout<<"bitsPopped:"<<bitsPerWord<<endl;
-
-        bitsRetrieved += bitsPerWord;
-        //dumpbits(d);
-        if(d.isFlag())
-        {
-          //cout<<"found a flag and so switching bitsPerWord "
-          //<<"was originally "<<bitsPerWord<<" and is now ";
-          switch(bitsPerWord)
-          {
-            case 1:
-              bitsPerWord = 2;
-              break;
-            case 2:
-              bitsPerWord = 3;
-              break;
-            case 3:
-              bitsPerWord = 6;
-              break;
-            case 6:
-              bitsPerWord = 11;
-              break;
-            default:
-              log_fatal("wrong 'bitsPerWord', code error %d", bitsPerWord);
-          }
-          //cout<<bitsPerWord<<endl;
-        }
-        else
-        {
-          accummulatedWaveform += d.getValue();
-          decodedWaveform[waveformBin] = accummulatedWaveform;
-          //cout<<"waveform["<<waveformBin<<"]="<<accummulatedWaveform<<endl;
-          waveformBin += 1;
-          if(d.wastedBits())
-          {
-            switch(bitsPerWord)
-            {
-              case 2:
-                bitsPerWord = 1;
-                break;
-              case 3:
-                bitsPerWord = 2;
-                break;
-              case 6:
-                bitsPerWord = 3;
-                break;
-              case 11:
-                bitsPerWord = 6;
-                break;
-              default:
-                log_fatal("wrong 'bitsPerWord', code error %d",bitsPerWord);
-            }
-          }
-
-          if(waveformBin == 256 || 
-              waveformBin == 256 + 128 ||
-              waveformBin == 256 + 128 + 128 ||
-              waveformBin == 256 + 128 + 128 + 128)
-          {
-            accummulatedWaveform =0;
-            bitsPerWord = 3;
-          }
-
-        }
-      }
-    }
+    if(fadcAvail || atwdAvail)
+      delta_decode_samples(buffer, start + 8 + 50, hitsize - 8,
+          decodedWaveform, nbins);
 
     // putting the RawChargeStamp into the DOMLaunch
     if(decodedRawChargeStamp.size() == 3)
@@ -323,44 +396,17 @@ namespace payload_parsing
 
 
     // now extract the waveform into the DOMLaunch 
-    if(decodedWaveform.size() >= 256)
-    {
-      launch.GetRawFADC().resize(256);
-      copy(&(decodedWaveform[0]),
-          &(decodedWaveform[256]),
-          launch.GetRawFADC().begin());
-    }
-
-    if(decodedWaveform.size() >= 128 + 256)
-    {
-      launch.GetRawATWD(0).resize(128);
+    if(nbins >= 256)
+      launch.GetRawFADC().assign(decodedWaveform, decodedWaveform + 256);
 
-      copy(&(decodedWaveform[256]),
-          &(decodedWaveform[128 + 256]),
-          launch.GetRawATWD(0).begin());
-      // reversing waveforms so that the timing is right...
-      reverse(launch.GetRawATWD(0).begin(), launch.GetRawATWD(0).end());
-
-    }
-
-    if(decodedWaveform.size() >= 128 + 128 + 256)
+    // reversing the ATWD waveforms so that the timing is right...
+    for(unsigned channel = 0 ; channel < 3 ; channel++)
     {
-      launch.GetRawATWD(1).resize(128);
-      copy(&(decodedWaveform[128 + 256]),
-          &(decodedWaveform[128 + 128 + 256]),
-          launch.GetRawATWD(1).begin());
-      // reversing waveforms so that the timing is right...
-      reverse(launch.GetRawATWD(1).begin(), launch.GetRawATWD(1).end());
+      const size_t first = 256 + 128 * channel;
+      if(nbins >= first + 128)
+        launch.GetRawATWD(channel).assign(
+            std::reverse_iterator<int*>(decodedWaveform + first + 128),
+            std::reverse_iterator<int*>(decodedWaveform + first));
     }
-
-    if(decodedWaveform.size() >= 128 + 128 + 128 + 256)
-    {
-      launch.GetRawATWD(2).resize(128);
-      copy(&(decodedWaveform[128 + 128 + 256]),
-          &(decodedWaveform[128 + 128 + 128 +256]),
-          launch.GetRawATWD(2).begin());
-      // reversing waveforms so that the timing is right...
-      reverse(launch.GetRawATWD(2).begin(), launch.GetRawATWD(2).end());
-    } 
   }
 };
@@ -1,5 +1,6 @@
 #include <I3Test.h>
 #include <vector>
+#include <cstdlib>
 
 #include <payload-parsing/delta_decode.h>
 
@@ -456,3 +457,90 @@ TEST(the_test)
   }
   */
 }
+
+namespace bitbuffertest
+{
+  // the bit by bit decoding loop delta_decode used before
+  // delta_decode_samples, kept as a reference
+  size_t reference_decode(const vector<char>& buffer,
+      unsigned start,
+      unsigned length,
+      vector<int>& decodedWaveform)
+  {
+    bitbuffer bits(buffer, start, length);
+    unsigned bitsPerWord = 3;
+    int accummulatedWaveform = 0;
+    size_t waveformBin = 0;
+    while(bits.remainingBits() - bitsPerWord > 0 &&
+        waveformBin < decodedWaveform.size())
+    {
+      delta d = bits.pop(bitsPerWord);
+      if(d.isFlag())
+      {
+        switch(bitsPerWord)
+        {
+          case 1: bitsPerWord = 2; break;
+          case 2: bitsPerWord = 3; break;
+          case 3: bitsPerWord = 6; break;
+          case 6: bitsPerWord = 11; break;
+        }
+      }
+      else
+      {
+        accummulatedWaveform += d.getValue();
+        decodedWaveform[waveformBin] = accummulatedWaveform;
+        waveformBin += 1;
+        if(d.wastedBits())
+        {
+          switch(bitsPerWord)
+          {
+            case 2: bitsPerWord = 1; break;
+            case 3: bitsPerWord = 2; break;
+            case 6: bitsPerWord = 3; break;
+            case 11: bitsPerWord = 6; break;
+          }
+        }
+        if(waveformBin == 256 ||
+            waveformBin == 256 + 128 ||
+            waveformBin == 256 + 128 + 128 ||
+            waveformBin == 256 + 128 + 128 + 128)
+        {
+          accummulatedWaveform = 0;
+          bitsPerWord = 3;
+        }
+      }
+    }
+    return waveformBin;
+  }
+}
+
+TEST(delta_decode_samples_matches_bitbuffer)
+{
+  srand(42);
+  const size_t sizes[] = {256, 256 + 128, 256 + 128 + 128 + 128 + 128};
+  for(unsigned trial = 0 ; trial < 2000 ; trial++)
+  {
+    unsigned start = rand() % 16;
+    unsigned length = rand() % 700;
+    size_t nbins = sizes[trial % 3];
+    // room for the reference reader to run past length (at most 20 bits
+    // per sample) without reaching the end of the buffer
+    vector<char> buffer(start + length + nbins * 3 + 16);
+    for(size_t i = 0 ; i < buffer.size() ; i++)
+    {
+      // mostly small deltas, as in real waveforms
+      buffer[i] = (trial % 2) ? rand() : (rand() & 0x49);
+    }
+
+    vector<int> expected(nbins, 0);
+    size_t nexpected =
+      bitbuffertest::reference_decode(buffer, start, length, expected);
+
+    vector<int> decoded(nbins, 0);
+    size_t ndecoded =
+      delta_decode_samples(buffer, start, length, &decoded[0], nbins);
+
+    ENSURE_EQUAL(ndecoded, nexpected, "same number of samples decoded");
+    ENSURE(decoded == expected, "same samples decoded");
+  }
+}
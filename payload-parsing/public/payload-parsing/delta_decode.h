@@ -23,6 +23,21 @@ namespace payload_parsing
       I3DOMLaunch& launch,
       unsigned WhichChargeStamp);
 
+  /**
+   * @brief Decodes the delta compressed samples of a hit starting at byte
+   * start of buffer into waveform, reading 64 bits at a time instead of
+   * popping words through a bitbuffer. The result is the same as stepping
+   * through a bitbuffer(buffer, start, length) with delta words; the
+   * accumulated sum and the word size reset at samples 256, 384, 512 and 640.
+   *
+   * @return the number of samples written, at most nbins
+   */
+  size_t delta_decode_samples(const std::vector<char>& buffer,
+      unsigned start,
+      unsigned length,
+      int* waveform,
+      size_t nbins);
+
 
   struct delta
   {
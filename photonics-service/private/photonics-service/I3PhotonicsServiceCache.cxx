@@ -0,0 +1,322 @@
+#include <photonics-service/I3PhotonicsServiceCache.h>
+
+#include <cmath>
+
+I3PhotonicsServiceCache::I3PhotonicsServiceCache(
+    I3PhotonicsServicePtr service, size_t maxEntries)
+    : service_(service), maxEntries_(maxEntries),
+      useGeo_(false),
+      hasSource_(false), sourceSynced_(true),
+      hits_(0), misses_(0)
+{
+    if (!service_)
+        log_fatal("No I3PhotonicsService to cache");
+    xOM_ = yOM_ = zOM_ = NAN;
+}
+
+I3PhotonicsServiceCache::~I3PhotonicsServiceCache()
+{
+    const unsigned long lookups = hits_ + misses_;
+    if (lookups > 0)
+        log_info("%lu of %lu photonics lookups (%.1f%%) served from the cache",
+                 hits_, lookups, 100.*hits_/lookups);
+}
+
+void
+I3PhotonicsServiceCache::SelectModuleCoordinates(double xOM, double yOM, double zOM)
+{
+    I3PhotonicsService::SelectModuleCoordinates(xOM, yOM, zOM);
+    useGeo_ = false;
+    hasSource_ = false;
+}
+
+void
+I3PhotonicsServiceCache::SelectModule(const I3OMGeo &geo)
+{
+    I3PhotonicsService::SelectModuleCoordinates(
+        geo.position.GetX(), geo.position.GetY(), geo.position.GetZ());
+    geo_ = geo;
+    useGeo_ = true;
+    hasSource_ = false;
+}
+
+void
+I3PhotonicsServiceCache::SelectInnerModule()
+{
+    // The wrapped service may be shared with modules that select their
+    // own modules on it, so it is always told which module we are on
+    if (useGeo_)
+        service_->SelectModule(geo_);
+    else
+        service_->SelectModuleCoordinates(xOM_, yOM_, zOM_);
+}
+
+void
+I3PhotonicsServiceCache::Sync()
+{
+    if (hasSource_ && !sourceSynced_) {
+        // the last yield came from the cache, set up the tables for it
+        SelectInnerModule();
+        double meanPEs, emissionPointDistance, geoTime;
+        service_->SelectSource(meanPEs, emissionPointDistance, geoTime, source_);
+        sourceSynced_ = true;
+    }
+}
+
+bool
+I3PhotonicsServiceCache::MakeKey(Key &key, PhotonicsSource const &source, double delay) const
+{
+    if (useGeo_) {
+        const I3Direction dir = geo_.GetDirection();
+        key[0] = geo_.omtype;
+        key[4] = dir.GetX();
+        key[5] = dir.GetY();
+        key[6] = dir.GetZ();
+    } else {
+        key[0] = -1;
+        key[4] = key[5] = key[6] = 0.;
+    }
+    key[1] = xOM_;
+    key[2] = yOM_;
+    key[3] = zOM_;
+    key[7] = source.x;
+    key[8] = source.y;
+    key[9] = source.z;
+    key[10] = source.dirx;
+    key[11] = source.diry;
+    key[12] = source.dirz;
+    key[13] = source.E;
+    key[14] = source.length;
+    key[15] = source.speed;
+    key[16] = source.type;
+    key[17] = delay;
+
+    // NaNs would break the ordering of the map, such lookups are not cached
+    for (Key::const_iterator it = key.begin(); it != key.end(); ++it)
+        if (std::isnan(*it))
+            return false;
+    return true;
+}
+
+void
+I3PhotonicsServiceCache::Reserve()
+{
+    if (GetSize() >= maxEntries_) {
+        log_debug("Photonics cache reached %zu entries, clearing it", maxEntries_);
+        Clear();
+    }
+}
+
+void
+I3PhotonicsServiceCache::Clear()
+{
+    yields_.clear();
+    photorec_.clear();
+}
+
+void 
+I3PhotonicsServiceCache::SelectSource( double &meanPEs,
+                           double &emissionPointDistance,
+                           double &geoTime,
+                           PhotonicsSource const &source)
+{
+    Key key;
+    const bool cacheable = MakeKey(key, source, 0.);
+    source_ = source;
+    hasSource_ = true;
+
+    if (cacheable) {
+        std::map<Key, Yield>::const_iterator it = yields_.find(key);
+        if (it != yields_.end()) {
+            ++hits_;
+            meanPEs = it->second.meanPEs;
+            emissionPointDistance = it->second.emissionPointDistance;
+            geoTime = it->second.geoTime;
+            sourceSynced_ = false;
+            return;
+        }
+    }
+
+    ++misses_;
+    SelectInnerModule();
+    service_->SelectSource(meanPEs, emissionPointDistance, geoTime, source);
+    sourceSynced_ = true;
+
+    if (cacheable) {
+        Reserve();
+        const Yield yield = {meanPEs, emissionPointDistance, geoTime};
+        yields_[key] = yield;
+    }
+}
+
+void 
+I3PhotonicsServiceCache::SelectSource( double &meanPEs,
+                           double gradients[6],
+                           double &emissionPointDistance,
+                           double &geoTime,
+                           PhotonicsSource const &source,
+                           bool getAmp)
+{
+    // gradients are not cached
+    SelectInnerModule();
+    service_->SelectSource(meanPEs, gradients, emissionPointDistance, geoTime, source, getAmp);
+    source_ = source;
+    hasSource_ = true;
+    sourceSynced_ = true;
+}
+
+bool
+I3PhotonicsServiceCache::GetPhotorecInfo(double &yield, double &probDensity,
+                           double delay, PhotonicsSource const &source)
+{
+    Key key;
+    const bool cacheable = MakeKey(key, source, delay);
+    source_ = source;
+    hasSource_ = true;
+
+    if (cacheable) {
+        std::map<Key, Photorec>::const_iterator it = photorec_.find(key);
+        if (it != photorec_.end()) {
+            ++hits_;
+            yield = it->second.yield;
+            probDensity = it->second.probDensity;
+            sourceSynced_ = false;
+            return it->second.ok;
+        }
+    }
+
+    ++misses_;
+    SelectInnerModule();
+    const bool ok = service_->GetPhotorecInfo(yield, probDensity, delay, source);
+    sourceSynced_ = true;
+
+    if (cacheable) {
+        Reserve();
+        const Photorec photorec = {yield, probDensity, ok};
+        photorec_[key] = photorec;
+    }
+    return ok;
+}
+
+void 
+I3PhotonicsServiceCache::GetTimeDelay(double random, double &timeDelay)
+{
+    Sync();
+    service_->GetTimeDelay(random, timeDelay);
+}
+
+void 
+I3PhotonicsServiceCache::GetTimeDelays(I3RandomServicePtr random,
+                           double *timeDelays, int n)
+{
+    Sync();
+    service_->GetTimeDelays(random, timeDelays, n);
+}
+
+void 
+I3PhotonicsServiceCache::GetProbabilityDensity(double &density, double timeDelay)
+{
+    Sync();
+    service_->GetProbabilityDensity(density, timeDelay);
+}
+
+bool 
+I3PhotonicsServiceCache::GetProbabilityQuantiles(double *time_edges,
+                                     double t_0,
+                                     double *amplitudes,
+                                     size_t n_bins)
+{
+    Sync();
+    return service_->GetProbabilityQuantiles(time_edges, t_0, amplitudes, n_bins);
+}
+
+bool 
+I3PhotonicsServiceCache::GetProbabilityQuantiles(double *time_edges,
+                                     double t_0,
+                                     double *amplitudes,
+                                     double gradients[][6],
+                                     size_t n_bins)
+{
+    Sync();
+    return service_->GetProbabilityQuantiles(time_edges, t_0, amplitudes, gradients, n_bins);
+}
+
+bool 
+I3PhotonicsServiceCache::GetMeanAmplitudeGradient(double gradient[6])
+{
+    Sync();
+    return service_->GetMeanAmplitudeGradient(gradient);
+}
+
+bool 
+I3PhotonicsServiceCache::GetMeanAmplitudeHessian(double gradient[6], double hessian[6][6])
+{
+    Sync();
+    return service_->GetMeanAmplitudeHessian(gradient, hessian);
+}
+
+bool 
+I3PhotonicsServiceCache::GetProbabilityQuantileGradients(double *time_edges, double t_0,
+    double gradients[][6], size_t n_bins)
+{
+    Sync();
+    return service_->GetProbabilityQuantileGradients(time_edges, t_0, gradients, n_bins);
+}
+
+bool 
+I3PhotonicsServiceCache::GetProbabilityQuantileHessians(double *time_edges,
+    double t_0, double values[], double gradients[][6], double hessians[][6][6], size_t n_bins)
+{
+    Sync();
+    return service_->GetProbabilityQuantileHessians(time_edges, t_0, values, gradients, hessians, n_bins);
+}
+
+bool
+I3PhotonicsServiceCache::SetAngularSelection(int level, float low, float high)
+{
+    Clear();
+    return service_->SetAngularSelection(level, low, high);
+}
+
+double
+I3PhotonicsServiceCache::GetAngularSelectionLow()
+{
+    return service_->GetAngularSelectionLow();
+}
+
+double
+I3PhotonicsServiceCache::GetAngularSelectionHigh()
+{
+    return service_->GetAngularSelectionHigh();
+}
+
+bool
+I3PhotonicsServiceCache::SetDepthSelection(int level, float low, float high)
+{
+    Clear();
+    return service_->SetDepthSelection(level, low, high);
+}
+
+double
+I3PhotonicsServiceCache::GetDepthSelectionLow()
+{
+    return service_->GetDepthSelectionLow();
+}
+
+double
+I3PhotonicsServiceCache::GetDepthSelectionHigh()
+{
+    return service_->GetDepthSelectionHigh();
+}
+
+double
+I3PhotonicsServiceCache::GetLmaxLevel1()
+{
+    return service_->GetLmaxLevel1();
+}
+
+double
+I3PhotonicsServiceCache::GetLmaxLevel2()
+{
+    return service_->GetLmaxLevel2();
+}
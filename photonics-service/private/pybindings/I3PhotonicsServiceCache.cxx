@@ -0,0 +1,22 @@
+#include <photonics-service/I3PhotonicsServiceCache.h>
+
+#include "wrappers.h"
+
+using namespace boost::python;
+
+void register_I3PhotonicsServiceCache() {
+
+	class_<I3PhotonicsServiceCache,
+	    boost::shared_ptr<I3PhotonicsServiceCache > ,
+	    bases<I3PhotonicsService >, boost::noncopyable>("I3PhotonicsServiceCache", no_init)
+	    .def(init<I3PhotonicsServicePtr, size_t>(
+	        (arg("service"), arg("maxEntries")=1000000),
+	        "Memoize the photon yields and photorec lookups of another photonics service. "
+	        "Entries are kept across frames until Clear() is called or maxEntries is reached."))
+	    .def("Clear", &I3PhotonicsServiceCache::Clear,
+	        "Drop all cached entries, e.g. at the start of every frame.")
+	    .add_property("hits", &I3PhotonicsServiceCache::GetHits)
+	    .add_property("misses", &I3PhotonicsServiceCache::GetMisses)
+	    .add_property("size", &I3PhotonicsServiceCache::GetSize)
+	    ;
+}
@@ -0,0 +1,147 @@
+/**
+ * Tests for I3PhotonicsServiceCache, using I3DummyPhotonicsService as the
+ * service that is cached.
+ *
+ * copyright  (C) 2020
+ * The Icecube Collaboration
+ *
+ * $Id$
+ */
+
+#include <I3Test.h>
+
+#include "photonics-service/I3PhotonicsServiceCache.h"
+#include "photonics-service/I3DummyPhotonicsService.h"
+#include "dataclasses/geometry/I3OMGeo.h"
+
+TEST_GROUP(I3PhotonicsServiceCache);
+
+namespace {
+
+PhotonicsSource MakeSource(int i)
+{
+	return PhotonicsSource(10.*i, -5., 20. - 3.*i, 40. + i, 120., 1.,
+	    -1., 1., 0);
+}
+
+I3OMGeo MakeModule(int i)
+{
+	I3OMGeo geo;
+	geo.omtype = I3OMGeo::IceCube;
+	geo.position = I3Position(30., 40. + 17.*i, -100. + 17.*i);
+	return geo;
+}
+
+}
+
+TEST(SameYields)
+{
+	I3PhotonicsServicePtr dummy(new I3DummyPhotonicsService);
+	I3PhotonicsServiceCache cache(I3PhotonicsServicePtr(new I3DummyPhotonicsService));
+
+	for (int pass = 0; pass < 3; ++pass) {
+		for (int m = 0; m < 5; ++m) {
+			dummy->SelectModule(MakeModule(m));
+			cache.SelectModule(MakeModule(m));
+			for (int s = 0; s < 4; ++s) {
+				double pe1, dist1, time1, pe2, dist2, time2;
+				dummy->SelectSource(pe1, dist1, time1, MakeSource(s));
+				cache.SelectSource(pe2, dist2, time2, MakeSource(s));
+				ENSURE_EQUAL(pe1, pe2);
+				ENSURE_EQUAL(dist1, dist2);
+				ENSURE_EQUAL(time1, time2);
+
+				// timing needs the tables of this source, also
+				// after a cached yield
+				double density1, density2;
+				dummy->GetProbabilityDensity(density1, 50.);
+				cache.GetProbabilityDensity(density2, 50.);
+				ENSURE_EQUAL(density1, density2);
+			}
+		}
+	}
+
+	ENSURE_EQUAL(cache.GetMisses(), 20ul);
+	ENSURE_EQUAL(cache.GetHits(), 40ul);
+	ENSURE_EQUAL(cache.GetSize(), 20ul);
+}
+
+TEST(Photorec)
+{
+	I3PhotonicsServicePtr dummy(new I3DummyPhotonicsService);
+	I3PhotonicsServiceCache cache(I3PhotonicsServicePtr(new I3DummyPhotonicsService));
+
+	for (int pass = 0; pass < 2; ++pass) {
+		for (int m = 0; m < 3; ++m) {
+			const I3OMGeo geo = MakeModule(m);
+			dummy->SelectModuleCoordinates(geo.position.GetX(),
+			    geo.position.GetY(), geo.position.GetZ());
+			cache.SelectModuleCoordinates(geo.position.GetX(),
+			    geo.position.GetY(), geo.position.GetZ());
+
+			double yield1, density1, yield2, density2;
+			ENSURE_EQUAL(dummy->GetPhotorecInfo(yield1, density1, 20., MakeSource(m)),
+			    cache.GetPhotorecInfo(yield2, density2, 20., MakeSource(m)));
+			ENSURE_EQUAL(yield1, yield2);
+			ENSURE_EQUAL(density1, density2);
+
+			// a different delay is a different lookup
+			dummy->GetPhotorecInfo(yield1, density1, 100., MakeSource(m));
+			cache.GetPhotorecInfo(yield2, density2, 100., MakeSource(m));
+			ENSURE_EQUAL(density1, density2);
+		}
+	}
+
+	ENSURE_EQUAL(cache.GetMisses(), 6ul);
+	ENSURE_EQUAL(cache.GetHits(), 6ul);
+}
+
+TEST(Clear)
+{
+	I3PhotonicsServiceCache cache(I3PhotonicsServicePtr(new I3DummyPhotonicsService), 3);
+	double pe, dist, time;
+
+	cache.SelectModule(MakeModule(0));
+	for (int s = 0; s < 3; ++s)
+		cache.SelectSource(pe, dist, time, MakeSource(s));
+	ENSURE_EQUAL(cache.GetSize(), 3ul);
+
+	// full: cleared before the next value is stored
+	cache.SelectSource(pe, dist, time, MakeSource(3));
+	ENSURE_EQUAL(cache.GetSize(), 1ul);
+
+	cache.Clear();
+	ENSURE_EQUAL(cache.GetSize(), 0ul);
+	cache.SelectSource(pe, dist, time, MakeSource(3));
+	ENSURE_EQUAL(cache.GetHits(), 0ul);
+	ENSURE_EQUAL(cache.GetMisses(), 5ul);
+
+	// NaN sources are passed on but not cached
+	PhotonicsSource source = MakeSource(0);
+	source.E = NAN;
+	cache.SelectSource(pe, dist, time, source);
+	ENSURE_EQUAL(cache.GetSize(), 1ul);
+}
+
+TEST(SharedService)
+{
+	// the wrapped service is also used directly, e.g. by another module
+	I3PhotonicsServicePtr dummy(new I3DummyPhotonicsService);
+	I3PhotonicsServicePtr shared(new I3DummyPhotonicsService);
+	I3PhotonicsServiceCache cache(shared);
+	double pe1, dist1, time1, pe2, dist2, time2;
+
+	cache.SelectModule(MakeModule(0));
+	cache.SelectSource(pe2, dist2, time2, MakeSource(0));
+	shared->SelectModule(MakeModule(3));
+	shared->SelectSource(pe2, dist2, time2, MakeSource(3));
+
+	// a miss has to go to the module selected on the cache
+	dummy->SelectModule(MakeModule(0));
+	dummy->SelectSource(pe1, dist1, time1, MakeSource(1));
+	cache.SelectSource(pe2, dist2, time2, MakeSource(1));
+	ENSURE_EQUAL(pe1, pe2);
+	ENSURE_EQUAL(dist1, dist2);
+	ENSURE_EQUAL(time1, time2);
+	ENSURE_EQUAL(cache.GetMisses(), 2ul);
+}
@@ -0,0 +1,154 @@
+#ifndef I3PHOTONICSSERVICE_CACHE_H
+#define I3PHOTONICSSERVICE_CACHE_H
+/**
+ *@file
+ *@brief I3PhotonicsServiceCache
+ *       An I3PhotonicsService that memoizes the expectations of another one
+ *
+ *(c) the IceCube Collaboration
+ */
+
+
+#include "photonics-service/I3PhotonicsService.h"
+#include "dataclasses/geometry/I3OMGeo.h"
+
+#include <array>
+#include <map>
+
+/**
+ *@brief Memoize the light yields of an I3PhotonicsService
+ *
+ * Several modules which look at the same fit (e.g. finiteReco's
+ * PhPnhPhotorec and I3TruncatedEnergy) ask the tables for the same
+ * source/module pairs. Installing one cache in the context and giving its
+ * name to all of them serves repeated lookups from memory.
+ *
+ * The mean amplitude of SelectSource() and the result of GetPhotorecInfo()
+ * are cached, keyed on the selected module (position, type and orientation)
+ * and all parameters of the PhotonicsSource. On a miss the current module
+ * is selected on the wrapped service again, as others may have used it in
+ * the meantime. Timing and gradient calls are passed on to the wrapped
+ * service, which is brought up to date with the current module and source
+ * first if the last yield came from the cache.
+ *
+ * The keys are exact, so cached values stay valid from one frame to the
+ * next and are kept until the cache reaches maxEntries, when it is
+ * cleared. Changing the table selection through the cache clears it too;
+ * changing it on the wrapped service directly requires a call to Clear().
+ * To keep the cache frame-scoped instead, call Clear() at the start of
+ * each frame, e.g. from a function in the tray.
+ */
+class I3PhotonicsServiceCache : public I3PhotonicsService {
+    public:
+        I3PhotonicsServiceCache(I3PhotonicsServicePtr service, size_t maxEntries = 1000000);
+        virtual ~I3PhotonicsServiceCache();
+
+        virtual void SelectModuleCoordinates(double xOM, double yOM, double zOM);
+
+        virtual void SelectModule(const I3OMGeo &);
+
+        virtual void SelectSource( double &meanPEs,
+                                   double &emissionPointDistance,
+                                   double &geoTime,
+                                   PhotonicsSource const &source);
+
+        virtual void SelectSource( double &meanPEs,
+                                   double gradients[6],
+                                   double &emissionPointDistance,
+                                   double &geoTime,
+                                   PhotonicsSource const &source,
+                                   bool getAmp=true);
+
+        virtual bool GetPhotorecInfo(double &yield, double &probDensity,
+                                     double delay, PhotonicsSource const &source);
+
+        virtual void GetTimeDelay(double random, double &timeDelay);
+
+        virtual void GetTimeDelays(I3RandomServicePtr random,
+                                   double *timeDelays, int n);
+        
+        virtual void GetProbabilityDensity(double &density, double timeDelay);
+
+        virtual bool GetProbabilityQuantiles(double *time_edges,
+                                             double t_0,
+                                             double *amplitudes,
+                                             size_t n_bins);
+
+        virtual bool GetProbabilityQuantiles(double *time_edges,
+                                             double t_0,
+                                             double *amplitudes,
+                                             double gradients[][6],
+                                             size_t n_bins);
+
+        virtual bool GetMeanAmplitudeGradient(double gradient[6]);
+        
+        virtual bool GetMeanAmplitudeHessian(double gradient[6], double hessian[6][6]);
+
+        virtual bool GetProbabilityQuantileGradients(double *time_edges, double t_0,
+            double gradients[][6], size_t n_bins);
+
+        virtual bool GetProbabilityQuantileHessians(double *time_edges,
+            double t_0, double values[], double gradients[][6], double hessians[][6][6], size_t n_bins);
+
+        virtual bool SetAngularSelection(int level, float low, float high);
+        virtual double GetAngularSelectionLow();
+        virtual double GetAngularSelectionHigh();
+        virtual bool SetDepthSelection(int level, float low, float high);
+        virtual double GetDepthSelectionLow();
+        virtual double GetDepthSelectionHigh();
+        virtual double GetLmaxLevel1();
+        virtual double GetLmaxLevel2();
+
+        /// Forget all cached values, e.g. at the start of a frame
+        void Clear();
+
+        /// Number of lookups served from the cache
+        unsigned long GetHits() const { return hits_; }
+        /// Number of lookups passed on to the wrapped service
+        unsigned long GetMisses() const { return misses_; }
+        /// Number of cached values
+        size_t GetSize() const { return yields_.size() + photorec_.size(); }
+
+    private:
+        /// module (type, position, orientation), source, photorec delay
+        typedef std::array<double, 18> Key;
+
+        struct Yield {
+            double meanPEs;
+            double emissionPointDistance;
+            double geoTime;
+        };
+
+        struct Photorec {
+            double yield;
+            double probDensity;
+            bool ok;
+        };
+
+        bool MakeKey(Key &key, PhotonicsSource const &source, double delay) const;
+        void Sync();
+        void SelectInnerModule();
+        void Reserve();
+
+        I3PhotonicsServicePtr service_;
+        size_t maxEntries_;
+
+        // currently selected module, passed on to service_ only when needed
+        bool useGeo_;
+        I3OMGeo geo_;
+
+        // source of the last yield, and whether service_ has seen it
+        PhotonicsSource source_;
+        bool hasSource_;
+        bool sourceSynced_;
+
+        std::map<Key, Yield> yields_;
+        std::map<Key, Photorec> photorec_;
+        unsigned long hits_;
+        unsigned long misses_;
+};
+
+I3_POINTER_TYPEDEFS(I3PhotonicsServiceCache);
+
+
+#endif // #ifdef I3PHOTONICSSERVICE_CACHE_H
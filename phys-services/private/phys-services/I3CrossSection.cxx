@@ -1,6 +1,9 @@
 #include <phys-services/I3CrossSection.h>
+#include <algorithm>
 #include <array>
 #include <fstream>
+#include <utility>
+#include <vector>
 
 namespace{
 	double particleMass(I3Particle::ParticleType type){
@@ -37,6 +40,125 @@ namespace{
 		double bd=sqrt(term*term-((m*m)/(E*E)));
 		return((ad-bd)<=d*y && d*y<=(ad+bd)); //Eq. 7
 	}
+	
+	///The same search as tablesearchcenters(), for a single dimension
+	///\return false if x is outside the table
+	bool searchCenter(const splinetable& table, int dim, double x, int& center){
+		const double* knots=table.knots[dim];
+		const int order=table.order[dim];
+		
+		if(x<=knots[0] || x>knots[table.nknots[dim]-1])
+			return(false);
+		
+		if(x<knots[order]){
+			center=order;
+			return(true);
+		}else if(x>=knots[table.naxes[dim]]){
+			center=int(table.naxes[dim])-1;
+			return(true);
+		}
+		
+		int min=order, max=int(table.nknots[dim])-2;
+		do{
+			center=(max+min)/2;
+			if(x<knots[center])
+				max=center-1;
+			else
+				min=center+1;
+		}while(x<knots[center] || x>=knots[center+1]);
+		
+		if(center==table.naxes[dim])
+			center--;
+		return(true);
+	}
+	
+	///The cross section spline at one fixed energy.
+	///The energy dimension is searched and its basis evaluated once, and the
+	///coefficients summed over it are cached for each coefficient of the
+	///remaining dimensions as they are visited. Evaluating many points at the
+	///same energy then costs about as much as a spline with one dimension less.
+	class EnergySlice{
+	public:
+		EnergySlice(const splinetable& table, double logEnergy):
+		table(table),maxDegree(0),inside(false),centers(table.ndim),k(table.ndim-1),
+		cellStride(table.ndim,1){
+			for(int d=0; d<table.ndim; d++)
+				maxDegree=std::max(maxDegree,table.order[d]+1);
+			basis.resize(table.ndim*maxDegree);
+			if(!searchCenter(table,0,logEnergy,centers[0]))
+				return;
+			inside=true;
+			bsplvb_simple(table.knots[0],table.nknots[0],logEnergy,
+			              centers[0],table.order[0]+1,&basis[0]);
+			for(int j=0; j<=table.order[0]; j++)
+				terms.push_back(std::make_pair(double(basis[j]),
+				  (centers[0]-table.order[0]+j)*table.strides[0]));
+			for(int d=table.ndim-2; d>0; d--)
+				cellStride[d]=cellStride[d+1]*table.naxes[d+1];
+			reduced.resize(cellStride[1]*table.naxes[1]);
+			known.resize(reduced.size(),0);
+		}
+		
+		///\return whether the energy lies within the spline
+		bool energyInside() const{ return(inside); }
+		
+		///Evaluate the spline
+		///\param coordinates the ndim-1 coordinates following the energy
+		///\param result set to the value of the spline
+		///\return false if the point is outside the spline
+		bool evaluate(const double* coordinates, double& result){
+			const int ndim=table.ndim;
+			if(!inside)
+				return(false);
+			for(int d=1; d<ndim; d++){
+				if(!searchCenter(table,d,coordinates[d-1],centers[d]))
+					return(false);
+				bsplvb_simple(table.knots[d],table.nknots[d],coordinates[d-1],
+				              centers[d],table.order[d]+1,&basis[d*maxDegree]);
+			}
+			
+			result=0;
+			std::fill(k.begin(),k.end(),0);
+			while(true){
+				size_t cell=0, offset=0;
+				double weight=1;
+				for(int d=1; d<ndim; d++){
+					const size_t pos=centers[d]-table.order[d]+k[d-1];
+					cell+=pos*cellStride[d];
+					offset+=pos*table.strides[d];
+					weight*=basis[d*maxDegree+k[d-1]];
+				}
+				if(!known[cell]){
+					double coefficient=0;
+					for(const auto& term : terms)
+						coefficient+=term.first*table.coefficients[term.second+offset];
+					reduced[cell]=coefficient;
+					known[cell]=1;
+				}
+				result+=weight*reduced[cell];
+				
+				//advance to the next basis function of the remaining dimensions
+				int d=ndim-2;
+				while(d>=0 && ++k[d]>table.order[d+1])
+					k[d--]=0;
+				if(d<0)
+					break;
+			}
+			return(true);
+		}
+		
+	private:
+		const splinetable& table;
+		int maxDegree;
+		bool inside;
+		std::vector<int> centers, k;
+		std::vector<float> basis;
+		///energy basis weight and coefficient offset of each energy term
+		std::vector<std::pair<double,size_t> > terms;
+		std::vector<size_t> cellStride;
+		std::vector<double> reduced;
+		std::vector<char> known;
+	};
 }
 
 I3CrossSection::finalStateRecord 
@@ -73,9 +195,6 @@ I3CrossSection::sampleFinalState_DIS(double energy,
     // kin_vars and its twin are 3-vectors containing [nu-energy, Bjorken X, Bjorken Y]
     std::array<double,3> kin_vars, test_kin_vars;
 
-	// centers of the cross section spline tales. 
-    std::array<int,3> spline_table_center, test_spline_table_center;
-
 	// values of cross_section from the splines.  By * Bx * Spline(E,x,y)
     double cross_section, test_cross_section;
     
@@ -89,6 +208,12 @@ I3CrossSection::sampleFinalState_DIS(double energy,
 	                 << pow(10.,crossSection.extents[0][0]) << " GeV,"
 	                 << pow(10.,crossSection.extents[0][1]) << " GeV]");
 	
+	//every point of the chain is at this energy, so reduce the spline once
+	EnergySlice slice(crossSection,kin_vars[0]);
+	if(!slice.energyInside())
+		log_fatal_stream("Interaction energy (" << energy << ") outside of the cross section spline");
+	double eval;
+	
 	//sample an intial point
 	do{
 		//rejection sample a point which is kinematically allowed by calculation limits
@@ -110,17 +235,15 @@ I3CrossSection::sampleFinalState_DIS(double energy,
         
 
 		if(accept)
-            // finds the centers in the cross section spline table, returns true if it's successful
-            //      also sets the centers
-			accept=!tablesearchcenters(&crossSection,kin_vars.data(),spline_table_center.data());
+            // evaluates the spline at that point, returns false if the point is outside of it
+			accept=slice.evaluate(&kin_vars[1],eval);
 	} while(!accept);
 
 	//TODO: better proposal distribution?
 	double measure=pow(10.,kin_vars[1]+kin_vars[2]); // Bx * By
 
     // Bx * By * xs(E, x, y)
-    // evalutates the differential spline at that point? 
-	cross_section=measure*pow(10.,ndsplineeval(&crossSection,kin_vars.data(),spline_table_center.data(),0)); 
+	cross_section=measure*pow(10.,eval); 
     
     // this is the magic part. Metropolis Hastings Algorithm.
     // MCMC method! 
@@ -145,12 +268,11 @@ I3CrossSection::sampleFinalState_DIS(double energy,
 		if(!accept)
 			continue;
 
-		accept=!tablesearchcenters(&crossSection,test_kin_vars.data(),test_spline_table_center.data());
+		accept=slice.evaluate(&test_kin_vars[1],eval);
 		if(!accept)
 			continue;
 		
 		double measure=pow(10.,test_kin_vars[1]+test_kin_vars[2]);
-		double eval=ndsplineeval(&crossSection,test_kin_vars.data(),test_spline_table_center.data(),0);
 		if(std::isnan(eval))
 			continue;
 		test_cross_section=measure*pow(10.,eval);
@@ -197,9 +319,6 @@ I3CrossSection::sampleFinalState_GR(double energy,
     // kin_vars and its twin are now  ***2-vectors*** containing [nu-energy, Bjorkfen Y]
     std::array<double,2> kin_vars, test_kin_vars;
 
-	// centers of the cross section spline tales. 
-    std::array<int,2> spline_table_center, test_spline_table_center;
-
 	// values of cross_section from the splines.  By * Spline(E,y)
     double cross_section, test_cross_section;
     
@@ -213,6 +332,11 @@ I3CrossSection::sampleFinalState_GR(double energy,
 	                 << pow(10.,crossSection.extents[0][0]) << " GeV,"
 	                 << pow(10.,crossSection.extents[0][1]) << " GeV]");
 	
+	EnergySlice slice(crossSection,kin_vars[0]);
+	if(!slice.energyInside())
+		log_fatal_stream("Interaction energy (" << energy << ") outside of the cross section spline");
+	double eval;
+	
 	//sample an intial point
 	do{
 		//rejection sample a point which is kinematically allowed by calculation limits
@@ -229,14 +353,14 @@ I3CrossSection::sampleFinalState_GR(double energy,
 			accept=false;	
 
 		if(accept)
-			accept=!tablesearchcenters(&crossSection,kin_vars.data(),spline_table_center.data());
+			accept=slice.evaluate(&kin_vars[1],eval);
 	} while(!accept);
 
 	//TODO: better proposal distribution?
     // dropped the extra term
 	double measure=pow(10.,kin_vars[1]); // By
 
-	cross_section=measure*pow(10.,ndsplineeval(&crossSection,kin_vars.data(),spline_table_center.data(),0)); 
+	cross_section=measure*pow(10.,eval); 
     
 	const size_t burnin=40; // converges to the correct distribution over multiple samplings. 
 	for(size_t j=0; j<=burnin; j++){
@@ -250,12 +374,11 @@ I3CrossSection::sampleFinalState_GR(double energy,
 		if(!accept)
 			continue;
 
-		accept=!tablesearchcenters(&crossSection,test_kin_vars.data(),test_spline_table_center.data());
+		accept=slice.evaluate(&test_kin_vars[1],eval);
 		if(!accept)
 			continue;
 		
 		double measure=pow(10.,test_kin_vars[1]);
-		double eval=ndsplineeval(&crossSection,test_kin_vars.data(),test_spline_table_center.data(),0);
 		if(std::isnan(eval))
 			continue;
 		test_cross_section=measure*pow(10.,eval);
@@ -331,6 +454,46 @@ double I3CrossSection::evaluateCrossSection(double energy, double x, double y,
 	return(result);
 }
 
+std::vector<double> I3CrossSection::evaluateCrossSections(double energy,
+                                                         const std::vector<double>& x,
+                                                         const std::vector<double>& y,
+                                                         I3Particle::ParticleType scatteredType) const{
+	if(x.size()!=y.size())
+		log_fatal_stream("Got " << x.size() << " x values, but " << y.size() << " y values");
+	if(crossSection.ndim!=3)
+		log_fatal_stream("I expected 3 dimensions in the cross section spline, but got "<< crossSection.ndim);
+	double log_energy=log10(energy);
+	//check preconditions
+	if(log_energy<totalCrossSection.extents[0][0]
+	   || log_energy>totalCrossSection.extents[0][1])
+		log_fatal_stream("Interaction energy (" << energy << 
+						 ") out of cross section table range: ["
+						 << pow(10.,totalCrossSection.extents[0][0]) << " GeV,"
+						 << pow(10.,totalCrossSection.extents[0][1]) << " GeV]");
+	
+	const double m=particleMass(scatteredType);
+	const double s=targetMass*targetMass+2*targetMass*energy;
+	EnergySlice slice(crossSection,log_energy);
+	std::vector<double> result(x.size(),0.);
+	for(size_t i=0; i<x.size(); i++){
+		if(x[i]<=0 || x[i]>=1)
+			log_fatal_stream("Interaction x out of range: " << x[i]);
+		if(y[i]<=0 || y[i]>=1)
+			log_fatal_stream("Interaction y out of range: " << y[i]);
+		
+		//the same cuts as in evaluateCrossSection
+		double Q2=(s-targetMass*targetMass)*x[i]*y[i];
+		if(Q2<Q2Min || !kinematicallyAllowed(x[i], y[i], energy, targetMass, m))
+			continue;
+		
+		std::array<double,2> coordinates{{log10(x[i]),log10(y[i])}};
+		double log_xs;
+		if(slice.evaluate(coordinates.data(),log_xs))
+			result[i]=pow(10.,log_xs);
+	}
+	return(result);
+}
+
 double I3CrossSection::evaluateTotalCrossSection(double energy) const{
 	double log_energy=log10(energy);
 	//check preconditions
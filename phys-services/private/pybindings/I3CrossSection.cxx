@@ -18,6 +18,9 @@ void register_I3CrossSection()
     .def("evaluate_cross_section",
          &I3CrossSection::evaluateCrossSection,
          args("energy", "x", "y", "scatteredType"))
+    .def("evaluate_cross_sections",
+         &I3CrossSection::evaluateCrossSections,
+         args("energy", "x", "y", "scatteredType"))
     .def("evaluate_total_cross_section",
          &I3CrossSection::evaluateTotalCrossSection,
          args("energy"))
@@ -1,6 +1,8 @@
 #ifndef I3CROSSSECTION_H
 #define I3CROSSSECTION_H
 
+#include <vector>
+
 #include <photospline/bspline.h>
 #include <phys-services/I3RandomService.h>
 #include <dataclasses/physics/I3Particle.h>
@@ -83,6 +85,21 @@ public:
 	///\param energy the neutrino energy in GeV
 	///\return the cross section in in square meters
 	double evaluateTotalCrossSection(double energy) const;
+	
+	///Get the value of the doubly-differential cross section at many points
+	///for one neutrino energy, e.g. to tabulate or integrate the final state
+	///distribution. The spline is reduced over the energy dimension once, so
+	///this is considerably cheaper than calling evaluateCrossSection for each
+	///point. The results are the same up to floating point rounding.
+	///\param energy the neutrino energy in GeV
+	///\param x Bjorken x of each point
+	///\param y Bjorken y of each point
+	///\param scatteredType the type of the outgoing lepton
+	///\return the doubly-differential cross section in square meters at each point
+	std::vector<double> evaluateCrossSections(double energy,
+	                                          const std::vector<double>& x,
+	                                          const std::vector<double>& y,
+	                                          I3Particle::ParticleType scatteredType) const;
 
 	const splinetable& getCrossSection() const{ return(crossSection); }
 	const splinetable& getTotalCrossSection() const{ return(totalCrossSection); }
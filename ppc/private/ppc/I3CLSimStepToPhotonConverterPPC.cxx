@@ -2,40 +2,123 @@
 #include "ppc/I3CLSimStepToPhotonConverterPPC.h"
 #include "ppc.h"
 
+#include <limits>
+
 boost::weak_ptr<I3CLSimStepToPhotonConverterPPC> I3CLSimStepToPhotonConverterPPC::instance_;
 
 boost::shared_ptr<I3CLSimStepToPhotonConverterPPC> I3CLSimStepToPhotonConverterPPC::GetInstance()
 {
     auto shared = instance_.lock();
     if (!shared) {
-        shared = boost::shared_ptr<I3CLSimStepToPhotonConverterPPC>(new I3CLSimStepToPhotonConverterPPC);
+        shared = boost::make_shared<I3CLSimStepToPhotonConverterPPC>();
         instance_ = shared;
     }
-    
+
     return shared;
 }
 
-I3CLSimStepToPhotonConverterPPC::I3CLSimStepToPhotonConverterPPC() :
-    isInitialized_(false), workgroupSize_(0), maxBunchSize_(0), inbox_(1)
+I3CLSimStepToPhotonConverterPPC::I3CLSimStepToPhotonConverterPPC(uint32_t seed, bool useCPUs, bool useGPUs) :
+    isInitialized_(false), seed_(seed), useCPUs_(useCPUs), useGPUs_(useGPUs),
+    workgroupSize_(0), maxBunchSize_(0), ppcStarted_(false),
+    inbox_(1), outbox_(1)
 {
-    xppc::start();
-    xppc::set_res(0.1f);  // 0.1 ns default resolution for hit binning
+    SetDeviceTypes(useCPUs, useGPUs);
+}
+
+I3CLSimStepToPhotonConverterPPC::I3CLSimStepToPhotonConverterPPC(I3RandomServicePtr rng, bool useCPUs, bool useGPUs) :
+    I3CLSimStepToPhotonConverterPPC(0, useCPUs, useGPUs)
+{
+    if (!rng)
+        log_fatal("No random service given");
+    // 0 would fall back to seeding from the clock
+    seed_ = 1 + rng->Integer(std::numeric_limits<uint32_t>::max());
+}
+
+void I3CLSimStepToPhotonConverterPPC::SetTablesDirectory(const std::string &dir)
+{
+    if (isInitialized_)
+        log_fatal("Already initialized!");
+    tablesDir_ = dir;
+}
+
+void I3CLSimStepToPhotonConverterPPC::SetDeviceTypes(bool useCPUs, bool useGPUs)
+{
+    if (isInitialized_)
+        log_fatal("Already initialized!");
+    if (!useCPUs && !useGPUs)
+        log_fatal("Need to use at least one device type");
+    useCPUs_ = useCPUs;
+    useGPUs_ = useGPUs;
 }
 
 I3CLSimStepToPhotonConverterPPC::~I3CLSimStepToPhotonConverterPPC()
 {
-    xppc::stop();
+    if (ppcThreadObj_)
+    {
+        if (ppcThreadObj_->joinable())
+        {
+            log_debug("Stopping the ppc worker thread..");
+
+            ppcThreadObj_->interrupt();
+
+            ppcThreadObj_->join(); // wait for it indefinitely
+
+            log_debug("ppc worker thread stopped.");
+        }
+
+        ppcThreadObj_.reset();
+    }
 }
 
 void I3CLSimStepToPhotonConverterPPC::Initialize()
 {
+    if (isInitialized_)
+        log_fatal("Already initialized!");
     if (!geometry_)
         log_fatal("Geometry has not yet been configured");
     if (!wavelenthBias_)
         log_fatal("Wavelength bias has not yet been configured!");
-    
+
+    log_debug("Starting the ppc worker thread..");
+    ppcStarted_=false;
+
+    ppcThreadObj_ = boost::shared_ptr<boost::thread>(new boost::thread(boost::bind(&I3CLSimStepToPhotonConverterPPC::PPCThread, this)));
+
+    // wait for startup
+    {
+        boost::unique_lock<boost::mutex> guard(ppcStarted_mutex_);
+        for (;;)
+        {
+            if (ppcStarted_) break;
+            ppcStarted_cond_.wait(guard);
+        }
+    }
+
+    if (!ppcStartError_.empty()) {
+        ppcThreadObj_->join();
+        ppcThreadObj_.reset();
+        log_fatal_stream("ppc setup failed: " << ppcStartError_);
+    }
+
+    log_debug("ppc worker thread started.");
+
+    isInitialized_ = true;
+}
+
+void I3CLSimStepToPhotonConverterPPC::SetupPPC()
+{
+    // all xppc state touched below is local to the calling thread
+    xppc::start();
+    xppc::set_res(0.1f);  // 0.1 ns default resolution for hit binning
+    if (seed_ != 0)
+        xppc::set_seed(seed_);
+    if (!tablesDir_.empty())
+        xppc::set_tables_dir(tablesDir_);
+    // both device types selected means all devices
+    xppc::use_devices(useCPUs_ && !useGPUs_, useGPUs_ && !useCPUs_);
+
     if (!xppc::i3oms.empty())
-        log_fatal("There can be only one ppc");
+        log_fatal("ppc state was already initialized on this thread");
     for (size_t i=0; i < geometry_->size(); i++) {
         xppc::OM om;
         om.str=geometry_->GetStringID(i);
@@ -44,7 +127,7 @@ void I3CLSimStepToPhotonConverterPPC::Initialize()
         om.r[1]=geometry_->GetPosY(i)/I3Units::m;
         om.r[2]=geometry_->GetPosZ(i)/I3Units::m;
         xppc::i3oms.push_back(om);
-        
+
         // Setting PMT high voltage > 0, RDE to 1.0, and om type to 1, and
         // as.dat to 1\n1, prevents xppc::print() from down-sampling photons
         // to account for wavelength and angular efficiency.
@@ -54,30 +137,98 @@ void I3CLSimStepToPhotonConverterPPC::Initialize()
 
     int gpu(-1);
     xppc::initialize(1.);
-    
+
     xppc::choose(gpu);
     xppc::ini();
 
     // Harmonize bunch sizes
     maxBunchSize_ = xppc::getMaxBunchSize();
     workgroupSize_ = xppc::getWorkgroupSize();
+}
 
-    isInitialized_ = true;
+void I3CLSimStepToPhotonConverterPPC::PPCThread()
+{
+    // do not interrupt this thread by default
+    boost::this_thread::disable_interruption di;
+
+    try {
+        SetupPPC();
+    } catch (const std::exception &e) {
+        ppcStartError_ = e.what();
+    } catch (...) {
+        ppcStartError_ = "unknown error";
+    }
+
+    {
+        boost::unique_lock<boost::mutex> guard(ppcStarted_mutex_);
+        ppcStarted_=true;
+    }
+    ppcStarted_cond_.notify_all();
+
+    if (!ppcStartError_.empty())
+        return;
+
+    try {
+        boost::this_thread::restore_interruption ri(di);
+        PPCThread_impl();
+    } catch (const boost::thread_interrupted &) {
+        log_debug("ppc worker thread was interrupted. closing.");
+    }
+
+    xppc::fin();
+    xppc::stop();
+}
+
+void I3CLSimStepToPhotonConverterPPC::PPCThread_impl()
+{
+    for (;;) {
+        I3CLSimStepSeriesConstPtr steps;
+        uint32_t identifier;
+        std::tie(steps, identifier) = inbox_.Get();
+
+        // errors (e.g. from log_fatal) must not escape the worker thread,
+        // hand them to the caller of GetConversionResult() instead
+        ConversionResult_t result;
+        std::exception_ptr error;
+        try {
+            result = Convert(*steps, identifier);
+        } catch (const boost::thread_interrupted &) {
+            throw;
+        } catch (...) {
+            error = std::current_exception();
+            // drop whatever is left of the failed bunch
+            xppc::efin();
+        }
+
+        outbox_.Put(std::make_pair(result, error));
+    }
 }
 
 void I3CLSimStepToPhotonConverterPPC::EnqueueSteps(I3CLSimStepSeriesConstPtr steps, uint32_t identifier)
 {
+    if (!isInitialized_)
+        log_fatal("Not initialized!");
+
     inbox_.Put(std::make_pair(steps, identifier));
 }
 
 I3CLSimStepToPhotonConverterPPC::ConversionResult_t I3CLSimStepToPhotonConverterPPC::GetConversionResult()
 {
-    I3CLSimStepSeriesConstPtr steps;
-    uint32_t identifier;
-    std::tie(steps, identifier) = inbox_.Get();
-    
+    if (!isInitialized_)
+        log_fatal("Not initialized!");
+
+    auto result = outbox_.Get();
+    if (result.second)
+        std::rethrow_exception(result.second);
+
+    return result.first;
+}
+
+I3CLSimStepToPhotonConverterPPC::ConversionResult_t
+I3CLSimStepToPhotonConverterPPC::Convert(const I3CLSimStepSeries &steps, uint32_t identifier)
+{
     // sends steps to kernel
-    for (const I3CLSimStep &step : *steps) {
+    for (const I3CLSimStep &step : steps) {
         const I3Direction n = *(step.GetDir());
         float nx=n.GetX(), ny=n.GetY(), nz=n.GetZ();
         std::pair<int, unsigned long long> id(static_cast<int>(step.GetID()), 0ULL);
@@ -99,9 +250,9 @@ I3CLSimStepToPhotonConverterPPC::ConversionResult_t I3CLSimStepToPhotonConverter
     }
     // Flush the kernel
     xppc::eout();
-    
+
     ConversionResult_t result(0, boost::make_shared<I3CLSimPhotonSeries>(), NULL);
-    
+
     // collect results
     for (auto &hit : xppc::hitz) {
         if (result.identifier == 0)
@@ -111,13 +262,13 @@ I3CLSimStepToPhotonConverterPPC::ConversionResult_t I3CLSimStepToPhotonConverter
                 log_fatal_stream("Got "<<static_cast<uint32_t>(hit.first.track.frame)<<" after "<<result.photons->size()<<" photons from bunch "<<result.identifier);
             assert( int(result.identifier) == hit.first.track.frame );
         }
-        
+
         for (auto &ppc_photon : hit.second) {
             I3CLSimPhoton photon;
             photon.SetID(hit.first.track.first);
             photon.SetStringID(hit.first.omkey.str);
             photon.SetOMID(hit.first.omkey.dom);
-            
+
             // NB: photon positions are relative to the hit DOM
             photon.SetPosX(ppc_photon.r[0]*I3Units::m);
             photon.SetPosY(ppc_photon.r[1]*I3Units::m);
@@ -126,12 +277,12 @@ I3CLSimStepToPhotonConverterPPC::ConversionResult_t I3CLSimStepToPhotonConverter
             photon.SetDir(ppc_photon.n[0],ppc_photon.n[1],ppc_photon.n[2]);
             photon.SetWavelength(ppc_photon.n[3]*I3Units::nanometer);
             photon.SetWeight(1.0/wavelenthBias_->GetValue(photon.GetWavelength()));
-            
+
             result.photons->push_back(photon);
         }
     }
     // clear output buffer
     xppc::efin();
-    
+
     return result;
 }
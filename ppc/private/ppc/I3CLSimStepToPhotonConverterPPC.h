@@ -4,16 +4,48 @@
 
 #include "clsim/I3CLSimStepToPhotonConverter.h"
 #include "clsim/I3CLSimQueue.h"
+#include "phys-services/I3RandomService.h"
 
+#include <exception>
+#include <string>
+
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+/**
+ * @brief Runs ppc as a clsim step-to-photon converter.
+ *
+ * All ppc state is thread-local, and every converter instance drives
+ * its own copy from a private worker thread. Several instances can thus
+ * coexist in one process, e.g. one per OpenCL CPU device partition or
+ * one per tray, each with an independent random number stream. Device
+ * selection and the table directory are per instance as well; the
+ * OCPU/OGPU/PPCTABLESDIR environment variables are only consulted when
+ * they are not set.
+ */
 class I3CLSimStepToPhotonConverterPPC : public I3CLSimStepToPhotonConverter {
 public:
     
+   /**
+    * @param seed seed for the random number streams of this instance.
+    *             0 seeds from the current time.
+    * @param useCPUs run on OpenCL CPU devices
+    * @param useGPUs run on OpenCL GPU devices
+    */
+   I3CLSimStepToPhotonConverterPPC(uint32_t seed=0, bool useCPUs=true, bool useGPUs=true);
+
+   /**
+    * Seed the random number streams of this instance from a random service,
+    * so that instances created at the same time get distinct streams.
+    */
+   I3CLSimStepToPhotonConverterPPC(I3RandomServicePtr rng, bool useCPUs=true, bool useGPUs=true);
    I3CLSimStepToPhotonConverterPPC(const I3CLSimStepToPhotonConverterPPC &) = delete;
    I3CLSimStepToPhotonConverterPPC(const I3CLSimStepToPhotonConverterPPC &&) = delete;
    
    virtual ~I3CLSimStepToPhotonConverterPPC();
    
-   /** Get the global shared instance */
+   /** Get the global shared instance (seeded from the current time) */
    static boost::shared_ptr<I3CLSimStepToPhotonConverterPPC> GetInstance();
    
    /**
@@ -50,6 +82,19 @@ public:
     * Will throw if used after the call to Initialize().
     */
    virtual void SetGeometry(I3CLSimSimpleGeometryConstPtr geometry) { geometry_ = geometry; };
+
+   /**
+    * Sets the directory with the ppc configuration and ice model tables.
+    * If empty, $PPCTABLESDIR or the tables shipped with ppc are used.
+    * Will throw if used after the call to Initialize().
+    */
+   void SetTablesDirectory(const std::string &dir);
+
+   /**
+    * Selects the OpenCL device types to run on.
+    * Will throw if used after the call to Initialize().
+    */
+   void SetDeviceTypes(bool useCPUs, bool useGPUs);
    
    /**
     * Initializes the simulation.
@@ -91,7 +136,7 @@ public:
     *
     * Will throw if not initialized.
     */
-   virtual std::size_t QueueSize() const { return inbox_.size(); }; 
+   virtual std::size_t QueueSize() const { return inbox_.size(); };
    
    /**
     * Returns true if more photons are available.
@@ -111,23 +156,40 @@ public:
     *
     * Might block if no photons are available.
     * 
-    * Will throw if not initialized.
+    * Will throw if not initialized, and rethrows errors raised
+    * by ppc while converting the corresponding steps.
     */
    virtual ConversionResult_t GetConversionResult();
    
    virtual std::map<std::string, double> GetStatistics() const { return std::map<std::string, double>(); };
 
 private:
-    I3CLSimStepToPhotonConverterPPC();
     static boost::weak_ptr<I3CLSimStepToPhotonConverterPPC> instance_;
     
+    // owns the (thread-local) ppc state for the lifetime of this instance
+    void PPCThread();
+    void PPCThread_impl();
+    void SetupPPC();
+    ConversionResult_t Convert(const I3CLSimStepSeries &steps, uint32_t identifier);
+    
     bool isInitialized_;
+    uint32_t seed_;
+    bool useCPUs_, useGPUs_;
+    std::string tablesDir_;
     I3CLSimSimpleGeometryConstPtr geometry_;
     I3CLSimFunctionConstPtr wavelenthBias_;
     
     size_t workgroupSize_, maxBunchSize_;
     
+    boost::shared_ptr<boost::thread> ppcThreadObj_;
+    boost::condition_variable ppcStarted_cond_;
+    boost::mutex ppcStarted_mutex_;
+    bool ppcStarted_;
+    std::string ppcStartError_;
+    
     I3CLSimQueue<std::pair<I3CLSimStepSeriesConstPtr, uint32_t>> inbox_;
+    // a result, or the error that was raised on the worker thread
+    I3CLSimQueue<std::pair<ConversionResult_t, std::exception_ptr>> outbox_;
 };
 
 #endif
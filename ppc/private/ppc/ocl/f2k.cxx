@@ -14,7 +14,7 @@ static const float ppm=2450.08;     // photons per meter
 static const float rho=0.9216;      // density of ice [mwe]
 static const float m0=0.105658389;  // muon rest mass [GeV]
 
-photon p;
+XTLS photon p;
 
 #ifdef XLIB
 float yield(float N, char type){  // LED light
@@ -176,7 +176,7 @@ struct mcid:pair<int,unsigned long long>{
   int frame;
 };
 
-struct ihit{
+XTLS struct ihit{
   ikey omkey;
   mcid track;
   float time;
@@ -191,13 +191,13 @@ struct ihit{
   }
 } tmph;
 
-float trz=0;
+XTLS float trz=0;
 
 void set_res(float t){
   trz=t;
 }
 
-float crz=0;
+XTLS float crz=0;
 
 void set_res(float t, float c){
   trz=t; crz=c;
@@ -207,18 +207,18 @@ float res(float val, float bin){
   return bin>0?(floor(val/bin)+0.5)*bin:val;
 }
 
-deque<mcid> flnz;
+XTLS deque<mcid> flnz;
 
 struct pout{
   float r[4], n[4];
 };
-map<ihit, vector<pout> > hitz;
+XTLS map<ihit, vector<pout> > hitz;
 #else
-deque<string> flnz;
+XTLS deque<string> flnz;
 #endif
 
-unsigned int flnb=0, flne=0;
-unsigned int flnd=0;
+XTLS unsigned int flnb=0, flne=0;
+XTLS unsigned int flnd=0;
 
 int hcmp(const void *a, const void *b){
   hit & ah = * (hit *) a;
@@ -640,7 +640,7 @@ const DOM& flset(int str, int dom){
 
   p.type=type;
 
-  static DOM om;
+  static XTLS DOM om;
   for(int m=0; m<3; m++) om.r[m]=r[m];
   return om;
 }
@@ -1,6 +1,6 @@
 const float fcv=FPI/180.f;
-static unsigned int ovr=1;
-int xr=1;
+static XTLS unsigned int ovr=1;
+XTLS int xr=1;
 
 struct ikey{
   int str, dom;
@@ -19,7 +19,7 @@ struct ikey{
 };
 
 struct OM:DOM,ikey{};
-vector<OM> i3oms;
+XTLS vector<OM> i3oms;
 
 template <int n> class V{
   double x[n];
@@ -47,18 +47,18 @@ struct name:ikey{
   }
 };
 
-map<ikey, float> hvs;
-map<ikey, pair<float, int> > rdes;
-map<xppc::ikey, V<3> > cx;
-map<xppc::ikey, float > dx;
+XTLS map<ikey, float> hvs;
+XTLS map<ikey, pair<float, int> > rdes;
+XTLS map<xppc::ikey, V<3> > cx;
+XTLS map<xppc::ikey, float > dx;
 
-bool rdef=false;
-float rmax=0, rmay=0;
+XTLS bool rdef=false;
+XTLS float rmax=0, rmay=0;
 
-dats d;
-datz z;
+XTLS dats d;
+XTLS datz z;
 
-struct doms{
+XTLS struct doms{
   DOM oms[MAXGEO];
   name names[MAXGEO];
   map<float, float> rde;
@@ -78,7 +78,18 @@ unsigned char sname(int n){
 }
 
 static const float zoff=1948.07;
-unsigned int sv=0;
+XTLS unsigned int sv=0;
+XTLS bool svfix=false;
+
+void set_seed(unsigned int seed){
+  sv=seed; svfix=true;
+}
+
+XTLS string tdir;
+
+void set_tables_dir(const string & dir){
+  tdir=dir;
+}
 
 void rs_ini(){
   union{
@@ -97,7 +108,7 @@ void rs_ini(){
   for(int i=0; i<d.rsize; i++) z.rs[i]=s.da;
 }
 
-struct ini{
+XTLS struct ini{
   float ctr(line & s, int m){
     return d.cb[0][m]*s.x+d.cb[1][m]*s.y;
   }
@@ -110,7 +121,8 @@ struct ini{
     string ppcdir("");
     {
       char * env = getenv("PPCTABLESDIR");
-      if(env!=NULL) { 
+      if(!tdir.empty()) ppcdir=tdir+"/";
+      else if(env!=NULL) { 
       	ppcdir=string(env)+"/";
       } else {
       	env = getenv("I3_SRC");
@@ -246,8 +258,10 @@ struct ini{
 
       cerr<<"Loaded "<<size<<" random multipliers"<<endl;
 
-      timeval tv; gettimeofday(&tv, NULL);
-      sv=1000000*(unsigned long long)tv.tv_sec+tv.tv_usec;
+      if(!svfix){
+	timeval tv; gettimeofday(&tv, NULL);
+	sv=1000000*(unsigned long long)tv.tv_sec+tv.tv_usec;
+      }
 
       d.rsize=size;
       for(int i=0; i<size; i++) z.rm[i]=rx[i];
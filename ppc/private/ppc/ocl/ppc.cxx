@@ -30,6 +30,12 @@
 
 using namespace std;
 
+#ifdef XLIB
+#define XTLS thread_local  // each thread drives its own independent propagator
+#else
+#define XTLS
+#endif
+
 namespace xppc{
 #define LMAX 6       // number of dust loggers
 #define LYRS 170     // number of depth points
@@ -65,9 +71,13 @@ namespace xppc{
 
   void initialize(float enh = 1.f){ m.set(); q.eff*=enh; }
 
-  unsigned int pmax, pmxo, pn, pk;
+  XTLS unsigned int pmax, pmxo, pn, pk;
 
-  bool xgpu=false;
+  XTLS bool xgpu=false;
+  XTLS bool ocpu=false;
+  XTLS bool ogpu=false;
+
+  void use_devices(bool cpu, bool gpu){ ocpu=cpu, ogpu=gpu; }
 
   void checkError(cl_int result){
     if(result!=CL_SUCCESS){
@@ -76,7 +86,7 @@ namespace xppc{
     }
   }
 
-  vector< pair<cl_platform_id,cl_device_id> > all;
+  XTLS vector< pair<cl_platform_id,cl_device_id> > all;
 
   struct gpu{
     dats d;
@@ -412,7 +422,7 @@ namespace xppc{
     return a*b/gcd(a, b);
   }
 
-  vector<gpu> gpus;
+  XTLS vector<gpu> gpus;
 
   void ini(){
     d.hnum=0; d.gnum=gpus.size();
@@ -471,12 +481,12 @@ namespace xppc{
     char * only;
 
     only=getenv("OCPU");
-    if(only!=NULL) if(*only==0 || atoi(only)>0){
+    if(ocpu || (only!=NULL && (*only==0 || atoi(only)>0))){
 	dtype|=CL_DEVICE_TYPE_CPU;
 	cerr<<"Running only on CPUs!"<<endl;
     }
     only=getenv("OGPU");
-    if(only!=NULL) if(*only==0 || atoi(only)>0){
+    if(ogpu || (only!=NULL && (*only==0 || atoi(only)>0))){
 	dtype|=CL_DEVICE_TYPE_GPU;
 	cerr<<"Running only on GPUs!"<<endl;
     }
@@ -576,7 +586,7 @@ namespace xppc{
     fprintf(stderr, "\n");
   }
 
-  static unsigned int old=0;
+  static XTLS unsigned int old=0;
 
   void print();
 
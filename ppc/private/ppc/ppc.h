@@ -11,6 +11,10 @@ namespace xppc{
 
   void flone(unsigned long long);
 
+  void set_seed(unsigned int);
+  void set_tables_dir(const std::string &);
+  void use_devices(bool, bool);
+
   size_t getMaxBunchSize();
   size_t getWorkgroupSize();
 
@@ -39,9 +43,9 @@ namespace xppc{
   };
 
   struct OM:DOM,ikey{};
-  extern std::vector<OM> i3oms;
-  extern std::map<ikey, float> hvs;
-  extern std::map<ikey, std::pair<float, int> > rdes;
+  extern thread_local std::vector<OM> i3oms;
+  extern thread_local std::map<ikey, float> hvs;
+  extern thread_local std::map<ikey, std::pair<float, int> > rdes;
 
   void initialize(float);
   const DOM& flset(int, int);
@@ -70,7 +74,7 @@ namespace xppc{
   };
 
   typedef std::map<ihit, std::vector<pout> > outz;
-  extern outz hitz;
+  extern thread_local outz hitz;
 
   void efin();
 
@@ -9,7 +9,13 @@ static void register_I3CLSimStepToPhotonConverterPPC()
     bp::class_<I3CLSimStepToPhotonConverterPPC,
                boost::shared_ptr<I3CLSimStepToPhotonConverterPPC>,
                bp::bases<I3CLSimStepToPhotonConverter>,
-               boost::noncopyable >("I3CLSimStepToPhotonConverterPPC", bp::no_init)
+               boost::noncopyable >("I3CLSimStepToPhotonConverterPPC",
+                                    bp::init<uint32_t, bool, bool>(
+                                        (bp::arg("seed")=0, bp::arg("useCPUs")=true, bp::arg("useGPUs")=true)))
+        .def(bp::init<I3RandomServicePtr, bool, bool>(
+            (bp::arg("randomService"), bp::arg("useCPUs")=true, bp::arg("useGPUs")=true)))
+        .def("SetTablesDirectory", &I3CLSimStepToPhotonConverterPPC::SetTablesDirectory)
+        .def("SetDeviceTypes", &I3CLSimStepToPhotonConverterPPC::SetDeviceTypes)
         .add_static_property("instance", &I3CLSimStepToPhotonConverterPPC::GetInstance)
     ;
 }
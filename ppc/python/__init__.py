@@ -16,7 +16,8 @@ def tau_dnde_builder(it):
     return dataclasses.I3VectorDoubleDouble(tmp)
 
 def MakeCLSimPropagator(DetectorParams, UseCPUs=False, UseGPUs=True,
-                        CopyConfig=False):
+                        CopyConfig=False, Shared=True, Seed=0,
+                        RandomService=None):
     """
     Configure ppc to for use with clsim. 
     
@@ -25,15 +26,32 @@ def MakeCLSimPropagator(DetectorParams, UseCPUs=False, UseGPUs=True,
     :param UseGPUs: use GPUs
     :param CopyConfig: copy the cfg.txt file and update first 2 rows instead of
     generating it from scratch
+    :param Shared: return the process-wide shared propagator. If False, a
+    new, independent propagator with its own worker thread is created, so
+    that several propagators can run side by side in one process.
+    :param Seed: random number seed of a non-shared propagator
+    :param RandomService: draw the seed of a non-shared propagator from
+    this I3RandomService. A non-shared propagator needs either this or a
+    nonzero Seed, so that propagators created at the same time do not
+    share a random number stream.
     """
     from icecube.icetray import I3Units
     from icecube import clsim
     from os.path import expandvars, join, isfile
-    from os import environ
     import tempfile, shutil
     import numpy
     
-    propagator = I3CLSimStepToPhotonConverterPPC.instance
+    if not UseGPUs and not UseCPUs:
+        raise ValueError("Need to use at least one device type")
+    if Shared:
+        propagator = I3CLSimStepToPhotonConverterPPC.instance
+        propagator.SetDeviceTypes(UseCPUs, UseGPUs)
+    elif Seed != 0:
+        propagator = I3CLSimStepToPhotonConverterPPC(Seed, UseCPUs, UseGPUs)
+    elif RandomService is not None:
+        propagator = I3CLSimStepToPhotonConverterPPC(RandomService, UseCPUs, UseGPUs)
+    else:
+        raise ValueError("A non-shared propagator needs a Seed or a RandomService")
     propagator.SetGeometry(DetectorParams['Geometry'])
     propagator.SetWlenBias(DetectorParams['WavelengthGenerationBias'])
 
@@ -95,13 +113,7 @@ def MakeCLSimPropagator(DetectorParams, UseCPUs=False, UseGPUs=True,
         if isfile(fname):
             shutil.copy(fname, tmpdir)
 
-    environ['PPCTABLESDIR'] = tmpdir
-    if UseCPUs and not UseGPUs:
-        environ['OCPU'] = '1'
-    elif UseGPUs and not UseCPUs:
-        environ['OGPU'] = '1'
-    elif not UseGPUs and not UseCPUs:
-        raise ValueError("Need to use at least one device type")
+    propagator.SetTablesDirectory(tmpdir)
     
     try:
         propagator.Initialize()
@@ -10,6 +10,7 @@
  */
 
 #include "gulliver/I3EventHypothesis.h"
+#include "gulliver/utilities/Dual.h"
 #include "rpdf/I3RecoLLH.h"
 
 I3RecoLLH::I3RecoLLH(const std::string &input_readout,
@@ -23,10 +24,10 @@ I3RecoLLH::I3RecoLLH(const std::string &input_readout,
   peprob_(peprob),jitter_(jitter),noise_(noise),ice_model_(ice)
 {
   if (likelihood_=="SPE1st"){
-    dom_likelihood_func_=rpdf::SPEfunc();
+    dom_likelihood_gradient_=rpdf::SPEgradient();
   }
   else if(likelihood_=="MPE"){
-    dom_likelihood_func_=rpdf::MPEfunc();
+    dom_likelihood_gradient_=rpdf::MPEgradient();
   }
   else {
     log_fatal("I3RecoLLH service was configured with unimplemented DOM likelihood '%s'",likelihood_.c_str());
@@ -65,13 +66,24 @@ void I3RecoLLH::SetEvent( const I3Frame &f )
   SetPulseMap(*pulse_map);
 }
 
+void I3RecoLLH::I3HitCache::clear()
+{
+  x.clear();
+  y.clear();
+  z.clear();
+  first_pulse_time.clear();
+  total_npe.clear();
+  mpe_hits.clear();
+  mpe_npe.clear();
+}
+
 void I3RecoLLH::SetPulseMap(const I3RecoPulseSeriesMap& pulse_map)
 {
   //empty the old hit cache
   hit_cache_.clear();
 
   //loop over every DOM in the pulse map
-  for (auto map_itr: pulse_map) {
+  for (const auto& map_itr: pulse_map) {
     const OMKey& omkey = map_itr.first;
     const I3RecoPulseSeries& pulse_series=map_itr.second;
 
@@ -81,56 +93,170 @@ void I3RecoLLH::SetPulseMap(const I3RecoPulseSeriesMap& pulse_map)
     //usually we don't get empty pulse series, but if we do, just skip it
     if (pulse_series.size()==0){continue;}
 
-    //initialize the cache with zero charge and t=infinity
-    I3HitCache hit_om = {0,
-                         std::numeric_limits<double>::infinity(),
-                         omgeo.position};
+    //initialize with zero charge and t=infinity
+    double total_npe = 0;
+    double first_pulse_time = std::numeric_limits<double>::infinity();
 
     //loop over the pulse series to sum the charge and find the earliest hit
-    for (auto pulse_itr: pulse_series){
+    for (const auto& pulse_itr: pulse_series){
       // sum the charge from each pulse
-      hit_om.total_npe += pulse_itr.GetCharge();
+      total_npe += pulse_itr.GetCharge();
 
       //if this is the earliest hit save it
-      if ( pulse_itr.GetTime() < hit_om.first_pulse_time ){
-        hit_om.first_pulse_time = pulse_itr.GetTime();
+      if ( pulse_itr.GetTime() < first_pulse_time ){
+        first_pulse_time = pulse_itr.GetTime();
       }
     }
 
-    hit_cache_.push_back(hit_om);
+    //MPE only needs the survival function if there is more than one PE,
+    //see MPEfunc
+    if (likelihood_=="MPE" && total_npe >= 1.5){
+      hit_cache_.mpe_hits.push_back(hit_cache_.size());
+      hit_cache_.mpe_npe.push_back(floor(total_npe+0.5));
+    }
+
+    hit_cache_.x.push_back(omgeo.position.GetX());
+    hit_cache_.y.push_back(omgeo.position.GetY());
+    hit_cache_.z.push_back(omgeo.position.GetZ());
+    hit_cache_.first_pulse_time.push_back(first_pulse_time);
+    hit_cache_.total_npe.push_back(total_npe);
   }
+
+  t_res_.resize(hit_cache_.size());
+  deff_.resize(hit_cache_.size());
+  dom_likelihood_.resize(hit_cache_.size());
+  mpe_t_res_.resize(hit_cache_.mpe_hits.size());
+  mpe_deff_.resize(hit_cache_.mpe_hits.size());
+  mpe_survival_.resize(hit_cache_.mpe_hits.size());
+}
+
+double I3RecoLLH::SumLogLikelihood()
+{
+  const size_t n = hit_cache_.size();
+  const size_t nmpe = hit_cache_.mpe_hits.size();
+
+  //the probability of the first hit for every DOM
+  pe_prob_->pdf_batch(n,t_res_.data(),deff_.data(),dom_likelihood_.data());
+
+  //times the probability of the other N-1 photons arriving later
+  if (nmpe){
+    for (size_t j=0; j<nmpe; ++j){
+      mpe_t_res_[j] = t_res_[hit_cache_.mpe_hits[j]];
+      mpe_deff_[j] = deff_[hit_cache_.mpe_hits[j]];
+    }
+    pe_prob_->sf_batch(nmpe,mpe_t_res_.data(),mpe_deff_.data(),mpe_survival_.data());
+    for (size_t j=0; j<nmpe; ++j){
+      const double iNpe = hit_cache_.mpe_npe[j];
+      double& dom_likelihood = dom_likelihood_[hit_cache_.mpe_hits[j]];
+      dom_likelihood = dom_likelihood*iNpe*std::pow(mpe_survival_[j],iNpe-1);
+    }
+  }
+
+  //Add noise and take the log
+  double event_loglikelihood=0.0;
+  for (size_t i=0; i<n; ++i){
+    event_loglikelihood+=log(dom_likelihood_[i]+noise_);
+  }
+  return event_loglikelihood;
 }
 
 double I3RecoLLH::GetLogLikelihood( const I3EventHypothesis &eh )
 {
   //extract the track hypothesis from Gulliver's data structure
   const I3Particle &track = *(eh.particle);
+  const I3Position &pos = track.GetPos();
+  const I3Direction &dir = track.GetDir();
+  const std::array<double,3> vertex = {{pos.GetX(),pos.GetY(),pos.GetZ()}};
+  const std::array<double,3> direction = {{dir.GetX(),dir.GetY(),dir.GetZ()}};
+  const double time = track.GetTime();
 
-  //this stores the total likelihood for the event
-  double event_loglikelihood=0.0;
+  //get the geometrical parameters for each DOM: the residual time from the
+  //time of the first pulse and the geometrical time, and the effective distance
+  for (size_t i=0; i<hit_cache_.size(); ++i) {
+    const std::pair<double,double> geo_params =
+      rpdf::track_geometry(hit_cache_.x[i],hit_cache_.y[i],hit_cache_.z[i],
+                           vertex,direction,time,ice_model_);
+    t_res_[i] = hit_cache_.first_pulse_time[i] - geo_params.first;
+    deff_[i] = geo_params.second;
+  }
+
+  return SumLogLikelihood();
+}
+
+double I3RecoLLH::GetLogLikelihoodWithGradient( const I3EventHypothesis &eh,
+                                                I3EventHypothesis &gradient,
+                                                double weight )
+{
+  //the derivatives are taken with respect to t, x, y, z, zenith and azimuth
+  typedef gulliver::Dual<6> Dual;
+
+  const I3Particle &track = *(eh.particle);
+  const I3Position &pos = track.GetPos();
+  const I3Direction &dir = track.GetDir();
+
+  const Dual time = Dual::Variable(0,track.GetTime());
+  const std::array<Dual,3> vertex = {{Dual::Variable(1,pos.GetX()),
+                                      Dual::Variable(2,pos.GetY()),
+                                      Dual::Variable(3,pos.GetZ())}};
+
+  //the unit vector is (-sin(zen)cos(azi),-sin(zen)sin(azi),-cos(zen)),
+  //set its derivatives by hand so the values are the same as in GetLogLikelihood
+  const double sin_zen = sin(dir.GetZenith());
+  const double cos_zen = cos(dir.GetZenith());
+  const double sin_azi = sin(dir.GetAzimuth());
+  const double cos_azi = cos(dir.GetAzimuth());
+  std::array<Dual,3> direction = {{dir.GetX(),dir.GetY(),dir.GetZ()}};
+  direction[0].d[4] = -cos_zen*cos_azi;
+  direction[0].d[5] =  sin_zen*sin_azi;
+  direction[1].d[4] = -cos_zen*sin_azi;
+  direction[1].d[5] = -sin_zen*cos_azi;
+  direction[2].d[4] =  sin_zen;
 
-  //loop over each DOM in the hit cache
-  for (auto itr: hit_cache_) {
-    //for each DOM calculate the likelihood
-    const double Npe = itr.total_npe;
-    const I3Position& om_pos = itr.pos;
-
-    //get the geometrical parameters: tgeo and deff
-    std::pair<double,double> geo_params = rpdf::muon_geometry(om_pos,track,ice_model_);
-    //get the residual time from the time of the first pulse and the geometrical time
-    const double t_res = itr.first_pulse_time - geo_params.first;
-    //the effective distance is the second parameter
-    const double deff = geo_params.second;
-    //get the likelihood for the individual DOM
-    const double dom_likelihood = dom_likelihood_func_(*pe_prob_,t_res,deff,Npe);
-
-    //Add noise and take the log
-    event_loglikelihood+=log(dom_likelihood+noise_);
+  std::vector<std::pair<Dual,Dual> > geo_params;
+  geo_params.reserve(hit_cache_.size());
+  for (size_t i=0; i<hit_cache_.size(); ++i) {
+    geo_params.push_back(rpdf::track_geometry(hit_cache_.x[i],hit_cache_.y[i],
+                                              hit_cache_.z[i],vertex,direction,
+                                              time,ice_model_));
+    t_res_[i] = hit_cache_.first_pulse_time[i] - geo_params[i].first.value;
+    deff_[i] = geo_params[i].second.value;
   }
 
+  //the value is calculated exactly as in GetLogLikelihood
+  const double event_loglikelihood = SumLogLikelihood();
+
+  std::array<double,6> event_gradient;
+  event_gradient.fill(0.);
+  for (size_t i=0; i<hit_cache_.size(); ++i) {
+    double dldt, dldd;
+    dom_likelihood_gradient_(*pe_prob_,t_res_[i],deff_[i],
+                             hit_cache_.total_npe[i],dldt,dldd);
+
+    //d log(L+noise) = dL/(L+noise), and d(t_res) = -d(t_geo)
+    const double likelihood = dom_likelihood_[i]+noise_;
+    const Dual& t_geo = geo_params[i].first;
+    const Dual& deff = geo_params[i].second;
+    for (unsigned k=0; k<6; ++k){
+      event_gradient[k] += (-dldt*t_geo.d[k] + dldd*deff.d[k])/likelihood;
+    }
+  }
+
+  I3Particle &g = *(gradient.particle);
+  g.SetTime(g.GetTime() + weight*event_gradient[0]);
+  g.SetPos(g.GetPos().GetX() + weight*event_gradient[1],
+           g.GetPos().GetY() + weight*event_gradient[2],
+           g.GetPos().GetZ() + weight*event_gradient[3]);
+  g.SetDir(g.GetDir().GetZenith() + weight*event_gradient[4],
+           g.GetDir().GetAzimuth() + weight*event_gradient[5]);
+
   return event_loglikelihood;
 }
 
+bool I3RecoLLH::HasGradient()
+{
+  return true;
+}
+
 unsigned int I3RecoLLH::GetMultiplicity()
 {
   return hit_cache_.size();
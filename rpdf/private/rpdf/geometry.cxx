@@ -52,47 +52,12 @@ namespace rpdf{
                                           const I3Particle& track,
                                           const IceModel& ice_model)
   {
-    const I3Direction dir=track.GetDir();
-
-    //delta is the difference between the OM and the track vertex
-    const I3Position delta = om_pos - track.GetPos();
-
-    //the distance along the track is the dot product of delta and the track direction
-    const double d_track      = (delta.GetX()*dir.GetX()+
-                                 delta.GetY()*dir.GetY()+
-                                 delta.GetZ()*dir.GetZ());
-
-    //the distance of closest approach is the magnitude of the cross product 
-    //between delta and the track direction 
-    const double d_approach = hypot(hypot(delta.GetY()*dir.GetZ()-delta.GetZ()*dir.GetY(), 
-                                          delta.GetZ()*dir.GetX()-delta.GetX()*dir.GetZ()), 
-                                    delta.GetX()*dir.GetY()-delta.GetY()*dir.GetX()); 
-
-    //calculate the time residual
-    const double t_geo        = track.GetTime()+cherenkov_time(d_track,d_approach);
-
-    double coseta;
-    if (d_approach<=0.0){
-      //if the approach distance is zero than the below calculation won't work
-      //so just skip it since we know that the effective distance will also be zero
-      //eff_distance=0;
-      coseta=0.0;
-    }else{
-      //this is the distance a direct photon travels from the track to the OM
-      const double d_travel    = d_approach/constants::SIN_CHERENKOV;
-      //this is the distance from the track's vertex to the origin of the direct photon
-      const double d_to_vertex = d_track-d_approach/constants::TAN_CHERENKOV;
-      //this is the distance the direct photon travels in the z direction
-      const double d_travel_z  = delta.GetZ() - d_to_vertex * track.GetDir().GetZ();
-      //eta is the angle between the direct photon and the orientation of the DOM
-      //so the cos(eta) is the the length in the z direction divided by the total distance
-      coseta                   = d_travel_z / d_travel;
-    }
-    //calculate the effective distance
-    const double eff_distance = effective_distance(d_approach,coseta,ice_model);
-
-    //return the time residual and the effective distance
-    return std::make_pair(t_geo,eff_distance);
+    const I3Position& pos=track.GetPos();
+    const I3Direction& dir=track.GetDir();
+    const std::array<double,3> vertex={{pos.GetX(),pos.GetY(),pos.GetZ()}};
+    const std::array<double,3> direction={{dir.GetX(),dir.GetY(),dir.GetZ()}};
+    return track_geometry(om_pos.GetX(),om_pos.GetY(),om_pos.GetZ(),
+                          vertex,direction,track.GetTime(),ice_model);
   }
 }//namespace rpdf
 
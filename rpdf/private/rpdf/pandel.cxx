@@ -17,6 +17,7 @@
 #include <gsl/gsl_sf_erf.h>
 #include <gsl/gsl_errno.h>
 #include <boost/math/distributions/gamma.hpp>
+#include <boost/math/special_functions/digamma.hpp>
 
 #include "dataclasses/physics/I3Particle.h"
 #include "rpdf/geometry.h"
@@ -28,6 +29,12 @@ namespace {
   /// this gets used a lot so precompute this as well
   const double SQRTPI_INV = 1./sqrt(M_PI);
 
+  /// step size for numerical derivatives by central differences
+  double derivative_step(const double x)
+  {
+    return 1e-5*(1+fabs(x));
+  }
+
   ///Class to hold the coefficients that fastConvolutedHyperg needs
   //this class was copied from ipdf/private/Pandel/ConvolutedHyperg.cxx:Line 24
   class PrecomputedBCoefficients
@@ -155,6 +162,78 @@ double rpdf::UnconvolutedPandel::sf(const double t, const double d)const
   return rpdf::pandel_sf(t,d,ice_model_);
 }
 
+double rpdf::UnconvolutedPandel::pdf_gradient(const double t, const double d,
+                                              double& dt, double& dd)const
+{
+  const double p = rpdf::pandel_pdf(t,d,ice_model_);
+  if (p<=0){
+    //outside of the support the pdf is constant zero
+    dt = dd = 0;
+    return p;
+  }
+  const double xi = d/ice_model_.scattering_length;
+  dt = p*((xi-1)/t - ice_model_.rho);
+  dd = p*(log(ice_model_.rho*t) - boost::math::digamma(xi))/ice_model_.scattering_length;
+  return p;
+}
+
+double rpdf::UnconvolutedPandel::sf_gradient(const double t, const double d,
+                                             double& dt, double& dd)const
+{
+  const double s = rpdf::pandel_sf(t,d,ice_model_);
+  if (t<=0 || d<=0){
+    dt = dd = 0;
+    return s;
+  }
+  dt = -rpdf::pandel_pdf(t,d,ice_model_);
+  //there is no closed form for the derivative of the incomplete gamma
+  //function with respect to its shape, keep the step inside d>0
+  const double hd = std::min(derivative_step(d),0.5*d);
+  dd = (rpdf::pandel_sf(t,d+hd,ice_model_)-rpdf::pandel_sf(t,d-hd,ice_model_))/(2*hd);
+  return s;
+}
+
+void rpdf::UnconvolutedPandel::pdf_batch(const size_t n, const double* t,
+                                         const double* d, double* out)const
+{
+  const double rho = ice_model_.rho;
+  const double inv_scattering_length = 1/ice_model_.scattering_length;
+  for (size_t i=0; i<n; ++i){
+    //same cuts as pandel_pdf
+    if (t[i]<=0 || d[i]<=0){
+      out[i] = 0;
+      continue;
+    }
+    const double xi = d[i]*inv_scattering_length;
+    const double rhot = rho*t[i];
+    out[i] = rho*exp((xi-1)*log(rhot) - rhot - lgamma(xi));
+  }
+}
+
+void rpdf::UnconvolutedPandel::sf_batch(const size_t n, const double* t,
+                                        const double* d, double* out)const
+{
+  for (size_t i=0; i<n; ++i){
+    out[i] = rpdf::pandel_sf(t[i],d[i],ice_model_);
+  }
+}
+
+void rpdf::FastConvolutedPandel::pdf_batch(const size_t n, const double* t,
+                                           const double* d, double* out)const
+{
+  for (size_t i=0; i<n; ++i){
+    out[i] = FastConvolutedPandel::pdf(t[i],d[i]);
+  }
+}
+
+void rpdf::FastConvolutedPandel::sf_batch(const size_t n, const double* t,
+                                          const double* d, double* out)const
+{
+  for (size_t i=0; i<n; ++i){
+    out[i] = FastConvolutedPandel::sf(t[i],d[i]);
+  }
+}
+
 double rpdf::FastConvolutedPandel::pdf(const double delay,const double propd)const
 {
   //this function was copied from ipdf/public/ipdf/Pandel/GaussConvolutedPEP.h: Line 213
@@ -321,6 +400,42 @@ double rpdf::FastConvolutedPandel::sf(const double t, const double d)const
   return result;
 }
 
+double rpdf::PhotoElectronProbability::pdf_gradient(const double t, const double d,
+                                                    double& dt, double& dd)const
+{
+  const double ht = derivative_step(t);
+  const double hd = derivative_step(d);
+  dt = (pdf(t+ht,d)-pdf(t-ht,d))/(2*ht);
+  dd = (pdf(t,d+hd)-pdf(t,d-hd))/(2*hd);
+  return pdf(t,d);
+}
+
+double rpdf::PhotoElectronProbability::sf_gradient(const double t, const double d,
+                                                   double& dt, double& dd)const
+{
+  const double ht = derivative_step(t);
+  const double hd = derivative_step(d);
+  dt = (sf(t+ht,d)-sf(t-ht,d))/(2*ht);
+  dd = (sf(t,d+hd)-sf(t,d-hd))/(2*hd);
+  return sf(t,d);
+}
+
+void rpdf::PhotoElectronProbability::pdf_batch(const size_t n, const double* t,
+                                               const double* d, double* out)const
+{
+  for (size_t i=0; i<n; ++i){
+    out[i] = pdf(t[i],d[i]);
+  }
+}
+
+void rpdf::PhotoElectronProbability::sf_batch(const size_t n, const double* t,
+                                              const double* d, double* out)const
+{
+  for (size_t i=0; i<n; ++i){
+    out[i] = sf(t[i],d[i]);
+  }
+}
+
 double rpdf::SPEfunc::operator()(const rpdf::PhotoElectronProbability& p,
                                  const double t_res, const double d_eff,
                                  const double Npe) const
@@ -350,3 +465,35 @@ double rpdf::MPEfunc::operator()(const PhotoElectronProbability& p,
     return spepdf*iNpe*std::pow(survival,iNpe-1);
   }
 }
+
+double rpdf::SPEgradient::operator()(const PhotoElectronProbability& p,
+                                     const double t_res, const double d_eff,
+                                     const double Npe,
+                                     double& dt, double& dd) const
+{
+  return p.pdf_gradient(t_res,d_eff,dt,dd);
+}
+
+double rpdf::MPEgradient::operator()(const PhotoElectronProbability& p,
+                                     const double t_res, const double d_eff,
+                                     const double Npe,
+                                     double& dt, double& dd) const
+{
+  double pdf_dt, pdf_dd;
+  const double spepdf = p.pdf_gradient(t_res,d_eff,pdf_dt,pdf_dd);
+
+  if (Npe < 1.5) {
+    dt = pdf_dt;
+    dd = pdf_dd;
+    return spepdf;
+  } else {
+    double sf_dt, sf_dd;
+    const double survival = p.sf_gradient(t_res,d_eff,sf_dt,sf_dd);
+    const double iNpe = floor(Npe+0.5);
+    //product rule on pdf*iNpe*sf^(iNpe-1), iNpe is at least 2
+    const double sf_pow = std::pow(survival,iNpe-2);
+    dt = iNpe*sf_pow*(survival*pdf_dt + (iNpe-1)*spepdf*sf_dt);
+    dd = iNpe*sf_pow*(survival*pdf_dd + (iNpe-1)*spepdf*sf_dd);
+    return spepdf*iNpe*std::pow(survival,iNpe-1);
+  }
+}
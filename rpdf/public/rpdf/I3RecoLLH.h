@@ -36,16 +36,26 @@ class I3RecoLLH : public I3EventLogLikelihoodBase {
   /**
    * Structure for caching the information needed to calculate the likelihood.
    * This data is the same regardless of the hypothesis so it is computed once
-   * per event and cached so it doesn't have to be calculated for each iteration
+   * per event and cached so it doesn't have to be calculated for each iteration.
+   * It is stored as one array per quantity so the loops over the hits in
+   * GetLogLikelihood() run over contiguous memory.
    */
   struct I3HitCache
   {
-    ///Total number of Photoelectrons observed by the DOM in the event
-    double total_npe;
-    ///The time of the first pulsse
-    double first_pulse_time;
-    ///position of the DOM
-    I3Position pos;
+    ///position of each DOM
+    std::vector<double> x, y, z;
+    ///The time of the first pulse of each DOM
+    std::vector<double> first_pulse_time;
+    ///Total number of Photoelectrons observed by each DOM in the event
+    std::vector<double> total_npe;
+    ///The hits which need the survival function: for MPE these are the
+    ///DOMs with more than one photoelectron, for SPE1st there are none
+    std::vector<size_t> mpe_hits;
+    ///The rounded number of photoelectrons of each of the mpe_hits
+    std::vector<double> mpe_npe;
+
+    void clear();
+    size_t size() const { return x.size(); }
   };
 
   ///A descriptive string representing the instance of this class
@@ -63,14 +73,28 @@ class I3RecoLLH : public I3EventLogLikelihoodBase {
 
   ///The ice model object to store the optical properties in
   const rpdf::IceModel ice_model_;
-  ///Instance of the DOM likelihood function object
-  rpdf::DOMLikelihoodFunction dom_likelihood_func_;
+  ///Instance of the DOM likelihood function object, for the gradient
+  rpdf::DOMLikelihoodGradientFunction dom_likelihood_gradient_;
   ///Instance of the Photoelectron probability function object
   std::shared_ptr<rpdf::PhotoElectronProbability> pe_prob_;
   ///A pointer to the geometry to store
   I3GeometryConstPtr geoptr_;
-  ///a list of the pertinent information for each hit in an event stored in a vector for fast access
-  std::vector<I3HitCache> hit_cache_;
+  ///the pertinent information for each hit in an event stored in vectors for fast access
+  I3HitCache hit_cache_;
+  ///The time residual and effective distance of each hit for the current hypothesis
+  std::vector<double> t_res_, deff_;
+  ///The likelihood of each hit for the current hypothesis, without noise
+  std::vector<double> dom_likelihood_;
+  ///Scratch space for the survival function of the mpe_hits
+  std::vector<double> mpe_t_res_, mpe_deff_, mpe_survival_;
+
+  /**
+   * Fill dom_likelihood_ from t_res_ and deff_ and sum the logs of the
+   * DOM likelihoods plus noise. This is the same as summing SPEfunc or
+   * MPEfunc over the hits, with the Pandel function evaluated for all
+   * hits at once.
+   */
+  double SumLogLikelihood();
 
  public:
   /**
@@ -127,6 +151,26 @@ class I3RecoLLH : public I3EventLogLikelihoodBase {
    */
   double GetLogLikelihood( const I3EventHypothesis &event_hypothesis);
 
+  /**
+   * Calculate the log likelihood and add weight times its derivatives
+   * with respect to the time, vertex and direction of the track to the
+   * corresponding fields of gradient. The derivatives of the geometry are
+   * calculated exactly with dual numbers, those of the photoelectron
+   * probability by PhotoElectronProbability::pdf_gradient().
+   *
+   * @param event_hypothesis the hypothesis to calculate the likelihood for
+   * @param gradient the hypothesis to add the derivatives to
+   * @param weight the weight of the derivatives
+   *
+   * @returns the likelihood of the hypothesis
+   */
+  double GetLogLikelihoodWithGradient( const I3EventHypothesis &event_hypothesis,
+                                       I3EventHypothesis &gradient,
+                                       double weight=1);
+
+  /// @returns true, the gradient is implemented
+  bool HasGradient();
+
   /**
    * @returns the multiplicity of the event in question:
    * the number of hit DOMs
@@ -12,6 +12,8 @@
  *
  */
 
+#include <array>
+#include <cmath>
 #include <utility>
 #include "dataclasses/I3Constants.h"
 class I3Position;
@@ -139,5 +141,64 @@ namespace rpdf{
                                          const I3Particle& track,
                                          const IceModel& ice_model);
 
+  /**
+   * @brief The same calculation as muon_geometry(), for a track given by
+   * its vertex, direction and time in any scalar type.
+   *
+   * Evaluating this with gulliver::Dual instead of double gives the
+   * derivatives of both parameters with respect to the track parameters,
+   * which is how I3RecoLLH calculates its gradient.
+   *
+   * @param om_x,om_y,om_z the position of the optical module being hit
+   * @param pos the vertex of the track
+   * @param dir the unit vector in the direction of the track
+   * @param time the time of the track at the vertex
+   * @param ice_model the model used to describe the optical properties of the ice
+   *
+   * @returns the time at which a direct photon arrives at the OM and the
+   * effective distance, see muon_geometry()
+   */
+  template <typename T>
+  std::pair<T,T> track_geometry(const double om_x,
+                                const double om_y,
+                                const double om_z,
+                                const std::array<T,3>& pos,
+                                const std::array<T,3>& dir,
+                                const T& time,
+                                const IceModel& ice_model)
+  {
+    using std::hypot;
+    using std::pow;
+
+    const T dx = om_x - pos[0];
+    const T dy = om_y - pos[1];
+    const T dz = om_z - pos[2];
+
+    const T d_track = dx*dir[0] + dy*dir[1] + dz*dir[2];
+    const T d_approach = hypot(hypot(dy*dir[2]-dz*dir[1],
+                                     dz*dir[0]-dx*dir[2]),
+                               dx*dir[1]-dy*dir[0]);
+
+    //see cherenkov_time()
+    const T t_geo = time +
+      (d_track + d_approach*constants::EFF_TAN_CHERENKOV)/constants::C_VACUUM;
+
+    T coseta(0.0);
+    if (d_approach>0.0){
+      const T d_travel    = d_approach/constants::SIN_CHERENKOV;
+      const T d_to_vertex = d_track-d_approach/constants::TAN_CHERENKOV;
+      const T d_travel_z  = dz - d_to_vertex*dir[2];
+      coseta              = d_travel_z/d_travel;
+    }
+
+    //see effective_distance()
+    const T eff_distance = (ice_model.P1*d_approach
+                            + ice_model.P0_CS0
+                            + ice_model.P0_CS1*coseta
+                            + ice_model.P0_CS2*pow(coseta,2));
+
+    return std::make_pair(t_geo,eff_distance);
+  }
+
 }
 #endif
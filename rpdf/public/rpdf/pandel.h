@@ -93,6 +93,43 @@ namespace rpdf{
      * @return the probability of a photon arriving at t>=t_res
      */
     virtual double sf (const double t, const double d)const=0;
+
+    /**
+     * @brief the pdf together with its partial derivatives.
+     *
+     * The default implementation uses central differences, subclasses which
+     * know the derivatives analytically should override it.
+     *
+     * @param t_res the time residual of the of a photon which hits a DOM
+     * @param eff_distance the effective distance of the DOM from the track
+     * @param dt returns the derivative with respect to t_res
+     * @param dd returns the derivative with respect to eff_distance
+     *
+     * @returns the probability density of a photon arriving at t=t_res
+     */
+    virtual double pdf_gradient(const double t, const double d,
+                                double& dt, double& dd)const;
+
+    /**
+     * @brief the survival function together with its partial derivatives,
+     * see pdf_gradient()
+     */
+    virtual double sf_gradient(const double t, const double d,
+                               double& dt, double& dd)const;
+
+    /**
+     * @brief evaluate pdf() for n hits at once: out[i]=pdf(t[i],d[i]).
+     *
+     * This is what I3RecoLLH calls for every hypothesis. The default
+     * implementation calls the virtual pdf() for every hit, subclasses
+     * override it with a loop the compiler can inline.
+     */
+    virtual void pdf_batch(const size_t n, const double* t, const double* d,
+                           double* out)const;
+
+    /// @brief evaluate sf() for n hits at once, see pdf_batch()
+    virtual void sf_batch(const size_t n, const double* t, const double* d,
+                          double* out)const;
   };
 
   /**
@@ -147,6 +184,11 @@ namespace rpdf{
      * @return the probability of a photon arriving at t>=t_res
      */
     virtual double sf (const double t_res, const double eff_distance)const;
+
+    virtual void pdf_batch(const size_t n, const double* t, const double* d,
+                           double* out)const;
+    virtual void sf_batch(const size_t n, const double* t, const double* d,
+                          double* out)const;
   };
 
   /**
@@ -188,6 +230,32 @@ namespace rpdf{
      * @return the probability of a photon arriving at t>=t_res
      */
     virtual double sf (const double t, const double d)const;
+
+    /**
+     * the pdf and its exact derivatives: with xi=d/scattering_length
+     * d(pdf)/dt = pdf*((xi-1)/t-rho) and
+     * d(pdf)/dxi = pdf*(log(rho*t)-digamma(xi))
+     */
+    virtual double pdf_gradient(const double t, const double d,
+                                double& dt, double& dd)const;
+
+    /**
+     * the survival function and its derivatives, d(sf)/dt is -pdf and
+     * d(sf)/dd is calculated numerically
+     */
+    virtual double sf_gradient(const double t, const double d,
+                               double& dt, double& dd)const;
+
+    /**
+     * pdf() for n hits, evaluating the gamma distribution directly as
+     * rho*exp((xi-1)*log(rho*t)-rho*t-lgamma(xi)) instead of through boost.
+     * The relative difference to pdf() is at the 1e-12 level, much less
+     * than the precision the likelihood needs.
+     */
+    virtual void pdf_batch(const size_t n, const double* t, const double* d,
+                           double* out)const;
+    virtual void sf_batch(const size_t n, const double* t, const double* d,
+                          double* out)const;
   };
 
   struct SPEfunc {
@@ -234,5 +302,30 @@ namespace rpdf{
     double (const PhotoElectronProbability& p, const double t_res,
             const double d_eff,const double Npe)
     > DOMLikelihoodFunction;
+
+  /**
+   * @brief The SPE1st likelihood for an individual DOM together with its
+   * derivatives with respect to t_res and eff_distance, see SPEfunc
+   */
+  struct SPEgradient {
+    double operator()(const PhotoElectronProbability& p, const double t_res,
+                      const double eff_distance, const double Npe,
+                      double& dt, double& dd) const;
+  };
+
+  /**
+   * @brief The MPE likelihood for an individual DOM together with its
+   * derivatives with respect to t_res and eff_distance, see MPEfunc
+   */
+  struct MPEgradient {
+    double operator()(const PhotoElectronProbability& p, const double t_res,
+                      const double eff_distance, const double Npe,
+                      double& dt, double& dd) const;
+  };
+  ///function declaration for the DOM Likelihoods with derivatives
+  typedef boost::function<
+    double (const PhotoElectronProbability& p, const double t_res,
+            const double d_eff,const double Npe, double& dt, double& dd)
+    > DOMLikelihoodGradientFunction;
 }
 #endif
@@ -0,0 +1,113 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+"""Unit tests for the gradient of `icecube.rpdf.I3RecoLLH`
+
+"""
+import unittest
+
+import numpy as np
+from icecube import dataclasses, gulliver, icetray, rpdf
+
+
+class TestRecoLLHGradient(unittest.TestCase):
+    """Compare `GetLogLikelihoodWithGradient` to numerical derivatives
+
+    """
+    def setUp(self):
+        rng = np.random.RandomState(42)
+        self.geometry = dataclasses.I3Geometry()
+        self.pulses = dataclasses.I3RecoPulseSeriesMap()
+
+        for om in range(1, 31):
+            key = icetray.OMKey(1 + om % 3, om)
+            omgeo = dataclasses.I3OMGeo()
+            omgeo.position = dataclasses.I3Position(
+                *rng.uniform(-100., 100., 3))
+            self.geometry.omgeo[key] = omgeo
+
+            pulse = dataclasses.I3RecoPulse()
+            pulse.time = rng.uniform(50., 500.)
+            pulse.charge = rng.uniform(0.5, 5.)
+            pulse.width = 1.
+            self.pulses[key] = dataclasses.I3RecoPulseSeries([pulse])
+
+        self.track = dataclasses.I3Particle(
+            dataclasses.I3Position(10., -20., 5.),
+            dataclasses.I3Direction(1.2, 2.5), 0.)
+        self.track.shape = dataclasses.I3Particle.InfiniteTrack
+
+    def llh(self, likelihood, peprob):
+        llh = rpdf.I3RecoLLH("pulses", likelihood, peprob, 4.,
+                             10.*icetray.I3Units.hertz, rpdf.H2)
+        llh.set_geometry(self.geometry)
+        llh.set_pulse_map(self.pulses)
+        return llh
+
+    @staticmethod
+    def zero_gradient():
+        gradient = dataclasses.I3Particle()
+        gradient.pos = dataclasses.I3Position(0., 0., 0.)
+        gradient.dir = dataclasses.I3Direction(0., 0.)
+        gradient.time = 0.
+        gradient.energy = 0.
+        return gulliver.I3EventHypothesis(gradient)
+
+    def numerical(self, llh, name, h):
+        values = []
+        for sign in (+1, -1):
+            params = {
+                "time": self.track.time, "x": self.track.pos.x,
+                "y": self.track.pos.y, "z": self.track.pos.z,
+                "zenith": self.track.dir.zenith,
+                "azimuth": self.track.dir.azimuth}
+            params[name] += sign*h
+            track = dataclasses.I3Particle(
+                dataclasses.I3Position(
+                    params["x"], params["y"], params["z"]),
+                dataclasses.I3Direction(
+                    params["zenith"], params["azimuth"]),
+                params["time"])
+            track.shape = dataclasses.I3Particle.InfiniteTrack
+            values.append(
+                llh.GetLogLikelihood(gulliver.I3EventHypothesis(track)))
+        return (values[0] - values[1])/(2.*h)
+
+    def check(self, likelihood, peprob):
+        llh = self.llh(likelihood, peprob)
+        self.assertTrue(llh.HasGradient())
+
+        hypothesis = gulliver.I3EventHypothesis(self.track)
+        gradient = self.zero_gradient()
+        value = llh.GetLogLikelihoodWithGradient(hypothesis, gradient, 2.)
+        self.assertEqual(value, llh.GetLogLikelihood(hypothesis))
+
+        g = gradient.particle
+        analytic = {
+            "time": g.time, "x": g.pos.x, "y": g.pos.y, "z": g.pos.z,
+            "zenith": g.dir.zenith, "azimuth": g.dir.azimuth}
+        steps = {"time": 1e-3, "x": 1e-3, "y": 1e-3, "z": 1e-3,
+                 "zenith": 1e-6, "azimuth": 1e-6}
+
+        for name, h in steps.items():
+            expected = 2.*self.numerical(llh, name, h)
+            self.assertAlmostEqual(
+                analytic[name], expected,
+                delta=1e-3*max(1., abs(expected)),
+                msg="%s %s d/d%s" % (likelihood, peprob, name))
+
+    def test_spe_unconvoluted(self):
+        self.check("SPE1st", "UnconvolutedPandel")
+
+    def test_mpe_unconvoluted(self):
+        self.check("MPE", "UnconvolutedPandel")
+
+    def test_spe_convoluted(self):
+        self.check("SPE1st", "GaussConvoluted")
+
+    def test_mpe_convoluted(self):
+        self.check("MPE", "GaussConvoluted")
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,99 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+"""Unit tests for `icecube.rpdf.I3RecoLLH`
+
+"""
+from math import floor, log
+import unittest
+
+import numpy as np
+from icecube import dataclasses, gulliver, icetray, rpdf
+
+
+class TestRecoLLH(unittest.TestCase):
+    """Compare `I3RecoLLH` to the likelihood summed up hit by hit
+
+    The likelihood service evaluates all hits at once, with a faster
+    evaluation of the unconvoluted Pandel function, the result has to
+    agree with `pdf` and `sf` of the photoelectron probabilities.
+
+    """
+    noise = 10.*icetray.I3Units.hertz
+
+    def setUp(self):
+        rng = np.random.RandomState(1)
+        self.geometry = dataclasses.I3Geometry()
+        self.pulses = dataclasses.I3RecoPulseSeriesMap()
+
+        for om in range(1, 61):
+            key = icetray.OMKey(1 + om % 5, om)
+            omgeo = dataclasses.I3OMGeo()
+            omgeo.position = dataclasses.I3Position(
+                *rng.uniform(-300., 300., 3))
+            self.geometry.omgeo[key] = omgeo
+
+            series = dataclasses.I3RecoPulseSeries()
+            for i in range(rng.randint(1, 4)):
+                pulse = dataclasses.I3RecoPulse()
+                pulse.time = rng.uniform(-200., 2000.)
+                pulse.charge = rng.uniform(0.2, 3.)
+                pulse.width = 1.
+                series.append(pulse)
+            self.pulses[key] = series
+
+        self.tracks = [
+            dataclasses.I3Particle(
+                dataclasses.I3Position(*rng.uniform(-100., 100., 3)),
+                dataclasses.I3Direction(
+                    rng.uniform(0., np.pi), rng.uniform(0., 2.*np.pi)),
+                rng.uniform(-100., 100.))
+            for i in range(10)]
+
+    def reference(self, track, likelihood, peprob):
+        llh = 0.
+        for key, series in self.pulses.items():
+            pos = self.geometry.omgeo[key].position
+            t_geo, deff = rpdf.muon_geometry(pos, track, rpdf.H2)
+            t_res = min(p.time for p in series) - t_geo
+            npe = sum(p.charge for p in series)
+
+            dom = peprob.pdf(t_res, deff)
+            if likelihood == "MPE" and npe >= 1.5:
+                n = floor(npe + 0.5)
+                dom *= n*peprob.sf(t_res, deff)**(n - 1)
+            llh += log(dom + self.noise)
+        return llh
+
+    def check(self, likelihood, peprob_name, peprob):
+        llh = rpdf.I3RecoLLH("pulses", likelihood, peprob_name, 4.,
+                             self.noise, rpdf.H2)
+        llh.set_geometry(self.geometry)
+        llh.set_pulse_map(self.pulses)
+        self.assertEqual(llh.get_multiplicity(), len(self.pulses))
+
+        for track in self.tracks:
+            expected = self.reference(track, likelihood, peprob)
+            value = llh.get_log_likelihood(gulliver.I3EventHypothesis(track))
+            self.assertAlmostEqual(value, expected,
+                                   delta=1e-10*abs(expected))
+
+    def test_spe_unconvoluted(self):
+        self.check("SPE1st", "UnconvolutedPandel",
+                   rpdf.UnconvolutedPandel(rpdf.H2))
+
+    def test_mpe_unconvoluted(self):
+        self.check("MPE", "UnconvolutedPandel",
+                   rpdf.UnconvolutedPandel(rpdf.H2))
+
+    def test_spe_convoluted(self):
+        self.check("SPE1st", "GaussConvoluted",
+                   rpdf.FastConvolutedPandel(4., rpdf.H2))
+
+    def test_mpe_convoluted(self):
+        self.check("MPE", "GaussConvoluted",
+                   rpdf.FastConvolutedPandel(4., rpdf.H2))
+
+
+if __name__ == "__main__":
+    unittest.main()
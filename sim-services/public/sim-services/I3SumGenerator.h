@@ -45,6 +45,15 @@ class I3SumGenerator
    *@param terms   Number of terms in the sum
    */
   double Generate(int terms);
+  /**
+   *@brief Generate the value of a sum of random numbers, drawing from the 
+   * given random service instead of the one passed at initialisation.
+   * The lookup tables are only read, so this may be called concurrently
+   * with different random services.
+   *@param terms   Number of terms in the sum
+   *@param random  Random number service to draw from
+   */
+  double Generate(int terms, I3RandomService& random) const;
 
   /**
    *@brief      Initialise a SumGenerator
@@ -25,6 +25,7 @@
 #include "tableio/converter/I3EventHeaderConverter.h"
 #include "tableio/converter/I3WaveformSeriesMapConverter.h"
 #include "tableio/converter/I3FilterResultMapConverter.h"
+#include "tableio/converter/I3SuperDSTConverter.h"
 
 #include "dataclasses/I3MapOMKeyMask.h"
 
@@ -75,6 +76,7 @@ void register_dataclasses_converters() {
     typedef I3MapOMKeyVectorConverter< convert::I3RecoPulse > I3RecoPulseSeriesMapConverter;
     I3_MAP_CONVERTER_EXPORT_DEFAULT(I3RecoPulseSeriesMapConverter,"Dumps all RecoPulses verbatim.");
     I3_MAP_CONVERTER_EXPORT_DEFAULT(I3RecoPulseSeriesMapMaskConverter,"Applies the mask, then dumps the resulting RecoPulses verbatim.");
+    I3_MAP_CONVERTER_EXPORT_DEFAULT(I3SuperDSTConverter,"Dumps the pulses in an I3SuperDST verbatim, without unpacking them into a RecoPulseSeriesMap.");
     typedef I3MapOMKeyVectorConverter< convert::I3RecoHit > I3RecoHitSeriesMapConverter;
     I3_MAP_CONVERTER_EXPORT_DEFAULT(I3RecoHitSeriesMapConverter,"Dumps all RecoHits verbatim.");
     typedef I3MapOMKeyVectorConverter< convert::I3MCHit > I3MCHitSeriesMapConverter;
@@ -11,6 +11,7 @@
 
 #include <icetray/I3Frame.h>
 #include <dataclasses/physics/I3RecoPulse.h>
+#include <dataclasses/payload/I3SuperDST.h>
 
 #include "tableio/I3TableWriter.h"
 #include "tableio/I3TableService.h"
@@ -22,10 +23,13 @@
 
 // Some things can pretend to be I3RecoPulseSeriesMaps, and we want them
 // to do that, so wrap frame->Get(). Any similar future hacks should also
-// go here.
+// go here. I3SuperDST has a converter of its own that reads the pulses
+// straight from the compressed data, so hand it over as it is.
 inline I3FrameObjectConstPtr GetFrameObject(I3FramePtr frame, std::string name)
 {
-    I3FrameObjectConstPtr object = frame->Get<I3RecoPulseSeriesMapConstPtr>(name);
+    I3FrameObjectConstPtr object = frame->Get<I3SuperDSTConstPtr>(name);
+    if (!object)
+        object = frame->Get<I3RecoPulseSeriesMapConstPtr>(name);
     if (!object)
         object = frame->Get<I3FrameObjectConstPtr>(name);
 
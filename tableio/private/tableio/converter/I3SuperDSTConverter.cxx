@@ -0,0 +1,116 @@
+/**
+ * copyright  (C) 2010
+ * The Icecube Collaboration
+ *
+ * $Id$
+ *
+ * @version $Revision$
+ * @date $LastChangedDate$
+ * @author Jakob van Santen <vansanten@wisc.edu> $LastChangedBy$
+ */
+
+#include "tableio/converter/I3SuperDSTConverter.h"
+
+#include <dataclasses/geometry/I3Geometry.h>
+#include <icetray/I3Frame.h>
+
+/******************************************************************************/
+
+I3SuperDSTConverter::I3SuperDSTConverter(bool bookGeometry)
+  : I3ConverterImplementation<I3SuperDST>(),
+    bookGeometry_(bookGeometry), unpacked_(NULL)
+{}
+
+/******************************************************************************/
+
+I3TableRowDescriptionPtr I3SuperDSTConverter::CreateDescription(const I3SuperDST& superdst)
+{
+  I3TableRowDescriptionPtr desc = I3TableRowDescriptionPtr(new I3TableRowDescription() );
+  desc->isMultiRow_ = true;
+  desc->AddField<int32_t>("string", "", "String number");
+  desc->AddField<uint32_t>("om", "", "OM number");
+  desc->AddField<uint32_t>("pmt", "", "PMT number");
+  if (bookGeometry_) {
+    desc->AddField<double>("x", "m", "X coordinate of the DOM");
+    desc->AddField<double>("y", "m", "Y coordinate of the DOM");
+    desc->AddField<double>("z", "m", "Z coordinate of the DOM");
+  }
+  desc->AddField<tableio_size_t>("vector_index", "", "index in vector");
+  desc->AddField<double>("time", "ns", "Leading-edge time of the pulse");
+  desc->AddField<double>("width", "ns", "Duration of the pulse");
+  desc->AddField<double>("charge", "PE", "Integrated pulse charge");
+
+  return desc;
+}
+
+/******************************************************************************/
+
+size_t I3SuperDSTConverter::GetNumberOfRows(const I3SuperDST& superdst)
+{
+  // I3TableWriter asks for the number of rows right before FillRows(),
+  // so unpack once here and keep the columns for the fill.
+  superdst.UnpackColumns(columns_);
+  unpacked_ = &superdst;
+
+  return columns_.GetNumberOfPulses();
+}
+
+/******************************************************************************/
+
+size_t I3SuperDSTConverter::FillRows(const I3SuperDST& superdst, I3TableRowPtr rows)
+{
+  static int nGeometryWarnings = 0;
+
+  if (unpacked_ != &superdst)
+    superdst.UnpackColumns(columns_);
+  unpacked_ = NULL;
+
+  I3GeometryConstPtr geometry;
+  if (bookGeometry_) {
+    if (!currentFrame_)  // obsolete check?
+      log_fatal("Trying to book geometry, but the current frame is not set.");
+    geometry = currentFrame_->Get<I3GeometryConstPtr>();
+    if (!geometry) {
+      log_error("%s: No geometry in frame", __PRETTY_FUNCTION__);
+      return 0;
+    }
+  }
+
+  size_t index = 0;
+  for (size_t i = 0; i < columns_.GetNumberOfDOMs(); i++) {
+    const OMKey &key = columns_.doms[i];
+    I3OMGeo omgeo;
+
+    if (bookGeometry_) {
+      I3OMGeoMap::const_iterator geoiter = geometry->omgeo.find(key);
+      if (geoiter == geometry->omgeo.end()) {
+        log_warn("%s: OMKey (%d,%d, %d) not in geometry!", __PRETTY_FUNCTION__,
+                 key.GetString(), key.GetOM(),
+                 static_cast<uint32_t>(key.GetPMT()));
+        ++nGeometryWarnings;
+        if (nGeometryWarnings >= 100)
+          log_info("Warned 100 times. Will suppress any further warnings.");
+      } else {
+        omgeo = geoiter->second;
+      }
+    }
+
+    for (uint32_t j = columns_.offsets[i]; j < columns_.offsets[i+1]; j++) {
+      rows->SetCurrentRow(index++);
+      rows->Set<int32_t>("string", key.GetString());
+      rows->Set<uint32_t>("om", key.GetOM());
+      rows->Set<uint32_t>("pmt", static_cast<uint32_t>(key.GetPMT()));
+      if (bookGeometry_) {
+        rows->Set<double>("x", omgeo.position.GetX());
+        rows->Set<double>("y", omgeo.position.GetY());
+        rows->Set<double>("z", omgeo.position.GetZ());
+      }
+      rows->Set<tableio_size_t>("vector_index", j - columns_.offsets[i]);
+      rows->Set<double>("time", columns_.times[j]);
+      rows->Set<double>("width", columns_.widths[j]);
+      rows->Set<double>("charge", columns_.charges[j]);
+    }
+  }
+
+  return index;
+}
@@ -0,0 +1,39 @@
+/**
+ * copyright  (C) 2010
+ * The Icecube Collaboration
+ *
+ * $Id$
+ *
+ * @version $Revision$
+ * @date $LastChangedDate$
+ * @author Jakob van Santen <vansanten@wisc.edu> $LastChangedBy$
+ */
+
+#ifndef TABLEIO_I3SUPERDSTCONVERTER_H_INCLUDED
+#define TABLEIO_I3SUPERDSTCONVERTER_H_INCLUDED
+
+#include "tableio/I3Converter.h"
+#include "dataclasses/payload/I3SuperDST.h"
+
+/**
+ * Dumps the pulses in an I3SuperDST with the same columns as the
+ * I3RecoPulseSeriesMap converter, but reads them from the column
+ * representation filled by I3SuperDST::UnpackColumns() instead of
+ * unpacking a pulse map for every frame.
+ */
+class I3SuperDSTConverter : public I3ConverterImplementation< I3SuperDST > {
+public:
+    I3SuperDSTConverter(bool bookGeometry = false);
+
+private:
+    I3TableRowDescriptionPtr CreateDescription(const I3SuperDST& superdst);
+    size_t FillRows(const I3SuperDST& superdst, I3TableRowPtr rows);
+    size_t GetNumberOfRows(const I3SuperDST& superdst);
+
+    bool bookGeometry_;
+    /* Reused for every frame; filled in GetNumberOfRows() */
+    I3SuperDSTPulseColumns columns_;
+    const I3SuperDST *unpacked_;
+};
+
+#endif // TABLEIO_I3SUPERDSTCONVERTER_H_INCLUDED
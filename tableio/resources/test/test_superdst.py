@@ -0,0 +1,64 @@
+#!/usr/bin/env python
+
+# Ensure that I3SuperDST is booked from its unpacked columns with the same
+# rows as the pulse map it decodes to.
+
+from icecube import icetray, dataclasses, dataio, tableio
+import os, shutil
+
+import I3Tray
+
+tray = I3Tray.I3Tray()
+
+tray.AddModule("I3InfiniteSource", "source", stream=icetray.I3Frame.Physics)
+
+def fakeit(frame):
+	header = dataclasses.I3EventHeader()
+	frame['I3EventHeader'] = header
+	pulsemap = dataclasses.I3RecoPulseSeriesMap()
+	for i, key in enumerate([icetray.OMKey(7,42), icetray.OMKey(9,42), icetray.OMKey(21,1)]):
+		pulses = dataclasses.I3RecoPulseSeries()
+		for j in range(i+1):
+			pulse = dataclasses.I3RecoPulse()
+			pulse.time = 10000. + 100*i + 30*j
+			pulse.charge = 1.5 + j
+			pulse.width = 3.
+			pulse.flags = int(dataclasses.I3RecoPulse.PulseFlags.LC)
+			pulses.append(pulse)
+		pulsemap[key] = pulses
+	superdst = dataclasses.I3SuperDST(pulsemap)
+	frame['SuperDST'] = superdst
+	frame['Unpacked'] = superdst.unpack()
+	
+	unpacked = superdst.unpack()
+	columns = superdst.unpack_columns()
+	assert len(columns) == sum(len(v) for v in unpacked.values())
+	assert columns.doms == list(unpacked.keys())
+	offsets = columns.offsets
+	for i, (key, pulses) in enumerate(unpacked.items()):
+		assert offsets[i+1] - offsets[i] == len(pulses)
+		for j, pulse in enumerate(pulses):
+			assert columns.times[offsets[i]+j] == pulse.time
+			assert abs(columns.charges[offsets[i]+j] - pulse.charge) < 1e-6
+			assert abs(columns.widths[offsets[i]+j] - pulse.width) < 1e-6
+			assert columns.flags[offsets[i]+j] == pulse.flags
+	
+tray.AddModule(fakeit, 'fakeit')
+
+dirname = os.environ['I3_BUILD'] + '/tableio/superdst_test'
+tabler = tableio.I3CSVTableService(dirname)
+
+tray.AddModule(tableio.I3TableWriter, 'scribe',
+	tableservice=tabler,
+	keys=['SuperDST', 'Unpacked'],
+	)
+
+tray.Execute(3)
+
+try:
+	superdst = open(os.path.join(dirname, 'SuperDST.csv')).read()
+	unpacked = open(os.path.join(dirname, 'Unpacked.csv')).read()
+	assert len(superdst.splitlines()) > 3*6
+	assert superdst == unpacked, "I3SuperDST rows match those of the unpacked pulse map"
+finally:
+	shutil.rmtree(dirname)
@@ -28,6 +28,9 @@
 #include "phys-services/source/I3GCDFileService.h"
 
 #include "toprec/I3LaputopLikelihood.h"
+#include "toprec/I3SnowCorrectionService.h"
+#include <recclasses/I3LaputopParams.h>
+#include <cmath>
 
 // Let's create a hypothetical pulseseries!
 // I stole these from an IT73 event, from my little testfile "Level2a_Laputop_IT73_0718_116195.i3"
@@ -306,3 +309,109 @@ TEST(BadStationBadTank)
   ENSURE(psat.size() == 2);
 
 }
+
+namespace {
+
+I3EventHypothesis LaputopHypothesis(double x, double y, double zenith,
+                                    double logs125, double beta) {
+  I3ParticlePtr track(new I3Particle);
+  track->SetPos(x, y, 1946.);
+  track->SetDir(zenith, 1.2);
+  track->SetTime(10143.);
+  I3LaputopParamsPtr params(new I3LaputopParams);
+  params->SetValue(Laputop::Parameter::Log10_S125, logs125);
+  params->SetValue(Laputop::Parameter::Beta, beta);
+  return I3EventHypothesis(track, params);
+}
+
+}
+
+TEST(SnowCorrectionCache)
+{
+  // The tank tables and snow corrections are kept between calls.  Whatever
+  // the order of the hypotheses, the likelihood has to be the same as the
+  // one of a fresh service which never saw another hypothesis.
+  std::string gcd(getenv("I3_TESTDATA"));
+  gcd = gcd+"/GCD/GeoCalibDetectorStatus_IC79.55380_corrected.i3.gz";
+  I3FramePtr frame(new I3Frame(I3Frame::Physics));
+  I3Time time1(2010,171195332233603703ULL );
+  I3GCDFileGeometryService geoservice(gcd);
+  frame->Put("I3Geometry", geoservice.GetGeometry(time1), I3Frame::Geometry);
+  I3GCDFileCalibrationService calibservice(gcd);
+  frame->Put("I3Calibration", calibservice.GetCalibration(time1), I3Frame::Calibration);
+  I3GCDFileDetectorStatusService detstatservice(gcd);
+  frame->Put("I3DetectorStatus", detstatservice.GetDetectorStatus(time1), I3Frame::DetectorStatus);
+  frame->Put("FakePulseSeriesMap", testPSM_tweaked());
+
+  std::vector<I3EventHypothesis> hypotheses;
+  hypotheses.push_back(LaputopHypothesis(-200., 200., 0.3, 0.5, 3.0));
+  hypotheses.push_back(LaputopHypothesis(-200., 200., 0.3, 0.8, 3.0));  // only S125
+  hypotheses.push_back(LaputopHypothesis(-200., 200., 0.3, 0.8, 3.5));  // only beta
+  hypotheses.push_back(LaputopHypothesis(-180., 230., 0.3, 0.8, 3.5));  // only the core
+  hypotheses.push_back(LaputopHypothesis(-180., 230., 0.4, 0.8, 3.5));  // only the direction
+  hypotheses.push_back(LaputopHypothesis(-200., 200., 0.3, 0.5, 3.0));  // back to the start
+
+  I3SnowCorrectionServiceBasePtr snowservices[2] = {
+    I3SnowCorrectionServiceBasePtr(new I3BORSSnowCorrectionService("BORS", false)),
+    I3SnowCorrectionServiceBasePtr(new I3SimpleSnowCorrectionService("Simple", 2.1))};
+
+  I3LaputopLikelihood reused("Laputop");
+  reused.SetReadoutName("FakePulseSeriesMap");
+  for (unsigned s = 0; s < 2; s++) {
+    reused.SetSnowService(snowservices[s]);
+    reused.SetEvent(*frame);
+    for (size_t i = 0; i < hypotheses.size(); i++) {
+      I3LaputopLikelihood fresh("Laputop");
+      fresh.SetReadoutName("FakePulseSeriesMap");
+      fresh.SetSnowService(snowservices[s]);
+      fresh.SetEvent(*frame);
+      const double expected = fresh.GetLogLikelihood(hypotheses[i]);
+      ENSURE(std::isfinite(expected));
+      ENSURE_EQUAL(reused.GetLogLikelihood(hypotheses[i]), expected,
+                   "cached snow corrections must not change the likelihood");
+    }
+  }
+}
+
+TEST(CutsAfterLikelihood)
+{
+  // Cutting pulses after a likelihood call has to drop them from the tank
+  // tables and snow corrections too, as if the cuts had come first.
+  std::string gcd(getenv("I3_TESTDATA"));
+  gcd = gcd+"/GCD/GeoCalibDetectorStatus_IC79.55380_corrected.i3.gz";
+  I3FramePtr frame(new I3Frame(I3Frame::Physics));
+  I3Time time1(2010,171195332233603703ULL );
+  I3GCDFileGeometryService geoservice(gcd);
+  frame->Put("I3Geometry", geoservice.GetGeometry(time1), I3Frame::Geometry);
+  I3GCDFileCalibrationService calibservice(gcd);
+  frame->Put("I3Calibration", calibservice.GetCalibration(time1), I3Frame::Calibration);
+  I3GCDFileDetectorStatusService detstatservice(gcd);
+  frame->Put("I3DetectorStatus", detstatservice.GetDetectorStatus(time1), I3Frame::DetectorStatus);
+  frame->Put("FakePulseSeriesMap", testPSM_tweaked());
+
+  // Put the core on the brightest station, so that the core cut hits it
+  const I3Position core = frame->Get<I3Geometry>().omgeo.find(OMKey(62,61))->second.position;
+  I3EventHypothesis hypo = LaputopHypothesis(core.GetX(), core.GetY(), 0.3, 0.5, 3.0);
+  I3SnowCorrectionServiceBasePtr snowservice(new I3SimpleSnowCorrectionService("Simple", 2.1));
+
+  I3LaputopLikelihood reused("Laputop");
+  reused.SetReadoutName("FakePulseSeriesMap");
+  reused.SetSnowService(snowservice);
+  reused.SetEvent(*frame);
+  ENSURE(std::isfinite(reused.GetLogLikelihood(hypo)));
+  const int ncore = reused.CutCorePulses(hypo, 20.);
+  ENSURE(ncore > 0, "the core cut should remove some tanks");
+  const int ntiming = reused.CutBadTimingPulses(hypo, 200.);
+
+  I3LaputopLikelihood fresh("Laputop");
+  fresh.SetReadoutName("FakePulseSeriesMap");
+  fresh.SetSnowService(snowservice);
+  fresh.SetEvent(*frame);
+  ENSURE_EQUAL(fresh.CutCorePulses(hypo, 20.), ncore);
+  ENSURE_EQUAL(fresh.CutBadTimingPulses(hypo, 200.), ntiming);
+  // Refills the tables from the remaining pulses
+  fresh.SetEvent(*frame);
+
+  ENSURE_EQUAL(reused.GetLogLikelihood(hypo), fresh.GetLogLikelihood(hypo),
+               "the likelihood must not see the cut pulses");
+}
@@ -11,6 +11,7 @@
  *
  */
 #include <cassert>
+#include <algorithm>
 #include "icetray/I3SingleServiceFactory.h"
 #include "toprec/I3LaputopLikelihood.h"
 #include "dataclasses/I3Position.h"
@@ -118,7 +119,8 @@ const double SAT_HG = 3000.;                  // Upper bound for HG in PE (same
 
 
 I3LaputopLikelihood::I3LaputopLikelihood( std::string name ):
-  I3EventLogLikelihoodBase(), I3ServiceBase(name), multiplicity_(0) {
+  I3EventLogLikelihoodBase(), I3ServiceBase(name), multiplicity_(0),
+  tankTablesValid_(false), snowCacheValid_(false) {
 
   // In this constructor, set defaults that will be helpful for running unit tests:
   // (Where one of these gets constructed without a context)
@@ -141,7 +143,8 @@ I3LaputopLikelihood::I3LaputopLikelihood( std::string name ):
 
 // construct self & declare configuration parameters
 I3LaputopLikelihood::I3LaputopLikelihood( const I3Context &context ):
-    I3EventLogLikelihoodBase(), I3ServiceBase(context),multiplicity_(0){
+    I3EventLogLikelihoodBase(), I3ServiceBase(context),multiplicity_(0),
+    tankTablesValid_(false), snowCacheValid_(false){
 
     log_debug( "(%s) hey, this is the likelihood function for "
                "ICETOP", GetName().c_str() );
@@ -330,6 +333,10 @@ int I3LaputopLikelihood::CutBadTimingPulses( const I3EventHypothesis &t, double
   }
   // The no-hits: leave them be, they have no timing likelihood...
 
+  // The tank tables and snow corrections still hold the removed pulses
+  tankTablesValid_ = false;
+  snowCacheValid_ = false;
+
   log_debug("BadTimingCut removed %d pulses total", nremoved);
   return nremoved;
 }  
@@ -402,6 +409,10 @@ int I3LaputopLikelihood::CutCorePulses( const I3EventHypothesis &t, double rcut
     } else { ++it; }
   }
 
+  // The tank tables and snow corrections still hold the removed tanks
+  tankTablesValid_ = false;
+  snowCacheValid_ = false;
+
   log_debug("CoreCut removed %d tanks total", nremoved);
   return nremoved;
 
@@ -415,6 +426,10 @@ void I3LaputopLikelihood::SetEvent( const I3Frame &f ){
   if(inputData_.size() == 0){ // this means new event, because I reset!
     nStation_ = FillInput(f);
   }
+  // Tanks may have been cut since the last call; the snow service may
+  // also have been reset (see TESTMODE_WITH_TRUE_TSTAGE below)
+  FillTankTables();
+  snowCacheValid_ = false;
 
 
 #if TESTMODE_WITH_TRUE_TSTAGE
@@ -527,6 +542,7 @@ unsigned int I3LaputopLikelihood::FillInput(const I3Frame &f){
   }
 
   timeFluctuatingTanks_ = 0;
+  tankTablesValid_ = false;
   // ----- get what is there
   const I3DetectorStatus &status = f.Get<I3DetectorStatus>();
   const I3Geometry &geometry = f.Get<I3Geometry>();
@@ -825,6 +841,87 @@ void I3LaputopLikelihood::ResetInput(){
   inputData_.clear();
   inputEmptyData_.clear();
   saturatedData_.clear();
+  tankTablesValid_ = false;
+  snowCacheValid_ = false;
+}
+
+void I3LaputopLikelihood::TankTable::Fill(const std::vector<tankPulse> &pulses){
+  const size_t n = pulses.size();
+  x.resize(n); y.resize(n); z.resize(n); t.resize(n);
+  logvem.resize(n); snowdepth.resize(n); usepulsetime.resize(n);
+  r.resize(n); delta_t.resize(n); logatt.assign(n, 0.);
+  for (size_t i = 0; i < n; i++) {
+    x[i] = pulses[i].x;
+    y[i] = pulses[i].y;
+    z[i] = pulses[i].z;
+    t[i] = pulses[i].t;
+    logvem[i] = pulses[i].logvem;
+    snowdepth[i] = pulses[i].snowdepth;
+    usepulsetime[i] = pulses[i].usepulsetime;
+  }
+}
+
+void I3LaputopLikelihood::FillTankTables(){
+  hitTable_.Fill(inputData_);
+  emptyTable_.Fill(inputEmptyData_);
+  saturatedTable_.Fill(saturatedData_);
+  tankTablesValid_ = true;
+  snowCacheValid_ = false;
+}
+
+// Same arithmetic as GetDistToAxis and GetDistToPlane, but as one loop over
+// plain arrays which the compiler can vectorize
+void I3LaputopLikelihood::ComputeTankGeometry(TankTable &tanks, double time,
+                                              const I3Position& core, const I3Direction &dir){
+  const double x_c = core.GetX();
+  const double y_c = core.GetY();
+  const double z_c = core.GetZ();
+  const double nx = dir.GetX();
+  const double ny = dir.GetY();
+  const double nz = sqrt(1. - nx*nx - ny*ny);
+
+  const size_t n = tanks.size();
+  const double *x = tanks.x.data();
+  const double *y = tanks.y.data();
+  const double *z = tanks.z.data();
+  const double *t = tanks.t.data();
+  double *r = tanks.r.data();
+  double *delta_t = tanks.delta_t.data();
+  for (size_t i = 0; i < n; i++) {
+    const double dx = x[i]-x_c;
+    const double dy = y[i]-y_c;
+    const double dz = z[i]-z_c;
+    const double abs_x_sq = dx*dx + dy*dy + dz*dz;
+    const double n_prod_x = nx*dx + ny*dy - nz*dz;
+    r[i] = sqrt(abs_x_sq - n_prod_x * n_prod_x);
+    delta_t[i] = (time + n_prod_x/I3Constants::c) - t[i];
+  }
+}
+
+void I3LaputopLikelihood::UpdateSnowCorrections(I3ParticleConstPtr track,
+                                                I3LaputopParamsConstPtr paramPtr){
+  const bool ldfparams = snowservice_->DependsOnLDFParams();
+  const double key[7] = {
+    track->GetPos().GetX(), track->GetPos().GetY(), track->GetPos().GetZ(),
+    track->GetDir().GetZenith(), track->GetDir().GetAzimuth(),
+    ldfparams ? paramPtr->GetValue(Laputop::Parameter::Log10_S125) : 0.,
+    ldfparams ? paramPtr->GetValue(Laputop::Parameter::Beta) : 0.};
+  if (snowCacheValid_ && std::equal(key, key+7, snowCacheKey_)) {
+    log_trace("Reusing the snow corrections of the last call");
+    return;
+  }
+
+  // The saturated tanks are not corrected
+  TankTable *tables[2] = {&hitTable_, &emptyTable_};
+  for (unsigned k = 0; k < 2; k++) {
+    TankTable &tanks = *tables[k];
+    for (size_t i = 0; i < tanks.size(); i++)
+      tanks.logatt[i] = std::log10(snowservice_->AttenuationFactor(
+        I3Position(tanks.x[i], tanks.y[i], tanks.z[i]), tanks.snowdepth[i],
+        *track, *paramPtr));
+  }
+  std::copy(key, key+7, snowCacheKey_);
+  snowCacheValid_ = true;
 }
 
 // compute likelihood
@@ -866,6 +963,8 @@ double I3LaputopLikelihood::GetLogLikelihood( const I3EventHypothesis &t ){
     bool combined_fit = (fCurv != "");  log_trace("Combined fit? %u", combined_fit);
     // Decide: do an LDF fit (with charge), or not?
     bool do_ldf = (fLDF != "");  log_trace("LDF fit? %u", do_ldf);
+    if (do_ldf && fLDF != DLP_NAME)
+      log_fatal("Sorry, no support yet for LDF function %s", fLDF.c_str());
 
     log_debug("Starting llh calculation ...");
     log_debug("X_c=%f, Y_c=%f, log10(S125)=%f, Beta=%f, nx=%f, ny=%f, t0=%f",
@@ -881,67 +980,46 @@ double I3LaputopLikelihood::GetLogLikelihood( const I3EventHypothesis &t ){
     // to use current LateralFitFunctions...
     double par[4] = {coreX,coreY,logS125,beta};    
 
+    // Distances and delays of all tanks first, then the snow corrections,
+    // which are only recomputed when they can have changed
+    if (!tankTablesValid_) FillTankTables();
+    ComputeTankGeometry(hitTable_, time, core, dir);
+    ComputeTankGeometry(emptyTable_, time, core, dir);
+    ComputeTankGeometry(saturatedTable_, time, core, dir);
+    const bool do_snow = do_ldf && snowservice_;
+    if (do_ldf && !snowservice_) log_error("There is no snowservice! Not attenuating!");
+    if (do_snow) UpdateSnowCorrections(track, paramPtr);
+
     // LOOP ONE : OVER THE "NORMAL" PULSES
-    for (std::vector<tankPulse>::iterator ii = inputData_.begin(); ii != inputData_.end(); ii++) {
-      double local_r = GetDistToAxis(core,dir,ii); 
+    for (size_t i = 0; i < hitTable_.size(); i++) {
+      double local_r = hitTable_.r[i];
 
       //////////////////
       //charge-llh :  //
       //////////////////
       if (do_ldf) {
-      double local_ldf;
-      if (fLDF == DLP_NAME) {
-	if ((fCoreCut <= 0.) || (local_r >= core_radius_)) {
-	  // A normal likelihood:
-	  local_ldf = LateralFitFunctions::top_ldf_dlp(local_r, par); 
-
-	} else {
-	  // Let's try this: keeping LLH constant (rather than zero)
-	  // inside the core cut
-	  log_debug("I'm using a radius of %f instead of %f", core_radius_, local_r);
-	  local_ldf = LateralFitFunctions::top_ldf_dlp(core_radius_, par); 
-	}
-      } else
-	log_fatal("Sorry, no support yet for LDF function %s", fLDF.c_str());
+      // Keep the LLH constant (rather than zero) inside the core cut
+      const double ldf_r = ((fCoreCut <= 0.) || (local_r >= core_radius_)) ? local_r : core_radius_;
+      double local_ldf = LateralFitFunctions::top_ldf_dlp(ldf_r, par); 
 
       // Snow-attenuate the expected signal
-      if (!snowservice_) log_error("There is no snowservice! Not attenuating!");
-      else
-	local_ldf = snowservice_->CalculateAttenuatedLogS(local_ldf, *ii, track, paramPtr);
-
+      if (do_snow)
+	local_ldf = local_ldf + hitTable_.logatt[i];
 
       //// ACTUALLY : a TEMP effect goes here as it could change the slope
       //// Or a pressure if it changes the slope of the LDF 
-      /*
-      if(fCorrectAtm_){
-	// Pressure (and temperature) correction
-	// Everything that depends on the signal/tank/distance goes here
-      } 
-      */
-
-
-      double local_sigma_q;
-      if ((fCoreCut <= 0.) || (local_r >= core_radius_)) {
-	local_sigma_q = LateralFitFunctions::top_ldf_sigma(local_r, local_ldf);
-      } else {
-	// Again, keep the LLH constant by using the core_radius_ instead
-	log_debug("Again, I'm using a radius of %f instead of %f", core_radius_, local_r);
-	local_sigma_q = LateralFitFunctions::top_ldf_sigma(core_radius_, local_ldf);
-      }
-      double local_delta_q = (ii->logvem - local_ldf)/local_sigma_q;
-      log_trace("(%d,%d): Normal hit: deltaq=%.9f, sigmaq=%.9f, llh = %.9lf",ii->omkey.GetString(),ii->omkey.GetOM(),
-		local_delta_q, local_sigma_q,
-		local_delta_q*local_delta_q/2.+log(local_sigma_q));
+
+      double local_sigma_q = LateralFitFunctions::top_ldf_sigma(ldf_r, local_ldf);
+      double local_delta_q = (hitTable_.logvem[i] - local_ldf)/local_sigma_q;
       llh += local_delta_q*local_delta_q/2.+log(local_sigma_q);
-      log_trace("(%d,%d): After charge... total llh went up to %lf",ii->omkey.GetString(),ii->omkey.GetOM(),llh);
       }
 
       //////////////////////
       // time-likelihood  //
       //////////////////////
       if(combined_fit){
-	if(ii->usepulsetime){ 
-	  double local_delta_t = GetDistToPlane(time,core,dir,ii);
+	if(hitTable_.usepulsetime[i]){ 
+	  double local_delta_t = hitTable_.delta_t[i];
 	  // Special case: the Kislat function
 	  if (fCurv == KISLAT_NAME) {
 	    double dummypar[1] = {0};
@@ -949,33 +1027,25 @@ double I3LaputopLikelihood::GetLogLikelihood( const I3EventHypothesis &t ){
 	  } else 
 	    // This function chooses the right one based on fCurv:
 	    llh += top_curv_gausspar_llh(local_r, local_delta_t, paramPtr); 
-	  
-	  log_trace("(%d,%d): After timing... total llh went up to %lf",ii->omkey.GetString(),ii->omkey.GetOM(),llh);
 	}
       }
     }  // loop over the "normal hits"
+    log_trace("After the normal hits... total llh went up to %lf", llh);
     
     ////////////////////////////////////
     // likelihood of silent stations  //
     ////////////////////////////////////
     if (do_ldf) {
-    for (std::vector<tankPulse>::iterator ie = inputEmptyData_.begin(); ie != inputEmptyData_.end(); ie++) {
-      double local_r = GetDistToAxis(core,dir,ie);
-      double local_ldf;
-      if (fLDF == DLP_NAME)
-	local_ldf = LateralFitFunctions::top_ldf_dlp(local_r, par); 
-      else
-	log_fatal("Sorry, no support yet for LDF function %s", fLDF.c_str());
+    for (size_t i = 0; i < emptyTable_.size(); i++) {
+      double local_r = emptyTable_.r[i];
+      double local_ldf = LateralFitFunctions::top_ldf_dlp(local_r, par); 
       
       // Snow-attenuate the expected signal
-      if (!snowservice_) log_error("There is no snowservice! Not attenuating!");
-      else
-	local_ldf = snowservice_->CalculateAttenuatedLogS(local_ldf, *ie, track, paramPtr);
-
+      if (do_snow)
+	local_ldf = local_ldf + emptyTable_.logatt[i];
 
       double local_sigma = LateralFitFunctions::top_ldf_sigma(local_r, std::max(local_ldf, logvem_threshold));
       // prob. to find that DOM without a pulse
-      //double local_p_nohit = 0.5*(TMath::Erf((logvem_threshold-local_ldf)/sqrt(2.)/local_sigma)+1.);
       double local_p_nohit = 0.5*(boost::math::erf((logvem_threshold-local_ldf)/sqrt(2.)/local_sigma)+1.);
       // prob. to find that DOM with a pulse
       double local_p_hit = 1.-local_p_nohit;
@@ -983,37 +1053,32 @@ double I3LaputopLikelihood::GetLogLikelihood( const I3EventHypothesis &t ){
       // prob. to find both tanks without a pulse 
       double local_station_nohit = (1.-pow(local_p_hit, 2.));
       
-      //log_trace("No pulse at station %u. Expected pulse height of %f, probability of not triggering is %f",
-      //	      inputShower->GetNoPulses().at(i).stationkey, local_ldf, local_station_nohit);
       if (local_station_nohit == 0.0){
       // use a small number (avoid infinities)
       // need to evaluate this a little more to get a useful number, or to correct the problem, where
       //   it really occurs
 	llh += -log(DBL_MIN);  // The reason for weird bump in the Llh distribution/silent_llh distribution, but looks like a good fit, leave it like this
 	log_trace("This one was a P=0 no-hit! %f whose log is %f", DBL_MIN, log(DBL_MIN));
-	log_trace("(%d,%d): After P=0-no-hit... total llh went up to %lf",ie->omkey.GetString(),ie->omkey.GetOM(),llh);
       }
       else {
-	log_trace("(%d,%d): Not-hit: llh = %.9lf",ie->omkey.GetString(),ie->omkey.GetOM(),
-		  local_station_nohit);
 	llh += -log(local_station_nohit);
-	log_trace("(%d,%d): After no-hit... total llh went up to %lf",ie->omkey.GetString(),ie->omkey.GetOM(),llh);
       }
     }
+    log_trace("After the no-hits... total llh went up to %lf", llh);
     }
     if(fSaturation_){
       ////////////////////////////////////
       // likelihood of saturated tanks //
       ///////////////////////////////////
       
-      for (std::vector<tankPulse>::iterator is = saturatedData_.begin(); is != saturatedData_.end(); is++) {
-	double local_r = GetDistToAxis(core,dir,is); 
+      for (size_t i = 0; i < saturatedTable_.size(); i++) {
+	double local_r = saturatedTable_.r[i];
 
 	//1) Saturated pulses have a good time, use the timellh
 	if(combined_fit) {
-	  double local_delta_t = GetDistToPlane(time,core,dir,is);
+	  double local_delta_t = saturatedTable_.delta_t[i];
 	  
-	  log_trace("(%d,%d): This saturated hit: local_r = %f, local_delta_t = %f", is->omkey.GetString(),is->omkey.GetOM(), local_r, local_delta_t);
+	  log_trace("This saturated hit: local_r = %f, local_delta_t = %f", local_r, local_delta_t);
 	  // Special case: the Kislat function
 	  if (fCurv == KISLAT_NAME) {
 	    double dummypar[1] = {0};
@@ -1030,22 +1095,17 @@ double I3LaputopLikelihood::GetLogLikelihood( const I3EventHypothesis &t ){
 	// Similar as PnoHit Llh.
 	if (do_ldf) {
 	
-	double local_ldf;
-	if (fLDF == DLP_NAME)
-	  local_ldf = LateralFitFunctions::top_ldf_dlp(local_r, par); 
-	else
-	  log_fatal("Sorry, no support yet for LDF function %s", fLDF.c_str());
+	double local_ldf = LateralFitFunctions::top_ldf_dlp(local_r, par); 
 	
 	// No correction for snowdepth : signal could've been only higher, ie. more saturated, some Prob!
 	
 	double local_sigma = LateralFitFunctions::top_ldf_sigma(local_r, local_ldf);
 	// prob. to find that a saturated DOM according to Gaussian around expected signal
-	double logsat = is->logvem;
+	double logsat = saturatedTable_.logvem[i];
 	// The opposite of the PnoHit term calculation. 
-	//double local_p_sat = 0.5*(1.- TMath::Erf( (logsat-local_ldf)/sqrt(2.)/local_sigma) );
 	double local_p_sat = 0.5*(1.- boost::math::erf( (logsat-local_ldf)/sqrt(2.)/local_sigma) );
 		
-	log_trace("Saturation Prob is %lf, for a signal of %lf VEM, when expecting %lf log10(VEM)",local_p_sat,is->logvem,local_ldf);
+	log_trace("Saturation Prob is %lf, for a signal of %lf log10(VEM), when expecting %lf log10(VEM)",local_p_sat,logsat,local_ldf);
 	llh += - local_p_sat;        // also need something like an upperbound, to avoid infinities???
 	}
       }
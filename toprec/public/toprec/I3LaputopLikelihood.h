@@ -143,6 +143,27 @@ class I3LaputopLikelihood : public I3EventLogLikelihoodBase,
   std::vector<tankPulse> inputEmptyData_;  // for noHitLlh (same struct)
   std::vector<tankPulse> saturatedData_;  // for saturationLlh
 
+  // The same tanks as struct-of-arrays, filled once per event, together
+  // with the per-hypothesis quantities computed for all tanks at once.
+  // This keeps the inner loops of GetLogLikelihood on plain arrays.
+  struct TankTable {
+    std::vector<double> x, y, z, t, logvem, snowdepth;
+    std::vector<char> usepulsetime;
+    // distance to the shower axis, delay behind the plane front,
+    // and log10 of the snow attenuation factor
+    std::vector<double> r, delta_t, logatt;
+    void Fill(const std::vector<tankPulse> &pulses);
+    size_t size() const { return x.size(); }
+  };
+  TankTable hitTable_, emptyTable_, saturatedTable_;
+  bool tankTablesValid_;
+
+  // Snow corrections only change with the inputs of the snow service: the
+  // shower geometry, and (unless the service says otherwise) S125 and beta.
+  // They are kept from one likelihood call to the next until these change.
+  bool snowCacheValid_;
+  double snowCacheKey_[7];
+
   // The core cut radius... is fCoreCut most of the time, but 
   // it may become dynamic in the future.
   double core_radius_;
@@ -167,6 +188,14 @@ class I3LaputopLikelihood : public I3EventLogLikelihoodBase,
   // This is computationally the most efficient way!
   double GetDistToAxis(const I3Position& core, const I3Direction &dir,std::vector<tankPulse>::iterator it);
   double GetDistToPlane(const double &time, const I3Position& core, const I3Direction &dir,std::vector<tankPulse>::iterator it);
+
+  // The same as GetDistToAxis and GetDistToPlane, for all tanks of a table
+  void ComputeTankGeometry(TankTable &tanks, double time, const I3Position& core, const I3Direction &dir);
+  // Fill the tank tables from inputData_ and friends
+  void FillTankTables();
+  // Recompute the snow corrections if the hypothesis changed in a way
+  // that matters to the snow service
+  void UpdateSnowCorrections(I3ParticleConstPtr track, I3LaputopParamsConstPtr paramPtr);
   
   // Helper functions used by FillInput:
   void UpdateFillCounts(std::set<StationKey> &setA, std::set<StationKey> &setB, OMKey key);
@@ -223,7 +252,7 @@ public:
     std::vector<tankPulse> GetInputEmptyData() { return inputEmptyData_; }  
     std::vector<tankPulse> GetInputSaturatedData() { return saturatedData_; } 
     void SetReadoutName(std::string name) { fDataReadoutLabel = name; }
-    void SetSnowService(I3SnowCorrectionServiceBasePtr ss) { snowservice_ = ss; }
+    void SetSnowService(I3SnowCorrectionServiceBasePtr ss) { snowservice_ = ss; snowCacheValid_ = false; }
 
     //Some Setters for flexible and efficient use of the same service
     void SetFunction(std::string newLDF){ fLDF=newLDF;}
@@ -48,6 +48,11 @@ class I3SnowCorrectionServiceBase : public I3ServiceBase {
     const
   { return 1.0; }
 
+  /// Whether AttenuationFactor depends on the LDF parameters (S125, beta)
+  /// of the hypothesis, or only on the shower geometry. Laputop keeps the
+  /// corrections of all tanks while the inputs they depend on don't change.
+  virtual bool DependsOnLDFParams() const { return true; }
+
   // Fill the "snow diagnostics" object; this will be called by Laputop at the end.
   virtual void FillSnowDiagnostics(SnowCorrectionDiagnosticsPtr diag, 
                                    I3ParticleConstPtr hypoth,
@@ -109,6 +114,9 @@ class I3SimpleSnowCorrectionService : public I3SnowCorrectionServiceBase {
 				                           const I3Particle&,
                                    const I3LaputopParams&) const;
 
+  /// Only the zenith angle enters the attenuation
+  virtual bool DependsOnLDFParams() const { return false; }
+
   virtual void FillSnowDiagnostics(SnowCorrectionDiagnosticsPtr,
                                    I3ParticleConstPtr,
                                    I3LaputopParamsConstPtr) const;
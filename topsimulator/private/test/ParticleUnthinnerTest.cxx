@@ -0,0 +1,101 @@
+#include <I3Test.h>
+
+#include <topsimulator/injectors/ParticleUnthinner.h>
+#include <dataclasses/physics/I3Particle.h>
+#include <dataclasses/I3Position.h>
+#include <dataclasses/I3Direction.h>
+#include <icetray/I3Units.h>
+#include <phys-services/I3GSLRandomService.h>
+
+#include <cmath>
+#include <vector>
+
+TEST_GROUP(PARTICLE_UNTHINNER);
+
+namespace {
+
+  void FillUnthinner(ParticleUnthinner& unthinner,
+                     std::vector<ExtendedI3Particle>& particles,
+                     std::vector<double>& weights)
+  {
+    const I3Particle primary(I3Position(0, 0, 0), I3Direction(0, 0, -1), 0.0);
+    unthinner.SetPrimary(primary);
+    unthinner.AddStation(I3Position(50, 0, 0), I3Position(60, 0, 0),
+                         1.0 * I3Units::m, 1.0 * I3Units::m);
+    unthinner.AddStation(I3Position(-30, 60, 0), I3Position(-30, 70, 0),
+                         1.0 * I3Units::m, 1.0 * I3Units::m);
+    unthinner.AddStation(I3Position(-100, -80, 0), I3Position(-90, -80, 0),
+                         1.0 * I3Units::m, 1.0 * I3Units::m);
+
+    I3GSLRandomService rng(1);
+    const I3Particle::ParticleType types[3] = {
+      I3Particle::Gamma, I3Particle::EMinus, I3Particle::MuMinus };
+    for (unsigned i = 0; i < 3 * ParticleUnthinner::SAMPLE_BLOCK_SIZE + 17; ++i) {
+      const double r = 150 * I3Units::m * std::sqrt(rng.Uniform());
+      const double phi = rng.Uniform(2 * M_PI);
+      ExtendedI3Particle p;
+      p.SetType(types[i % 3]);
+      p.SetPos(r * std::cos(phi), r * std::sin(phi), 0.0);
+      p.SetDir(0.1, 0.05, -std::sqrt(1 - 0.01 - 0.0025));
+      p.SetTime(rng.Uniform(10, 100) * I3Units::ns);
+      const double weight = (i % 5 == 0) ? 1.0 : rng.Uniform(10, 500);
+      unthinner.AddParticle(p, weight);
+      particles.push_back(p);
+      weights.push_back(weight);
+    }
+  }
+
+}
+
+// the clones only depend on the random service, not on the number of threads
+TEST(sample_batch_threads)
+{
+  ParticleUnthinner unthinner(500 * I3Units::m, 30, 12);
+  std::vector<ExtendedI3Particle> particles;
+  std::vector<double> weights;
+  FillUnthinner(unthinner, particles, weights);
+
+  std::vector<ExtendedI3Particle> reference;
+  {
+    I3GSLRandomService rng(42);
+    unthinner.SampleBatch(reference, particles, weights, rng, 1);
+  }
+  ENSURE(reference.size() > 0, "some particles should have been unthinned");
+
+  const unsigned nthreads[3] = { 2, 4, 0 };
+  for (unsigned k = 0; k < 3; ++k) {
+    I3GSLRandomService rng(42);
+    std::vector<ExtendedI3Particle> sample;
+    const size_t n = unthinner.SampleBatch(sample, particles, weights, rng, nthreads[k]);
+    ENSURE_EQUAL(n, reference.size(), "same number of clones");
+    ENSURE_EQUAL(sample.size(), reference.size(), "same number of clones");
+    for (size_t i = 0; i < sample.size(); ++i) {
+      ENSURE_EQUAL(sample[i].GetType(), reference[i].GetType());
+      ENSURE_EQUAL(sample[i].GetX(), reference[i].GetX());
+      ENSURE_EQUAL(sample[i].GetY(), reference[i].GetY());
+      ENSURE_EQUAL(sample[i].GetZ(), reference[i].GetZ());
+      ENSURE_EQUAL(sample[i].GetTime(), reference[i].GetTime());
+    }
+  }
+}
+
+// particles of weight 1 are passed through, in order, if asked to
+TEST(sample_batch_unit_weight)
+{
+  ParticleUnthinner unthinner(500 * I3Units::m, 30, 12);
+  std::vector<ExtendedI3Particle> particles;
+  std::vector<double> weights;
+  FillUnthinner(unthinner, particles, weights);
+  for (size_t i = 0; i < weights.size(); ++i)
+    weights[i] = 1.0;
+
+  I3GSLRandomService rng(42);
+  std::vector<ExtendedI3Particle> sample;
+  ENSURE_EQUAL(unthinner.SampleBatch(sample, particles, weights, rng, 3, true),
+               particles.size());
+  for (size_t i = 0; i < sample.size(); ++i) {
+    ENSURE_EQUAL(sample[i].GetX(), particles[i].GetX());
+    ENSURE_EQUAL(sample[i].GetY(), particles[i].GetY());
+    ENSURE_EQUAL(sample[i].GetTime(), particles[i].GetTime());
+  }
+}
@@ -267,6 +267,18 @@ void I3TopSimulator::DAQ(I3FramePtr frame)
   ExtendedI3Particle injectorParticle;
   while(injector_->NextParticle(injectorParticle))
   {
+    // Get map of tanks (tank responses) where the particle is within the sampling radius 
+    I3TankResponseMapPtr respMap = response_->GetTankResponseMap(injectorParticle);
+
+    const bool inIceMuon = mcTreeIC &&
+      (injectorParticle.GetType()==I3Particle::MuMinus ||
+       injectorParticle.GetType()==I3Particle::MuPlus) &&
+      injectorParticle.GetEnergy() > muEnergyCut_;
+
+    // Most particles of a shower are far from any tank, skip them
+    // before paying for a new particle
+    if(!respMap && !inIceMuon) continue;
+
     // create new particle with unique particle ID, so that
     // mapping between I3MCTrees and I3MCPE maps works,
     // injector particles all have same ID :-(
@@ -285,8 +297,6 @@ void I3TopSimulator::DAQ(I3FramePtr frame)
     else
       particle.SetAirShowerComponent(GetAirShowerComponent(injectorParticle));
 
-    // Get map of tanks (tank responses) where the particle is within the sampling radius 
-    I3TankResponseMapPtr respMap = response_->GetTankResponseMap(injectorParticle);
     if(respMap)
     {
       bool hitTank = false;
@@ -309,10 +319,7 @@ void I3TopSimulator::DAQ(I3FramePtr frame)
     }
   
     // Store muons above the energy threshold in InIce MCTree
-    if(mcTreeIC &&
-       (particle.GetType()==I3Particle::MuMinus ||
-        particle.GetType()==I3Particle::MuPlus) &&
-       particle.GetEnergy() > muEnergyCut_)
+    if(inIceMuon)
     {   
       particle.SetShape(I3Particle::InfiniteTrack); 
       particle.SetLength(0);
@@ -23,7 +23,8 @@ I3CorsikaReader::I3CorsikaReader():
   isThinned_(false),
   isCurved_(false),
   particleDataSize_(0),
-  zObsLevel_(NAN)
+  zObsLevel_(NAN),
+  readBuffer_(1 << 20)
 {
 }
 
@@ -185,7 +186,10 @@ bool I3CorsikaReader::OpenFile(const std::string& filename)
     // Close and reset previous buffers
     CloseFile();
     
-    // Open new CORSIKA file
+    // Open new CORSIKA file. Sub-blocks are much smaller than the default
+    // stream buffer, so give it a large one to read the file in big chunks.
+    // This has to happen before opening.
+    corsFile_.rdbuf()->pubsetbuf(&readBuffer_[0], readBuffer_.size());
     corsFile_.open(filename.c_str(), ios::in|ios::binary);
     if(!corsFile_)
     {
@@ -41,7 +41,9 @@ I3CorsikaThinnedInjector::I3CorsikaThinnedInjector(const I3Context& context):
   numSamples_(0),
   sampleIndex_(0),
   randomServiceName_(""),
-  randomService_(I3RandomServicePtr())
+  randomService_(I3RandomServicePtr()),
+  numThreads_(1),
+  batchIndex_(0)
 {  
   AddParameter("FileNameList",
          "List of CORSIKA file names.",
@@ -92,6 +94,14 @@ I3CorsikaThinnedInjector::I3CorsikaThinnedInjector(const I3Context& context):
          "If true (default), particles with weight 1 are not unthinned and simply "
          "passed through. If false, all particles are unthinned, whatever their weight.",
          smartUnthinning_);
+
+  AddParameter("NumThreads",
+         "Number of threads for the unthinning. With 1 (default), particles are "
+         "unthinned one by one with the random service. Otherwise (0 means one per "
+         "core), they are unthinned in batches, with a random stream per block of "
+         "particles seeded from the random service, so that the result does not "
+         "depend on the number of threads.",
+         numThreads_);
 }
 
 
@@ -138,6 +148,8 @@ void I3CorsikaThinnedInjector::Configure()
   }
 
   GetParameter("SmartUnthinning", smartUnthinning_);
+
+  GetParameter("NumThreads", numThreads_);
 }
 
 
@@ -216,6 +228,41 @@ I3CorsikaThinnedInjector::NextEvent(int& runID, int& evtID,
   Relocate(primary, shiftX_, shiftY_);
   unthinner_.SetPrimaryPos(primary.GetPos());
 
+  clones_.clear();
+  batch_.clear();
+  batchIndex_ = 0;
+
+  return true;
+}
+
+
+bool
+I3CorsikaThinnedInjector::NextBatch()
+{
+  // Large enough to keep all threads busy, small enough for memory
+  const size_t batchSize = 64 * ParticleUnthinner::SAMPLE_BLOCK_SIZE;
+
+  std::vector<ExtendedI3Particle> particles;
+  std::vector<double> weights;
+  particles.reserve(batchSize);
+  weights.reserve(batchSize);
+  ExtendedI3Particle particle;
+  double weight;
+  double hadgen;
+  while (particles.size() < batchSize &&
+         reader_.NextParticle(particle, weight, hadgen, ignoreTypes_)) {
+    Relocate(particle, shiftX_, shiftY_);
+    particle.SetAirShowerComponent(GetAirShowerComponent(particle, hadgen));
+    particles.push_back(particle);
+    weights.push_back(weight);
+  }
+  if (particles.empty())
+    return false;
+
+  batch_.clear();
+  batchIndex_ = 0;
+  unthinner_.SampleBatch(batch_, particles, weights, *randomService_,
+                         numThreads_, smartUnthinning_);
   return true;
 }
 
@@ -223,6 +270,15 @@ I3CorsikaThinnedInjector::NextEvent(int& runID, int& evtID,
 bool
 I3CorsikaThinnedInjector::NextParticle(ExtendedI3Particle& particle)
 {  
+  if (numThreads_ != 1) {
+    while (batchIndex_ == batch_.size()) {
+      if (!NextBatch())
+        return false;
+    }
+    particle = batch_[batchIndex_++];
+    return true;
+  }
+
   while (clones_.empty()) {
     double weight;
     double hadgen;
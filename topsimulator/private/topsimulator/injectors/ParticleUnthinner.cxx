@@ -1,13 +1,17 @@
 #include "topsimulator/injectors/ParticleUnthinner.h"
 
 #include <phys-services/I3Calculator.h>
+#include <phys-services/I3GSLRandomService.h>
 #include <phys-services/surfaces/Cylinder.h>
 #include <dataclasses/I3Constants.h>
 #include <dataclasses/geometry/I3Geometry.h>
 #include <dataclasses/geometry/I3TankGeo.h>
 
 #include <boost/foreach.hpp>
+#include <boost/thread.hpp>
+#include <atomic>
 #include <cmath>
+#include <exception>
 #include <limits>
 
 namespace {
@@ -387,12 +391,81 @@ ParticleUnthinner::Sample(
         log_trace_stream(p.GetTypeString() << " " << p.GetID() << " "
                          "weight " << weight << " "
                          "npart " << npart);
-        nclones += GenerateClones(sample, sta, p, npart, rng);
+        nclones += GenerateClones(sample, ind, sta, p, npart, rng);
     }
     return nclones;
 }
 
 
+const size_t ParticleUnthinner::SAMPLE_BLOCK_SIZE;
+
+size_t
+ParticleUnthinner::SampleBatch(
+    std::vector<ExtendedI3Particle>& sample,
+    const std::vector<ExtendedI3Particle>& particles,
+    const std::vector<double>& weights,
+    I3RandomService& rng,
+    unsigned nthreads,
+    bool keepUnitWeight)
+    const
+{
+    if (particles.size() != weights.size())
+        log_fatal("Got %zu particles, but %zu weights",
+                  particles.size(), weights.size());
+
+    // seeds are drawn in block order, before any thread runs
+    const size_t nblocks =
+        (particles.size() + SAMPLE_BLOCK_SIZE - 1) / SAMPLE_BLOCK_SIZE;
+    std::vector<unsigned> seeds(nblocks);
+    BOOST_FOREACH(unsigned& seed, seeds)
+        seed = rng.Integer(std::numeric_limits<unsigned>::max());
+
+    std::vector<std::vector<ExtendedI3Particle> > blocks(nblocks);
+    std::atomic<size_t> next(0);
+    std::exception_ptr error;
+    boost::mutex error_mutex;
+    auto work = [&]() {
+        try {
+            for (size_t b = next++; b < nblocks; b = next++) {
+                I3GSLRandomService block_rng(seeds[b], false);
+                const size_t end = std::min(particles.size(),
+                                            (b + 1) * SAMPLE_BLOCK_SIZE);
+                for (size_t i = b * SAMPLE_BLOCK_SIZE; i < end; ++i) {
+                    if (keepUnitWeight && weights[i] == 1.0)
+                        blocks[b].push_back(particles[i]);
+                    else
+                        Sample(blocks[b], particles[i], weights[i], block_rng);
+                }
+            }
+        } catch (...) {
+            boost::mutex::scoped_lock lock(error_mutex);
+            if (!error)
+                error = std::current_exception();
+            next = nblocks;
+        }
+    };
+
+    if (nthreads == 0)
+        nthreads = std::max(1u, boost::thread::hardware_concurrency());
+    nthreads = unsigned(std::min(size_t(nthreads), nblocks));
+    if (nthreads < 2) {
+        work();
+    } else {
+        boost::thread_group threads;
+        for (unsigned t = 0; t < nthreads; ++t)
+            threads.create_thread(work);
+        threads.join_all();
+    }
+    if (error)
+        std::rethrow_exception(error);
+
+    const size_t nbefore = sample.size();
+    BOOST_FOREACH(const std::vector<ExtendedI3Particle>& block, blocks)
+        sample.insert(sample.end(), block.begin(), block.end());
+    return sample.size() - nbefore;
+}
+
+
 double
 ParticleUnthinner::NParticles(
     Index ind,
@@ -427,6 +500,7 @@ ParticleUnthinner::NParticles(
 unsigned
 ParticleUnthinner::GenerateClones(
     std::vector<ExtendedI3Particle>& sample,
+    Index ind,
     const Station& sta,
     const ExtendedI3Particle& p,
     double npart,
@@ -439,7 +513,6 @@ ParticleUnthinner::GenerateClones(
         return 0;
 
     // fetch mean and standard deviation of logTime distribution
-    const Index ind = ToIndex(p.GetPos());
     const Statistics& stats =
         GetGridNode(ind).stats_[ParticleClass(p)];
     double meanLogTimeDelta = stats.logdt_sum / stats.w_sum;
@@ -23,6 +23,7 @@
 #include <dataclasses/I3Constants.h>
 
 #include <string>
+#include <vector>
 #include <fstream>
 
 
@@ -103,6 +104,7 @@ private:
     int fileIndex_;
 
 
+    std::vector<char> readBuffer_; ///< stream buffer of corsFile_, has to outlive it
     std::ifstream corsFile_;
     CorsikaSubBlock subBlock_;
 
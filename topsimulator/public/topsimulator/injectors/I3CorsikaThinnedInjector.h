@@ -50,6 +50,9 @@ private:
 
   AirShowerComponent GetAirShowerComponent(const I3Particle& p, double hadgen) const;
 
+  /// Read the next batch of particles and unthin them on numThreads_ threads
+  bool NextBatch();
+
   std::vector<std::string> corsikaFiles_;
   std::vector<int> ignoreTypes_;
   I3CorsikaReader reader_;
@@ -71,6 +74,10 @@ private:
 
   std::vector<ExtendedI3Particle> clones_;
 
+  unsigned numThreads_;
+  std::vector<ExtendedI3Particle> batch_;
+  size_t batchIndex_;
+
   std::string randomServiceName_;
   I3RandomServicePtr randomService_;
   bool smartUnthinning_;
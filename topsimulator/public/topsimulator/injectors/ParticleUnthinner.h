@@ -89,6 +89,7 @@ private:
                       const I3Particle&,
                       double weight) const;
     unsigned GenerateClones(std::vector<ExtendedI3Particle>&,
+                            Index,
                             const Station&,
                             const ExtendedI3Particle&,
                             double npart,
@@ -123,6 +124,21 @@ public:
                     const ExtendedI3Particle&,
                     double weight,
                     I3RandomService&) const;
+    /** Unthin many particles on nthreads threads (0: one per core).
+
+        The particles are split into blocks of SAMPLE_BLOCK_SIZE, each of
+        which is sampled with its own random stream, seeded from rng in
+        block order. The clones are appended block by block, so they do
+        not depend on the number of threads. If keepUnitWeight is set,
+        particles of weight 1 are passed through instead of unthinned.
+     */
+    size_t SampleBatch(std::vector<ExtendedI3Particle>&,
+                       const std::vector<ExtendedI3Particle>&,
+                       const std::vector<double>& weights,
+                       I3RandomService&,
+                       unsigned nthreads,
+                       bool keepUnitWeight = false) const;
+    static const size_t SAMPLE_BLOCK_SIZE = 1024;
 
     // interface for introspection and debugging
     void ToShowerFrontCS(double& rho,
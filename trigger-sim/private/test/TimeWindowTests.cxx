@@ -349,3 +349,22 @@ TEST(theshold_equal) {
 TEST(theshold_low) {
   TimeWindowTests::TestThreshold(9);
 }
+
+TEST(windows_point_into_input) {
+  // windows are reported as iterators into the caller's vector, with
+  // coincident hits at the window edges included
+  TimeWindow timeWindowClass(3, 10);
+  TriggerHitVector hits;
+  hits.push_back(TriggerHit(0,1,1));
+  hits.push_back(TriggerHit(5,2,1));
+  hits.push_back(TriggerHit(5,3,1));
+  hits.push_back(TriggerHit(8,4,1));
+  hits.push_back(TriggerHit(100,5,1));
+  hits.push_back(TriggerHit(200,6,1));
+
+  TriggerHitIterPairVectorPtr timeWindows = timeWindowClass.SlidingTimeWindows(hits);
+  ENSURE_EQUAL(timeWindows->size(), 1u);
+  TriggerHitVector::const_iterator first = hits.begin();
+  ENSURE(timeWindows->at(0).first == first);
+  ENSURE(timeWindows->at(0).second == first + 4);
+}
@@ -44,6 +44,7 @@ void MultiplicityStringTriggerAlgorithm::AddHits(TriggerHitVectorPtr hits)
    * Check Trigger condition on this string
    *------------------------------------------------------------*/
   TimeWindow timeWindow(triggerThreshold_, triggerWindow_);
+  hits_ = hits;
   triggers_.clear();
   triggerCount_ = 0;
 
@@ -62,26 +63,18 @@ void MultiplicityStringTriggerAlgorithm::AddHits(TriggerHitVectorPtr hits)
        timeWindowIter != timeWindows->end(); 
        timeWindowIter++) {
 
-    // Create a vector of the hits in this time window
-    TriggerHitVectorPtr timeHits(new TriggerHitVector);
-
     // Get the window boundaries
     TriggerHitVector::const_iterator firstHit = timeWindowIter->first;
     TriggerHitVector::const_iterator lastHit  = timeWindowIter->second;
 
-    // Iterate over the hits and pull out the ones for this window
-    for (TriggerHitVector::const_iterator hitIter = firstHit; 
-	 hitIter != lastHit; 
-	 hitIter++)
-      timeHits->push_back(*hitIter);
-
-    log_debug("Time window (%f, %f) has %zd hits", firstHit->time, (--lastHit)->time, timeHits->size());
+    log_debug("Time window (%f, %f) has %zd hits", firstHit->time, (lastHit-1)->time,
+              size_t(lastHit - firstHit));
 
     // Check the positions of these hits
-    bool posTrigger = PosWindow(timeHits);
+    bool posTrigger = PosWindow(firstHit, lastHit);
 	  
     if (posTrigger) {
-      triggers_.push_back(*timeHits);
+      triggers_.push_back(*timeWindowIter);
       triggerCount_++;
       log_debug("Trigger! Count = %d", triggerCount_);
     }
@@ -99,12 +92,14 @@ TriggerHitVectorPtr MultiplicityStringTriggerAlgorithm::GetNextTrigger() {
   if (triggerCount_ > 0) {
     triggerCount_--;
     log_debug("Returning trigger window %d", triggerCount_);
-    hits = TriggerHitVectorPtr(new TriggerHitVector(triggers_.at(triggerCount_)));
+    const TriggerHitIterPair& window = triggers_.at(triggerCount_);
+    hits = TriggerHitVectorPtr(new TriggerHitVector(window.first, window.second));
   }
   return hits;
 }
 
-bool MultiplicityStringTriggerAlgorithm::PosWindow(TriggerHitVectorPtr inputHits)
+bool MultiplicityStringTriggerAlgorithm::PosWindow(TriggerHitVector::const_iterator firstHit,
+                                                   TriggerHitVector::const_iterator lastHit)
 {
   log_debug("  Position window trigger...");
 
@@ -113,7 +108,7 @@ bool MultiplicityStringTriggerAlgorithm::PosWindow(TriggerHitVectorPtr inputHits
    *------------------------------------------------------------*/
 
   bool veto = false;
-  BOOST_FOREACH(const TriggerHit& hit1, *inputHits) {
+  BOOST_FOREACH(const TriggerHit& hit1, std::make_pair(firstHit, lastHit)) {
     unsigned int pos1 = hit1.pos;
     if (pos1 <= vetoDepth_) {
       log_debug("  VETO: Hit in veto region (<= %u): %u", vetoDepth_, pos1);
@@ -128,7 +123,7 @@ bool MultiplicityStringTriggerAlgorithm::PosWindow(TriggerHitVectorPtr inputHits
 
   // loop over all hits and use each as the start of the trigger window
   unsigned int count = 0;
-  BOOST_FOREACH(const TriggerHit& hit1, *inputHits){
+  BOOST_FOREACH(const TriggerHit& hit1, std::make_pair(firstHit, lastHit)){
     unsigned int startPos = hit1.pos;
     unsigned int stopPos = startPos + maxSpan_ - 1;
     if (stopPos > 60) stopPos = 60;
@@ -136,7 +131,7 @@ bool MultiplicityStringTriggerAlgorithm::PosWindow(TriggerHitVectorPtr inputHits
     log_debug("    New position window = (%d,%d)", startPos, stopPos);
 
     // now loop over all other hits and store any that fall in this window
-    BOOST_FOREACH(const TriggerHit& hit2, *inputHits){
+    BOOST_FOREACH(const TriggerHit& hit2, std::make_pair(firstHit, lastHit)){
       unsigned int pos = hit2.pos;
       log_debug("      Checking hit at %d", pos);
       if ( (pos >= startPos) && (pos <= stopPos) ) {
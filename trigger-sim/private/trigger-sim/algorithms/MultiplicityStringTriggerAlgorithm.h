@@ -88,10 +88,14 @@ class MultiplicityStringTriggerAlgorithm
   unsigned int maxSpan_;
   unsigned int vetoDepth_;
 
-  TriggerHitVectorVector triggers_;
+  // the triggered windows point into hits_, they are only copied out
+  // when requested
+  TriggerHitVectorPtr hits_;
+  TriggerHitIterPairVector triggers_;
   unsigned int triggerCount_;
 
-  bool PosWindow(TriggerHitVectorPtr timeHits);
+  bool PosWindow(TriggerHitVector::const_iterator firstHit,
+                 TriggerHitVector::const_iterator lastHit);
 
   SET_LOGGER("MultiplicityStringTriggerAlgorithm");
 };
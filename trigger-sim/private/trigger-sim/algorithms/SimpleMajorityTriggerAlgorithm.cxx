@@ -41,45 +41,21 @@ void SimpleMajorityTriggerAlgorithm::AddHits(TriggerHitVectorPtr hits)
    * Check Trigger condition
    *------------------------------------------------------------*/
   TimeWindow timeWindow(triggerThreshold_, triggerWindow_);
-  triggers_.clear();
+  hits_ = hits;
   triggerCount_ = 0;
   triggerIndex_ = 0;
 
   // Get time windows
-  TriggerHitIterPairVectorPtr timeWindows = timeWindow.SlidingTimeWindows(hits);
+  triggers_ = timeWindow.SlidingTimeWindows(hits_);
 
   // If the vector is empty, there are no time windows for this string
-  if (timeWindows->empty()) {
+  if (triggers_->empty()) {
     log_debug("No valid time windows for this string");
     return;
   }
-  log_debug("Found %zd triggered time windows", timeWindows->size());
+  log_debug("Found %zd triggered time windows", triggers_->size());
 
-  // Loop over the time windows and pull out the hits in each
-  for (TriggerHitIterPairVector::const_iterator timeWindowIter = timeWindows->begin(); 
-       timeWindowIter != timeWindows->end(); 
-       timeWindowIter++) {
-
-    // Create a vector of the hits in this time window
-    TriggerHitVectorPtr timeHits(new TriggerHitVector);
-
-    // Get the window boundaries
-    TriggerHitVector::const_iterator firstHit = timeWindowIter->first;
-    TriggerHitVector::const_iterator lastHit  = timeWindowIter->second;
-
-    // Iterate over the hits and pull out the ones for this window
-    for (TriggerHitVector::const_iterator hitIter = firstHit; 
-	 hitIter != lastHit; 
-	 hitIter++)
-      timeHits->push_back(*hitIter);
-
-    log_debug("Time window (%f, %f) has %zd hits", firstHit->time, (--lastHit)->time, timeHits->size());
-
-    triggers_.push_back(*timeHits);
-    triggerCount_++;
-    log_debug("Trigger! Count = %d", triggerCount_);
-
-  } 
+  triggerCount_ = triggers_->size();
   
 }
 
@@ -91,7 +67,8 @@ TriggerHitVectorPtr SimpleMajorityTriggerAlgorithm::GetNextTrigger() {
   TriggerHitVectorPtr hits;
   if (triggerCount_ > 0) {
     log_debug("Returning trigger window %d", triggerIndex_);
-    hits = TriggerHitVectorPtr(new TriggerHitVector(triggers_.at(triggerIndex_)));
+    const TriggerHitIterPair& window = triggers_->at(triggerIndex_);
+    hits = TriggerHitVectorPtr(new TriggerHitVector(window.first, window.second));
     triggerCount_--;
     triggerIndex_++;
   }
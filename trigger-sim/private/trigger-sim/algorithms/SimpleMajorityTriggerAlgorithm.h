@@ -65,7 +65,10 @@ class SimpleMajorityTriggerAlgorithm
   double triggerWindow_;
   unsigned int triggerThreshold_;
 
-  TriggerHitVectorVector triggers_;
+  // the triggered windows point into hits_, they are only copied out
+  // when requested
+  TriggerHitVectorPtr hits_;
+  TriggerHitIterPairVectorPtr triggers_;
   unsigned int triggerCount_;
   unsigned int triggerIndex_;
 
@@ -1,290 +1,154 @@
 #include "trigger-sim/algorithms/TimeWindow.h"
-#include <boost/foreach.hpp>
+#include <algorithm>
 
 using namespace std;
 
 TimeWindow::TimeWindow(unsigned int threshold, double window) 
   : threshold_(threshold), window_(window) 
-{
-  timeWindowHits_ = TriggerHitListPtr( new TriggerHitList() );
-  triggerWindowHits_ = TriggerHitListPtr( new TriggerHitList() );
-}
+{}
 
 TimeWindow::~TimeWindow() {}
 
+namespace {
+
+  bool EarlierThan(const TriggerHit& hit, double time) { return hit.time < time; }
+
+  /**
+   * The window reported for a trigger runs from the first hit sharing the
+   * time of its earliest hit to one past the first hit sharing the time of
+   * its latest hit.  For time ordered input this is a binary search.
+   */
+  TriggerHitVector::const_iterator
+  FirstAtTime(const TriggerHitVector& hits, double time)
+  {
+    return std::lower_bound(hits.begin(), hits.end(), time, EarlierThan);
+  }
+
+}
+
 /**
    Implementation of a sliding time window algorithm.
-   Input is a vector of TriggerHit objects that should be time ordered:
+   Input is a vector of TriggerHit objects that must be time ordered:
       std::vector<TriggerHit>
    Output is a std::vector of pairs comprised of iterators pointing to the begining and end
    of each valid time window:
       std::vector<pair<TriggerHitVector::const_iterator,TriqggerHitVector::const_iterator> >
 
+   Since the input is time ordered, both the sliding time window and the
+   trigger window are contiguous ranges of the input, so the scan only keeps
+   track of their boundaries (two pointers) and never copies hits.  The
+   returned iterators point into the caller's vector, which therefore has to
+   outlive them.
  */
-TriggerHitIterPairVectorPtr TimeWindow::SlidingTimeWindows(TriggerHitVectorPtr hits)
+TriggerHitIterPairVectorPtr TimeWindow::SlidingTimeWindows(const TriggerHitVector& hits)
 {
   // The return variable is a std::vector of pairs, each pair is the begin/end iterators for the time window
   TriggerHitIterPairVectorPtr triggerWindows(new TriggerHitIterPairVector());
 
-  // Initialize the trigger condition
-  bool trigger = false;
+  if (hits.empty())
+    return triggerWindows;
 
-  // Keep track of hits in the sliding time window
-  timeWindowHits_->clear();
+  const size_t last = hits.size() - 1;
 
-  // Keep track of hits in the current trigger window
-  triggerWindowHits_->clear();
+  // Initialize the trigger condition
+  bool trigger = false;
 
-  // Create the begin/end pointers
-  TriggerHitVector::const_iterator beginHit;
-  TriggerHitVector::const_iterator endHit;
+  // The sliding time window holds hits [windowBegin, n], the trigger window
+  // holds hits [triggerBegin, triggerEnd]
+  size_t windowBegin = 0;
+  size_t triggerBegin = 0;
+  size_t triggerEnd = 0;
 
-  // Outer loop over all hits except the last
-  // The iteration of startingHit is controlled by the sliding of the time window
-  TriggerHitVector::const_iterator startingHit = hits->begin();
-  if(startingHit==hits->end())
-  {
-    return triggerWindows;
-  }
- // while (startingHit != hits->end()) {
-
-  // Define the times of this trigger window
-  double startTime = startingHit->time;
+  double startTime = hits[0].time;
   double stopTime  = startTime + window_;
   log_debug("New starting hit! TimeWindow = (%f, %f)", startTime, stopTime);
 
-  // Push the startingHit into the timeWindowHits if its empty
-  //if (timeWindowHits_->empty())
-  timeWindowHits_->push_back(*startingHit);
-
-  DumpHits(*timeWindowHits_, " TimeWindowHits:", "   ");
-
-  // Initialize the counter (including startingHit)
-  unsigned int count = timeWindowHits_->size(); // holds the number of hits within the sliding timewindow
-//  unsigned int trigger_hit_count=0;
-
-  // Initialize the begin/end pointers if the trigger is not active
-  if (!trigger) {
-    beginHit = startingHit;
-    endHit = hits->end();
-  }
-
   // Inner loop over all later hits
-  TriggerHitVector::const_iterator nextHit;
-  for (nextHit = startingHit + 1; nextHit != hits->end(); nextHit++) {
+  for (size_t n = 1; n < hits.size(); n++) {
 
     // The time of the next hit
-    double nextTime = nextHit->time;
+    double nextTime = hits[n].time;
     log_debug("  NextTime = %f", nextTime);
 
-    // Check if it falls in the time window
-    if (nextTime < startTime)
-    {
-      log_debug("ERROR HITS NOT TIMEORDERED_");
-      // error, hits should be time ordered
-    } 
-    else if (nextTime <= stopTime)
-    {
-      // in window, increment counter
-      timeWindowHits_->push_back(*nextHit);
-      count = timeWindowHits_->size();
-
-      if(trigger)
-      {
-      	triggerWindowHits_->push_back(*nextHit);
-
+    // Number of hits in the time window before this one
+    unsigned int count = n - windowBegin;
 
+    if (nextTime < startTime)
+      log_fatal("Hits are not time ordered (%f < %f)", nextTime, startTime);
 
-      //   trigger_hit_count=triggerWindowHits_->size();
+    if (nextTime <= stopTime) {
+      // in window, increment counter
+      count++;
+      if (trigger)
+        triggerEnd = n;
+
+      // we are at the last hit, this is in simulation only.... form a trigger if there is one...
+      if (n == last && (trigger || count >= threshold_)) {
+        if (!trigger) {
+          triggerBegin = windowBegin;
+          triggerEnd = n;
+        }
+        AddWindow(hits, triggerBegin, triggerEnd, *triggerWindows);
       }
 
-      if(nextHit == (hits->end()-1)) // we are at the last hit, this is in simulation only.... form a trigger if there is one...
-      {
-      	log_debug("special case;;;;;; we are at the last hit adn still in window");
-      	if(trigger || (!trigger && (timeWindowHits_->size() >= threshold_)) )
-      	{
-	  log_debug("yeah"); 
-
-	  if(!trigger)
-	  {
-	    CopyHits(*timeWindowHits_, *triggerWindowHits_); 
-	  }
-
-      	  double trigger_start=triggerWindowHits_->front().time;
-      	  double trigger_end=triggerWindowHits_->back().time;
-
-      	  for(beginHit=hits->begin(); beginHit!=hits->end(); beginHit++)
-      	  {
-      	    if(beginHit->time == trigger_start)
-      	    {
-	      log_debug("trigger_start: %f", trigger_start);
-      	      break;
-      	    }
-      	  }
-      	  for(endHit=hits->begin(); endHit!=hits->end(); endHit++)
-      	  {
-      	    if(endHit->time == trigger_end)
-      	    {
-	      log_debug("trigger_end: %f", trigger_end);
-      	      break;
-      	    }
-      	  }
-
-
-       //   beginHit=triggerWindowHits_->begin();
-	//  endHit=(triggerWindowHits_->end()-1);
-
-	  TriggerHitIterPair triggerWindow(beginHit, (endHit+1));
-	  triggerWindows->push_back(triggerWindow);
-	  DumpHits(*triggerWindowHits_, "      TriggerWindowHits:", "      ");
-	 }
-
-       //  break; // break the whole loop
-
-       }  
-
-
       log_debug("    Hit inside window, counter = %d", count);
-      DumpHits(*timeWindowHits_, "    TimeWindowHits:", "      ");
     } else {
       // Hit is beyond window, must slide window
       log_debug("    Hit outside window, sliding...");
 
       // First check if the current window is above threshold
-      if (count >= threshold_) { 
-	log_debug("      Window is above threshold");
-	// First time we are above threshold, so no trigger yet, 
-	// then define beginHit for this trigger!!
-	if(!trigger){
-	 // beginHit =  startingHit;
-	  CopyHits(*timeWindowHits_, *triggerWindowHits_); 
-      //    trigger_hit_count=triggerWindowHits_->size();
-	  DumpHits(*triggerWindowHits_, "      TriggerWindowHits:", "      ");
-
-
-	  log_debug("StartTime of trigger: %lf",beginHit->time);
-	}
-	trigger = true;
-	//endHit = nextHit;  
-      }
-
-      // Copy new hits into the triggerWindowHits
-
-      // Now slide the window
-      //  slide until either next hit is inside or count goes to zero
-      bool inWindow = true;
-      if (nextTime > stopTime)
-      {
-	 inWindow=false;
+      if (count >= threshold_ && !trigger) {
+        log_debug("      Window is above threshold");
+        // First time we are above threshold, the trigger window starts
+        // as a copy of the time window
+        triggerBegin = windowBegin;
+        triggerEnd = n - 1;
+        trigger = true;
+        log_debug("StartTime of trigger: %lf", hits[triggerBegin].time);
       }
 
-      log_debug("nextTime: %f, stopTime: %f", nextTime, stopTime);
-
-      while ((!inWindow) && (count > 1))
-      {
-	//startingHit++;
-        timeWindowHits_->pop_front();
-        count = timeWindowHits_->size();
-      	log_debug("nextTime: %f, stopTime: %f", nextTime, stopTime);
-	// new time window
-	startTime = timeWindowHits_->front().time;
-	stopTime = startTime + window_;
-	log_debug("      New TimeWindow = (%f, %f)  Count = %d", startTime, stopTime, count);
-	DumpHits(*timeWindowHits_, "      TimeWindowHits:", "        ");
-
-	if (nextTime <= stopTime) {
-	  inWindow = true;
-	}
+      // Now slide the window until either next hit is inside or only one is left
+      while (nextTime > stopTime && n - windowBegin > 1) {
+        windowBegin++;
+        startTime = hits[windowBegin].time;
+        stopTime = startTime + window_;
+        log_debug("      New TimeWindow = (%f, %f)  Count = %zu",
+                  startTime, stopTime, n - windowBegin);
       }
-
-      if(!inWindow) // the prior while loop broke because count was 1
-      {
-	timeWindowHits_->pop_front();
-
-	timeWindowHits_->push_back(*nextHit);
-	startTime = timeWindowHits_->front().time;
-	stopTime = startTime + window_;
-
-	count = timeWindowHits_->size();
-
-
+      // the window could not be slid far enough, restart it with this hit
+      if (nextTime > stopTime) {
+        windowBegin = n;
+        startTime = nextTime;
+        stopTime = startTime + window_;
       }
-      else // Hit really falls into the window and count is bigger than 1
-      {
-	// just push it back
-	timeWindowHits_->push_back(*nextHit);
-	count = timeWindowHits_->size();
+      count = n - windowBegin + 1;
+
+      if (trigger) {
+        bool overlap = Overlap(hits, windowBegin, triggerBegin, n);
+        if ( ((count < threshold_) && (!overlap)) || (count==1 && threshold_== 1) || n == last) {
+          log_debug("form a trigger...");
+          // if we overlap we have to take it - simulation/daq issue
+          if (n == last && overlap)
+            triggerEnd = n;
+          AddWindow(hits, triggerBegin, triggerEnd, *triggerWindows);
+          trigger = false;
+        } else {
+          triggerEnd = n;
+        }
       }
-
-      if(trigger)
-      {
-	log_debug("am in trigger...");
-
-	DumpHits(*triggerWindowHits_, "  overlap..     TriggerWindowHits:", "        ");
-
-	bool overlap = Overlap(*timeWindowHits_, *triggerWindowHits_);
-	if( ((count < threshold_) && (!overlap)) || (count==1 && threshold_== 1) || nextHit == (hits->end()-1))
-	{
-	  log_debug("form a trigger...");
-	  if( nextHit == (hits->end()-1) && (overlap)) // if we overlap we have to take it - simulation/daq issue
-	  {
-	    triggerWindowHits_->push_back(*nextHit);
-	  }
-      /*    for(int i = 0; i < (int)triggerWindowHits_->size(); i++)
-	  {
-
-
-
-	  }*/
-
-	  double trigger_start=triggerWindowHits_->front().time;
-	  double trigger_end=triggerWindowHits_->back().time;
-
-	  for(beginHit=hits->begin(); beginHit!=hits->end(); beginHit++)
-	  {
-	    if(beginHit->time == trigger_start)
-	    {
-	      break;
-	    }
-	  }
-	  for(endHit=hits->begin(); endHit!=hits->end(); endHit++)
-	  {
-	    if(endHit->time == trigger_end)
-	    {
-	      break;
-	    }
-	  }
-
-
-       //   beginHit=triggerWindowHits_->begin();
-	//  endHit=(triggerWindowHits_->end()-1);
-
-	  TriggerHitIterPair triggerWindow(beginHit, (endHit+1));
-	  triggerWindows->push_back(triggerWindow);
-	  DumpHits(*triggerWindowHits_, "       TriggerWindowHits:", "        ");
-	  trigger=false;
-	  triggerWindowHits_->clear();
-
-
-	}
-	else
-	{
-	  triggerWindowHits_->push_back(*nextHit);
-
-	}
-
-      }
-      // Check for overlap
     } // end time window check
 
   } // end inner loop
-  timeWindowHits_->clear();
   log_debug("      Reached end of inner loop...");
-  DumpHits(*timeWindowHits_, "       TimeWindowHits:", "        ");
 
   return triggerWindows;
 }
 
+TriggerHitIterPairVectorPtr TimeWindow::SlidingTimeWindows(TriggerHitVectorPtr hits)
+{
+  return SlidingTimeWindows(*hits);
+}
+
 /**
    Implementation of a sliding time window algorithm.
    Input is a std::vector of TriggerHit objects that should be time ordered:
@@ -366,45 +230,28 @@ TriggerHitIterPairVectorPtr TimeWindow::FixedTimeWindows(TriggerHitVectorPtr hit
   return triggerWindows;
 }
 
-TriggerHitIterPairVectorPtr TimeWindow::SlidingTimeWindows(TriggerHitVector& hits)
-{
-
-  TriggerHitVectorPtr hitsPtr(new TriggerHitVector(hits));
-  return SlidingTimeWindows(hitsPtr);
-
-}
-
-void TimeWindow::DumpHits(TriggerHitList& hits, const string& head, const string& pad)
+void TimeWindow::AddWindow(const TriggerHitVector& hits, size_t first, size_t last,
+                           TriggerHitIterPairVector& windows)
 {
+  TriggerHitVector::const_iterator beginHit = FirstAtTime(hits, hits[first].time);
+  TriggerHitVector::const_iterator endHit = FirstAtTime(hits, hits[last].time);
+  windows.push_back(TriggerHitIterPair(beginHit, endHit + 1));
 
-  log_debug("%s", head.c_str());
-  int n = 0;
-  BOOST_FOREACH( const TriggerHit& hit, hits ) {
-    log_debug("%sHit %d @ Time %f", pad.c_str(), n, hit.time);
-    n++;
-  }
-
+  log_debug("      TriggerWindowHits:");
+  for (size_t n = first; n <= last; n++)
+    log_debug("        Hit %zu @ Time %f", n - first, hits[n].time);
 }
 
-void TimeWindow::CopyHits(TriggerHitList& sourceHits, TriggerHitList& destHits)
+bool TimeWindow::Overlap(const TriggerHitVector& hits, size_t windowBegin,
+                         size_t triggerBegin, size_t next)
 {
-
-  // Copy from source to dest IFF source does not already exist in dest
-  BOOST_FOREACH( TriggerHit sourceHit, sourceHits ) {
-    if (find(destHits.begin(), destHits.end(), sourceHit) == destHits.end())
-      destHits.push_back(sourceHit);
-  }
-
-}
-
-bool TimeWindow::Overlap(TriggerHitList& hits1, TriggerHitList& hits2)
-{
-  bool overlap = false;
-  BOOST_FOREACH( TriggerHit hit1, hits1 ) {
-    if (find(hits2.begin(), hits2.end(), hit1) != hits2.end()) {
-      overlap = true;
-      break;
-    }
-  }
-  return overlap;
+  // The time window [windowBegin, next] shares a hit with the trigger window
+  // [triggerBegin, next-1] if it reaches back before next, or if the new hit
+  // duplicates one already in the trigger window.
+  if (windowBegin < next)
+    return true;
+  for (size_t n = next; n > triggerBegin && hits[n-1].time == hits[next].time; n--)
+    if (hits[n-1] == hits[next])
+      return true;
+  return false;
 }
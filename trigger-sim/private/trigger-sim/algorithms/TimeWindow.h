@@ -21,10 +21,11 @@ class TimeWindow
   ~TimeWindow();
 
   /**
-   * Sliding time windows
+   * Sliding time windows over time ordered hits.  The returned iterators
+   * point into hits, no hits are copied.
    */
   TriggerHitIterPairVectorPtr SlidingTimeWindows(TriggerHitVectorPtr hits);
-  TriggerHitIterPairVectorPtr SlidingTimeWindows(TriggerHitVector& hits);
+  TriggerHitIterPairVectorPtr SlidingTimeWindows(const TriggerHitVector& hits);
 
   /**
    * Fixed time windows
@@ -38,16 +39,14 @@ class TimeWindow
    */
   TimeWindow();
 
-  void DumpHits(TriggerHitList& hits, const std::string& head, const std::string& pad);
-  void CopyHits(TriggerHitList& sourceHits, TriggerHitList& destHits);
-  bool Overlap(TriggerHitList& hits1, TriggerHitList& hits2);
+  void AddWindow(const TriggerHitVector& hits, size_t first, size_t last,
+                 TriggerHitIterPairVector& windows);
+  bool Overlap(const TriggerHitVector& hits, size_t windowBegin,
+               size_t triggerBegin, size_t next);
 
   unsigned int threshold_;
   double window_;
 
-  TriggerHitListPtr timeWindowHits_;
-  TriggerHitListPtr triggerWindowHits_;
-
   SET_LOGGER("TimeWindow");
 };
 
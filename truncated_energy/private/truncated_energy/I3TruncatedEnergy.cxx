@@ -39,6 +39,7 @@
 
 #include <algorithm>  // for SORT command
 #include <cmath>
+#include <functional>
 
 
 // length along the track of one bin in the BIN method, 120 m chosen for best precision:
@@ -92,6 +93,13 @@ I3TruncatedEnergy::I3TruncatedEnergy(const I3Context &ctx)
         RecoParticleName_
     );
 
+    AddParameter("RecoParticleNames",
+        "Names of several reconstructed particles to evaluate in one pass, "
+        "instead of RecoParticleName. The results of each are written with "
+        "the prefix ResultParticleName+name. Default is [].",
+        RecoParticleNames_
+    );
+
     ResultParticleName_ = "TruncatedEnergy_"+RecoParticleName_;
     AddParameter("ResultParticleName",
         "Name of the resulting particle you want to write to the frame. "
@@ -166,6 +174,7 @@ I3TruncatedEnergy::Configure ()
 {
     GetParameter("RecoPulsesName",         RecoPulsesName_);
     GetParameter("RecoParticleName",       RecoParticleName_);
+    GetParameter("RecoParticleNames",      RecoParticleNames_);
     GetParameter("ResultParticleName",     ResultParticleName_);
     GetParameter("I3PhotonicsServiceName", I3PhotonicsServiceName_);
     GetParameter("SetMinCylinderBIN",      SetMinCylinderBIN_);
@@ -186,6 +195,11 @@ I3TruncatedEnergy::Configure ()
         log_fatal("(%s) 'ResultParticleName' cannot be an empty string!",
             GetName().c_str());
     }
+
+    if(!RecoParticleName_.empty() && !RecoParticleNames_.empty()) {
+        log_fatal("(%s) Set either 'RecoParticleName' or 'RecoParticleNames', not both!",
+            GetName().c_str());
+    }
 }
 
 //______________________________________________________________________________
@@ -219,72 +233,134 @@ I3TruncatedEnergy::Geometry(I3FramePtr frame)
 }
 
 //______________________________________________________________________________
-/** This method is called in Physics() below, to count the expected PE from
- *  photonics for each DOM.
+/** This method is called in Physics() below, to collect the DOMs that can
+ *  contribute and their measured charge. None of this depends on the track,
+ *  so it is done once per frame for all tracks.
  */
-
-double
-I3TruncatedEnergy::CalculateExpectedDomNPEsFromTrack(
-    I3ParticleConstPtr          reco_particle,
-    const OMKey                 &omkey,
-    const I3OMGeo               &omgeo,
-    const double                ref_energy,
-    const I3VectorOMKeyConstPtr bad_dom_list
+void
+I3TruncatedEnergy::FillDoms(
+    const I3RecoPulseSeriesMap  &reco_pulses_map,
+    const I3VectorOMKey         &bad_dom_list
 )
 {
-    if(std::find(bad_dom_list->begin(), bad_dom_list->end(), omkey) != bad_dom_list->end())
+    std::vector<OMKey> bad_doms(bad_dom_list.begin(), bad_dom_list.end());
+    std::sort(bad_doms.begin(), bad_doms.end());
+
+    doms_.clear();
+    const I3OMGeoMap &omgeomap = geo_->omgeo;
+    for(I3OMGeoMap::const_iterator omgeomap_citer = omgeomap.begin();
+        omgeomap_citer != omgeomap.end();
+        ++omgeomap_citer
+       )
     {
-        log_debug("(%s) Found DOM %s in BadDomList, returning 0. expected NPE.",
-                    GetName().c_str(), omkey.str().c_str());
-        return 0.;
+        const OMKey   &omkey = omgeomap_citer->first;
+        const I3OMGeo &omgeo = omgeomap_citer->second;
+
+        // exclude IceTop DOMs
+        if(omgeo.omtype != I3OMGeo::IceCube)
+            continue;
+
+        if(std::binary_search(bad_doms.begin(), bad_doms.end(), omkey))
+        {
+            log_debug("(%s) Found DOM %s in BadDomList, returning 0. expected NPE.",
+                        GetName().c_str(), omkey.str().c_str());
+            continue;
+        }
+
+        dom_t dom;
+        dom.omkey = omkey;
+        dom.position = omgeo.position;
+
+        // check if we got pulses on this DOM, if so, count all the measured PEs
+        dom.det_npes = 0.;
+        I3RecoPulseSeriesMap::const_iterator reco_pulses_map_citer = reco_pulses_map.find(omkey);
+        if(reco_pulses_map_citer != reco_pulses_map.end())
+        {
+            // this DOM has pulses in this event; sum them up!
+            const I3RecoPulseSeries &reco_pulses = reco_pulses_map_citer->second;
+            for(I3RecoPulseSeries::const_iterator reco_pulses_citer = reco_pulses.begin();
+                reco_pulses_citer != reco_pulses.end();
+                ++reco_pulses_citer
+               )
+            {
+                double reco_pulse_npes = reco_pulses_citer->GetCharge();
+                if(reco_pulse_npes < 0) {
+                    log_warn("(%s) Got a sick pulse in DOM %s! Ignore the pulse.",
+                        GetName().c_str(), omkey.str().c_str());
+                    continue;
+                }
+                dom.det_npes += reco_pulse_npes;
+            }
+        }
+
+        // Correct for electronics, DeepCore, ...
+        dom.rde = UseRDE_ ? truncated_energy::GetRDE(omkey, calib_) : 1.;
+
+        doms_.push_back(dom);
     }
+}
+
+//______________________________________________________________________________
+/** This method is called in Physics() below, to count the expected PE from
+ *  photonics for each DOM in doms_. The result is stored in expNPEs_, zero
+ *  where photonics failed.
+ */
 
+void
+I3TruncatedEnergy::CalculateExpectedNPEsFromTrack(
+    const I3Particle &reco_particle,
+    const double     ref_energy
+)
+{
     const int    photonics_flag   = 1;    // preset for Lightsaber tables for muons
     const double photonics_length = -1.0; // preset for Lightsaber tables for muons
 
-    PhotonicsSource source(
-        reco_particle->GetX() * truncated_energy::i3unit_inv_m,
-        reco_particle->GetY() * truncated_energy::i3unit_inv_m,
-        reco_particle->GetZ() * truncated_energy::i3unit_inv_m,
-        reco_particle->GetZenith()  * truncated_energy::i3unit_inv_deg,
-        reco_particle->GetAzimuth() * truncated_energy::i3unit_inv_deg,
+    // the source is the same for all DOMs
+    const PhotonicsSource source(
+        reco_particle.GetX() * truncated_energy::i3unit_inv_m,
+        reco_particle.GetY() * truncated_energy::i3unit_inv_m,
+        reco_particle.GetZ() * truncated_energy::i3unit_inv_m,
+        reco_particle.GetZenith()  * truncated_energy::i3unit_inv_deg,
+        reco_particle.GetAzimuth() * truncated_energy::i3unit_inv_deg,
 	1.,
         photonics_length,
         ref_energy,
         photonics_flag
     );
 
-    // select OM coordinates in photonics
-    const double omx = omgeo.position.GetX() * truncated_energy::i3unit_inv_m;
-    const double omy = omgeo.position.GetY() * truncated_energy::i3unit_inv_m;
-    const double omz = omgeo.position.GetZ() * truncated_energy::i3unit_inv_m;
-    I3PhotonicsService_->SelectModuleCoordinates(omx, omy, omz);
-
-    // get photorec information about the selected OM
-    double probability = 1;
-    double expected_npe = 0;
-    double dummytime = 20.*I3Units::ns;
-    bool goodinfo = I3PhotonicsService_->GetPhotorecInfo(
-        expected_npe,
-        probability,
-        dummytime,
-        source
-    );
-
-    if(goodinfo && std::isnormal(expected_npe) && (expected_npe > 0))
+    expNPEs_.resize(doms_.size());
+    for(size_t i = 0; i < doms_.size(); ++i)
     {
-        ++nCallsSuccess_;
-
-        // Correct for electronics, DeepCore, ...
-        if(UseRDE_ && omgeo.omtype == I3OMGeo::IceCube) {
-            expected_npe *= truncated_energy::GetRDE(omkey, calib_);
+        const dom_t &dom = doms_[i];
+
+        // select OM coordinates in photonics
+        const double omx = dom.position.GetX() * truncated_energy::i3unit_inv_m;
+        const double omy = dom.position.GetY() * truncated_energy::i3unit_inv_m;
+        const double omz = dom.position.GetZ() * truncated_energy::i3unit_inv_m;
+        I3PhotonicsService_->SelectModuleCoordinates(omx, omy, omz);
+
+        // get photorec information about the selected OM
+        double probability = 1;
+        double expected_npe = 0;
+        double dummytime = 20.*I3Units::ns;
+        bool goodinfo = I3PhotonicsService_->GetPhotorecInfo(
+            expected_npe,
+            probability,
+            dummytime,
+            source
+        );
+
+        if(goodinfo && std::isnormal(expected_npe) && (expected_npe > 0))
+        {
+            ++nCallsSuccess_;
+            expNPEs_[i] = UseRDE_ ? expected_npe * dom.rde : expected_npe;
+        }
+        else
+        {
+            ++nCallsFail_;
+            expNPEs_[i] = 0.;
         }
-
-        return expected_npe;
     }
-
-    ++nCallsFail_;
-    return 0.;
 }
 
 //______________________________________________________________________________
@@ -294,7 +370,8 @@ I3TruncatedEnergy::CalculateExpectedDomNPEsFromTrack(
 bool
 I3TruncatedEnergy::CheckEventPulsesAndFitStatus(
     I3RecoPulseSeriesMapConstPtr reco_pulses_map,
-    I3ParticleConstPtr           reco_particle)
+    I3ParticleConstPtr           reco_particle,
+    const std::string            &reco_particle_name)
 {
     if(reco_pulses_map && !(reco_pulses_map->empty()) &&
        reco_particle && (reco_particle->GetFitStatus() == I3Particle::OK)
@@ -315,7 +392,7 @@ I3TruncatedEnergy::CheckEventPulsesAndFitStatus(
             else
             {
                 log_debug("(%s) \"%s\" has NAN values! Skipping energy estimation for this event!",
-                    GetName().c_str(), RecoParticleName_.c_str());
+                    GetName().c_str(), reco_particle_name.c_str());
                 ++nMissingParticle_;
                 return false;
             }
@@ -323,7 +400,7 @@ I3TruncatedEnergy::CheckEventPulsesAndFitStatus(
         else
         {
             log_debug("(%s) \"%s\" is not a track, skipping energy estimation for this event!",
-                GetName().c_str(), RecoParticleName_.c_str());
+                GetName().c_str(), reco_particle_name.c_str());
             ++nMissingParticle_;
             return false;
         }
@@ -347,13 +424,13 @@ I3TruncatedEnergy::CheckEventPulsesAndFitStatus(
     if(! reco_particle)
     {
         log_debug("(%s) \"%s\" absent in frame, skipping energy estimation for this event!",
-            GetName().c_str(), RecoParticleName_.c_str());
+            GetName().c_str(), reco_particle_name.c_str());
         ++nMissingParticle_; 
     }
     else if(reco_particle->GetFitStatus() != I3Particle::OK)
     {
         log_debug("(%s) \"%s\" status not OK, skipping energy estimation for this event!",
-            GetName().c_str(), RecoParticleName_.c_str());
+            GetName().c_str(), reco_particle_name.c_str());
         ++nMissingParticle_;
     }
 
@@ -369,7 +446,6 @@ I3TruncatedEnergy::Physics(I3FramePtr frame)
         log_fatal("(%s) No I3Geometry object has been loaded. Is GCD file missing?",
             GetName().c_str());
     }
-    const I3OMGeoMap &omgeomap = geo_->omgeo;
 
     // check if the calibration has been loaded if it is needed in case the
     // relative DOM efficiency should be used to treat each DOM equally
@@ -377,45 +453,78 @@ I3TruncatedEnergy::Physics(I3FramePtr frame)
       log_fatal("(%s) No Calibration info but this is essential for Relative DOM Efficiencies!",
                 GetName().c_str()); 
 
-    // get the reconstructed particle and pulses map from the frame
-    I3ParticleConstPtr reco_particle =
-        frame->Get<I3ParticleConstPtr>(RecoParticleName_);
+    // get the pulses map from the frame
     I3RecoPulseSeriesMapConstPtr reco_pulses_map =
         frame->Get<I3RecoPulseSeriesMapConstPtr>(RecoPulsesName_);
 
-    // check event's health, if bad, push the frame with no more calculations
-    if(! CheckEventPulsesAndFitStatus(reco_pulses_map, reco_particle) )
+    // the DOMs and their measured charges are the same for all tracks, they
+    // are only collected once the first good track is found
+    bool doms_filled = false;
+
+    const bool single_track = RecoParticleNames_.empty();
+    const size_t n_tracks = single_track ? 1 : RecoParticleNames_.size();
+    for(size_t i_track = 0; i_track < n_tracks; ++i_track)
     {
-        PushFrame(frame, "OutBox");
-        return;
-    }
+        const std::string &reco_particle_name =
+            single_track ? RecoParticleName_ : RecoParticleNames_[i_track];
+        const std::string result_name =
+            single_track ? ResultParticleName_ : ResultParticleName_ + reco_particle_name;
 
-    log_debug("(%s) Geo map has %zu DOMs and reco pulses map has %zu DOMs with pulses.",
-        GetName().c_str(), omgeomap.size(), reco_pulses_map->size());
+        // get the reconstructed particle from the frame
+        I3ParticleConstPtr reco_particle =
+            frame->Get<I3ParticleConstPtr>(reco_particle_name);
 
-    // check if the BadDomList can be found in case we need it (only in UseAllDOMs mode)
-    I3VectorOMKeyConstPtr badDomList = frame->Get<I3VectorOMKeyConstPtr>(BadDomListName_);
-    
-    if(BadDomListName_.empty())
-    {
-        badDomList = I3VectorOMKeyConstPtr(new I3VectorOMKey());
-    }
-    if(!badDomList)
-    {
-        log_warn("(%s) BadDomList %s can not be found in frame. Using all DOMs...",
-            GetName().c_str(), BadDomListName_.c_str());
-        badDomList = I3VectorOMKeyConstPtr(new I3VectorOMKey());
+        // check event's health, if bad, skip this track
+        if(! CheckEventPulsesAndFitStatus(reco_pulses_map, reco_particle, reco_particle_name) )
+            continue;
+
+        if(! doms_filled)
+        {
+            log_debug("(%s) Geo map has %zu DOMs and reco pulses map has %zu DOMs with pulses.",
+                GetName().c_str(), geo_->omgeo.size(), reco_pulses_map->size());
+
+            // check if the BadDomList can be found in case we need it (only in UseAllDOMs mode)
+            I3VectorOMKeyConstPtr badDomList = frame->Get<I3VectorOMKeyConstPtr>(BadDomListName_);
+
+            if(BadDomListName_.empty())
+            {
+                badDomList = I3VectorOMKeyConstPtr(new I3VectorOMKey());
+            }
+            if(!badDomList)
+            {
+                log_warn("(%s) BadDomList %s can not be found in frame. Using all DOMs...",
+                    GetName().c_str(), BadDomListName_.c_str());
+                badDomList = I3VectorOMKeyConstPtr(new I3VectorOMKey());
+            }
+            log_debug("(%s) BadDomList loaded with %zu DOMs.",
+                GetName().c_str(), badDomList->size());
+
+            FillDoms(*reco_pulses_map, *badDomList);
+            doms_filled = true;
+        }
+
+        EstimateEnergy(frame, reco_particle, result_name);
     }
-    log_debug("(%s) BadDomList loaded with %zu DOMs.",
-        GetName().c_str(), badDomList->size());
-    
 
+    // Don't forget to push the frame back to the outbox!!!
+    PushFrame(frame, "OutBox");
+}
+
+//______________________________________________________________________________
+/** This method is called in Physics() above for each good track, with the
+ *  DOMs of the frame in doms_.
+ */
+void
+I3TruncatedEnergy::EstimateEnergy(
+    I3FramePtr         frame,
+    I3ParticleConstPtr reco_particle,
+    const std::string  &result_name
+)
+{
     // ---------------------------------------------------------------
     // SECTION FOR BINNING THE ENERGIES OF PHOTONICS AND ACTUAL NPE
     // ---------------------------------------------------------------
 
-    dom_prop_map_t DomPropMap;
-
     // define the minimal maximum number of bins for the BIN method
     // NOTE: This number is only used for optimization, the actual number of
     //       bins will be increased automatically for a possible bigger detector!
@@ -426,88 +535,48 @@ I3TruncatedEnergy::Physics(I3FramePtr frame)
     // value.
     const double ref_energy = 1.0 * I3Units::GeV;
 
+    // get expected NPEs of the track on all DOMs by asking photonics
+    CalculateExpectedNPEsFromTrack(*reco_particle, ref_energy);
+
     double tot_det_npes = 0.;
     double tot_exp_npes = 0.;
     double minDomDistAlongTrack =  HUGE_VAL;
     double maxDomDistAlongTrack = -HUGE_VAL;
 
-    // iterate through all DOMs of the configured geometry (given by the
-    // geometry frame) and get the expected and measured number of photo
-    // electrons.
-    // Save everything inside the DomPropMap structure.
-    I3OMGeoMap::const_iterator omgeomap_citer;
-    for(omgeomap_citer = omgeomap.begin();
-        omgeomap_citer != omgeomap.end();
-        ++omgeomap_citer
-       )
+    // iterate through all DOMs of the frame and get the expected and
+    // measured number of photo electrons.
+    // Save everything inside domProps_, in the order of the geometry.
+    domProps_.clear();
+    for(size_t i = 0; i < doms_.size(); ++i)
     {
-        const OMKey   &omkey = omgeomap_citer->first;
-        const I3OMGeo &omgeo = omgeomap_citer->second;
-
-        // exclude IceTop DOMs
-        if(omgeo.omtype != I3OMGeo::IceCube)
-            continue;
-
-        // get expected NPEs of the track on this DOM by asking photonics
-        const double exp_npes = CalculateExpectedDomNPEsFromTrack(reco_particle, omkey, omgeo, ref_energy, badDomList);
+        const dom_t &dom = doms_[i];
+        const double exp_npes = expNPEs_[i];
         if(exp_npes == 0.)
         {
-            // do not consider bad DOMs 
+            // do not consider DOMs for which photonics failed
             continue;
         }
-        // NOTE: expected charge > 0. means that the DOM is not bad and
-        //       photonics didn't fail
-        
-        // count the total expected PEs for the photorec method
-        tot_exp_npes += exp_npes;
+        // NOTE: expected charge > 0. means that photonics didn't fail
 
-        // check if we got pulses on this DOM, if so, count all the measured PEs
-        // and store it inside dom_prop.npes
-
-        double det_npes = 0.;
-        I3RecoPulseSeriesMap::const_iterator reco_pulses_map_citer = reco_pulses_map->find(omkey);
-        if(reco_pulses_map_citer != reco_pulses_map->end())
-        {
-            // this DOM has pulses in this event; sum them up!
-            const I3RecoPulseSeries &reco_pulses = reco_pulses_map_citer->second;
-            for(I3RecoPulseSeries::const_iterator reco_pulses_citer = reco_pulses.begin();
-                reco_pulses_citer != reco_pulses.end();
-                ++reco_pulses_citer
-               )
-            {
-                double reco_pulse_npes = reco_pulses_citer->GetCharge();
-                if(reco_pulse_npes < 0) {
-                    log_warn("(%s) Got a sick pulse in DOM %s! Ignore the pulse.",
-                        GetName().c_str(), omkey.str().c_str());
-                    continue;
-                }
-                det_npes += reco_pulse_npes;
-            }
-            tot_det_npes += det_npes;
-        }
+        // count the total expected and measured PEs for the photorec method
+        tot_exp_npes += exp_npes;
+        tot_det_npes += dom.det_npes;
 
         // create DOM property structure
         dom_prop_t dom_prop;
 
         // set measured und expected number of photo electrons
-        dom_prop.det_npes = det_npes;
+        dom_prop.det_npes = dom.det_npes;
         dom_prop.exp_npes = exp_npes;
         // calculate DOM distance perpendicular to the track
-        dom_prop.dist_perpendicular_to_track = I3Calculator::ClosestApproachDistance(*reco_particle, omgeo.position);
+        dom_prop.dist_perpendicular_to_track = I3Calculator::ClosestApproachDistance(*reco_particle, dom.position);
         // calculate DOM distance along the track
-        dom_prop.dist_along_track = I3Calculator::DistanceAlongTrack(*reco_particle, omgeo.position);
-        // insert HIT DOM into DomPropMap
-        std::pair<dom_prop_map_t::iterator, bool> ret;
-        ret = DomPropMap.insert(std::pair<const OMKey, dom_prop_t>(omkey, dom_prop));
-        if(ret.second == false)
-        {
-            log_fatal("(%s) Unable to insert DOM %s into DomPropMap!",
-                GetName().c_str(), omkey.str().c_str());
-        }
+        dom_prop.dist_along_track = I3Calculator::DistanceAlongTrack(*reco_particle, dom.position);
+        domProps_.push_back(dom_prop);
 
         // calculate minimum and maximum DOM distance along the track of hit
         // DOMs for determining the binning
-        if((det_npes > 0.)                                                    &&
+        if((dom.det_npes > 0.)                                                &&
            (dom_prop.dist_perpendicular_to_track >= SetMinCylinderBIN_) &&
            (dom_prop.dist_perpendicular_to_track <= SetMaxCylinderBIN_) 
           )
@@ -521,12 +590,11 @@ I3TruncatedEnergy::Physics(I3FramePtr frame)
                 maxDomDistAlongTrack = dom_prop.dist_along_track;
             }
         }
-    } // END geometry FOR loop
+    } // END DOM FOR loop
     if(minDomDistAlongTrack == HUGE_VAL)
     {
         log_debug("(%s) Not a single DOM with charge in cylinder, probably reco-track went horribly wrong!",
             GetName().c_str() );
-        //std::cout << reco_particle->GetZenith() << " " << reco_particle->GetAzimuth() << "\n" << "\n";
     }
 
     // calculate original photorec ratio
@@ -546,15 +614,13 @@ I3TruncatedEnergy::Physics(I3FramePtr frame)
     // purely for optimization reasons, no physics impact
     DOMMethod_DomNPEsRatioList.reserve(240);
     unsigned int DOMMethod_N_DOMs_all = 0;
-    for(dom_prop_map_t::const_iterator dom_prop_map_citer = DomPropMap.begin();
-        dom_prop_map_citer != DomPropMap.end();
-        ++dom_prop_map_citer
+    for(std::vector<dom_prop_t>::const_iterator dom_prop_citer = domProps_.begin();
+        dom_prop_citer != domProps_.end();
+        ++dom_prop_citer
        )
     {
         // get DOM property structure for this DOM
-        // NOTE: There are only DOMs inside the DomProbMap that are relevant for
-        //       the current method (i.e., only hit DOMs if not UseAllDoms_).
-        const dom_prop_t &dom_prop = dom_prop_map_citer->second;
+        const dom_prop_t &dom_prop = *dom_prop_citer;
 
         // BIN method
         if((dom_prop.dist_perpendicular_to_track >= SetMinCylinderBIN_) &&
@@ -644,28 +710,26 @@ I3TruncatedEnergy::Physics(I3FramePtr frame)
     {
         BINMethod_event_type = BIN_METHOD_EVENT_TYPE__BIN_COUNT_GREATER_EQUAL_3;
 
-        /*  calculate the bin ranking
-         *  We want to make a rank 1-15, if the event had 15 non-zero bins,
-         *  to find the highest (rank 1) ratio, then next highest (rank 2), etc.
-         *  This ranking is needed to preserve the bin index relation between
-         *  the BINMethod_MesNPEsBins and BINMethod_ExpNPEsBins vectors.
+        /*  The bins are ranked from the highest (rank 1) to the lowest ratio,
+         *  a bin is kept if its rank, i.e. the number of bins with a ratio at
+         *  least as high, is above 40% of the non-zero bins. That is the case
+         *  exactly for the bins with a ratio up to the n_keep-th highest one,
+         *  which nth_element finds without sorting all bins.
+         *  The bin index relation between the BINMethod_MesNPEsBins and
+         *  BINMethod_ExpNPEsBins vectors is preserved.
          */
-        std::vector<unsigned> BINMethod_NPEsBinRatios_Ranks(BINMethod_N_bins, 0);
-        std::vector<unsigned> BINMethod_NPEsBinRatios_Ranks_AllDOMs(BINMethod_N_bins, 0);
-        for(unsigned i=0; i<BINMethod_N_bins; ++i)
-        {
-            for(unsigned j=0; j<BINMethod_N_bins; ++j)
-            {
-                if(BINMethod_NPEsBinRatios[i] <= BINMethod_NPEsBinRatios[j])
-                {
-                    ++BINMethod_NPEsBinRatios_Ranks[i];
-                }
-                if(BINMethod_NPEsBinRatios_AllDOMs[i] <= BINMethod_NPEsBinRatios_AllDOMs[j])
-                {
-                    ++BINMethod_NPEsBinRatios_Ranks_AllDOMs[i];
-                }
-            }
-        }
+        const unsigned n_keep = static_cast<unsigned>(std::floor(0.40*BINMethod_N_NPEsBinRatios_entries_greater_zero)) + 1;
+        std::vector<double> BINMethod_NPEsBinRatios_Sorted(BINMethod_NPEsBinRatios);
+        std::nth_element(BINMethod_NPEsBinRatios_Sorted.begin(),
+                         BINMethod_NPEsBinRatios_Sorted.begin() + (n_keep - 1),
+                         BINMethod_NPEsBinRatios_Sorted.end(), std::greater<double>());
+        const double BINMethod_max_kept_ratio = BINMethod_NPEsBinRatios_Sorted[n_keep - 1];
+
+        BINMethod_NPEsBinRatios_Sorted.assign(BINMethod_NPEsBinRatios_AllDOMs.begin(), BINMethod_NPEsBinRatios_AllDOMs.end());
+        std::nth_element(BINMethod_NPEsBinRatios_Sorted.begin(),
+                         BINMethod_NPEsBinRatios_Sorted.begin() + (n_keep - 1),
+                         BINMethod_NPEsBinRatios_Sorted.end(), std::greater<double>());
+        const double BINMethod_max_kept_ratio_AllDOMs = BINMethod_NPEsBinRatios_Sorted[n_keep - 1];
 
         // sum the actual and expected NPEs per bin by applying the
         // 40% truncation
@@ -674,12 +738,12 @@ I3TruncatedEnergy::Physics(I3FramePtr frame)
         double BINMethod_truncated_ExpNPEsBins_sum_AllDOMs = 0.;
         for(unsigned bin_index=0; bin_index < BINMethod_N_bins; ++bin_index)
         {
-            if(BINMethod_NPEsBinRatios_Ranks[bin_index] > 0.40*BINMethod_N_NPEsBinRatios_entries_greater_zero)
+            if(BINMethod_NPEsBinRatios[bin_index] <= BINMethod_max_kept_ratio)
             {
                 BINMethod_truncated_MesNPEsBins_sum += BINMethod_MesNPEsBins[bin_index];
                 BINMethod_truncated_ExpNPEsBins_sum += BINMethod_ExpNPEsBins[bin_index];
             }
-            if(BINMethod_NPEsBinRatios_Ranks_AllDOMs[bin_index] > 0.40*BINMethod_N_NPEsBinRatios_entries_greater_zero)
+            if(BINMethod_NPEsBinRatios_AllDOMs[bin_index] <= BINMethod_max_kept_ratio_AllDOMs)
             {
                 BINMethod_truncated_ExpNPEsBins_sum_AllDOMs += BINMethod_ExpNPEsBins_AllDOMs[bin_index];
             }
@@ -717,11 +781,14 @@ I3TruncatedEnergy::Physics(I3FramePtr frame)
     double DOMMethod_50p_cor_reco_E_AllDOMs = 0.;
     if(DOMMethod_event_type != DOM_METHOD_EVENT_TYPE__BAD)
     {
-        sort(DOMMethod_DomNPEsRatioList.begin(), DOMMethod_DomNPEsRatioList.end());
-
         // determines how many DOMs to cut, rounded down
         // 50% cuts, sum the first 50% lower ratios
         unsigned int n_doms_keep_50 = static_cast<unsigned int>(std::ceil(DOMMethod_N_DOMs_hit * 0.50));
+
+        // only the lower ratios need to be in order
+        std::partial_sort(DOMMethod_DomNPEsRatioList.begin(),
+                          DOMMethod_DomNPEsRatioList.begin() + n_doms_keep_50,
+                          DOMMethod_DomNPEsRatioList.end());
         unsigned int n_doms_cut_50 = DOMMethod_N_DOMs_hit - n_doms_keep_50;
         double sum_50 = 0.;
         for(unsigned i=0; i<n_doms_keep_50; ++i)
@@ -860,24 +927,24 @@ I3TruncatedEnergy::Physics(I3FramePtr frame)
             mu_energy_BINS = pow(10.0, pwr_BINS);
         }
         i3particle_result_muon_BINS->SetEnergy(mu_energy_BINS);
-        frame->Put(ResultParticleName_+"_BINS_Muon", i3particle_result_muon_BINS);
+        frame->Put(result_name+"_BINS_Muon", i3particle_result_muon_BINS);
 
         // output double for dEdx
         I3DoublePtr i3double_dedx_BINS(new I3Double(BINMethod_40p_cor_reco_E));
-        frame->Put(ResultParticleName_+"_BINS_dEdX", i3double_dedx_BINS);
+        frame->Put(result_name+"_BINS_dEdX", i3double_dedx_BINS);
 
         // output double for Eres in log10(E)
         I3DoublePtr i3double_res_BINS(new I3Double(res_BINS));
-        frame->Put(ResultParticleName_+"_BINS_MuEres", i3double_res_BINS);
+        frame->Put(result_name+"_BINS_MuEres", i3double_res_BINS);
 
         // output neutrino particle for Bins method
         I3ParticlePtr i3particle_result_nu_BINS(new I3Particle(*reco_particle));
         i3particle_result_nu_BINS->SetEnergy(nu_energy_BINS);
-        frame->Put(ResultParticleName_+"_BINS_Neutrino", i3particle_result_nu_BINS);
+        frame->Put(result_name+"_BINS_Neutrino", i3particle_result_nu_BINS);
 
         // output vector for dE/dx 
         I3VectorDoublePtr i3vector_dedx_BINS(new I3VectorDouble(I3BINMethod_NPEsBinRatios)); 
-        frame->Put(ResultParticleName_+"_BINS_dEdxVector", i3vector_dedx_BINS);        
+        frame->Put(result_name+"_BINS_dEdxVector", i3vector_dedx_BINS);        
     }
 
     // repeat the if to get a new scope; those equations might be error-prone
@@ -946,20 +1013,20 @@ I3TruncatedEnergy::Physics(I3FramePtr frame)
             mu_energy_BINS_AllDOMs = pow(10.0, pwr_BINS_AllDOMs);
         }
         i3particle_result_muon_BINS_AllDOMs->SetEnergy(mu_energy_BINS_AllDOMs);
-        frame->Put(ResultParticleName_+"_AllBINS_Muon", i3particle_result_muon_BINS_AllDOMs);
+        frame->Put(result_name+"_AllBINS_Muon", i3particle_result_muon_BINS_AllDOMs);
 
         // output double for dEdx
         I3DoublePtr i3double_dedx_BINS_AllDOMs(new I3Double(BINMethod_40p_cor_reco_E_AllDOMs));
-        frame->Put(ResultParticleName_+"_AllBINS_dEdX", i3double_dedx_BINS_AllDOMs);
+        frame->Put(result_name+"_AllBINS_dEdX", i3double_dedx_BINS_AllDOMs);
 
         // output double for Eres in log10(E) in AllDOMs mode
         I3DoublePtr i3double_res_BINS_AllDOMs(new I3Double(res_BINS_AllDOMs));
-        frame->Put(ResultParticleName_+"_AllBINS_MuEres", i3double_res_BINS_AllDOMs);
+        frame->Put(result_name+"_AllBINS_MuEres", i3double_res_BINS_AllDOMs);
 
         // output neutrino particle for Bins method in AllDOMs mode
         I3ParticlePtr i3particle_result_nu_BINS_AllDOMs(new I3Particle(*reco_particle));
         i3particle_result_nu_BINS_AllDOMs->SetEnergy(nu_energy_BINS_AllDOMs);
-        frame->Put(ResultParticleName_+"_AllBINS_Neutrino", i3particle_result_nu_BINS_AllDOMs);
+        frame->Put(result_name+"_AllBINS_Neutrino", i3particle_result_nu_BINS_AllDOMs);
     }
 
     //--------------------------------------------------------------------------
@@ -1081,20 +1148,20 @@ I3TruncatedEnergy::Physics(I3FramePtr frame)
             mu_energy_DOMS = pow(10., pwr_DOMS);
         }
         i3particle_result_muon_DOMS->SetEnergy(mu_energy_DOMS);
-        frame->Put(ResultParticleName_+"_DOMS_Muon", i3particle_result_muon_DOMS);
+        frame->Put(result_name+"_DOMS_Muon", i3particle_result_muon_DOMS);
 
         // output double for dEdx
         I3DoublePtr i3double_dedx_DOMS(new I3Double(DOMMethod_50p_cor_reco_E));
-        frame->Put(ResultParticleName_+"_DOMS_dEdX", i3double_dedx_DOMS);
+        frame->Put(result_name+"_DOMS_dEdX", i3double_dedx_DOMS);
 
         // output double for Eres in log10(E)
         I3DoublePtr i3double_res_DOMS(new I3Double(res_DOMS));
-        frame->Put(ResultParticleName_+"_DOMS_MuEres", i3double_res_DOMS);
+        frame->Put(result_name+"_DOMS_MuEres", i3double_res_DOMS);
 
         // output neutrino particle for DOMs method
         I3ParticlePtr i3particle_result_nu_DOMS(new I3Particle(*reco_particle));
         i3particle_result_nu_DOMS->SetEnergy(nu_energy_DOMS);
-        frame->Put(ResultParticleName_+"_DOMS_Neutrino", i3particle_result_nu_DOMS);
+        frame->Put(result_name+"_DOMS_Neutrino", i3particle_result_nu_DOMS);
     }
 
     // and again, new scope for the AllDOMs method
@@ -1161,20 +1228,20 @@ I3TruncatedEnergy::Physics(I3FramePtr frame)
             mu_energy_DOMS_AllDOMs = pow(10., pwr_DOMS_AllDOMs);
         }
         i3particle_result_muon_DOMS_AllDOMs->SetEnergy(mu_energy_DOMS_AllDOMs);
-        frame->Put(ResultParticleName_+"_AllDOMS_Muon", i3particle_result_muon_DOMS_AllDOMs);
+        frame->Put(result_name+"_AllDOMS_Muon", i3particle_result_muon_DOMS_AllDOMs);
 
         // output double for dEdx
         I3DoublePtr i3double_dedx_AllDOMs(new I3Double(DOMMethod_50p_cor_reco_E_AllDOMs));
-        frame->Put(ResultParticleName_+"_AllDOMS_dEdX", i3double_dedx_AllDOMs);
+        frame->Put(result_name+"_AllDOMS_dEdX", i3double_dedx_AllDOMs);
 
         // output double for Eres in log10(E) in AllDOMs mode
         I3DoublePtr i3double_res_DOMS_AllDOMs(new I3Double(res_DOMS_AllDOMs));
-        frame->Put(ResultParticleName_+"_AllDOMS_MuEres", i3double_res_DOMS_AllDOMs);
+        frame->Put(result_name+"_AllDOMS_MuEres", i3double_res_DOMS_AllDOMs);
 
         // output neutrino particle for DOMs method in AllDOMs mode
         I3ParticlePtr i3particle_result_nu_DOMS_AllDOMs(new I3Particle(*reco_particle));
         i3particle_result_nu_DOMS_AllDOMs->SetEnergy(nu_energy_DOMS_AllDOMs);
-        frame->Put(ResultParticleName_+"_AllDOMS_Neutrino", i3particle_result_nu_DOMS_AllDOMs);
+        frame->Put(result_name+"_AllDOMS_Neutrino", i3particle_result_nu_DOMS_AllDOMs);
     }
 
     // all events should get the Orig Photorec energy value as a minimum
@@ -1193,12 +1260,12 @@ I3TruncatedEnergy::Physics(I3FramePtr frame)
         muon_energy_ORIG = 0.0;
     }
     i3particle_photorec_result->SetEnergy(muon_energy_ORIG);
-    frame->Put(ResultParticleName_+"_ORIG_Muon", i3particle_photorec_result);
+    frame->Put(result_name+"_ORIG_Muon", i3particle_photorec_result);
 
     //--------------------------------------------------------------------------
     // give the Original dE/dx value for all events
     I3DoublePtr dEdX(new I3Double(OrigPhotorec));
-    frame->Put(ResultParticleName_+"_ORIG_dEdX", dEdX);
+    frame->Put(result_name+"_ORIG_dEdX", dEdX);
 
     //--------------------------------------------------------------------------
     // neutrino for Orig Photorec
@@ -1214,10 +1281,7 @@ I3TruncatedEnergy::Physics(I3FramePtr frame)
         nu_energy_ORIG = 0.0;
     }
     i3particle_result_nu_ORIG->SetEnergy(nu_energy_ORIG);
-    frame->Put(ResultParticleName_+"_ORIG_Neutrino", i3particle_result_nu_ORIG);
-
-    // Don't forget to push the frame back to the outbox!!!
-    PushFrame(frame, "OutBox");
+    frame->Put(result_name+"_ORIG_Neutrino", i3particle_result_nu_ORIG);
 }
 
 //______________________________________________________________________________
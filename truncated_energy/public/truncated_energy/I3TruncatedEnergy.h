@@ -10,6 +10,9 @@
 #include <dataclasses/calibration/I3Calibration.h>  // for useRDE
 #include <dataclasses/geometry/I3Geometry.h>
 
+#include <string>
+#include <vector>
+
 namespace truncated_energy
 {
     /// define inverse I3Units in advance because multiplications are much
@@ -63,7 +66,14 @@ class I3TruncatedEnergy : public I3ConditionalModule
         double dist_perpendicular_to_track; //< distance of the DOM perpendicular to the track
         double dist_along_track;            //< distance of the DOM along the track
     };
-    typedef std::map<const OMKey, dom_prop_t> dom_prop_map_t;
+
+    /// in-ice DOM of the current frame, with everything that does not depend on the track
+    struct dom_t {
+        OMKey omkey;
+        I3Position position;
+        double det_npes;                    //< number of detected photo electrons at the DOM
+        double rde;                         //< relative DOM efficiency applied to the expectation
+    };
 
     /// enum type for event classification for the BIN method
     enum BINMethodEventType_t {
@@ -91,6 +101,9 @@ class I3TruncatedEnergy : public I3ConditionalModule
     /// name of the reconstructed particle to use.  
     std::string RecoParticleName_;
 
+    /// names of several reconstructed particles to evaluate in one pass
+    std::vector<std::string> RecoParticleNames_;
+
     /// name of the result particle to put in the frame.  
     std::string ResultParticleName_;
 
@@ -103,18 +116,36 @@ class I3TruncatedEnergy : public I3ConditionalModule
     /// check if pulses and fit are usable
     bool CheckEventPulsesAndFitStatus(
         I3RecoPulseSeriesMapConstPtr reco_pulses_map,
-        I3ParticleConstPtr           reco_particle
+        I3ParticleConstPtr           reco_particle,
+        const std::string            &reco_particle_name
     );
 
-    /// get expected NPE from table, for a particular DOM+track
-    double CalculateExpectedDomNPEsFromTrack(
+    /// collect the in-ice DOMs which are not bad and their measured charge
+    void FillDoms(
+        const I3RecoPulseSeriesMap  &reco_pulses_map,
+        const I3VectorOMKey         &bad_dom_list
+    );
+
+    /// get expected NPEs from table for all DOMs in doms_, for one track
+    void CalculateExpectedNPEsFromTrack(
+        const I3Particle &reco_particle,
+        const double     ref_energy
+    );
+
+    /// estimate the energy of one track and put the results into the frame
+    void EstimateEnergy(
+        I3FramePtr         frame,
         I3ParticleConstPtr reco_particle,
-        const OMKey        &omkey,
-        const I3OMGeo      &omgeo,
-        const double       ref_energy,
-        const I3VectorOMKeyConstPtr bad_dom_list
+        const std::string  &result_name
     );
 
+    /// DOMs of the current frame
+    std::vector<dom_t> doms_;
+    /// expected NPEs of doms_ for the current track
+    std::vector<double> expNPEs_;
+    /// DOM properties for the current track, buffer reused between tracks
+    std::vector<dom_prop_t> domProps_;
+
     /// diagnostic counter: missing input particle (track, cascade)
     unsigned int nMissingParticle_;
     /// diagnostic counter: missing input pulses
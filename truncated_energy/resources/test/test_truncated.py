@@ -44,6 +44,27 @@ tray.AddModule("I3TruncatedEnergy",
                UseRDE = True,
                )
 
+# several tracks in one pass have to give the same results as one pass per
+# track, so run the single-track module on the second fit as well
+fits = ["SplineMPE", "MPEFit"]
+tray.AddModule("I3TruncatedEnergy",
+               RecoPulsesName = 'TWSRTHVInIcePulses',
+               RecoParticleName = "MPEFit",
+               ResultParticleName = "MPEFitTruncatedEnergy2_SPICEMie",
+               I3PhotonicsServiceName = "PhotonicsServiceMu_SpiceMie",
+               UseRDE = True,
+               )
+
+tray.AddModule("I3TruncatedEnergy",
+               RecoPulsesName = 'TWSRTHVInIcePulses',
+               RecoParticleNames = fits,
+               ResultParticleName = "TruncatedEnergy3_",
+               I3PhotonicsServiceName = "PhotonicsServiceMu_SpiceMie",
+               UseRDE = True,
+               )
+
+compared = dict((fit, 0) for fit in fits)
+
 def test(frame):
     for key in frame.keys():
         if key.startswith("SplineMPETruncatedEnergy_"):
@@ -56,8 +77,33 @@ def test(frame):
             nd = d/(energy1 + energy2) if (energy1 + energy2) > 0 else 0.
             print("%s difference = %f normalized difference = %0.10f" % (key, d, nd))
             assert(nd < 1e-6)
+        for fit in fits:
+            single = fit + "TruncatedEnergy2_SPICEMie_"
+            if not key.startswith(single):
+                continue
+            multi = key.replace(single, "TruncatedEnergy3_" + fit + "_")
+            assert multi in frame, "%s is missing" % multi
+            f2 = frame[key]
+            f3 = frame[multi]
+            if isinstance(f2, dataclasses.I3Particle):
+                assert(f2.energy == f3.energy)
+            elif isinstance(f2, dataclasses.I3Double):
+                assert(f2.value == f3.value)
+            else:
+                assert(list(f2) == list(f3))
+            compared[fit] += 1
+    # tracks without results in the single-track run have none in the
+    # multi-track run either
+    for key in frame.keys():
+        for fit in fits:
+            multi = "TruncatedEnergy3_" + fit + "_"
+            if key.startswith(multi):
+                assert key.replace(multi, fit + "TruncatedEnergy2_SPICEMie_") in frame
 
 tray.AddModule(test)
 
 tray.Execute()
 
+for fit in fits:
+    assert compared[fit] > 0, "no results to compare for %s" % fit
+
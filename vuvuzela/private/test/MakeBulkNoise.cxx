@@ -0,0 +1,54 @@
+#include <I3Test.h>
+
+#include "icetray/I3Units.h"
+
+#include "vuvuzela/CounterRNG.h"
+#include "vuvuzela/VuvuzelaFunctions.h"
+
+using namespace std;
+
+TEST_GROUP(BulkNoise);
+
+TEST(CounterRNGStreams){
+  // The same key and stream give the same numbers, other streams differ
+  CounterRNG a(1234, 5, 6), b(1234, 5, 6), c(1234, 5, 7);
+  std::vector<double> ua, ub, uc;
+  a.FillUniform(ua, 100);
+  b.FillUniform(ub, 100);
+  c.FillUniform(uc, 100);
+  for (size_t i = 0; i < ua.size(); i++){
+    ENSURE(ua[i] > 0 && ua[i] < 1, "Uniform numbers must be in (0,1)");
+    ENSURE_EQUAL(ua[i], ub[i], "Streams with the same key must be identical");
+  }
+  ENSURE(ua != uc, "Streams with different stream words must differ");
+}
+
+TEST(BulkNoiseRate){
+  NoiseParameters params;
+  params.thermalRate = 100 * I3Units::hertz;
+  params.decayRate = 100 * I3Units::hertz;
+  params.scintillationHits = 10;
+  params.scintillationMean = 3;
+  params.scintillationSigma = 3;
+  double start = 0 * I3Units::second;
+  double stop = 1 * I3Units::second;
+
+  // 100 thermal hits, plus 100 decays with one hit each and 10 from scintillation
+  double expected = 100 + 100 * (1 + 10);
+  double total = 0;
+  const int nTrials = 20;
+  for (int i = 0; i < nTrials; i++){
+    CounterRNG rng(42, i, 0);
+    std::vector<double> hits;
+    MakeBulkNoiseHits(rng, params, 0, start, stop, true, hits);
+    total += hits.size();
+  }
+  ENSURE_DISTANCE(total/nTrials, expected, 30, "Unexpected number of bulk noise hits in 1 s.");
+
+  // The same stream reproduces the hits exactly
+  CounterRNG first(7, 1, 2), second(7, 1, 2);
+  std::vector<double> firstHits, secondHits;
+  MakeBulkNoiseHits(first, params, 0, start, stop, true, firstHits);
+  MakeBulkNoiseHits(second, params, 0, start, stop, true, secondHits);
+  ENSURE(firstHits == secondHits, "Bulk noise must be reproducible for a given key");
+}
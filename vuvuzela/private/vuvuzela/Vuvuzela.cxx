@@ -2,6 +2,7 @@
 
 #include "vuvuzela/Vuvuzela.h"
 #include <cmath>
+#include <limits>
 #include <boost/foreach.hpp>
 
 
@@ -75,6 +76,12 @@ Vuvuzela::Vuvuzela(const I3Context& ctx) : I3Module(ctx)
   randomServiceName_ = std::string("I3RandomService");
   AddParameter("RandomServiceName","Name of RNG in the context",randomServiceName_);
 
+  bulkGeneration_ = false;
+  AddParameter("BulkGeneration", "Generate the noise of all DOMs in bulk from counter-based "
+               "streams, keyed once per frame from the random service. Faster for long "
+               "windows and many PMTs, and reproducible for a given seed, but the hits "
+               "differ from the default generation.", bulkGeneration_);
+
   AddOutBox("OutBox");
 }
 
@@ -106,6 +113,7 @@ Vuvuzela::~Vuvuzela()
  * ScintillationHits The expected number of hits from a cluster.
  * UseIndividual Use individual numbers for each DOM?
  * DisableLowDTCutoff Removes the truncation at 2 microseconds for the timing distribution of noise hits 
+ * BulkGeneration Generate the noise of all DOMs in bulk from counter-based random streams
  *//******************************************************************* */ 
 void Vuvuzela::Configure()
 {
@@ -130,6 +138,7 @@ void Vuvuzela::Configure()
   GetParameter("SimulateNewDOMs", simulateNewDoms_);
   GetParameter("MultiPMT", multiPMT_);
   GetParameter("DisableLowDTCutoff", disableLowDTcutoff_);
+  GetParameter("BulkGeneration", bulkGeneration_);
 
   //   Check to see if valid values were passed
   if (endWindow_ < startWindow_)
@@ -172,6 +181,7 @@ void Vuvuzela::Configure()
   }
 
   bufferMap.clear();
+  bulkBuffer_.clear();
   firstTime = true;
   nhits = 0;
   bufferTime = 0 * I3Units::second;
@@ -253,9 +263,16 @@ void Vuvuzela::DAQ(I3FramePtr frame)
     GetGoodDoms(geometry, calib);
 
     bufferMap.clear();
-    GetNoiseHits(calib,
-                 -0.1 * I3Units::second,
-                 0 * I3Units::second);
+    bulkBuffer_.assign(goodDOMs.size(), std::vector<double>());
+    if (bulkGeneration_)
+      GetBulkNoiseHits(calib,
+                       -0.1 * I3Units::second,
+                       0 * I3Units::second,
+                       FrameKey());
+    else
+      GetNoiseHits(calib,
+                   -0.1 * I3Units::second,
+                   0 * I3Units::second);
     
     firstTime = false;
     nhits = 0;
@@ -263,8 +280,11 @@ void Vuvuzela::DAQ(I3FramePtr frame)
   }
   
   // Get the noise hits for this event
-  I3MCPESeriesMapConstPtr noiseMap = GetNoiseHits(calib,
-						  start, stop);
+  I3MCPESeriesMapConstPtr noiseMap;
+  if (bulkGeneration_)
+    noiseMap = GetBulkNoiseHits(calib, start, stop, FrameKey());
+  else
+    noiseMap = GetNoiseHits(calib, start, stop);
   
   // Add the generated hits to the old hitmap
   I3MCPESeriesMapConstPtr outputHitMap = AddHitMaps(inputHitMap, noiseMap, outputHitInfo);
@@ -352,6 +372,139 @@ void Vuvuzela::GetGoodDoms(const I3Geometry& geometry,
 
 
 
+/* ******************************************************************** */ 
+/* GetNoiseParameters                                                   */
+/** Looks up the noise parameters of a DOM, applying the defaults and the
+ *  (DeepCore) scale factors.
+ *
+ *  \param calibration The I3Calibration for the file. Used to get HQE/QE status
+ *  \param dom The DOM to look up
+ *  \returns The parameters to simulate this DOM with
+ *//******************************************************************* */ 
+NoiseParameters Vuvuzela::GetNoiseParameters(const I3Calibration& calibration,
+                                             const OMKey& dom) const
+{
+  I3Map<OMKey,I3DOMCalibration>::const_iterator calibIter = calibration.domCal.find(dom);
+
+  NoiseParameters params;
+  params.thermalRate = thermalRate_;
+  params.decayRate = decayRate_;
+  params.scintillationHits = scintillationHits_;
+  params.scintillationMean = scintillationMean_;
+  params.scintillationSigma = scintillationSigma_;
+
+  // Get the values for thermal, decay, mean, sigma, and nhits
+  if (useIndividual_ && (calibIter != calibration.domCal.end())){
+    // Grab the individual DOM's parameters
+    NoiseParameters individual;
+    individual.thermalRate = calibIter->second.GetDomNoiseThermalRate();
+    individual.decayRate = calibIter->second.GetDomNoiseDecayRate();
+    individual.scintillationHits = calibIter->second.GetDomNoiseScintillationHits();
+    individual.scintillationMean = calibIter->second.GetDomNoiseScintillationMean();
+    individual.scintillationSigma = calibIter->second.GetDomNoiseScintillationSigma();
+
+    // Check for NaNs
+    if ( (std::isnan(individual.thermalRate) || 
+          std::isnan(individual.decayRate) ||
+          std::isnan(individual.scintillationHits) ||
+          std::isnan(individual.scintillationMean) ||
+          std::isnan(individual.scintillationSigma)) )
+      {
+        if (!simulateNewDoms_)
+          log_fatal("DOM %02i-%02i has no Vuvuzela parameters in GCD file! If you want to simply "
+                    "use the default values, enable SimulateNewDOMs.", 
+                    dom.GetString(),
+                    dom.GetOM());
+      }
+    else
+      params = individual;
+  }
+
+  // Multiply the rates (not anything else) by the scale factor.
+  params.thermalRate *= scaleFactor_;
+  params.decayRate   *= scaleFactor_;
+
+  // For DeepCore: Scale noise for DeepCore(HQE) DOMs
+  if ( calibIter != calibration.domCal.end() &&
+       calibIter->second.GetRelativeDomEff() > 1 ){
+    params.thermalRate *= deepCoreScaleFactor_;
+    params.decayRate   *= deepCoreScaleFactor_;
+  }
+
+  return params;
+}
+
+/* ******************************************************************** */ 
+/* FrameKey                                                             */
+/** Draws the key for this frame's counter-based streams from the random
+ *  service, so that the bulk noise is reproducible for a given seed.
+ *//******************************************************************* */ 
+uint64_t Vuvuzela::FrameKey()
+{
+  uint64_t hi = randomService->Integer(std::numeric_limits<uint32_t>::max());
+  uint64_t lo = randomService->Integer(std::numeric_limits<uint32_t>::max());
+  return (hi << 32) | lo;
+}
+
+/* ******************************************************************** */ 
+/* GetBulkNoiseHits                                                     */
+/** Fills the hit map with thermal and nonthermal noise for the entire
+ *  period from start to stop and for each DOM. Each DOM draws from its
+ *  own counter-based stream, selected by the frame key and its OMKey, so
+ *  the hits of a DOM do not depend on which other DOMs are simulated.
+ *  The per-DOM buffers are sorted vectors: new hits are sorted once and
+ *  merged in, and the hits before stop are moved to the output in one go.
+ *
+ *  \param calibration The I3Calibration for the file. Used to get HQE/QE status
+ *  \param start The time for the event to begin
+ *  \param stop The time for the event to end
+ *  \param key The key for this frame's random streams
+ *  \returns An I3Map of OMKey to the noise hits of this frame.
+ *//******************************************************************* */ 
+I3MCPESeriesMapConstPtr Vuvuzela::GetBulkNoiseHits(const I3Calibration& calibration,
+                                                   double start, double stop,
+                                                   uint64_t key)
+{
+  // Gather the parameters of all DOMs first
+  std::vector<NoiseParameters> params(goodDOMs.size());
+  for (size_t i = 0; i < goodDOMs.size(); i++)
+    params[i] = GetNoiseParameters(calibration, goodDOMs[i]);
+
+  I3MCPESeriesMapPtr noiseMap(new I3MCPESeriesMap());
+  const double lastBufferedTime = stop - start + bufferTime;
+  for (size_t i = 0; i < goodDOMs.size(); i++){
+    const OMKey& dom = goodDOMs[i];
+    std::vector<double>& buffer = bulkBuffer_[i];
+
+    // MakeCoincidentHits does not produce any hits yet, so there is no
+    // multi-PMT term to add here.
+    CounterRNG rng(key, uint32_t(dom.GetString()),
+                   (uint32_t(dom.GetOM()) << 8) | uint32_t(dom.GetPMT()));
+    const size_t nOld = buffer.size();
+    MakeBulkNoiseHits(rng, params[i], bufferTime, start, stop,
+                      disableLowDTcutoff_, buffer);
+    std::sort(buffer.begin() + nOld, buffer.end());
+    std::inplace_merge(buffer.begin(), buffer.begin() + nOld, buffer.end());
+
+    std::vector<double>::iterator last =
+      std::upper_bound(buffer.begin(), buffer.end(), lastBufferedTime);
+    if (last == buffer.begin()) continue;
+
+    I3MCPESeries& hitSeries = (*noiseMap)[dom];
+    hitSeries.reserve(last - buffer.begin());
+    for (std::vector<double>::const_iterator it = buffer.begin(); it != last; ++it){
+      I3MCPE hit;
+      hit.time = *it - bufferTime + start;
+      hit.npe = 1;
+      hitSeries.push_back(hit);
+    }
+    nhits += hitSeries.size();
+    buffer.erase(buffer.begin(), last);
+  }
+
+  return noiseMap;
+}
+
 /* ******************************************************************** */ 
 /* GetNoiseHits                                                        */
 /** Fills the hit map with thermal and nonthermal noise
@@ -369,55 +522,7 @@ I3MCPESeriesMapConstPtr Vuvuzela::GetNoiseHits(const I3Calibration& calibration,
   for(domIter = goodDOMs.begin(); domIter != goodDOMs.end(); ++domIter){
     
     OMKey dom = *domIter;
-    I3Map<OMKey,I3DOMCalibration>::const_iterator calibIter = calibration.domCal.find(dom);
-    
-    // Create the variables for this DOM
-    double currentThermalRate = thermalRate_;
-    double currentDecayRate = decayRate_ ;
-    double currentScintillationHits = scintillationHits_;
-    double currentScintillationMean = scintillationMean_;
-    double currentScintillationSigma = scintillationSigma_;
-	
-    // Get the values for thermal, decay, mean, sigma, and nhits
-    if (useIndividual_ && (calibIter != calibration.domCal.end())){
-      // Grab the individual DOM's parameters
-      currentThermalRate = calibIter->second.GetDomNoiseThermalRate();
-      currentDecayRate = calibIter->second.GetDomNoiseDecayRate();
-      currentScintillationHits = calibIter->second.GetDomNoiseScintillationHits();
-      currentScintillationMean = calibIter->second.GetDomNoiseScintillationMean();
-      currentScintillationSigma = calibIter->second.GetDomNoiseScintillationSigma();
-      
-      // Check for NaNs
-      if ( (std::isnan(currentThermalRate) || 
-	    std::isnan(currentDecayRate) ||
-	    std::isnan(currentScintillationHits) ||
-	    std::isnan(currentScintillationMean) ||
-	    std::isnan(currentScintillationSigma)) )
-	  {
-	    if (simulateNewDoms_){
-	      currentThermalRate = thermalRate_;
-	      currentDecayRate = decayRate_ ;
-	      currentScintillationHits = scintillationHits_;
-	      currentScintillationMean = scintillationMean_;
-	      currentScintillationSigma = scintillationSigma_;
-	    }
-	    else
-	      log_fatal("DOM %02i-%02i has no Vuvuzela parameters in GCD file! If you want to simply "
-                    "use the default values, enable SimulateNewDOMs.", 
-                    dom.GetString(),
-                    dom.GetOM());
-      }
-    }
-
-    // Multiply the rates (not anything else) by the scale factor.
-    currentThermalRate  *= scaleFactor_;
-    currentDecayRate    *= scaleFactor_;
-
-    // For DeepCore: Scale noise for DeepCore(HQE) DOMs
-    if (  calibIter->second.GetRelativeDomEff() > 1 ){
-      currentThermalRate *= deepCoreScaleFactor_;
-      currentDecayRate    *= deepCoreScaleFactor_;
-    }
+    const NoiseParameters params = GetNoiseParameters(calibration, dom);
 
     // Grab the buffer for this DOM
     std::set<double>& bufferHits = bufferMap[dom];
@@ -426,7 +531,7 @@ I3MCPESeriesMapConstPtr Vuvuzela::GetNoiseHits(const I3Calibration& calibration,
     MakeThermalHits(randomService, 
 		    bufferHits,
 		    bufferTime,
-		    currentThermalRate, 
+		    params.thermalRate, 
 		    start, 
 		    stop);
     
@@ -436,10 +541,10 @@ I3MCPESeriesMapConstPtr Vuvuzela::GetNoiseHits(const I3Calibration& calibration,
     		   bufferHits,
 		       bufferTime,
                decayTimes,
-		       currentDecayRate, 
-		       currentScintillationHits,
-		       currentScintillationMean,
-		       currentScintillationSigma,
+		       params.decayRate, 
+		       params.scintillationHits,
+		       params.scintillationMean,
+		       params.scintillationSigma,
 		       start, stop,
 		       disableLowDTcutoff_);
 
@@ -156,6 +156,126 @@ void MakeThermalHits(I3RandomServicePtr random,
   return;
 }
 
+namespace {
+
+  /// Appends the arrival times of a Poisson process with the given rate on
+  /// [0, window) to times, shifted by offset. The exponential gaps are
+  /// drawn in blocks sized to the expected number of arrivals.
+  void PoissonProcess(CounterRNG& rng, double rate, double window,
+                      double offset, std::vector<double>& times,
+                      std::vector<double>& uniforms){
+    if (!(rate > 0) || !(window > 0)) return;
+    const double expected = rate * window;
+    const size_t block = 8 + size_t(expected + 3*sqrt(expected));
+    const double invRate = 1. / rate;
+    double t = 0;
+    for (;;){
+      rng.FillUniform(uniforms, block);
+      for (size_t i = 0; i < block; i++)
+        uniforms[i] = -log(uniforms[i]) * invRate;
+      for (size_t i = 0; i < block; i++){
+        t += uniforms[i];
+        if (t >= window) return;
+        times.push_back(offset + t);
+      }
+    }
+  }
+
+  /// Draws a Poisson number by inverting the cumulative distribution.
+  /// Large means are split into pieces to keep exp(-mean) representable.
+  int PoissonCount(CounterRNG& rng, double mean){
+    if (!(mean > 0)) return 0;
+    const int pieces = 1 + int(mean / 50.);
+    const double pieceMean = mean / pieces;
+    const double p0 = exp(-pieceMean);
+    int count = 0;
+    for (int i = 0; i < pieces; i++){
+      double u = rng.Uniform();
+      double p = p0, cdf = p0;
+      int k = 0;
+      while (u > cdf && p > 0){
+        k++;
+        p *= pieceMean / k;
+        cdf += p;
+      }
+      count += k;
+    }
+    return count;
+  }
+
+  /// Fills out with n standard normal numbers (Box-Muller, in pairs)
+  void FillGaus(CounterRNG& rng, size_t n, std::vector<double>& out){
+    const size_t pairs = (n + 1) / 2;
+    rng.FillUniform(out, 2*pairs);
+    for (size_t i = 0; i < pairs; i++){
+      double r = sqrt(-2. * log(out[2*i]));
+      double phi = 2. * M_PI * out[2*i+1];
+      out[2*i] = r * cos(phi);
+      out[2*i+1] = r * sin(phi);
+    }
+    out.resize(n);
+  }
+}
+
+/* ******************************************************************** */ 
+/* MakeBulkNoiseHits                                                    */
+/** Produces the thermal and the decay + scintillation hits of one DOM
+ *  from a counter-based stream. The distributions are the same as in
+ *  MakeThermalHits and MakeNonThermalHits: thermal hits and decays are
+ *  a Poisson process in time (drawn as exponential gaps), and each decay
+ *  is followed by a Poisson number of hits with lognormal spacing.
+ *  Hits are appended to a plain vector, so no per-hit tree insertion is
+ *  needed; the caller sorts the result once.
+ *
+ *  \param rng The counter-based stream for this DOM
+ *  \param params The noise parameters of this DOM
+ *  \param bufferTime The current time of the buffer.
+ *  \param start The time for the event to begin
+ *  \param stop The time for the event to end
+ *  \param disableCutoff Keep scintillation hits with dt < 2 microseconds
+ *  \param hits Buffer the new hit times are appended to
+ *  \returns void
+ *//******************************************************************* */ 
+void MakeBulkNoiseHits(CounterRNG& rng,
+                       const NoiseParameters& params,
+                       const double bufferTime,
+                       const double start,
+                       const double stop,
+                       bool disableCutoff,
+                       std::vector<double>& hits)
+{
+  const double window = fabs(stop-start);
+  std::vector<double> scratch;
+
+  // Thermal hits
+  PoissonProcess(rng, params.thermalRate, window, bufferTime, hits, scratch);
+
+  // Decays. Each decay produces a hit itself and a cluster of scintillation hits.
+  std::vector<double> decayTimes;
+  PoissonProcess(rng, params.decayRate, window, bufferTime, decayTimes, scratch);
+
+  std::vector<double> deltaTs;
+  for (size_t i = 0; i < decayTimes.size(); i++){
+    const double currentTime = decayTimes[i];
+    hits.push_back(currentTime);
+
+    const int nhits = PoissonCount(rng, params.scintillationHits);
+    if (nhits == 0) continue;
+
+    FillGaus(rng, nhits, deltaTs);
+    for (int j = 0; j < nhits; j++)
+      deltaTs[j] = pow(10, params.scintillationMean + params.scintillationSigma*deltaTs[j]);
+    std::sort(deltaTs.begin(), deltaTs.end());
+
+    double hitTime = deltaTs.front() * 2 + currentTime;
+    for (int j = 0; j < nhits; j++){
+      if (!disableCutoff && deltaTs[j] < 2*I3Units::microsecond) continue;
+      hits.push_back(hitTime);
+      hitTime += deltaTs[j];
+    }
+  }
+}
+
 /* ******************************************************************** */ 
 /* GetTimeRange                                                         */
 /** Reads the hit map to find the time of the first and last hits.
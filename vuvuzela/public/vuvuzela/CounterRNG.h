@@ -0,0 +1,108 @@
+/* ******************************************************************** */
+/** class CounterRNG
+ *  Version $Id: $
+ *  date: $Date: $
+ *  (c) 2012 IceCube Collaboration
+ *
+ *  \brief A counter-based random number generator (Philox4x32-10, from
+ *  Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC11).
+ *  Every block of four 32 bit outputs is a pure function of a 64 bit key
+ *  and a 128 bit counter, so independent streams (one per DOM) need no
+ *  shared state and can be filled in bulk in any order.
+ *//******************************************************************* */
+#ifndef VUVUZELA_COUNTERRNG_H_INCLUDED
+#define VUVUZELA_COUNTERRNG_H_INCLUDED
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+class CounterRNG
+{
+  public:
+
+    /**
+     * \brief Build a stream from a 64 bit key. The two stream words select
+     *  independent streams for the same key (eg. one per DOM).
+     */
+    CounterRNG(uint64_t key, uint32_t stream0, uint32_t stream1) :
+      block_(0), next_(4)
+    {
+      key_[0] = uint32_t(key);
+      key_[1] = uint32_t(key >> 32);
+      stream_[0] = stream0;
+      stream_[1] = stream1;
+    }
+
+    /**
+     * \brief Fill out with n doubles, uniform in (0,1). Each double uses
+     *  two 32 bit outputs for 53 bits of precision.
+     */
+    void FillUniform(double* out, size_t n)
+    {
+      for (size_t i = 0; i < n; i++){
+        uint64_t hi = NextWord() >> 5;   // 27 bits
+        uint64_t lo = NextWord() >> 6;   // 26 bits
+        out[i] = ((hi << 26) + lo + 0.5) * (1.0 / 9007199254740992.0);
+      }
+    }
+
+    void FillUniform(std::vector<double>& out, size_t n)
+    {
+      out.resize(n);
+      if (n) FillUniform(&out[0], n);
+    }
+
+    /// A single uniform double in (0,1)
+    double Uniform()
+    {
+      double u;
+      FillUniform(&u, 1);
+      return u;
+    }
+
+  private:
+
+    uint32_t NextWord()
+    {
+      if (next_ == 4){
+        Generate(block_++);
+        next_ = 0;
+      }
+      return out_[next_++];
+    }
+
+    static inline uint32_t MulHiLo(uint32_t a, uint32_t b, uint32_t& hi)
+    {
+      uint64_t p = uint64_t(a) * uint64_t(b);
+      hi = uint32_t(p >> 32);
+      return uint32_t(p);
+    }
+
+    void Generate(uint64_t block)
+    {
+      const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+      const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+
+      uint32_t c[4] = {uint32_t(block), uint32_t(block >> 32), stream_[0], stream_[1]};
+      uint32_t k[2] = {key_[0], key_[1]};
+      for (int round = 0; round < 10; round++){
+        uint32_t hi0, hi1;
+        uint32_t lo0 = MulHiLo(M0, c[0], hi0);
+        uint32_t lo1 = MulHiLo(M1, c[2], hi1);
+        uint32_t n0 = hi1 ^ c[1] ^ k[0];
+        uint32_t n2 = hi0 ^ c[3] ^ k[1];
+        c[0] = n0; c[1] = lo1; c[2] = n2; c[3] = lo0;
+        k[0] += W0; k[1] += W1;
+      }
+      out_[0] = c[0]; out_[1] = c[1]; out_[2] = c[2]; out_[3] = c[3];
+    }
+
+    uint32_t key_[2];
+    uint32_t stream_[2];
+    uint64_t block_;
+    uint32_t out_[4];
+    unsigned next_;
+};
+
+#endif
@@ -73,9 +73,26 @@ class Vuvuzela : public I3Module
     I3MCPESeriesMapConstPtr GetNoiseHits(const I3Calibration& calibration,
 					  double start, double stop);
 
+    /**
+     * \brief GetBulkNoiseHits: Produce the map of noise hits to be added to this
+     *  frame, drawing from per-DOM counter-based streams keyed by key
+     */
+    I3MCPESeriesMapConstPtr GetBulkNoiseHits(const I3Calibration& calibration,
+                                              double start, double stop,
+                                              uint64_t key);
+
+    /**
+     * \brief GetNoiseParameters: The noise parameters to simulate for a DOM
+     */
+    NoiseParameters GetNoiseParameters(const I3Calibration& calibration,
+                                       const OMKey& dom) const;
+
 
  private:
 
+    /// Draws the key for this frame's counter-based noise streams
+    uint64_t FrameKey();
+
     // Option variables
     std::string inputHitSeriesMapName_;
     std::string outputHitSeriesMapName_;
@@ -95,6 +112,7 @@ class Vuvuzela : public I3Module
     bool multiPMT_;
     bool useEventHeaderBounds_;
     bool disableLowDTcutoff_;
+    bool bulkGeneration_;
 
     double thermalRate_;
     double decayRate_; 
@@ -106,6 +124,8 @@ class Vuvuzela : public I3Module
     I3RandomServicePtr randomService;
     std::string randomServiceName_;
     std::map<OMKey, std::set<double> > bufferMap;
+    // Sorted buffered hit times for each of goodDOMs, used in bulk generation
+    std::vector<std::vector<double> > bulkBuffer_;
     std::map<OMKey, int> maxPMTMap_;
 
     bool firstTime;
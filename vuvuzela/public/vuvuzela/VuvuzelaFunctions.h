@@ -25,6 +25,20 @@
 
 #include "phys-services/I3RandomService.h"
 
+#include "vuvuzela/CounterRNG.h"
+
+/* ******************************************************************** */ 
+/* NoiseParameters                                                      */
+/** \brief The noise model parameters of a single DOM
+ *//******************************************************************* */ 
+struct NoiseParameters{
+  double thermalRate;
+  double decayRate;
+  double scintillationHits;
+  double scintillationMean;
+  double scintillationSigma;
+};
+
 /* ******************************************************************** */ 
 /* MakeCoincidentHits                                                   */
 /** \brief Produces correlated noise hits on a second PMT
@@ -68,6 +82,20 @@ void MakeThermalHits(I3RandomServicePtr random,
 		     const double start, 
 		     const double stop);
 
+/* ******************************************************************** */ 
+/* MakeBulkNoiseHits                                                    */
+/** \brief Produces the thermal, decay and scintillation hits of one DOM
+ *  from a counter-based stream, drawing the random numbers in blocks.
+ *  The new hit times are appended to hits in no particular order.
+ *//******************************************************************* */ 
+void MakeBulkNoiseHits(CounterRNG& rng,
+                       const NoiseParameters& params,
+                       const double bufferTime,
+                       const double start,
+                       const double stop,
+                       bool disableCutoff,
+                       std::vector<double>& hits);
+
 /* ******************************************************************** */ 
 /* GetTimeRange                                                         */
 /** \brief Reads the hit map to find the time of the first and last hits.
@@ -21,6 +21,7 @@ def AddNoise(tray, name,
 	     UseEventHeaderTimeWindow = False,
 	     SimulateNewDOMs        = True,
 	     DisableLowDTCutoff     = True,
+	     BulkGeneration         = False,
              OMTypes = [I3OMGeo.IceCube, 
                         I3OMGeo.PDOM,
                         I3OMGeo.mDOM,],
@@ -34,6 +35,7 @@ def AddNoise(tray, name,
 	:param ExcludeList: List of OMKeys to avoid sinulating.
 	:param StartTime: The amount of time before the first hit to simulate noise
 	:param EndTime: The amount of time after the last hit to simulate noise
+	:param BulkGeneration: Draw the noise in bulk from per-DOM counter-based random streams
 	"""
                 
 	tray.AddModule("Vuvuzela", "vuvuzela_" + name,
@@ -48,6 +50,7 @@ def AddNoise(tray, name,
 		       RandomService          = RandomServiceName,
 		       SimulateNewDOMs        = SimulateNewDOMs,
 		       DisableLowDTCutoff     = DisableLowDTCutoff,
+		       BulkGeneration         = BulkGeneration,
 		       UseIndividual          = True
 		       )
 